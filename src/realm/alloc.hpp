@@ -103,6 +103,14 @@ public:
     /// Calls do_translate().
     char* translate(ref_type ref) const noexcept;
 
+    /// Hint that the \a size bytes starting at the specified \a ref are about
+    /// to be read, so that an allocator backed by a memory mapped file can
+    /// ask the kernel to start paging them in. Returns false if nothing was
+    /// done because the memory was resident already (or is not backed by a
+    /// file), in which case the memory that follows is likely resident too,
+    /// unless the file is being scanned sequentially. Calls do_prefetch().
+    bool prefetch(ref_type ref, size_t size) const noexcept;
+
     /// Returns true if, and only if the object at the specified 'ref'
     /// is in the immutable part of the memory managed by this
     /// allocator. The method by which some objects become part of the
@@ -171,6 +179,12 @@ protected:
     /// is not modified by way of the returned memory pointer.
     virtual char* do_translate(ref_type ref) const noexcept = 0;
 
+    /// The default version of this function does nothing and returns false.
+    virtual bool do_prefetch(ref_type, size_t) const noexcept
+    {
+        return false;
+    }
+
     Allocator() noexcept;
 
     // FIXME: This really doesn't belong in an allocator, but it is the best
@@ -360,6 +374,11 @@ inline char* Allocator::translate(ref_type ref) const noexcept
     return do_translate(ref);
 }
 
+inline bool Allocator::prefetch(ref_type ref, size_t size) const noexcept
+{
+    return do_prefetch(ref, size);
+}
+
 inline bool Allocator::is_read_only(ref_type ref) const noexcept
 {
     REALM_ASSERT_DEBUG(ref != 0);
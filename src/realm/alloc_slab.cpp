@@ -70,6 +70,9 @@ struct SlabAlloc::MappedFile {
     size_t m_num_global_mappings = 0;
     size_t m_capacity_global_mappings = 0;
     std::unique_ptr<std::shared_ptr<const util::File::Map<char>>[]> m_global_mappings;
+    // access pattern hint applied to every mapping of the file, also read
+    // without the mutex by do_prefetch()
+    std::atomic<util::File::Advice> m_access_hint{util::File::advice_Normal};
 
     /// Indicates if attaching to the file was succesfull
     bool m_success = false;
@@ -614,6 +617,50 @@ char* SlabAlloc::do_translate(ref_type ref) const noexcept
 }
 
 
+bool SlabAlloc::do_prefetch(ref_type ref, size_t size) const noexcept
+{
+    // Only the part of the file that is mapped can be paged in ahead of
+    // time. Slabs live in anonymous memory and are always resident.
+    if (!m_file_mappings || ref >= m_baseline)
+        return false;
+
+    const File::Map<char>* map;
+    size_t offset;
+    if (ref < m_initial_chunk_size) {
+        map = &m_file_mappings->m_initial_mapping;
+        offset = ref;
+    }
+    else {
+        size_t section_index = get_section_index(ref);
+        size_t mapping_index = section_index - m_file_mappings->m_first_additional_mapping;
+        REALM_ASSERT_DEBUG(mapping_index < m_num_local_mappings);
+        map = m_local_mappings[mapping_index].get();
+        offset = ref - get_section_base(section_index);
+    }
+
+    // Unless the file is being scanned sequentially, memory that is resident
+    // already means that the file is warm, so the system call is not worth it
+    if (m_file_mappings->m_access_hint != File::advice_Sequential && map->is_resident(offset, size))
+        return false;
+    map->advise(File::advice_WillNeed, offset, size);
+    return true;
+}
+
+
+void SlabAlloc::set_access_hint(File::Advice advice) const noexcept
+{
+    if (!m_file_mappings)
+        return;
+
+    std::lock_guard<util::Mutex> lock(m_file_mappings->m_mutex);
+    m_file_mappings->m_access_hint = advice;
+    if (m_file_mappings->m_initial_mapping.is_attached())
+        m_file_mappings->m_initial_mapping.advise(advice);
+    for (size_t k = 0; k < m_file_mappings->m_num_global_mappings; ++k)
+        m_file_mappings->m_global_mappings[k]->advise(advice);
+}
+
+
 int SlabAlloc::get_committed_file_format_version() const noexcept
 {
     const Header& header = *reinterpret_cast<const Header*>(m_data);
@@ -1011,6 +1058,15 @@ size_t SlabAlloc::get_total_size() const noexcept
 }
 
 
+size_t SlabAlloc::get_allocated_slab_size() const noexcept
+{
+    size_t size = get_total_size() - m_baseline;
+    for (const auto& chunk : m_free_space)
+        size -= chunk.size;
+    return size;
+}
+
+
 void SlabAlloc::reset_free_space_tracking()
 {
     internal_invalidate_cache();
@@ -1081,6 +1137,8 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 get_section_base(1 + k + m_file_mappings->m_first_additional_mapping) - section_start_offset;
             m_file_mappings->m_global_mappings[k] = std::make_shared<const util::File::Map<char>>(
                 m_file_mappings->m_file, section_start_offset, File::access_ReadOnly, section_size);
+            if (m_file_mappings->m_access_hint != File::advice_Normal)
+                m_file_mappings->m_global_mappings[k]->advise(m_file_mappings->m_access_hint);
         }
 
         // Share the increased number of mappings. This *must* be a conditional update to ensure
@@ -258,6 +258,15 @@ public:
     /// allocator. Doing so will result in undefined behavior.
     size_t get_total_size() const noexcept;
 
+    /// Get the number of bytes of mutable memory (ref-space outside the
+    /// attached file) that is currently in use. This is the size of the arrays
+    /// that have been created, or copied on write, since the last call to
+    /// reset_free_space_tracking().
+    ///
+    /// It is an error to call this function on a detached
+    /// allocator. Doing so will result in undefined behavior.
+    size_t get_allocated_slab_size() const noexcept;
+
     /// Mark all mutable memory (ref-space outside the attached file) as free
     /// space.
     void reset_free_space_tracking();
@@ -282,6 +291,14 @@ public:
     /// and force any later address translations to trigger decryption if required.
     void update_reader_view(size_t file_size);
 
+    /// Advise the kernel about how the mapped database file is going to be
+    /// accessed (see util::File::advise_map()). The hint applies to all
+    /// current mappings of the file, including those shared with other
+    /// allocators attached to the same file, and to mappings established later
+    /// by update_reader_view(). It is ignored for encrypted files and when the
+    /// allocator is not attached to a file.
+    void set_access_hint(util::File::Advice) const noexcept;
+
     /// Returns true initially, and after a call to reset_free_space_tracking()
     /// up until the point of the first call to SlabAlloc::alloc(). Note that a
     /// call to SlabAlloc::alloc() corresponds to a mutation event.
@@ -304,6 +321,7 @@ protected:
     // FIXME: It would be very nice if we could detect an invalid free operation in debug mode
     void do_free(ref_type, const char*) noexcept override;
     char* do_translate(ref_type) const noexcept override;
+    bool do_prefetch(ref_type, size_t) const noexcept override;
 
     /// Returns the first section boundary *above* the given position.
     size_t get_upper_section_boundary(size_t start_pos) const noexcept;
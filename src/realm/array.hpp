@@ -371,6 +371,13 @@ public:
     template <size_t w>
     void get_chunk(size_t ndx, int64_t res[8]) const noexcept;
 
+    /// Copy the elements in the range [begin, end) to \a out, unpacked to 64
+    /// bits, dispatching on the element width only once.
+    void get_range(size_t begin, size_t end, int64_t* out) const noexcept;
+
+    template <size_t w>
+    void get_range(size_t begin, size_t end, int64_t* out) const noexcept;
+
     ref_type get_as_ref(size_t ndx) const noexcept;
 
     RefOrTagged get_as_ref_or_tagged(size_t ndx) const noexcept;
@@ -826,6 +833,9 @@ public:
     static uint_least8_t get_width_from_header(const char*) noexcept;
     static size_t get_size_from_header(const char*) noexcept;
 
+    /// Same as get_byte_size().
+    static size_t get_byte_size_from_header(const char*) noexcept;
+
     static Type get_type_from_header(const char*) noexcept;
 
     /// Get the number of bytes currently in use by this array. This
@@ -971,9 +981,6 @@ protected:
     /// Get the address of the header of this array.
     char* get_header() noexcept;
 
-    /// Same as get_byte_size().
-    static size_t get_byte_size_from_header(const char*) noexcept;
-
     // Undefined behavior if array is in immutable memory
     static size_t get_capacity_from_header(const char*) noexcept;
 
@@ -1344,6 +1351,13 @@ inline void Array::get_chunk(size_t ndx, int64_t res[8]) const noexcept
 }
 
 
+inline void Array::get_range(size_t begin, size_t end, int64_t* out) const noexcept
+{
+    REALM_ASSERT_DEBUG(begin <= end && end <= m_size);
+    REALM_TEMPEX(get_range, m_width, (begin, end, out));
+}
+
+
 inline int64_t Array::get(size_t ndx) const noexcept
 {
     REALM_ASSERT_DEBUG(is_attached());
@@ -2002,6 +2016,13 @@ int64_t Array::get(size_t ndx) const noexcept
     return get_universal<w>(m_data, ndx);
 }
 
+template <size_t w>
+void Array::get_range(size_t begin, size_t end, int64_t* out) const noexcept
+{
+    for (size_t i = begin; i < end; ++i)
+        *out++ = get_universal<w>(m_data, i);
+}
+
 template <size_t w>
 int64_t Array::get_universal(const char* data, size_t ndx) const
 {
@@ -39,6 +39,11 @@ public:
 
     T get(size_t ndx) const noexcept;
     bool is_null(size_t ndx) const noexcept;
+
+    /// The elements of this array, which are stored unpacked. The pointer is
+    /// invalidated by any modification of the array.
+    const T* data() const noexcept;
+
     void add(T value);
     void set(size_t ndx, T value);
     void set_null(size_t ndx);
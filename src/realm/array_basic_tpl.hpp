@@ -135,6 +135,13 @@ inline T BasicArray<T>::get(size_t ndx) const noexcept
 }
 
 
+template <class T>
+inline const T* BasicArray<T>::data() const noexcept
+{
+    return reinterpret_cast<const T*>(m_data);
+}
+
+
 template <class T>
 inline bool BasicArray<T>::is_null(size_t ndx) const noexcept
 {
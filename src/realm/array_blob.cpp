@@ -83,8 +83,8 @@ ref_type ArrayBlob::replace(size_t begin, size_t end, const char* data, size_t d
             size_t space_left = max_binary_size - lastNode.size();
             size_t size_to_copy = std::min(space_left, data_size);
             lastNode.add(data, size_to_copy);
-            data_size -= space_left;
-            data += space_left;
+            data_size -= size_to_copy;
+            data += size_to_copy;
 
             while (data_size) {
                 // Create new nodes as required
@@ -161,6 +161,46 @@ ref_type ArrayBlob::replace(size_t begin, size_t end, const char* data, size_t d
     return get_ref();
 }
 
+ref_type ArrayBlob::write(size_t pos, const char* data, size_t data_size)
+{
+    size_t sz = blob_size();
+    REALM_ASSERT_3(pos, <=, sz);
+    REALM_ASSERT(data_size == 0 || data);
+
+    size_t overwrite_size = std::min(data_size, sz - pos);
+    if (!get_context_flag()) {
+        if (pos + data_size <= max_binary_size)
+            return replace(pos, pos + overwrite_size, data, data_size); // Throws
+        // Overwrite what is there, and let the append split the blob
+        replace(pos, pos + overwrite_size, data, overwrite_size);                      // Throws
+        return replace(sz, sz, data + overwrite_size, data_size - overwrite_size); // Throws
+    }
+
+    // Only the arrays holding the overwritten bytes are copied on write
+    size_t offset = pos;
+    size_t n = size();
+    for (size_t i = 0; i < n && overwrite_size > 0; ++i) {
+        ref_type ref = get_as_ref(i);
+        size_t chunk_size = Array::get_size_from_header(m_alloc.translate(ref));
+        if (offset >= chunk_size) {
+            offset -= chunk_size;
+            continue;
+        }
+        size_t size_to_copy = std::min(chunk_size - offset, overwrite_size);
+        ArrayBlob chunk(m_alloc);
+        chunk.init_from_ref(ref);
+        chunk.set_parent(this, i);
+        chunk.replace(offset, offset + size_to_copy, data, size_to_copy); // Throws
+        data += size_to_copy;
+        data_size -= size_to_copy;
+        overwrite_size -= size_to_copy;
+        offset = 0;
+    }
+    if (data_size > 0)
+        replace(sz, sz, data, data_size); // Throws
+    return get_ref();
+}
+
 size_t ArrayBlob::blob_size() const noexcept
 {
     if (get_context_flag()) {
@@ -45,6 +45,14 @@ public:
     ref_type replace(size_t begin, size_t end, const char* data, size_t data_size, bool add_zero_term = false);
     void erase(size_t begin, size_t end);
 
+    /// Overwrite the bytes starting at \a pos with the specified data,
+    /// growing the blob if the data extends beyond its end. \a pos must not
+    /// be greater than the size of the blob. If the blob is split into
+    /// multiple arrays, only those holding the overwritten bytes are
+    /// modified. Returns the new ref of the blob, which differs from the old
+    /// one if the blob had to be split.
+    ref_type write(size_t pos, const char* data, size_t data_size);
+
     /// Get the specified element without the cost of constructing an
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
@@ -131,13 +139,18 @@ inline MemRef ArrayBlob::create_array(size_t init_size, Allocator& allocator)
     return Array::create(type_Normal, context_flag, wtype_Ignore, init_size, value, allocator); // Throws
 }
 
-inline size_t ArrayBlob::calc_byte_len(size_t for_size, size_t) const
+// A split blob is a root array of refs to the arrays holding the data
+inline size_t ArrayBlob::calc_byte_len(size_t for_size, size_t width) const
 {
+    if (m_has_refs)
+        return Array::calc_byte_len(for_size, width);
     return header_size + for_size;
 }
 
-inline size_t ArrayBlob::calc_item_count(size_t bytes, size_t) const noexcept
+inline size_t ArrayBlob::calc_item_count(size_t bytes, size_t width) const noexcept
 {
+    if (m_has_refs)
+        return Array::calc_item_count(bytes, width);
     return bytes - header_size;
 }
 
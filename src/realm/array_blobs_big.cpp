@@ -17,16 +17,20 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <map>
 
 #include <realm/array_blobs_big.hpp>
 #include <realm/column.hpp>
+#include <realm/impl/destroy_guard.hpp>
 
 
 using namespace realm;
 
 BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const noexcept
 {
-    ref_type ref = get_as_ref(ndx);
+    ref_type ref = get_blob_ref(ndx);
     if (ref == 0)
         return {}; // realm::null();
 
@@ -37,39 +41,78 @@ BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const noexcept
 }
 
 
-void ArrayBigBlobs::add(BinaryData value, bool add_zero_term)
+void ArrayBigBlobs::add(BinaryData value, bool add_zero_term, OwnerIndex* owners)
 {
     REALM_ASSERT_7(value.size(), ==, 0, ||, value.data(), !=, 0);
 
+    size_t owner_ndx = not_found;
+    if (owners) {
+        attach_owners(*owners); // Throws
+        if (!value.is_null())
+            owner_ndx = find_owner(value, add_zero_term, *owners);
+    }
+
     if (value.is_null()) {
         Array::add(0); // Throws
     }
+    else if (owner_ndx != not_found) {
+        Array::add(RefOrTagged::make_tagged(owner_ndx)); // Throws
+    }
     else {
         ArrayBlob new_blob(m_alloc);
         new_blob.create();                                                      // Throws
         ref_type ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
         Array::add(from_ref(ref));                                              // Throws
+        if (owners)
+            add_owner(*owners, size() - 1); // Throws
     }
+
+    if (owners)
+        sync_owners(*owners);
 }
 
 
-void ArrayBigBlobs::set(size_t ndx, BinaryData value, bool add_zero_term)
+void ArrayBigBlobs::set(size_t ndx, BinaryData value, bool add_zero_term, OwnerIndex* owners)
 {
     REALM_ASSERT_3(ndx, <, size());
     REALM_ASSERT_7(value.size(), ==, 0, ||, value.data(), !=, 0);
 
+    if (owners) {
+        attach_owners(*owners); // Throws
+        size_t owner_ndx = value.is_null() ? not_found : find_owner(value, add_zero_term, *owners);
+        if (owner_ndx != not_found) {
+            RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+            bool is_same = owner_ndx == ndx || (ref_or_tagged.is_tagged() && ref_or_tagged.get_as_int() == owner_ndx);
+            if (!is_same) {
+                remove_owner(*owners, ndx);
+                release(ndx, owners);                                 // Throws
+                Array::set(ndx, RefOrTagged::make_tagged(owner_ndx)); // Throws
+            }
+            sync_owners(*owners);
+            return;
+        }
+        // The element is given a value of its own below
+        remove_owner(*owners, ndx);
+    }
+
+    // A shared blob is left to the other elements sharing it
+    if (owners) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+        if (ref_or_tagged.is_tagged() || (ref_or_tagged.get_as_ref() != 0 && hand_over(ndx, size(), owners))) // Throws
+            Array::set(ndx, 0); // Throws
+    }
+
     ArrayBlob blob(m_alloc);
     ref_type ref = get_as_ref(ndx);
 
     if (ref == 0 && value.is_null()) {
-        return;
+        // Nothing to do
     }
     else if (ref == 0 && value.data() != nullptr) {
         ArrayBlob new_blob(m_alloc);
         new_blob.create();                                             // Throws
         ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
         Array::set_as_ref(ndx, ref);
-        return;
     }
     else if (ref != 0 && value.data() != nullptr) {
         blob.init_from_ref(ref);
@@ -78,23 +121,69 @@ void ArrayBigBlobs::set(size_t ndx, BinaryData value, bool add_zero_term)
         if (new_ref != ref) {
             Array::set_as_ref(ndx, new_ref);
         }
-        return;
     }
     else if (ref != 0 && value.is_null()) {
         Array::destroy_deep(ref, get_alloc());
         Array::set(ndx, 0);
+    }
+    else {
+        REALM_ASSERT(false);
+    }
+
+    if (owners) {
+        add_owner(*owners, ndx); // Throws
+        sync_owners(*owners);
+    }
+}
+
+
+void ArrayBigBlobs::write(size_t ndx, size_t pos, BinaryData value, bool deduplicated)
+{
+    REALM_ASSERT_3(ndx, <, size());
+    REALM_ASSERT_7(value.size(), ==, 0, ||, value.data(), !=, 0);
+
+    ref_type ref = deduplicated ? unshare(ndx) : get_as_ref(ndx); // Throws
+    if (ref == 0) {
+        REALM_ASSERT_3(pos, ==, 0);
+        set(ndx, value.is_null() ? BinaryData("", 0) : value); // Throws
         return;
     }
-    REALM_ASSERT(false);
+
+    ArrayBlob blob(m_alloc);
+    blob.init_from_ref(ref);
+    blob.set_parent(this, ndx);
+    ref_type new_ref = blob.write(pos, value.data(), value.size()); // Throws
+    if (new_ref != blob.get_ref())
+        Array::set_as_ref(ndx, new_ref); // Throws
+}
+
+
+size_t ArrayBigBlobs::get_blob_size(size_t ndx) const noexcept
+{
+    ref_type ref = get_blob_ref(ndx);
+    if (ref == 0)
+        return 0;
+
+    ArrayBlob blob(m_alloc);
+    blob.init_from_ref(ref);
+    return blob.blob_size();
 }
 
 
-void ArrayBigBlobs::insert(size_t ndx, BinaryData value, bool add_zero_term)
+void ArrayBigBlobs::insert(size_t ndx, BinaryData value, bool add_zero_term, OwnerIndex* owners)
 {
     REALM_ASSERT_3(ndx, <=, size());
     REALM_ASSERT_7(value.size(), ==, 0, ||, value.data(), !=, 0);
 
-    if (value.is_null()) {
+    size_t owner_ndx = not_found;
+    if (owners) {
+        attach_owners(*owners); // Throws
+        if (!value.is_null())
+            owner_ndx = find_owner(value, add_zero_term, *owners);
+    }
+    bool is_append = ndx == size();
+
+    if (value.is_null() || owner_ndx != not_found) {
         Array::insert(ndx, 0); // Throws
     }
     else {
@@ -104,85 +193,178 @@ void ArrayBigBlobs::insert(size_t ndx, BinaryData value, bool add_zero_term)
 
         Array::insert(ndx, int64_t(ref)); // Throws
     }
+
+    if (!is_append && owners) {
+        adjust_owners(ndx, 1); // Throws
+        for (auto& entry : owners->m_owners) {
+            if (entry.second >= ndx)
+                ++entry.second;
+        }
+    }
+    if (owner_ndx != not_found) {
+        if (owner_ndx >= ndx)
+            ++owner_ndx;
+        Array::set(ndx, RefOrTagged::make_tagged(owner_ndx)); // Throws
+    }
+
+    if (owners) {
+        add_owner(*owners, ndx); // Throws
+        sync_owners(*owners);
+    }
 }
 
 
-size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+void ArrayBigBlobs::erase(size_t ndx, bool deduplicated)
 {
-    size_t num_matches = 0;
+    if (!deduplicated) {
+        ref_type blob_ref = Array::get_as_ref(ndx);
+        if (blob_ref != 0)                              // nothing to destroy if null
+            Array::destroy_deep(blob_ref, get_alloc()); // Deep
+        Array::erase(ndx);
+        return;
+    }
 
-    size_t begin_2 = begin;
-    for (;;) {
-        size_t ndx = find_first(value, is_string, begin_2, end);
-        if (ndx == not_found)
-            break;
-        ++num_matches;
-        begin_2 = ndx + 1;
+    release(ndx); // Throws
+    Array::erase(ndx);
+    if (ndx != size())
+        adjust_owners(ndx, -1); // Throws
+}
+
+
+void ArrayBigBlobs::truncate(size_t new_size, bool deduplicated)
+{
+    // Blobs shared with remaining elements must survive
+    if (deduplicated) {
+        size_t n = size();
+        for (size_t i = new_size; i < n; ++i) {
+            RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+            if (ref_or_tagged.is_ref() && ref_or_tagged.get_as_ref() != 0 && hand_over(i, new_size)) // Throws
+                Array::set(i, 0);                                                                   // Throws
+        }
     }
+    Array::truncate_and_destroy_children(new_size);
+}
 
-    return num_matches;
+
+void ArrayBigBlobs::unshare_all()
+{
+    size_t n = size();
+    for (size_t i = 0; i != n; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_ref())
+            continue;
+        size_t owner_ndx = size_t(ref_or_tagged.get_as_int());
+        MemRef mem = clone(MemRef(get_as_ref(owner_ndx), m_alloc), m_alloc, m_alloc); // Throws
+        _impl::DeepArrayRefDestroyGuard dg(mem.get_ref(), m_alloc);
+        Array::set_as_ref(i, mem.get_ref()); // Throws
+        dg.release();
+    }
 }
 
 
-size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+template <class F>
+void ArrayBigBlobs::find(BinaryData value, bool is_string, size_t begin, size_t end, F found) const
 {
     if (end == npos)
         end = m_size;
     REALM_ASSERT_11(begin, <=, m_size, &&, end, <=, m_size, &&, begin, <=, end);
 
+    if (value.is_null()) {
+        for (size_t i = begin; i != end; ++i) {
+            ref_type ref = get_blob_ref(i);
+            if (ref == 0 && !found(i))
+                return;
+        }
+        return;
+    }
+
     // When strings are stored as blobs, they are always zero-terminated
     // but the value we get as input might not be.
     size_t value_size = value.size();
     size_t full_size = is_string ? value_size + 1 : value_size;
-
-    if (value.is_null()) {
-        for (size_t i = begin; i != end; ++i) {
-            ref_type ref = get_as_ref(i);
-            if (ref == 0)
-                return i;
+    auto equals = [&](ref_type ref) {
+        if (ref == 0)
+            return false;
+        const char* blob_header = get_alloc().translate(ref);
+        size_t blob_size = get_size_from_header(blob_header);
+        if (blob_size != full_size)
+            return false;
+        const char* blob_value = ArrayBlob::get(blob_header, 0);
+        return std::equal(blob_value, blob_value + value_size, value.data());
+    };
+
+    // A blob shared by several elements is compared only once
+    std::bitset<REALM_MAX_BPNODE_SIZE> compared, matches;
+    for (size_t i = begin; i != end; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        bool is_match;
+        if (ref_or_tagged.is_ref()) {
+            is_match = equals(ref_or_tagged.get_as_ref());
+            if (i < compared.size()) {
+                compared.set(i);
+                matches.set(i, is_match);
+            }
         }
-    }
-    else {
-        for (size_t i = begin; i != end; ++i) {
-            ref_type ref = get_as_ref(i);
-            if (ref) {
-                const char* blob_header = get_alloc().translate(ref);
-                size_t blob_size = get_size_from_header(blob_header);
-                if (blob_size == full_size) {
-                    const char* blob_value = ArrayBlob::get(blob_header, 0);
-                    if (std::equal(blob_value, blob_value + value_size, value.data()))
-                        return i;
+        else {
+            size_t owner_ndx = size_t(ref_or_tagged.get_as_int());
+            if (owner_ndx < compared.size() && compared.test(owner_ndx)) {
+                is_match = matches.test(owner_ndx);
+            }
+            else {
+                is_match = equals(get_as_ref(owner_ndx));
+                if (owner_ndx < compared.size()) {
+                    compared.set(owner_ndx);
+                    matches.set(owner_ndx, is_match);
                 }
             }
         }
+        if (is_match && !found(i))
+            return;
     }
+}
 
-    return not_found;
+
+size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+{
+    size_t num_matches = 0;
+    find(value, is_string, begin, end, [&](size_t) {
+        ++num_matches;
+        return true;
+    });
+    return num_matches;
+}
+
+
+size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+{
+    size_t result = not_found;
+    find(value, is_string, begin, end, [&](size_t ndx) {
+        result = ndx;
+        return false;
+    });
+    return result;
 }
 
 
 void ArrayBigBlobs::find_all(IntegerColumn& result, BinaryData value, bool is_string, size_t add_offset, size_t begin,
                              size_t end)
 {
-    size_t begin_2 = begin;
-    for (;;) {
-        size_t ndx = find_first(value, is_string, begin_2, end);
-        if (ndx == not_found)
-            break;
+    find(value, is_string, begin, end, [&](size_t ndx) {
         result.add(add_offset + ndx); // Throws
-        begin_2 = ndx + 1;
-    }
+        return true;
+    });
 }
 
 
-ref_type ArrayBigBlobs::bptree_leaf_insert(size_t ndx, BinaryData value, bool add_zero_term, TreeInsertBase& state)
+ref_type ArrayBigBlobs::bptree_leaf_insert(size_t ndx, BinaryData value, bool add_zero_term, TreeInsertBase& state,
+                                           OwnerIndex* owners)
 {
     size_t leaf_size = size();
     REALM_ASSERT_3(leaf_size, <=, REALM_MAX_BPNODE_SIZE);
     if (leaf_size < ndx)
         ndx = leaf_size;
     if (REALM_LIKELY(leaf_size < REALM_MAX_BPNODE_SIZE)) {
-        insert(ndx, value, add_zero_term);
+        insert(ndx, value, add_zero_term, owners);
         return 0; // Leaf was not split
     }
 
@@ -190,16 +372,21 @@ ref_type ArrayBigBlobs::bptree_leaf_insert(size_t ndx, BinaryData value, bool ad
     ArrayBigBlobs new_leaf(m_alloc, m_nullable);
     new_leaf.create(); // Throws
     if (ndx == leaf_size) {
-        new_leaf.add(value, add_zero_term);
+        // The index moves on to the new leaf, which receives further appends
+        new_leaf.add(value, add_zero_term, owners);
         state.m_split_offset = ndx;
     }
     else {
         for (size_t i = ndx; i != leaf_size; ++i) {
-            ref_type blob_ref = Array::get_as_ref(i);
-            new_leaf.Array::add(blob_ref);
+            int_fast64_t blob_ref_or_tagged = Array::get(i);
+            new_leaf.Array::add(blob_ref_or_tagged);
         }
+        localize_sharing(*this, new_leaf, ndx, leaf_size); // Throws
+        localize_sharing(*this, *this, 0, ndx);            // Throws
         Array::truncate(ndx); // Avoiding destruction of transferred blobs
-        add(value, add_zero_term);
+        if (owners)
+            owners->clear();
+        add(value, add_zero_term, owners);
         state.m_split_offset = ndx + 1;
     }
     state.m_split_size = leaf_size + 1;
@@ -207,13 +394,229 @@ ref_type ArrayBigBlobs::bptree_leaf_insert(size_t ndx, BinaryData value, bool ad
 }
 
 
+MemRef ArrayBigBlobs::slice(size_t offset, size_t slice_size, Allocator& target_alloc) const
+{
+    MemRef mem = slice_and_clone_children(offset, slice_size, target_alloc); // Throws
+    ArrayBigBlobs new_slice(target_alloc, m_nullable);
+    _impl::DeepArrayDestroyGuard dg(&new_slice);
+    new_slice.init_from_mem(mem);
+    localize_sharing(*this, new_slice, offset, offset + slice_size); // Throws
+    dg.release();
+    return mem;
+}
+
+
+size_t ArrayBigBlobs::find_owner(BinaryData value, bool add_zero_term, const OwnerIndex& owners) const
+{
+    REALM_ASSERT_DEBUG(owners.m_leaf_ref == get_ref() && owners.m_leaf_size == size());
+    size_t full_size = add_zero_term ? value.size() + 1 : value.size();
+    auto candidates = owners.m_owners.equal_range(owner_key(value.data(), value.size(), full_size));
+    for (auto i = candidates.first; i != candidates.second; ++i) {
+        size_t ndx = i->second;
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+        if (ref_or_tagged.is_tagged() || ref_or_tagged.get_as_ref() == 0)
+            continue;
+        const char* blob_header = m_alloc.translate(ref_or_tagged.get_as_ref());
+        // Blobs split into multiple arrays are never shared
+        if (get_context_flag_from_header(blob_header) || get_size_from_header(blob_header) != full_size)
+            continue;
+        const char* blob_value = ArrayBlob::get(blob_header, 0);
+        if (std::equal(value.data(), value.data() + value.size(), blob_value))
+            return ndx;
+    }
+    return not_found;
+}
+
+
+void ArrayBigBlobs::attach_owners(OwnerIndex& owners) const
+{
+    if (owners.m_leaf_ref == get_ref() && owners.m_leaf_size == size())
+        return;
+
+    owners.clear();
+    sync_owners(owners);
+    size_t n = size();
+    owners.m_owners.reserve(n); // Throws
+    for (size_t i = 0; i != n; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged() || ref_or_tagged.get_as_ref() == 0)
+            continue;
+        // Equal blobs that are not shared, such as the empty values of a leaf
+        // upgraded from small blobs, would pile up under one key, and make
+        // remove_owner() slow
+        const char* blob_header = m_alloc.translate(ref_or_tagged.get_as_ref());
+        if (get_context_flag_from_header(blob_header))
+            continue;
+        BinaryData blob(ArrayBlob::get(blob_header, 0), get_size_from_header(blob_header));
+        if (find_owner(blob, false, owners) == not_found)
+            add_owner(owners, i); // Throws
+    }
+}
+
+
+void ArrayBigBlobs::add_owner(OwnerIndex& owners, size_t ndx) const
+{
+    RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+    if (ref_or_tagged.is_tagged() || ref_or_tagged.get_as_ref() == 0)
+        return;
+    const char* blob_header = m_alloc.translate(ref_or_tagged.get_as_ref());
+    if (get_context_flag_from_header(blob_header))
+        return;
+    size_t blob_size = get_size_from_header(blob_header);
+    uint_fast64_t key = owner_key(ArrayBlob::get(blob_header, 0), blob_size, blob_size);
+    owners.m_owners.emplace(key, ndx); // Throws
+}
+
+
+void ArrayBigBlobs::remove_owner(OwnerIndex& owners, size_t ndx) const noexcept
+{
+    RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+    if (ref_or_tagged.is_tagged() || ref_or_tagged.get_as_ref() == 0)
+        return;
+    const char* blob_header = m_alloc.translate(ref_or_tagged.get_as_ref());
+    size_t blob_size = get_size_from_header(blob_header);
+    uint_fast64_t key = owner_key(ArrayBlob::get(blob_header, 0), blob_size, blob_size);
+    auto entries = owners.m_owners.equal_range(key);
+    for (auto i = entries.first; i != entries.second; ++i) {
+        if (i->second == ndx) {
+            owners.m_owners.erase(i);
+            return;
+        }
+    }
+}
+
+
+void ArrayBigBlobs::sync_owners(OwnerIndex& owners) const noexcept
+{
+    owners.m_leaf_ref = get_ref();
+    owners.m_leaf_size = size();
+}
+
+
+uint_fast64_t ArrayBigBlobs::owner_key(const char* data, size_t data_size, size_t blob_size) noexcept
+{
+    // The size and the first 8 bytes, where a missing terminating zero, like
+    // any bytes beyond the end of the blob, counts as zero
+    uint_fast64_t prefix = 0;
+    std::memcpy(&prefix, data, std::min(data_size, sizeof prefix));
+    uint_fast64_t key = (prefix ^ (uint_fast64_t(blob_size) << 48)) * 0x9E3779B97F4A7C15ULL;
+    return key ^ (key >> 29) ^ uint_fast64_t(blob_size);
+}
+
+
+size_t ArrayBigBlobs::find_sharing(size_t owner_ndx, size_t end) const noexcept
+{
+    for (size_t i = 0; i != end; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged() && ref_or_tagged.get_as_int() == owner_ndx)
+            return i;
+    }
+    return not_found;
+}
+
+
+bool ArrayBigBlobs::hand_over(size_t owner_ndx, size_t end, OwnerIndex* owners)
+{
+    size_t new_owner_ndx = find_sharing(owner_ndx, end);
+    if (new_owner_ndx == not_found)
+        return false;
+    Array::set(new_owner_ndx, get_as_ref_or_tagged(owner_ndx)); // Throws
+    for (size_t i = new_owner_ndx + 1; i != end; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged() && ref_or_tagged.get_as_int() == owner_ndx)
+            Array::set(i, RefOrTagged::make_tagged(new_owner_ndx)); // Throws
+    }
+    if (owners)
+        add_owner(*owners, new_owner_ndx); // Throws
+    return true;
+}
+
+
+void ArrayBigBlobs::release(size_t ndx, OwnerIndex* owners)
+{
+    RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+    if (ref_or_tagged.is_ref()) {
+        ref_type blob_ref = ref_or_tagged.get_as_ref();
+        if (blob_ref == 0)
+            return;
+        if (!hand_over(ndx, size(), owners))            // Throws
+            Array::destroy_deep(blob_ref, get_alloc()); // Deep
+    }
+    Array::set(ndx, 0); // Throws
+}
+
+
+ref_type ArrayBigBlobs::unshare(size_t ndx)
+{
+    RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+    bool is_owner = ref_or_tagged.is_ref();
+    if (is_owner && (ref_or_tagged.get_as_ref() == 0 || find_sharing(ndx, size()) == not_found))
+        return ref_or_tagged.get_as_ref();
+
+    MemRef mem = clone(MemRef(get_blob_ref(ndx), m_alloc), m_alloc, m_alloc); // Throws
+    _impl::DeepArrayRefDestroyGuard dg(mem.get_ref(), m_alloc);
+    if (is_owner)
+        hand_over(ndx, size()); // Throws
+    Array::set_as_ref(ndx, mem.get_ref()); // Throws
+    return dg.release();
+}
+
+
+void ArrayBigBlobs::adjust_owners(size_t begin, int diff)
+{
+    size_t n = size();
+    for (size_t i = 0; i != n; ++i) {
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged() && ref_or_tagged.get_as_int() >= begin)
+            Array::set(i, RefOrTagged::make_tagged(ref_or_tagged.get_as_int() + diff)); // Throws
+    }
+}
+
+
+void ArrayBigBlobs::localize_sharing(const ArrayBigBlobs& source, ArrayBigBlobs& target, size_t begin, size_t end)
+{
+    // Owner in source -> new owner in target
+    std::map<size_t, size_t> new_owners;
+    for (size_t i = 0; i != end - begin; ++i) {
+        RefOrTagged ref_or_tagged = target.get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_ref())
+            continue;
+        size_t owner_ndx = size_t(ref_or_tagged.get_as_int());
+        if (owner_ndx >= begin && owner_ndx < end) {
+            if (begin != 0)
+                target.Array::set(i, RefOrTagged::make_tagged(owner_ndx - begin)); // Throws
+            continue;
+        }
+        auto j = new_owners.find(owner_ndx);
+        if (j != new_owners.end()) {
+            target.Array::set(i, RefOrTagged::make_tagged(j->second)); // Throws
+            continue;
+        }
+        Allocator& alloc = source.get_alloc();
+        MemRef mem = clone(MemRef(source.get_as_ref(owner_ndx), alloc), alloc, target.get_alloc()); // Throws
+        _impl::DeepArrayRefDestroyGuard dg(mem.get_ref(), target.get_alloc());
+        new_owners[owner_ndx] = i;                       // Throws
+        target.Array::set_as_ref(i, dg.release()); // Throws
+    }
+}
+
+
 #ifdef REALM_DEBUG // LCOV_EXCL_START ignore debug functions
 
 void ArrayBigBlobs::verify() const
 {
     REALM_ASSERT(has_refs());
     for (size_t i = 0; i < size(); ++i) {
-        ref_type blob_ref = Array::get_as_ref(i);
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged()) {
+            // The owner of a shared blob is an element of this leaf
+            size_t owner_ndx = size_t(ref_or_tagged.get_as_int());
+            REALM_ASSERT_3(owner_ndx, <, size());
+            REALM_ASSERT(get_as_ref_or_tagged(owner_ndx).is_ref());
+            REALM_ASSERT_3(get_as_ref(owner_ndx), !=, 0);
+            continue;
+        }
+        ref_type blob_ref = ref_or_tagged.get_as_ref();
         // 0 is used to indicate realm::null()
         if (blob_ref != 0) {
             ArrayBlob blob(m_alloc);
@@ -237,7 +640,10 @@ void ArrayBigBlobs::to_dot(std::ostream& out, bool, StringData title) const
     Array::to_dot(out, "big_blobs_leaf");
 
     for (size_t i = 0; i < size(); ++i) {
-        ref_type blob_ref = Array::get_as_ref(i);
+        RefOrTagged ref_or_tagged = get_as_ref_or_tagged(i);
+        if (ref_or_tagged.is_tagged() || ref_or_tagged.get_as_ref() == 0)
+            continue;
+        ref_type blob_ref = ref_or_tagged.get_as_ref();
         ArrayBlob blob(m_alloc);
         blob.init_from_ref(blob_ref);
         blob.set_parent(const_cast<ArrayBigBlobs*>(this), i);
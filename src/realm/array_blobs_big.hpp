@@ -19,15 +19,32 @@
 #ifndef REALM_ARRAY_BIG_BLOBS_HPP
 #define REALM_ARRAY_BIG_BLOBS_HPP
 
+#include <unordered_map>
+
 #include <realm/array_blob.hpp>
 
 namespace realm {
 
 
+/// Identical values can share storage. When given an OwnerIndex, add(),
+/// set(), and insert() store a value that is already stored in the same
+/// leaf by tagging the element with the index of the element that owns the
+/// blob (see RefOrTagged). Sharing never crosses leaves, so it is invisible
+/// to copy-on-write, and to the relocation of refs on commit.
+///
+/// Keeping track of the elements sharing a blob takes time linear in the
+/// size of the leaf, so it is only done for the leaves of deduplicated
+/// columns. These are the ones given an OwnerIndex by add(), set(), and
+/// insert(), and `deduplicated = true` by erase(), truncate(), and
+/// write(). The leaves of other columns must not hold shared blobs (see
+/// unshare_all()). The functions that only read handle shared blobs in any
+/// leaf.
 class ArrayBigBlobs : public Array {
 public:
     typedef BinaryData value_type;
 
+    class OwnerIndex;
+
     explicit ArrayBigBlobs(Allocator&, bool nullable) noexcept;
 
     // Disable copying, this is not allowed.
@@ -36,12 +53,23 @@ public:
 
     BinaryData get(size_t ndx) const noexcept;
     BinaryData get_at(size_t ndx, size_t& pos) const noexcept;
-    void set(size_t ndx, BinaryData value, bool add_zero_term = false);
-    void add(BinaryData value, bool add_zero_term = false);
-    void insert(size_t ndx, BinaryData value, bool add_zero_term = false);
-    void erase(size_t ndx);
-    void truncate(size_t new_size);
+    void set(size_t ndx, BinaryData value, bool add_zero_term = false, OwnerIndex* owners = nullptr);
+
+    /// Overwrite the bytes of the specified blob starting at \a pos, growing
+    /// it as needed. See ArrayBlob::write(). A null blob is treated as empty.
+    void write(size_t ndx, size_t pos, BinaryData value, bool deduplicated = false);
+
+    /// The size of the specified blob, also if it is split into multiple
+    /// arrays. Zero if it is null.
+    size_t get_blob_size(size_t ndx) const noexcept;
+    void add(BinaryData value, bool add_zero_term = false, OwnerIndex* owners = nullptr);
+    void insert(size_t ndx, BinaryData value, bool add_zero_term = false, OwnerIndex* owners = nullptr);
+    void erase(size_t ndx, bool deduplicated = false);
+    void truncate(size_t new_size, bool deduplicated = false);
     void clear();
+
+    /// Give every element that shares a blob a copy of its own.
+    void unshare_all();
     void destroy();
 
     size_t count(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const noexcept;
@@ -55,18 +83,19 @@ public:
     /// slower.
     static BinaryData get(const char* header, size_t ndx, Allocator&) noexcept;
 
-    ref_type bptree_leaf_insert(size_t ndx, BinaryData, bool add_zero_term, TreeInsertBase& state);
+    ref_type bptree_leaf_insert(size_t ndx, BinaryData, bool add_zero_term, TreeInsertBase& state,
+                                OwnerIndex* owners = nullptr);
 
     //@{
     /// Those that return a string, discard the terminating zero from
     /// the stored value. Those that accept a string argument, add a
     /// terminating zero before storing the value.
     StringData get_string(size_t ndx) const noexcept;
-    void add_string(StringData value);
-    void set_string(size_t ndx, StringData value);
-    void insert_string(size_t ndx, StringData value);
+    void add_string(StringData value, OwnerIndex* owners = nullptr);
+    void set_string(size_t ndx, StringData value, OwnerIndex* owners = nullptr);
+    void insert_string(size_t ndx, StringData value, OwnerIndex* owners = nullptr);
     static StringData get_string(const char* header, size_t ndx, Allocator&, bool nullable) noexcept;
-    ref_type bptree_leaf_insert_string(size_t ndx, StringData, TreeInsertBase& state);
+    ref_type bptree_leaf_insert_string(size_t ndx, StringData, TreeInsertBase& state, OwnerIndex* owners = nullptr);
     //@}
 
     /// Create a new empty big blobs array and attach this accessor to
@@ -88,6 +117,84 @@ public:
 
 private:
     bool m_nullable;
+
+    /// The ref of the blob holding the specified element, also if it is
+    /// shared with other elements.
+    ref_type get_blob_ref(size_t ndx) const noexcept;
+    static ref_type get_blob_ref(const char* header, size_t ndx) noexcept;
+
+    /// The index of an element owning a blob identical to the specified
+    /// value, or `not_found`. \a owners must describe this leaf.
+    size_t find_owner(BinaryData value, bool add_zero_term, const OwnerIndex& owners) const;
+
+    /// Make \a owners describe this leaf, unless it already does.
+    void attach_owners(OwnerIndex& owners) const;
+
+    /// Add or remove the entry of the specified element, if it owns a blob.
+    void add_owner(OwnerIndex& owners, size_t ndx) const;
+    void remove_owner(OwnerIndex& owners, size_t ndx) const noexcept;
+
+    /// Record that \a owners is up to date with the current state of this
+    /// leaf.
+    void sync_owners(OwnerIndex& owners) const noexcept;
+
+    /// The key of the blob with the specified size and first bytes in
+    /// OwnerIndex. \a data_size may be smaller than \a blob_size if the
+    /// blob ends with a terminating zero that is not part of \a data.
+    static uint_fast64_t owner_key(const char* data, size_t data_size, size_t blob_size) noexcept;
+
+    /// The index of the first element in [0, end) that shares the blob of
+    /// the specified element, or `not_found`.
+    size_t find_sharing(size_t owner_ndx, size_t end) const noexcept;
+
+    /// Pass the blob owned by the specified element on to the first element
+    /// in [0, end) sharing it. Returns false if there is no such element. The
+    /// new owner is added to \a owners, if specified.
+    bool hand_over(size_t owner_ndx, size_t end, OwnerIndex* owners = nullptr);
+
+    /// Detach the specified element from its blob, leaving it null. The blob
+    /// is destroyed, unless other elements share it.
+    void release(size_t ndx, OwnerIndex* owners = nullptr);
+
+    /// Make sure that the specified element has a blob of its own, and
+    /// return its ref.
+    ref_type unshare(size_t ndx);
+
+    /// Shift the indexes of owning elements at, or after \a begin by \a
+    /// diff, after elements were inserted or erased.
+    void adjust_owners(size_t begin, int diff);
+
+    /// Make the elements of \a target, which were copied from [begin, end)
+    /// of \a source, refer only to blobs in \a target. Blobs of elements
+    /// outside the range are cloned.
+    static void localize_sharing(const ArrayBigBlobs& source, ArrayBigBlobs& target, size_t begin, size_t end);
+
+    template <class F>
+    void find(BinaryData value, bool is_string, size_t begin, size_t end, F found) const;
+};
+
+
+/// Lets deduplicating writes to an ArrayBigBlobs find the element owning a
+/// blob equal to the new value without comparing the value with every blob
+/// of the leaf. An index describes one leaf at a time. It is built from the
+/// leaf when used with a leaf of another ref or size than the one it was
+/// last used with, and is then kept up to date by the writes given it. Only
+/// the size and the first bytes of each blob go into the index, and the
+/// candidates it returns are compared with the value, so an index left
+/// behind by changes made without it can at worst miss an equal blob. Blobs
+/// equal to one already in the index are left out of it. A column keeps an
+/// index for the last leaf it wrote to.
+class ArrayBigBlobs::OwnerIndex {
+public:
+    /// Forget the leaf described, if any.
+    void clear() noexcept;
+
+private:
+    ref_type m_leaf_ref = 0;
+    size_t m_leaf_size = 0;
+    std::unordered_multimap<uint_fast64_t, size_t> m_owners; // Key -> owning element
+
+    friend class ArrayBigBlobs;
 };
 
 
@@ -99,9 +206,25 @@ inline ArrayBigBlobs::ArrayBigBlobs(Allocator& allocator, bool nullable) noexcep
 {
 }
 
+inline ref_type ArrayBigBlobs::get_blob_ref(size_t ndx) const noexcept
+{
+    RefOrTagged ref_or_tagged = get_as_ref_or_tagged(ndx);
+    if (ref_or_tagged.is_tagged())
+        ref_or_tagged = get_as_ref_or_tagged(size_t(ref_or_tagged.get_as_int()));
+    return ref_or_tagged.get_as_ref();
+}
+
+inline ref_type ArrayBigBlobs::get_blob_ref(const char* header, size_t ndx) noexcept
+{
+    int_fast64_t value = Array::get(header, ndx);
+    if ((value & 1) != 0)
+        value = Array::get(header, size_t(uint_fast64_t(value) >> 1));
+    return to_ref(value);
+}
+
 inline BinaryData ArrayBigBlobs::get(size_t ndx) const noexcept
 {
-    ref_type ref = get_as_ref(ndx);
+    ref_type ref = get_blob_ref(ndx);
     if (ref == 0)
         return {}; // realm::null();
 
@@ -116,7 +239,7 @@ inline BinaryData ArrayBigBlobs::get(size_t ndx) const noexcept
 
 inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator& alloc) noexcept
 {
-    ref_type blob_ref = to_ref(Array::get(header, ndx));
+    ref_type blob_ref = get_blob_ref(header, ndx);
     if (blob_ref == 0)
         return {};
 
@@ -129,20 +252,6 @@ inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator&
     return {};
 }
 
-inline void ArrayBigBlobs::erase(size_t ndx)
-{
-    ref_type blob_ref = Array::get_as_ref(ndx);
-    if (blob_ref != 0) {                       // nothing to destroy if null
-        Array::destroy_deep(blob_ref, get_alloc()); // Deep
-    }
-    Array::erase(ndx);
-}
-
-inline void ArrayBigBlobs::truncate(size_t new_size)
-{
-    Array::truncate_and_destroy_children(new_size);
-}
-
 inline void ArrayBigBlobs::clear()
 {
     Array::clear_and_destroy_children();
@@ -162,28 +271,28 @@ inline StringData ArrayBigBlobs::get_string(size_t ndx) const noexcept
         return StringData(bin.data(), bin.size() - 1); // Do not include terminating zero
 }
 
-inline void ArrayBigBlobs::set_string(size_t ndx, StringData value)
+inline void ArrayBigBlobs::set_string(size_t ndx, StringData value, OwnerIndex* owners)
 {
     REALM_ASSERT_DEBUG(!(!m_nullable && value.is_null()));
     BinaryData bin(value.data(), value.size());
     bool add_zero_term = true;
-    set(ndx, bin, add_zero_term);
+    set(ndx, bin, add_zero_term, owners);
 }
 
-inline void ArrayBigBlobs::add_string(StringData value)
+inline void ArrayBigBlobs::add_string(StringData value, OwnerIndex* owners)
 {
     REALM_ASSERT_DEBUG(!(!m_nullable && value.is_null()));
     BinaryData bin(value.data(), value.size());
     bool add_zero_term = true;
-    add(bin, add_zero_term);
+    add(bin, add_zero_term, owners);
 }
 
-inline void ArrayBigBlobs::insert_string(size_t ndx, StringData value)
+inline void ArrayBigBlobs::insert_string(size_t ndx, StringData value, OwnerIndex* owners)
 {
     REALM_ASSERT_DEBUG(!(!m_nullable && value.is_null()));
     BinaryData bin(value.data(), value.size());
     bool add_zero_term = true;
-    insert(ndx, bin, add_zero_term);
+    insert(ndx, bin, add_zero_term, owners);
 }
 
 inline StringData ArrayBigBlobs::get_string(const char* header, size_t ndx, Allocator& alloc, bool nullable) noexcept
@@ -197,23 +306,25 @@ inline StringData ArrayBigBlobs::get_string(const char* header, size_t ndx, Allo
         return StringData(bin.data(), bin.size() - 1); // Do not include terminating zero
 }
 
-inline ref_type ArrayBigBlobs::bptree_leaf_insert_string(size_t ndx, StringData value, TreeInsertBase& state)
+inline ref_type ArrayBigBlobs::bptree_leaf_insert_string(size_t ndx, StringData value, TreeInsertBase& state,
+                                                         OwnerIndex* owners)
 {
     REALM_ASSERT_DEBUG(!(!m_nullable && value.is_null()));
     BinaryData bin(value.data(), value.size());
     bool add_zero_term = true;
-    return bptree_leaf_insert(ndx, bin, add_zero_term, state);
+    return bptree_leaf_insert(ndx, bin, add_zero_term, state, owners);
 }
 
-inline void ArrayBigBlobs::create()
+inline void ArrayBigBlobs::OwnerIndex::clear() noexcept
 {
-    bool context_flag = true;
-    Array::create(type_HasRefs, context_flag); // Throws
+    m_leaf_ref = 0;
+    m_owners.clear();
 }
 
-inline MemRef ArrayBigBlobs::slice(size_t offset, size_t slice_size, Allocator& target_alloc) const
+inline void ArrayBigBlobs::create()
 {
-    return slice_and_clone_children(offset, slice_size, target_alloc);
+    bool context_flag = true;
+    Array::create(type_HasRefs, context_flag); // Throws
 }
 
 
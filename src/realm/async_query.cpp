@@ -0,0 +1,253 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+
+#include <realm/async_query.hpp>
+#include <realm/exceptions.hpp>
+#include <realm/lang_bind_helper.hpp>
+#include <realm/util/scope_exit.hpp>
+
+using namespace realm;
+
+
+namespace {
+
+std::unique_ptr<SharedGroup> open_shared_group(const std::string& path, Replication* history,
+                                               const SharedGroupOptions& options)
+{
+    if (history)
+        return std::unique_ptr<SharedGroup>(new SharedGroup(*history, options)); // Throws
+    bool no_create = false;
+    return std::unique_ptr<SharedGroup>(new SharedGroup(path, no_create, options)); // Throws
+}
+
+} // anonymous namespace
+
+
+// State that must outlive the service, because results refer to it.
+struct AsyncQueryService::Shared {
+    util::Mutex mutex;
+    std::unique_ptr<Replication> history;
+    std::unique_ptr<SharedGroup> sg;
+
+    // Release a version pinned by a background thread, on behalf of a
+    // result that was never imported.
+    void unpin(VersionID version) noexcept
+    {
+        util::LockGuard lock(mutex);
+        sg->unpin_version(version);
+    }
+};
+
+struct AsyncQueryService::Worker {
+    std::unique_ptr<Replication> history;
+    std::unique_ptr<SharedGroup> sg;
+    util::Thread thread;
+};
+
+
+AsyncQueryService::AsyncQueryService(const std::string& path, HistoryFactory make_history,
+                                     SharedGroupOptions options, size_t num_threads)
+    : m_shared(std::make_shared<Shared>()) // Throws
+{
+    if (make_history)
+        m_shared->history = make_history(); // Throws
+    m_shared->sg = open_shared_group(path, m_shared->history.get(), options); // Throws
+
+    num_threads = std::max(num_threads, size_t(1));
+    for (size_t i = 0; i < num_threads; ++i) {
+        std::unique_ptr<Worker> worker(new Worker); // Throws
+        if (make_history)
+            worker->history = make_history(); // Throws
+        worker->sg = open_shared_group(path, worker->history.get(), options); // Throws
+        m_workers.push_back(std::move(worker)); // Throws
+    }
+
+    try {
+        for (const auto& worker : m_workers) {
+            Worker* w = worker.get();
+            w->thread.start([this, w] { worker_loop(*w); }); // Throws
+        }
+    }
+    catch (...) {
+        stop();
+        throw;
+    }
+}
+
+
+AsyncQueryService::~AsyncQueryService() noexcept
+{
+    stop();
+}
+
+
+void AsyncQueryService::stop() noexcept
+{
+    {
+        util::LockGuard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    for (const auto& worker : m_workers) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    // Destroying the callbacks of the discarded tasks breaks their promises
+    for (Task& task : m_tasks)
+        m_shared->unpin(task.version);
+    m_tasks.clear();
+}
+
+
+std::future<AsyncQueryService::Result> AsyncQueryService::run(SharedGroup& sg, const Query& query,
+                                                              const DescriptorOrdering& ordering)
+{
+    auto promise = std::make_shared<std::promise<Result>>(); // Throws
+    std::future<Result> future = promise->get_future();      // Throws
+    submit(sg, query, ordering, [promise](Result result, std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        }
+        else {
+            promise->set_value(std::move(result));
+        }
+    }); // Throws
+    return future;
+}
+
+
+void AsyncQueryService::run(SharedGroup& sg, const Query& query, const DescriptorOrdering& ordering,
+                            Callback callback)
+{
+    submit(sg, query, ordering, std::move(callback)); // Throws
+}
+
+
+void AsyncQueryService::submit(SharedGroup& sg, const Query& query, const DescriptorOrdering& ordering,
+                               Callback callback)
+{
+    Task task;
+    task.query = sg.export_for_handover(query, ConstSourcePayload::Stay); // Throws
+    DescriptorOrdering::generate_patch(ordering, task.ordering);          // Throws
+    task.callback = std::move(callback);
+    task.version = sg.pin_version(); // Throws
+    try {
+        util::LockGuard lock(m_mutex);
+        m_tasks.push_back(std::move(task)); // Throws
+    }
+    catch (...) {
+        sg.unpin_version(task.version);
+        throw;
+    }
+    m_cond.notify();
+}
+
+
+void AsyncQueryService::worker_loop(Worker& worker)
+{
+    for (;;) {
+        Task task;
+        {
+            util::LockGuard lock(m_mutex);
+            while (!m_stop && m_tasks.empty())
+                m_cond.wait(lock);
+            if (m_stop)
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        execute(worker, task);
+    }
+}
+
+
+void AsyncQueryService::execute(Worker& worker, Task& task)
+{
+    SharedGroup& sg = *worker.sg;
+    Result result;
+    try {
+        sg.begin_read(task.version); // Throws
+    }
+    catch (...) {
+        sg.unpin_version(task.version);
+        task.callback(std::move(result), std::current_exception());
+        return;
+    }
+    // From here on, the read transaction keeps the submitted version alive
+    sg.unpin_version(task.version);
+
+    std::exception_ptr error;
+    try {
+        auto end_read = util::make_scope_exit([&]() noexcept { sg.end_read(); });
+        std::unique_ptr<Query> query = sg.import_from_handover(std::move(task.query)); // Throws
+        if (worker.history)
+            LangBindHelper::advance_read(sg); // Throws
+        const TableRef& table = query->get_table();
+        if (!table || !table->is_attached())
+            throw LogicError(LogicError::detached_accessor);
+        // The ordering refers to columns by pointer, so it must be created
+        // after the accessors have been refreshed by advance_read().
+        DescriptorOrdering ordering = DescriptorOrdering::create_from_and_consume_patch(task.ordering,
+                                                                                        *table); // Throws
+        TableView tv = query->find_all(); // Throws
+        if (!ordering.is_empty())
+            tv.apply_descriptor_ordering(ordering);                                  // Throws
+        result.m_handover = sg.export_for_handover(tv, MutableSourcePayload::Move); // Throws
+        sg.pin_version();                                                            // Throws
+        result.m_shared = m_shared;
+    }
+    catch (...) {
+        error = std::current_exception();
+        result = Result();
+    }
+    task.callback(std::move(result), error);
+}
+
+
+std::unique_ptr<TableView> AsyncQueryService::Result::import_into(SharedGroup& sg)
+{
+    if (!m_handover)
+        throw LogicError(LogicError::detached_accessor);
+    if (sg.get_transact_stage() != SharedGroup::transact_Reading)
+        throw LogicError(LogicError::wrong_transact_state);
+
+    VersionID version = m_handover->version;
+    VersionID current = sg.get_version_of_current_transaction();
+    if (current > version)
+        throw SharedGroup::BadVersion();
+    if (current < version)
+        LangBindHelper::advance_read(sg, version); // Throws
+
+    std::unique_ptr<SharedGroup::Handover<TableView>> handover = std::move(m_handover);
+    m_shared.reset();
+    // The version stays alive for as long as the read transaction of `sg`
+    auto unpin = util::make_scope_exit([&]() noexcept { sg.unpin_version(version); });
+    return sg.import_from_handover(std::move(handover)); // Throws
+}
+
+
+void AsyncQueryService::Result::release() noexcept
+{
+    if (m_handover && m_shared)
+        m_shared->unpin(m_handover->version);
+    m_handover.reset();
+    m_shared.reset();
+}
@@ -0,0 +1,203 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ASYNC_QUERY_HPP
+#define REALM_ASYNC_QUERY_HPP
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <realm/group_shared.hpp>
+#include <realm/query.hpp>
+#include <realm/replication.hpp>
+#include <realm/table_view.hpp>
+#include <realm/views.hpp>
+#include <realm/util/thread.hpp>
+
+namespace realm {
+
+/// A pool of background threads, each with its own SharedGroup on the same
+/// Realm file, that run queries on behalf of other threads.
+///
+/// A query is submitted from a thread that has a read transaction in
+/// progress. The query (and optionally a sort and distinct ordering) is
+/// handed over to one of the background threads, which runs it, and hands
+/// the resulting TableView back through a Result:
+///
+/// <pre>
+///
+///   AsyncQueryService service(path, [&] { return make_in_realm_history(path); });
+///   ...
+///   std::future<AsyncQueryService::Result> future = service.run(sg, query, ordering);
+///   ...
+///   std::unique_ptr<TableView> tv = future.get().import_into(sg);
+///
+/// </pre>
+///
+/// If a history factory is specified, the background thread advances to the
+/// latest version before running the query, so the result may be newer than
+/// the read transaction of the submitting thread. Result::import_into() then
+/// advances that transaction to the version of the result. Without a history,
+/// the query is run at the version at which it was submitted.
+///
+/// The version at which a query was submitted is pinned until the background
+/// thread has started its read transaction, and the version of a result is
+/// pinned until the result is imported or destroyed.
+///
+/// All member functions of the service may be called from any thread, but
+/// the SharedGroup passed to run() and Result::import_into() must be the one
+/// of the calling thread.
+class AsyncQueryService {
+public:
+    class Result;
+
+    using HistoryFactory = std::function<std::unique_ptr<Replication>()>;
+    using Callback = std::function<void(Result, std::exception_ptr)>;
+
+    /// Open \a num_threads (at least one) background SharedGroups on the
+    /// specified file. If \a make_history is specified, it is called once for
+    /// each of them, and must create a history of the same type as the one
+    /// used by the other SharedGroups on the file.
+    AsyncQueryService(const std::string& path, HistoryFactory make_history = HistoryFactory(),
+                      SharedGroupOptions options = SharedGroupOptions(), size_t num_threads = 1);
+
+    /// Stop the background threads, waiting for the queries that are being
+    /// run to complete. Queries that have not yet been started are
+    /// discarded. Their callbacks are not called, and their futures report
+    /// `std::future_errc::broken_promise`.
+    ~AsyncQueryService() noexcept;
+
+    AsyncQueryService(const AsyncQueryService&) = delete;
+    AsyncQueryService& operator=(const AsyncQueryService&) = delete;
+
+    /// Run the specified query in the background, and sort and filter the
+    /// result according to \a ordering. The query must belong to the read
+    /// transaction in progress on \a sg.
+    std::future<Result> run(SharedGroup& sg, const Query&,
+                            const DescriptorOrdering& ordering = DescriptorOrdering());
+
+    /// Same as the other overload, but the result, or the exception thrown
+    /// while running the query, is delivered by calling \a callback on the
+    /// background thread. The callback must not throw.
+    void run(SharedGroup& sg, const Query&, const DescriptorOrdering& ordering, Callback callback);
+
+private:
+    struct Shared;
+    struct Worker;
+
+    struct Task {
+        std::unique_ptr<SharedGroup::Handover<Query>> query;
+        DescriptorOrdering::HandoverPatch ordering;
+        SharedGroup::VersionID version; // Pinned by the submitting thread
+        Callback callback;
+    };
+
+    std::shared_ptr<Shared> m_shared;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    util::Mutex m_mutex;
+    util::CondVar m_cond;
+    std::deque<Task> m_tasks;
+    bool m_stop = false;
+
+    void stop() noexcept;
+    void submit(SharedGroup&, const Query&, const DescriptorOrdering&, Callback);
+    void worker_loop(Worker&);
+    void execute(Worker&, Task&);
+};
+
+
+/// The result of a query run by an AsyncQueryService, ready to be imported
+/// into the read transaction of another thread.
+class AsyncQueryService::Result {
+public:
+    Result() noexcept;
+    Result(Result&&) noexcept;
+    Result& operator=(Result&&) noexcept;
+    ~Result() noexcept;
+
+    /// False for a default constructed result, and after import_into().
+    explicit operator bool() const noexcept;
+
+    /// The version of the Realm at which the query was run.
+    SharedGroup::VersionID get_version() const noexcept;
+
+    /// Create a TableView accessor for the result in the read transaction in
+    /// progress on \a sg. If that transaction is at an older version than
+    /// the result, it is first advanced to the version of the result, which
+    /// requires \a sg to have a history. A result can only be imported once.
+    ///
+    /// \throw SharedGroup::BadVersion If the transaction in progress on \a sg
+    /// is at a newer version than the result. The result is not consumed, so
+    /// the query can be run again.
+    std::unique_ptr<TableView> import_into(SharedGroup& sg);
+
+private:
+    std::shared_ptr<Shared> m_shared;
+    std::unique_ptr<SharedGroup::Handover<TableView>> m_handover;
+
+    void release() noexcept;
+
+    friend class AsyncQueryService;
+};
+
+
+// Implementation
+
+inline AsyncQueryService::Result::Result() noexcept
+{
+}
+
+inline AsyncQueryService::Result::Result(Result&& other) noexcept
+    : m_shared(std::move(other.m_shared))
+    , m_handover(std::move(other.m_handover))
+{
+}
+
+inline AsyncQueryService::Result& AsyncQueryService::Result::operator=(Result&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_shared = std::move(other.m_shared);
+        m_handover = std::move(other.m_handover);
+    }
+    return *this;
+}
+
+inline AsyncQueryService::Result::~Result() noexcept
+{
+    release();
+}
+
+inline AsyncQueryService::Result::operator bool() const noexcept
+{
+    return bool(m_handover);
+}
+
+inline SharedGroup::VersionID AsyncQueryService::Result::get_version() const noexcept
+{
+    return m_handover ? m_handover->version : SharedGroup::VersionID();
+}
+
+} // namespace realm
+
+#endif // REALM_ASYNC_QUERY_HPP
@@ -0,0 +1,197 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_BINARY_STREAM_HPP
+#define REALM_BINARY_STREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include <realm/binary_data.hpp>
+#include <realm/exceptions.hpp>
+#include <realm/row.hpp>
+#include <realm/table.hpp>
+
+namespace realm {
+
+/// A handle for reading and writing a binary value piece by piece, so that
+/// neither the reader nor the writer needs to hold the whole value in
+/// memory. This allows values bigger than the 16 MB limit of
+/// Table::set_binary(). Such values can only be accessed through a stream,
+/// or through Table::get_binary_at().
+///
+/// The handle refers to the cell through a row accessor, so it follows the
+/// row when other rows are inserted or removed, and becomes detached if the
+/// row is removed. It has a current position, which is advanced by read()
+/// and write().
+///
+/// Writes are applied through Table::write_binary(). Only the parts of the
+/// value that are modified are copied, and only the written bytes are
+/// recorded in the transaction log.
+///
+///     BinaryStream stream(table->get(row_ndx), col_ndx);
+///     stream.append(trailer);
+///     stream.seek(0);
+///     while (size_t n = stream.read(buffer, sizeof buffer))
+///         consume(buffer, n);
+///
+/// \sa BinaryIterator
+template <class T>
+class BasicBinaryStream {
+public:
+    BasicBinaryStream(const BasicRow<T>& row, size_t col_ndx) noexcept;
+
+    bool is_attached() const noexcept;
+
+    /// The current size of the value.
+    size_t size() const;
+
+    size_t tell() const noexcept;
+
+    /// Set the current position. It may be beyond the end of the value, in
+    /// which case reads return nothing, and writes throw.
+    void seek(size_t pos) noexcept;
+
+    /// Copy up to \a size bytes from the current position into \a buffer, and
+    /// advance the position accordingly. Returns the number of bytes copied,
+    /// which is less than \a size only at the end of the value.
+    size_t read(char* buffer, size_t size);
+
+    /// Get the bytes from the current position to the end of the array
+    /// holding them, without copying, and advance past them. Returns an
+    /// empty value at the end. The returned data is only valid until the
+    /// table is modified, or the transaction ends.
+    BinaryData read_chunk();
+
+    /// Overwrite the bytes at the current position, growing the value as
+    /// needed, and advance the position past them.
+    void write(BinaryData);
+
+    /// Add the specified bytes to the end of the value, and move the current
+    /// position past them.
+    void append(BinaryData);
+
+private:
+    BasicRow<T> m_row;
+    size_t m_col_ndx;
+    size_t m_pos = 0;
+
+    const T& get_table() const;
+    T& get_table();
+};
+
+typedef BasicBinaryStream<Table> BinaryStream;
+typedef BasicBinaryStream<const Table> ConstBinaryStream;
+
+
+// Implementation
+
+template <class T>
+inline BasicBinaryStream<T>::BasicBinaryStream(const BasicRow<T>& row, size_t col_ndx) noexcept
+    : m_row(row)
+    , m_col_ndx(col_ndx)
+{
+}
+
+template <class T>
+inline bool BasicBinaryStream<T>::is_attached() const noexcept
+{
+    return m_row.is_attached();
+}
+
+template <class T>
+inline size_t BasicBinaryStream<T>::size() const
+{
+    return get_table().get_binary_size(m_col_ndx, m_row.get_index()); // Throws
+}
+
+template <class T>
+inline size_t BasicBinaryStream<T>::tell() const noexcept
+{
+    return m_pos;
+}
+
+template <class T>
+inline void BasicBinaryStream<T>::seek(size_t pos) noexcept
+{
+    m_pos = pos;
+}
+
+template <class T>
+size_t BasicBinaryStream<T>::read(char* buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size) {
+        BinaryData chunk = read_chunk(); // Throws
+        if (chunk.size() == 0)
+            break;
+        size_t size_to_copy = std::min(chunk.size(), size - n);
+        std::copy_n(chunk.data(), size_to_copy, buffer + n);
+        n += size_to_copy;
+        // Do not skip the part of the chunk that did not fit
+        m_pos -= chunk.size() - size_to_copy;
+    }
+    return n;
+}
+
+template <class T>
+BinaryData BasicBinaryStream<T>::read_chunk()
+{
+    const T& table = get_table(); // Throws
+    size_t row_ndx = m_row.get_index();
+    if (m_pos >= table.get_binary_size(m_col_ndx, row_ndx))
+        return BinaryData("", 0);
+    size_t pos = m_pos;
+    BinaryData chunk = table.get_binary_at(m_col_ndx, row_ndx, pos);
+    m_pos += chunk.size();
+    return chunk;
+}
+
+template <class T>
+inline void BasicBinaryStream<T>::write(BinaryData data)
+{
+    get_table().write_binary(m_col_ndx, m_row.get_index(), m_pos, data); // Throws
+    m_pos += data.size();
+}
+
+template <class T>
+inline void BasicBinaryStream<T>::append(BinaryData data)
+{
+    m_pos = size();
+    write(data); // Throws
+}
+
+template <class T>
+inline const T& BasicBinaryStream<T>::get_table() const
+{
+    if (REALM_UNLIKELY(!m_row.is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    return *m_row.get_table();
+}
+
+template <class T>
+inline T& BasicBinaryStream<T>::get_table()
+{
+    if (REALM_UNLIKELY(!m_row.is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    return *m_row.get_table();
+}
+
+} // namespace realm
+
+#endif // REALM_BINARY_STREAM_HPP
@@ -411,6 +411,47 @@ std::pair<MemRef, size_t> BpTreeNode::get_bptree_leaf(size_t ndx) const noexcept
     return {};
 }
 
+size_t BpTreeNode::update_bptree_size_of_last_branch(size_t last_leaf_size)
+{
+    REALM_ASSERT(is_inner_bptree_node());
+    REALM_ASSERT_3(size(), >=, 1 + 1 + 1); // invar:bptree-nonempty-inner
+
+    size_t num_children = size() - 2;
+    size_t child_ref_ndx = num_children; // Last child
+    ref_type child_ref = get_as_ref(child_ref_ndx);
+    char* child_header = m_alloc.translate(child_ref);
+    size_t elems_in_child = last_leaf_size;
+    if (get_is_inner_bptree_node_from_header(child_header)) {
+        BpTreeNode child(m_alloc);
+        child.init_from_mem(MemRef(child_header, child_ref, m_alloc));
+        child.set_parent(this, child_ref_ndx);
+        elems_in_child = child.update_bptree_size_of_last_branch(last_leaf_size); // Throws
+    }
+
+    size_t elem_ndx_offset = 0;
+    int_fast64_t first_value = get(0);
+    if (first_value % 2 == 0) {
+        // General form, the offsets array has an entry for every child
+        // except the last one.
+        if (num_children > 1) {
+            Array offsets(m_alloc);
+            offsets.init_from_ref(to_ref(first_value));
+            elem_ndx_offset = to_size_t(offsets.back());
+        }
+    }
+    else {
+        // Compact form
+        size_t elems_per_child = to_size_t(first_value / 2);
+        elem_ndx_offset = (num_children - 1) * elems_per_child;
+    }
+
+    size_t total_elems = elem_ndx_offset + elems_in_child;
+    int_fast64_t v = total_elems;
+    set(size() - 1, 1 + 2 * v); // Throws
+    return total_elems;
+}
+
+
 ref_type BpTreeNode::insert_bptree_child(Array& offsets, size_t orig_child_ndx, ref_type new_sibling_ref,
                                          TreeInsertBase& state)
 {
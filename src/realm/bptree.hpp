@@ -155,6 +155,21 @@ public:
     template <class TreeTraits>
     ref_type bptree_append(TreeInsert<TreeTraits>& state);
 
+    /// Recompute the total number of elements stored in each inner node
+    /// along the path from this node to the last leaf of the B+-tree, given
+    /// the number of elements in that leaf. This must be called on an inner
+    /// B+-tree node, never a leaf.
+    ///
+    /// bptree_append() assumes that each call adds a single element to the
+    /// tree, so after attaching a leaf holding more than one element, the
+    /// sizes of the inner nodes that were not split will be too small. The
+    /// offsets of all but the last child are still correct, which is what
+    /// this function relies on.
+    ///
+    /// \return The total number of elements in the subtree rooted at this
+    /// node.
+    size_t update_bptree_size_of_last_branch(size_t last_leaf_size);
+
     /// Insert an element into the B+-subtree rooted at this array
     /// node. The element is inserted before the specified element
     /// index. This function must be called on an inner B+-tree node,
@@ -204,6 +219,14 @@ public:
     void introduce_new_root(ref_type new_sibling_ref, TreeInsertBase& state, bool is_append);
     void replace_root(std::unique_ptr<Array> leaf);
 
+    /// Hint that the leaf containing the element at the specified index is
+    /// about to be read, see Allocator::prefetch(). The size of the leaf is
+    /// not known without touching its header, so the caller provides an
+    /// estimate, typically the byte size of the leaf it is currently
+    /// scanning. Does nothing if the root is a leaf. Returns the value of
+    /// Allocator::prefetch(), or false if the root is a leaf.
+    bool prefetch_leaf(size_t elem_ndx, size_t size_hint) const noexcept;
+
 protected:
     explicit BpTreeBase(std::unique_ptr<Array> root);
     explicit BpTreeBase(BpTreeBase&&) = default;
@@ -285,6 +308,19 @@ public:
     void set(size_t, T value);
     void set_null(size_t);
     void insert(size_t ndx, T value, size_t num_rows = 1);
+
+    /// Append \a num_values elements after the last element of the tree.
+    /// \a value_at is called with each index in [0, num_values) in order,
+    /// and must return the value to be stored at that position relative to
+    /// the prior end of the tree.
+    ///
+    /// Rather than descending from the root once per element, as insert()
+    /// does, this fills up the last leaf, then builds each following leaf
+    /// to its full size before attaching it to the tree, and finally
+    /// updates the sizes stored along the last branch once.
+    template <class F>
+    void bulk_append(size_t num_values, F value_at);
+
     void erase(size_t ndx, bool is_last = false);
     void move_last_over(size_t ndx, size_t last_row_ndx);
     void clear();
@@ -338,6 +374,9 @@ private:
 
     struct LeafValueInserter;
     struct LeafNullInserter;
+    struct LeafAttacher;
+    template <class F>
+    struct LastLeafFiller;
 
     template <class TreeTraits>
     void bptree_insert(size_t row_ndx, BpTreeNode::TreeInsert<TreeTraits>& state, size_t num_rows);
@@ -453,6 +492,14 @@ inline const BpTreeNode& BpTreeBase::root_as_node() const
     return static_cast<const BpTreeNode&>(*arr);
 }
 
+inline bool BpTreeBase::prefetch_leaf(size_t elem_ndx, size_t size_hint) const noexcept
+{
+    if (root_is_leaf())
+        return false;
+    std::pair<MemRef, size_t> p = root_as_node().get_bptree_leaf(elem_ndx);
+    return get_alloc().prefetch(p.first.get_ref(), size_hint);
+}
+
 inline void BpTreeBase::set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept
 {
     m_root->set_parent(parent, ndx_in_parent);
@@ -893,6 +940,108 @@ void BpTree<T>::insert(size_t row_ndx, T value, size_t num_rows)
     bptree_insert(row_ndx, inserter, num_rows);                            // Throws
 }
 
+template <class T>
+struct BpTree<T>::LeafAttacher {
+    // The ref of an already populated leaf, and the number of elements in it
+    using value_type = std::pair<ref_type, size_t>;
+
+    // TreeTraits concept:
+    static ref_type leaf_insert(MemRef leaf_mem, ArrayParent&, size_t, Allocator& alloc, size_t,
+                                BpTreeNode::TreeInsert<LeafAttacher>& state)
+    {
+        // The new leaf always goes after the current last leaf, which is
+        // expected to be full, so this is a split where the new sibling holds
+        // all of the new elements.
+        LeafType leaf{alloc};
+        leaf.init_from_mem(leaf_mem);
+        size_t leaf_size = leaf.size();
+        state.m_split_offset = leaf_size;
+        state.m_split_size = leaf_size + state.m_value.second;
+        return state.m_value.first;
+    }
+};
+
+template <class T>
+template <class F>
+struct BpTree<T>::LastLeafFiller : BpTreeNode::UpdateHandler {
+    LeafType m_leaf;
+    size_t m_num_values;
+    F& m_value_at;
+    size_t m_num_added = 0;
+    size_t m_leaf_size = 0;
+    LastLeafFiller(BpTreeBase& tree, size_t num_values, F& value_at) noexcept
+        : m_leaf(tree.get_alloc())
+        , m_num_values(num_values)
+        , m_value_at(value_at)
+    {
+    }
+    void update(MemRef mem, ArrayParent* parent, size_t ndx_in_parent, size_t) override
+    {
+        m_leaf.init_from_mem(mem);
+        m_leaf.set_parent(parent, ndx_in_parent);
+        while (m_num_added < m_num_values && m_leaf.size() < REALM_MAX_BPNODE_SIZE)
+            m_leaf.add(m_value_at(m_num_added++)); // Throws
+        m_leaf_size = m_leaf.size();
+    }
+};
+
+template <class T>
+template <class F>
+void BpTree<T>::bulk_append(size_t num_values, F value_at)
+{
+    if (num_values == 0)
+        return;
+
+    size_t ndx = 0;
+    size_t last_leaf_size;
+    if (root_is_leaf()) {
+        LeafType& leaf = root_as_leaf();
+        while (ndx < num_values && leaf.size() < REALM_MAX_BPNODE_SIZE)
+            leaf.add(value_at(ndx++)); // Throws
+        last_leaf_size = leaf.size();
+    }
+    else {
+        // The sizes stored in the inner nodes are left unchanged by the
+        // filler, but they are only needed again once all leaves have been
+        // attached.
+        LastLeafFiller<F> filler(*this, num_values, value_at);
+        root_as_node().update_bptree_elem(size() - 1, filler); // Throws
+        ndx = filler.m_num_added;
+        last_leaf_size = filler.m_leaf_size;
+    }
+
+    Allocator& alloc = get_alloc();
+    while (ndx < num_values) {
+        LeafType new_leaf(alloc);
+        new_leaf.create(Array::type_Normal); // Throws
+        _impl::DestroyGuard<LeafType> dg(&new_leaf);
+        size_t end = std::min(num_values, ndx + REALM_MAX_BPNODE_SIZE);
+        while (ndx < end)
+            new_leaf.add(value_at(ndx++)); // Throws
+
+        BpTreeNode::TreeInsert<LeafAttacher> state;
+        state.m_value = std::make_pair(new_leaf.get_ref(), new_leaf.size());
+        ref_type new_sibling_ref;
+        if (root_is_leaf()) {
+            new_sibling_ref = state.m_value.first;
+            state.m_split_offset = root_as_leaf().size();
+            state.m_split_size = state.m_split_offset + state.m_value.second;
+        }
+        else {
+            new_sibling_ref = root_as_node().bptree_append(state); // Throws
+        }
+        if (new_sibling_ref) {
+            bool is_append = true;
+            introduce_new_root(new_sibling_ref, state, is_append); // Throws
+        }
+        dg.release();
+        last_leaf_size = state.m_value.second;
+    }
+
+    if (!root_is_leaf())
+        root_as_node().update_bptree_size_of_last_branch(last_leaf_size); // Throws
+}
+
 template <class T>
 struct BpTree<T>::UpdateHandler : BpTreeNode::UpdateHandler {
     LeafType m_leaf;
@@ -60,6 +60,16 @@ void ColumnBase::set_null(size_t)
     throw LogicError{LogicError::column_not_nullable};
 }
 
+void ColumnBase::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                     bool broken_reciprocal_backlinks)
+{
+    for (size_t i = num_rows_to_erase; i > 0; --i) {
+        size_t row_ndx_2 = row_ndx + i - 1;
+        size_t prior_num_rows_2 = prior_num_rows - (num_rows_to_erase - i);
+        move_last_row_over(row_ndx_2, prior_num_rows_2, broken_reciprocal_backlinks); // Throws
+    }
+}
+
 void ColumnBase::move_assign(ColumnBase&) noexcept
 {
     destroy();
@@ -33,6 +33,7 @@
 #include <realm/bptree.hpp>
 #include <realm/index_string.hpp>
 #include <realm/impl/destroy_guard.hpp>
+#include <realm/impl/float_kernels.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/table_ref.hpp>
 
@@ -173,6 +174,15 @@ public:
     /// should ignore this argument.
     virtual void move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks) = 0;
 
+    /// Removes \a num_rows_to_erase consecutive elements starting at \a
+    /// row_ndx by moving the element at the last row index over each of them,
+    /// starting with the last one. The removed elements below the new size
+    /// thereby receive the elements above it that are not removed.
+    ///
+    /// The default implementation calls move_last_row_over() once per element.
+    virtual void move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                     bool broken_reciprocal_backlinks);
+
     /// Remove all elements from this column.
     ///
     /// \param num_rows The total number of rows in this column.
@@ -362,6 +372,13 @@ protected:
     size_t upper_bound(const L& list, T value) const noexcept;
     //@}
 
+    /// Call `move(old_row_ndx, new_row_ndx)` for each row that ends up at a
+    /// new position when move_last_rows_over() removes the specified rows.
+    /// All new positions are rows that are removed, and all old positions are
+    /// at or above the new size, so the moves can be applied in any order.
+    template <class F>
+    static void for_each_row_moved_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, F move);
+
     // Node functions
 
     class CreateHandler {
@@ -590,6 +607,9 @@ public:
     /// and never directly through the specfied fallback accessor.
     void get_leaf(size_t ndx, size_t& ndx_in_leaf, LeafInfo& inout_leaf) const noexcept;
 
+    /// See BpTreeBase::prefetch_leaf().
+    bool prefetch_leaf(size_t ndx, size_t size_hint) const noexcept;
+
     // Getting and setting values
     T get(size_t ndx) const noexcept;
     bool is_null(size_t ndx) const noexcept override;
@@ -603,6 +623,13 @@ public:
     void move_last_over(size_t row_ndx, size_t last_row_ndx);
     void clear();
 
+    /// Append \a num_rows values to the end of the column, where the value
+    /// of the i'th new row is `value_at(i)`. This is equivalent to calling
+    /// add() once per value, but fills the underlying B+-tree a leaf at a
+    /// time. See BpTree::bulk_append().
+    template <class F>
+    void bulk_append(size_t num_rows, F value_at);
+
     // Index support
     StringData get_index_data(size_t ndx, StringIndex::StringConversionBuffer& buffer) const noexcept override;
 
@@ -634,6 +661,11 @@ public:
 
     double average(size_t start = 0, size_t end = npos, size_t limit = npos, size_t* return_ndx = nullptr) const;
 
+    /// The sum of the non-null values in [start, end), computed with Kahan
+    /// summation, such that the rounding error does not grow with the number
+    /// of values. Only for float and double columns.
+    double sum_compensated(size_t start = 0, size_t end = npos) const;
+
     size_t find_first(T value, size_t begin = 0, size_t end = npos) const;
     void find_all(Column<int64_t>& out_indices, T value, size_t begin = 0, size_t end = npos) const;
 
@@ -680,6 +712,7 @@ public:
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
+    void move_last_rows_over(size_t, size_t, size_t, bool) override;
 
     /// \brief Swap the elements at the specified indices.
     ///
@@ -779,6 +812,29 @@ inline size_t IntNullColumn::get_size_from_ref(ref_type root_ref, Allocator& all
 }
 
 
+template <class F>
+void ColumnBase::for_each_row_moved_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, F move)
+{
+    size_t new_size = prior_num_rows - num_rows_to_erase;
+    if (row_ndx + num_rows_to_erase <= new_size) {
+        for (size_t i = 0; i < num_rows_to_erase; ++i)
+            move(new_size + i, row_ndx + i); // Throws
+        return;
+    }
+
+    // The removed rows reach into the rows that are moved, so some rows are
+    // moved several times. Find out where they end up.
+    std::vector<size_t> rows(prior_num_rows - row_ndx); // Throws
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = row_ndx + i;
+    for (size_t i = num_rows_to_erase; i > 0; --i) {
+        rows[i - 1] = rows.back();
+        rows.pop_back();
+    }
+    for (size_t i = 0; i < rows.size(); ++i)
+        move(rows[i], row_ndx + i); // Throws
+}
+
 inline bool ColumnBase::supports_search_index() const noexcept
 {
     REALM_ASSERT(!has_search_index());
@@ -971,6 +1027,27 @@ typename ColumnTypeTraits<T>::sum_type Column<T>::sum(size_t start, size_t end,
         return aggregate<T, sum_type, act_Sum, None>(*this, 0, start, end, limit, return_ndx);
 }
 
+template <class T>
+double Column<T>::sum_compensated(size_t start, size_t end) const
+{
+    static_assert(std::is_floating_point<T>::value, "Only float and double columns");
+    if (end == npos)
+        end = size();
+
+    _impl::FloatSum state;
+    LeafType fallback(get_alloc());
+    const LeafType* leaf = nullptr;
+    LeafInfo leaf_info{&leaf, &fallback};
+    for (size_t ndx = start; ndx < end;) {
+        size_t ndx_in_leaf;
+        get_leaf(ndx, ndx_in_leaf, leaf_info);
+        size_t n = std::min(leaf->size() - ndx_in_leaf, end - ndx);
+        _impl::float_sum(leaf->data() + ndx_in_leaf, n, true, state);
+        ndx += n;
+    }
+    return state.sum - state.compensation;
+}
+
 template <class T>
 double Column<T>::average(size_t start, size_t end, size_t limit, size_t* return_ndx) const
 {
@@ -1007,6 +1084,12 @@ void Column<T>::get_leaf(size_t ndx, size_t& ndx_in_leaf, LeafInfo& inout_leaf_i
     m_tree.get_leaf(ndx, ndx_in_leaf, inout_leaf_info);
 }
 
+template <class T>
+bool Column<T>::prefetch_leaf(size_t ndx, size_t size_hint) const noexcept
+{
+    return m_tree.prefetch_leaf(ndx, size_hint);
+}
+
 template <class T>
 StringData Column<T>::get_index_data(size_t ndx, StringIndex::StringConversionBuffer& buffer) const noexcept
 {
@@ -1319,6 +1402,20 @@ void Column<T>::insert(size_t row_ndx, T value, size_t num_rows)
     }
 }
 
+template <class T>
+template <class F>
+void Column<T>::bulk_append(size_t num_rows, F value_at)
+{
+    size_t column_size = this->size(); // Slow
+    m_tree.bulk_append(num_rows, value_at); // Throws
+
+    if (has_search_index()) {
+        bool is_append = true;
+        for (size_t i = 0; i < num_rows; ++i)
+            m_search_index->insert(column_size + i, value_at(i), 1, is_append); // Throws
+    }
+}
+
 template <class T>
 void Column<T>::erase_without_updating_index(size_t row_ndx, bool is_last)
 {
@@ -1486,6 +1583,33 @@ void Column<T>::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool)
     move_last_over(row_ndx, last_row_ndx); // Throws
 }
 
+// Overriding method in ColumnBase.
+template <class T>
+void Column<T>::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, bool)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+    REALM_ASSERT(num_rows_to_erase <= prior_num_rows);
+    REALM_ASSERT(row_ndx <= prior_num_rows - num_rows_to_erase);
+
+    // Each row is moved once, directly to its final position
+    if (has_search_index()) {
+        bool is_last = true; // This tells StringIndex::erase_rows() to not adjust subsequent indexes
+        m_search_index->erase_rows<T>(row_ndx, num_rows_to_erase, is_last); // Throws
+        for_each_row_moved_over(row_ndx, num_rows_to_erase, prior_num_rows, [&](size_t from, size_t to) {
+            T moved_value = get(from);
+            m_search_index->update_ref(moved_value, from, to); // Throws
+        });
+    }
+
+    for_each_row_moved_over(row_ndx, num_rows_to_erase, prior_num_rows, [&](size_t from, size_t to) {
+        m_tree.set(to, m_tree.get(from)); // Throws
+    });
+    bool is_last = true;
+    size_t new_size = prior_num_rows - num_rows_to_erase;
+    for (size_t i = prior_num_rows; i > new_size; --i)
+        erase_without_updating_index(i - 1, is_last); // Throws
+}
+
 // Implementing pure virtual method of ColumnBase.
 template <class T>
 void Column<T>::clear(size_t, bool)
@@ -1604,12 +1728,8 @@ void Column<T>::refresh_accessor_tree(size_t new_col_ndx, const Spec& spec)
 template <class T>
 void Column<T>::do_erase(size_t row_ndx, size_t num_rows_to_erase, bool is_last)
 {
-    if (has_search_index()) {
-        for (size_t i = num_rows_to_erase; i > 0; --i) {
-            size_t row_ndx_2 = row_ndx + i - 1;
-            m_search_index->erase<T>(row_ndx_2, is_last); // Throws
-        }
-    }
+    if (has_search_index())
+        m_search_index->erase_rows<T>(row_ndx, num_rows_to_erase, is_last); // Throws
     for (size_t i = num_rows_to_erase; i > 0; --i) {
         size_t row_ndx_2 = row_ndx + i - 1;
         erase_without_updating_index(row_ndx_2, is_last); // Throws
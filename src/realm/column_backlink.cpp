@@ -267,7 +267,7 @@ void BacklinkColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t
             m_origin_column->do_nullify_link(origin_row_ndx, row_ndx + i); // Throws
         };
         bool do_destroy = true;
-        for_each_link(row_ndx, do_destroy, handler); // Throws
+        for_each_link(row_ndx + i, do_destroy, handler); // Throws
     }
 
     // Update forward links to the moved target rows
@@ -65,6 +65,7 @@ public:
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
+    void move_last_rows_over(size_t, size_t, size_t, bool) override;
     void swap_rows(size_t, size_t) override;
     void clear(size_t, bool) override;
     void adj_acc_insert_rows(size_t, size_t) noexcept override;
@@ -157,6 +158,15 @@ inline void BacklinkColumn::add_row()
     IntegerColumn::add(0);
 }
 
+// Overriding virtual method of Column. The forward links to each moved row
+// must be updated, so the rows are moved one at a time.
+inline void BacklinkColumn::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                                bool broken_reciprocal_backlinks)
+{
+    ColumnBase::move_last_rows_over(row_ndx, num_rows_to_erase, prior_num_rows,
+                                    broken_reciprocal_backlinks); // Throws
+}
+
 inline void BacklinkColumn::adj_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept
 {
     IntegerColumn::adj_acc_insert_rows(row_ndx, num_rows);
@@ -20,6 +20,7 @@
 #include <iomanip>
 
 #include <memory>
+#include <string>
 #include <realm/column_binary.hpp>
 
 using namespace realm;
@@ -39,6 +40,39 @@ void copy_leaf(const ArrayBinary& from, ArrayBigBlobs& to)
     }
 }
 
+// Values of a small blobs leaf are rewritten in full
+std::string splice_value(BinaryData old_value, size_t pos, BinaryData value)
+{
+    REALM_ASSERT_3(pos, <=, old_value.size());
+    std::string new_value(old_value.data(), pos); // Throws
+    new_value.append(value.data(), value.size()); // Throws
+    if (pos + value.size() < old_value.size())
+        new_value.append(old_value.data() + pos + value.size(), old_value.size() - pos - value.size()); // Throws
+    return new_value;
+}
+
+
+class UnshareLeaf : public BpTreeNode::UpdateHandler {
+public:
+    UnshareLeaf(Allocator& alloc) noexcept
+        : m_alloc(alloc)
+    {
+    }
+    void update(MemRef mem, ArrayParent* parent, size_t ndx_in_parent, size_t) override
+    {
+        bool is_big = Array::get_context_flag_from_header(mem.get_addr());
+        if (!is_big)
+            return;
+        ArrayBigBlobs leaf(m_alloc, false);
+        leaf.init_from_mem(mem);
+        leaf.set_parent(parent, ndx_in_parent);
+        leaf.unshare_all(); // Throws
+    }
+
+private:
+    Allocator& m_alloc;
+};
+
 } // anonymous namespace
 
 
@@ -77,10 +111,12 @@ struct SetLeafElem : BpTreeNode::UpdateHandler {
     Allocator& m_alloc;
     const BinaryData m_value;
     const bool m_add_zero_term;
-    SetLeafElem(Allocator& alloc, BinaryData value, bool add_zero_term) noexcept
+    ArrayBigBlobs::OwnerIndex* const m_owners;
+    SetLeafElem(Allocator& alloc, BinaryData value, bool add_zero_term, ArrayBigBlobs::OwnerIndex* owners) noexcept
         : m_alloc(alloc)
         , m_value(value)
         , m_add_zero_term(add_zero_term)
+        , m_owners(owners)
     {
     }
     void update(MemRef mem, ArrayParent* parent, size_t ndx_in_parent, size_t elem_ndx_in_leaf) override
@@ -90,7 +126,7 @@ struct SetLeafElem : BpTreeNode::UpdateHandler {
             ArrayBigBlobs leaf(m_alloc, false);
             leaf.init_from_mem(mem);
             leaf.set_parent(parent, ndx_in_parent);
-            leaf.set(elem_ndx_in_leaf, m_value, m_add_zero_term); // Throws
+            leaf.set(elem_ndx_in_leaf, m_value, m_add_zero_term, m_owners); // Throws
             return;
         }
         ArrayBinary leaf(m_alloc);
@@ -107,7 +143,7 @@ struct SetLeafElem : BpTreeNode::UpdateHandler {
         new_leaf.update_parent();                   // Throws
         copy_leaf(leaf, new_leaf);                  // Throws
         leaf.destroy();
-        new_leaf.set(elem_ndx_in_leaf, m_value, m_add_zero_term); // Throws
+        new_leaf.set(elem_ndx_in_leaf, m_value, m_add_zero_term, m_owners); // Throws
     }
 };
 
@@ -122,9 +158,14 @@ BinaryData BinaryColumn::get_at(size_t ndx, size_t& pos) const noexcept
         bool is_big = arr->get_context_flag();
         if (!is_big) {
             // Small blobs
-            pos = 0;
             REALM_ASSERT_DEBUG(dynamic_cast<ArrayBinary*>(arr) != nullptr);
-            return static_cast<ArrayBinary*>(arr)->get(ndx);
+            BinaryData value = static_cast<ArrayBinary*>(arr)->get(ndx);
+            size_t offset = pos;
+            pos = 0;
+            if (offset == 0 || value.is_null())
+                return value;
+            offset = std::min(offset, value.size());
+            return BinaryData(value.data() + offset, value.size() - offset);
         }
         else {
             // Big blobs
@@ -139,10 +180,15 @@ BinaryData BinaryColumn::get_at(size_t ndx, size_t& pos) const noexcept
         bool is_big = Array::get_context_flag_from_header(leaf_header);
         if (!is_big) {
             // Small blobs
-            pos = 0;
             ArrayBinary leaf(m_array->get_alloc());
             leaf.init_from_mem(p.first);
-            return leaf.get(p.second);
+            BinaryData value = leaf.get(p.second);
+            size_t offset = pos;
+            pos = 0;
+            if (offset == 0 || value.is_null())
+                return value;
+            offset = std::min(offset, value.size());
+            return BinaryData(value.data() + offset, value.size() - offset);
         }
         else {
             // Big blobs
@@ -168,16 +214,134 @@ void BinaryColumn::set(size_t ndx, BinaryData value, bool add_zero_term)
         }
         // Big blobs root leaf
         ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-        leaf->set(ndx, value, add_zero_term); // Throws
+        leaf->set(ndx, value, add_zero_term, get_owner_index()); // Throws
         return;
     }
 
     // Non-leaf root
-    SetLeafElem set_leaf_elem(m_array->get_alloc(), value, add_zero_term);
+    SetLeafElem set_leaf_elem(m_array->get_alloc(), value, add_zero_term, get_owner_index());
     static_cast<BpTreeNode*>(m_array.get())->update_bptree_elem(ndx, set_leaf_elem); // Throws
 }
 
 
+size_t BinaryColumn::get_blob_size(size_t ndx) const noexcept
+{
+    REALM_ASSERT_3(ndx, <, size());
+
+    MemRef mem;
+    size_t ndx_in_leaf;
+    if (root_is_leaf()) {
+        mem = m_array->get_mem();
+        ndx_in_leaf = ndx;
+    }
+    else {
+        std::pair<MemRef, size_t> p = static_cast<BpTreeNode*>(m_array.get())->get_bptree_leaf(ndx);
+        mem = p.first;
+        ndx_in_leaf = p.second;
+    }
+    bool is_big = Array::get_context_flag_from_header(mem.get_addr());
+    if (!is_big) {
+        // Small blobs
+        return ArrayBinary::get(mem.get_addr(), ndx_in_leaf, m_array->get_alloc()).size();
+    }
+    // Big blobs
+    ArrayBigBlobs leaf(m_array->get_alloc(), m_nullable);
+    leaf.init_from_mem(mem);
+    return leaf.get_blob_size(ndx_in_leaf);
+}
+
+
+class BinaryColumn::WriteLeafElem : public BpTreeNode::UpdateHandler {
+public:
+    Allocator& m_alloc;
+    const size_t m_pos;
+    const BinaryData m_value;
+    const bool m_deduplicated;
+    WriteLeafElem(Allocator& alloc, size_t pos, BinaryData value, bool deduplicated) noexcept
+        : m_alloc(alloc)
+        , m_pos(pos)
+        , m_value(value)
+        , m_deduplicated(deduplicated)
+    {
+    }
+    void update(MemRef mem, ArrayParent* parent, size_t ndx_in_parent, size_t elem_ndx_in_leaf) override
+    {
+        bool is_big = Array::get_context_flag_from_header(mem.get_addr());
+        if (is_big) {
+            ArrayBigBlobs leaf(m_alloc, false);
+            leaf.init_from_mem(mem);
+            leaf.set_parent(parent, ndx_in_parent);
+            leaf.write(elem_ndx_in_leaf, m_pos, m_value, m_deduplicated); // Throws
+            return;
+        }
+        ArrayBinary leaf(m_alloc);
+        leaf.init_from_mem(mem);
+        leaf.set_parent(parent, ndx_in_parent);
+        std::string new_value = splice_value(leaf.get(elem_ndx_in_leaf), m_pos, m_value); // Throws
+        BinaryData new_value_2(new_value.data(), new_value.size());
+        if (new_value.size() <= small_blob_max_size) {
+            leaf.set(elem_ndx_in_leaf, new_value_2); // Throws
+            return;
+        }
+        // Upgrade leaf from small to big blobs
+        ArrayBigBlobs new_leaf(m_alloc, false);
+        new_leaf.create();                          // Throws
+        new_leaf.set_parent(parent, ndx_in_parent); // Throws
+        new_leaf.update_parent();                   // Throws
+        copy_leaf(leaf, new_leaf);                  // Throws
+        leaf.destroy();
+        new_leaf.set(elem_ndx_in_leaf, new_value_2); // Throws
+    }
+};
+
+
+void BinaryColumn::write(size_t ndx, size_t pos, BinaryData value)
+{
+    REALM_ASSERT_3(ndx, <, size());
+
+    // Writing does not keep the owner index up to date
+    m_owner_index.clear();
+
+    bool array_root_is_leaf = !m_array->is_inner_bptree_node();
+    if (array_root_is_leaf) {
+        bool is_big = m_array->get_context_flag();
+        if (!is_big) {
+            // Small blobs root leaf
+            ArrayBinary* leaf = static_cast<ArrayBinary*>(m_array.get());
+            std::string new_value = splice_value(leaf->get(ndx), pos, value); // Throws
+            set(ndx, BinaryData(new_value.data(), new_value.size()));        // Throws
+            return;
+        }
+        // Big blobs root leaf
+        ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
+        leaf->write(ndx, pos, value, m_deduplicated); // Throws
+        return;
+    }
+
+    // Non-leaf root
+    WriteLeafElem write_leaf_elem(m_array->get_alloc(), pos, value, m_deduplicated);
+    static_cast<BpTreeNode*>(m_array.get())->update_bptree_elem(ndx, write_leaf_elem); // Throws
+}
+
+
+void BinaryColumn::unshare_all()
+{
+    m_owner_index.clear();
+
+    bool array_root_is_leaf = !m_array->is_inner_bptree_node();
+    if (array_root_is_leaf) {
+        bool is_big = m_array->get_context_flag();
+        if (is_big)
+            static_cast<ArrayBigBlobs*>(m_array.get())->unshare_all(); // Throws
+        return;
+    }
+
+    // Non-leaf root
+    UnshareLeaf unshare_leaf(m_array->get_alloc());
+    static_cast<BpTreeNode*>(m_array.get())->update_bptree_leaves(unshare_leaf); // Throws
+}
+
+
 bool BinaryColumn::compare_binary(const BinaryColumn& c) const
 {
     size_t n = size();
@@ -215,7 +379,8 @@ void BinaryColumn::do_insert(size_t row_ndx, BinaryData value, bool add_zero_ter
             else {
                 // Big blobs root leaf
                 ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-                new_sibling_ref = leaf->bptree_leaf_insert(row_ndx_2, value, add_zero_term, state); // Throws
+                new_sibling_ref =
+                    leaf->bptree_leaf_insert(row_ndx_2, value, add_zero_term, state, get_owner_index()); // Throws
             }
         }
         else {
@@ -223,6 +388,7 @@ void BinaryColumn::do_insert(size_t row_ndx, BinaryData value, bool add_zero_ter
             BpTreeNode* node = static_cast<BpTreeNode*>(m_array.get());
             state.m_value = value;
             state.m_add_zero_term = add_zero_term;
+            state.m_owners = get_owner_index();
             if (row_ndx_2 == realm::npos) {
                 new_sibling_ref = node->bptree_append(state);
             }
@@ -247,7 +413,8 @@ ref_type BinaryColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t
         ArrayBigBlobs leaf(alloc, false);
         leaf.init_from_mem(leaf_mem);
         leaf.set_parent(&parent, ndx_in_parent);
-        return leaf.bptree_leaf_insert(insert_ndx, state_2.m_value, state_2.m_add_zero_term, state); // Throws
+        return leaf.bptree_leaf_insert(insert_ndx, state_2.m_value, state_2.m_add_zero_term, state,
+                                       state_2.m_owners); // Throws
     }
     ArrayBinary leaf(alloc);
     leaf.init_from_mem(leaf_mem);
@@ -261,7 +428,8 @@ ref_type BinaryColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t
     new_leaf.update_parent();  // Throws
     copy_leaf(leaf, new_leaf); // Throws
     leaf.destroy();
-    return new_leaf.bptree_leaf_insert(insert_ndx, state_2.m_value, state_2.m_add_zero_term, state); // Throws
+    return new_leaf.bptree_leaf_insert(insert_ndx, state_2.m_value, state_2.m_add_zero_term, state,
+                                       state_2.m_owners); // Throws
 }
 
 
@@ -302,7 +470,7 @@ public:
         size_t ndx = elem_ndx_in_leaf;
         if (ndx == npos)
             ndx = last_ndx;
-        leaf.erase(ndx); // Throws
+        leaf.erase(ndx, m_column.m_deduplicated); // Throws
         return false;
     }
     void destroy_leaf(MemRef leaf_mem) noexcept override
@@ -353,7 +521,7 @@ void BinaryColumn::erase(size_t ndx, bool is_last)
         }
         // Big blobs root leaf
         ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-        leaf->erase(ndx); // Throws
+        leaf->erase(ndx, m_deduplicated); // Throws
         return;
     }
 
@@ -438,6 +606,7 @@ void BinaryColumn::swap_rows(size_t row_ndx_1, size_t row_ndx_2)
 
 void BinaryColumn::do_clear()
 {
+    m_owner_index.clear();
     bool array_root_is_leaf = !m_array->is_inner_bptree_node();
     if (array_root_is_leaf) {
         bool is_big = m_array->get_context_flag();
@@ -577,6 +746,9 @@ ref_type BinaryColumn::write(size_t slice_offset, size_t slice_size, size_t tabl
 void BinaryColumn::refresh_accessor_tree(size_t new_col_ndx, const Spec& spec)
 {
     ColumnBaseSimple::refresh_accessor_tree(new_col_ndx, spec);
+    ColumnAttr attr = spec.get_column_attr(new_col_ndx);
+    m_deduplicated = (attr & col_attr_Deduplicated) != 0;
+    m_owner_index.clear();
     ref_type ref = m_array->get_ref_from_parent();
     update_from_ref(ref); // Throws
 }
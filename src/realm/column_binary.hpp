@@ -43,6 +43,16 @@ public:
     }
     bool is_nullable() const noexcept override;
 
+    /// Whether values stored from now on share storage with identical values
+    /// in the same leaf. See ArrayBigBlobs.
+    bool is_deduplicated() const noexcept;
+    void set_deduplicated(bool) noexcept;
+
+    /// Give every value that shares storage a copy of its own. Only
+    /// deduplicated columns keep track of shared values, so this must be done
+    /// before deduplication is turned off.
+    void unshare_all();
+
     BinaryData get(size_t ndx) const noexcept;
 
     /// Return data from position 'pos' and onwards. If the blob is distributed
@@ -51,12 +61,23 @@ public:
     /// data. It will be 0 if no more data.
     BinaryData get_at(size_t ndx, size_t& pos) const noexcept;
 
+    /// The size of the specified value, also if it is bigger than ~ 16M and
+    /// therefore distributed across multiple arrays.
+    size_t get_blob_size(size_t ndx) const noexcept;
+
     bool is_null(size_t ndx) const noexcept override;
     StringData get_index_data(size_t, StringIndex::StringConversionBuffer&) const noexcept final;
 
     void add(BinaryData value);
     void set(size_t ndx, BinaryData value, bool add_zero_term = false);
     void set_null(size_t ndx) override;
+
+    /// Overwrite the bytes of the specified value starting at \a pos, growing
+    /// it as needed. \a pos must not be greater than the size of the value. A
+    /// null value is treated as empty. Of a value that is distributed across
+    /// multiple arrays, only the arrays holding the overwritten bytes are
+    /// modified.
+    void write(size_t ndx, size_t pos, BinaryData value);
     void insert(size_t ndx, BinaryData value);
     void erase(size_t row_ndx);
     void erase(size_t row_ndx, bool is_last);
@@ -112,11 +133,13 @@ private:
 
     struct InsertState : BpTreeNode::TreeInsert<BinaryColumn> {
         bool m_add_zero_term;
+        ArrayBigBlobs::OwnerIndex* m_owners;
     };
 
     class EraseLeafElem;
     class CreateHandler;
     class SliceHandler;
+    class WriteLeafElem;
 
     void do_move_last_over(size_t row_ndx, size_t last_row_ndx);
     void do_clear();
@@ -127,6 +150,12 @@ private:
     bool upgrade_root_leaf(size_t value_size);
 
     bool m_nullable = false;
+    bool m_deduplicated = false;
+    ArrayBigBlobs::OwnerIndex m_owner_index;
+
+    /// The owner index to pass to big blobs leaves, null unless the column
+    /// is deduplicated.
+    ArrayBigBlobs::OwnerIndex* get_owner_index() noexcept;
 
     void leaf_to_dot(MemRef, ArrayParent*, size_t ndx_in_parent, std::ostream&) const override;
 
@@ -208,6 +237,21 @@ inline bool BinaryColumn::is_nullable() const noexcept
     return m_nullable;
 }
 
+inline bool BinaryColumn::is_deduplicated() const noexcept
+{
+    return m_deduplicated;
+}
+
+inline void BinaryColumn::set_deduplicated(bool value) noexcept
+{
+    m_deduplicated = value;
+}
+
+inline ArrayBigBlobs::OwnerIndex* BinaryColumn::get_owner_index() noexcept
+{
+    return m_deduplicated ? &m_owner_index : nullptr;
+}
+
 inline void BinaryColumn::update_from_parent(size_t old_baseline) noexcept
 {
     if (root_is_leaf()) {
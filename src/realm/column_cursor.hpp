@@ -0,0 +1,368 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_COLUMN_CURSOR_HPP
+#define REALM_COLUMN_CURSOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <realm/array_blobs_big.hpp>
+#include <realm/array_string.hpp>
+#include <realm/array_string_long.hpp>
+#include <realm/column.hpp>
+#include <realm/column_string.hpp>
+#include <realm/column_string_enum.hpp>
+#include <realm/exceptions.hpp>
+#include <realm/null.hpp>
+#include <realm/string_data.hpp>
+#include <realm/table.hpp>
+
+namespace realm {
+
+/// A run of consecutive values of one column, as produced by
+/// ColumnCursor::next().
+template <class T>
+struct ColumnBlock {
+    /// The index of the row of the first value.
+    size_t start_row = 0;
+
+    /// The number of values.
+    size_t size = 0;
+
+    const T* values = nullptr;
+
+    /// A bitmap with one bit per value, which is set if the value is null.
+    /// Bit `i % 64` of `nulls[i / 64]` refers to `values[i]`. Null if the
+    /// column is not nullable. The entries of `values` for null values are
+    /// unspecified, except for strings, which are null strings.
+    const uint64_t* nulls = nullptr;
+
+    bool is_null(size_t i) const noexcept
+    {
+        return nulls && ((nulls[i / 64] >> (i % 64)) & 1) != 0;
+    }
+};
+
+
+/// A read-only cursor that returns the values of one column a B+-tree leaf at
+/// a time, instead of one value at a time through Table::get_int() and
+/// friends, which each descend the B+-tree from the root.
+///
+/// The supported value types are `int64_t` (for integer, boolean, and
+/// OldDateTime columns), `float`, `double`, and `StringData`. Integers are
+/// unpacked to 64 bits, and strings are returned as an array of StringData
+/// referring to the leaf. Float and double values are returned in place,
+/// without copying.
+///
+///     ColumnCursor<int64_t> cursor(*table, col_ndx);
+///     ColumnBlock<int64_t> block;
+///     while (cursor.next(block)) {
+///         for (size_t i = 0; i < block.size; ++i)
+///             sum += block.values[i];
+///     }
+///
+/// A block is valid until the next call to next(), or until the table is
+/// modified or the transaction ends. The table must not be modified while the
+/// cursor is in use.
+template <class T>
+class ColumnCursor {
+public:
+    /// Iterate over the rows in the range [begin, end) of the specified
+    /// column. An \a end of `npos` means the size of the table.
+    ColumnCursor(const Table&, size_t col_ndx, size_t begin = 0, size_t end = npos);
+
+    /// Get the values of the next rows, up to the end of the leaf holding the
+    /// first of them. Returns false, and leaves \a block unchanged, when all
+    /// rows in the range have been returned.
+    bool next(ColumnBlock<T>& block);
+
+    /// The index of the first row to be returned by the next call to next().
+    size_t tell() const noexcept;
+
+    /// Continue at the specified row, which must be in the range [begin, end].
+    void seek(size_t row_ndx) noexcept;
+
+private:
+    ConstTableRef m_table;
+    size_t m_col_ndx;
+    size_t m_begin;
+    size_t m_row;
+    size_t m_end;
+    bool m_nullable;
+    std::vector<T> m_values;
+    std::vector<uint64_t> m_nulls;
+
+    // For enumerated string columns
+    std::vector<int64_t> m_key_ndxs;
+    std::vector<StringData> m_keys;
+    uint_fast64_t m_keys_version = uint_fast64_t(-1);
+
+    static bool is_valid_type(DataType) noexcept;
+
+    // Decode at most \a max_size values starting at \a row_ndx, up to the
+    // end of the leaf, and return their number.
+    size_t load(size_t row_ndx, size_t max_size, const T*& values);
+
+    template <class L, class F>
+    size_t load_strings(const L& leaf, size_t ndx_in_leaf, size_t max_size, F get);
+
+    void clear_nulls(size_t size);
+    void set_null(size_t i) noexcept;
+};
+
+
+// Implementation
+
+template <class T>
+ColumnCursor<T>::ColumnCursor(const Table& table, size_t col_ndx, size_t begin, size_t end)
+    : m_col_ndx(col_ndx)
+    , m_begin(begin)
+    , m_row(begin)
+{
+    if (REALM_UNLIKELY(!table.is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndx >= table.get_column_count()))
+        throw LogicError(LogicError::column_index_out_of_range);
+    if (REALM_UNLIKELY(!is_valid_type(table.get_column_type(col_ndx))))
+        throw LogicError(LogicError::type_mismatch);
+    size_t size = table.size();
+    if (end == npos)
+        end = size;
+    if (REALM_UNLIKELY(end > size || begin > end))
+        throw LogicError(LogicError::row_index_out_of_range);
+    m_table = table.get_table_ref();
+    m_end = end;
+    m_nullable = table.is_nullable(col_ndx);
+}
+
+template <class T>
+bool ColumnCursor<T>::next(ColumnBlock<T>& block)
+{
+    if (REALM_UNLIKELY(!m_table->is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (m_row >= m_end)
+        return false;
+
+    const T* values;
+    size_t size = load(m_row, m_end - m_row, values); // Throws
+    block.start_row = m_row;
+    block.size = size;
+    block.values = values;
+    block.nulls = m_nullable ? m_nulls.data() : nullptr;
+    m_row += size;
+    return true;
+}
+
+template <class T>
+inline size_t ColumnCursor<T>::tell() const noexcept
+{
+    return m_row;
+}
+
+template <class T>
+inline void ColumnCursor<T>::seek(size_t row_ndx) noexcept
+{
+    REALM_ASSERT(row_ndx >= m_begin && row_ndx <= m_end);
+    m_row = row_ndx;
+}
+
+template <class T>
+inline void ColumnCursor<T>::clear_nulls(size_t size)
+{
+    m_nulls.assign((size + 63) / 64, 0); // Throws
+}
+
+template <class T>
+inline void ColumnCursor<T>::set_null(size_t i) noexcept
+{
+    m_nulls[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+template <>
+inline bool ColumnCursor<int64_t>::is_valid_type(DataType type) noexcept
+{
+    return type == type_Int || type == type_Bool || type == type_OldDateTime;
+}
+
+template <>
+inline bool ColumnCursor<float>::is_valid_type(DataType type) noexcept
+{
+    return type == type_Float;
+}
+
+template <>
+inline bool ColumnCursor<double>::is_valid_type(DataType type) noexcept
+{
+    return type == type_Double;
+}
+
+template <>
+inline bool ColumnCursor<StringData>::is_valid_type(DataType type) noexcept
+{
+    return type == type_String;
+}
+
+template <>
+inline size_t ColumnCursor<int64_t>::load(size_t row_ndx, size_t max_size, const int64_t*& values)
+{
+    const ColumnBase& col = _impl::TableFriend::get_column(*m_table, m_col_ndx);
+    size_t ndx_in_leaf;
+    if (m_nullable) {
+        const IntNullColumn& int_col = static_cast<const IntNullColumn&>(col);
+        ArrayIntNull fallback(int_col.get_alloc());
+        const ArrayIntNull* leaf = nullptr;
+        IntNullColumn::LeafInfo leaf_info{&leaf, &fallback};
+        int_col.get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+        size_t size = std::min(leaf->size() - ndx_in_leaf, max_size);
+        m_values.resize(size); // Throws
+        clear_nulls(size);     // Throws
+        // The first element of the underlying array is the value that
+        // represents null
+        leaf->Array::get_range(ndx_in_leaf + 1, ndx_in_leaf + 1 + size, m_values.data());
+        int64_t null_value = leaf->null_value();
+        for (size_t i = 0; i < size; ++i) {
+            if (m_values[i] == null_value)
+                set_null(i);
+        }
+        values = m_values.data();
+        return size;
+    }
+
+    const IntegerColumn& int_col = static_cast<const IntegerColumn&>(col);
+    ArrayInteger fallback(int_col.get_alloc());
+    const ArrayInteger* leaf = nullptr;
+    IntegerColumn::LeafInfo leaf_info{&leaf, &fallback};
+    int_col.get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+    size_t size = std::min(leaf->size() - ndx_in_leaf, max_size);
+    m_values.resize(size); // Throws
+    leaf->get_range(ndx_in_leaf, ndx_in_leaf + size, m_values.data());
+    values = m_values.data();
+    return size;
+}
+
+// Float and double
+template <class T>
+size_t ColumnCursor<T>::load(size_t row_ndx, size_t max_size, const T*& values)
+{
+    using ColType = Column<T>;
+    const ColType& col = static_cast<const ColType&>(_impl::TableFriend::get_column(*m_table, m_col_ndx));
+    typename ColType::LeafType fallback(col.get_alloc());
+    const typename ColType::LeafType* leaf = nullptr;
+    typename ColType::LeafInfo leaf_info{&leaf, &fallback};
+    size_t ndx_in_leaf;
+    col.get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+    size_t size = std::min(leaf->size() - ndx_in_leaf, max_size);
+    // The values are stored unpacked, so they can be returned in place. The
+    // memory is owned by the allocator, not by the leaf accessor.
+    const char* data = Array::get_data_from_header(leaf->get_mem().get_addr());
+    values = reinterpret_cast<const T*>(data) + ndx_in_leaf;
+    if (m_nullable) {
+        clear_nulls(size); // Throws
+        for (size_t i = 0; i < size; ++i) {
+            if (null::is_null_float(values[i]))
+                set_null(i);
+        }
+    }
+    return size;
+}
+
+template <class T>
+template <class L, class F>
+size_t ColumnCursor<T>::load_strings(const L& leaf, size_t ndx_in_leaf, size_t max_size, F get)
+{
+    size_t size = std::min(leaf.size() - ndx_in_leaf, max_size);
+    m_values.resize(size); // Throws
+    if (m_nullable)
+        clear_nulls(size); // Throws
+    for (size_t i = 0; i < size; ++i) {
+        StringData value = get(leaf, ndx_in_leaf + i);
+        m_values[i] = value;
+        if (m_nullable && value.is_null())
+            set_null(i);
+    }
+    return size;
+}
+
+template <>
+inline size_t ColumnCursor<StringData>::load(size_t row_ndx, size_t max_size, const StringData*& values)
+{
+    const ColumnBase& col = _impl::TableFriend::get_column(*m_table, m_col_ndx);
+
+    if (_impl::TableFriend::get_spec(*m_table).get_column_type(m_col_ndx) == col_type_StringEnum) {
+        const StringEnumColumn& enum_col = static_cast<const StringEnumColumn&>(col);
+        if (m_keys_version != m_table->get_version_counter()) {
+            const StringColumn& keys = enum_col.get_keys();
+            size_t num_keys = keys.size();
+            m_keys.resize(num_keys); // Throws
+            for (size_t i = 0; i < num_keys; ++i)
+                m_keys[i] = keys.get(i);
+            m_keys_version = m_table->get_version_counter();
+        }
+        ArrayInteger fallback(enum_col.get_alloc());
+        const ArrayInteger* leaf = nullptr;
+        IntegerColumn::LeafInfo leaf_info{&leaf, &fallback};
+        size_t ndx_in_leaf;
+        enum_col.get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+        size_t size = std::min(leaf->size() - ndx_in_leaf, max_size);
+        m_key_ndxs.resize(size); // Throws
+        m_values.resize(size);   // Throws
+        if (m_nullable)
+            clear_nulls(size); // Throws
+        leaf->get_range(ndx_in_leaf, ndx_in_leaf + size, m_key_ndxs.data());
+        for (size_t i = 0; i < size; ++i) {
+            StringData value = m_keys[size_t(m_key_ndxs[i])];
+            m_values[i] = value;
+            if (m_nullable && value.is_null())
+                set_null(i);
+        }
+        values = m_values.data();
+        return size;
+    }
+
+    const StringColumn& string_col = static_cast<const StringColumn&>(col);
+    size_t ndx_in_leaf;
+    StringColumn::LeafType leaf_type;
+    std::unique_ptr<const ArrayParent> leaf = string_col.get_leaf(row_ndx, ndx_in_leaf, leaf_type); // Throws
+    size_t size = 0;
+    switch (leaf_type) {
+        case StringColumn::leaf_type_Small:
+            size = load_strings(static_cast<const ArrayString&>(*leaf), ndx_in_leaf, max_size,
+                                [](const ArrayString& l, size_t i) { return l.get(i); }); // Throws
+            break;
+        case StringColumn::leaf_type_Medium:
+            size = load_strings(static_cast<const ArrayStringLong&>(*leaf), ndx_in_leaf, max_size,
+                                [](const ArrayStringLong& l, size_t i) { return l.get(i); }); // Throws
+            break;
+        case StringColumn::leaf_type_Big:
+            size = load_strings(static_cast<const ArrayBigBlobs&>(*leaf), ndx_in_leaf, max_size,
+                                [](const ArrayBigBlobs& l, size_t i) { return l.get_string(i); }); // Throws
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+    values = m_values.data();
+    return size;
+}
+
+} // namespace realm
+
+#endif // REALM_COLUMN_CURSOR_HPP
@@ -53,6 +53,8 @@ public:
 
     void swap_rows(size_t, size_t) override = 0;
 
+    void move_last_rows_over(size_t, size_t, size_t, bool) override;
+
     virtual void do_nullify_link(size_t row_ndx, size_t old_target_row_ndx) = 0;
     virtual void do_update_link(size_t row_ndx, size_t old_target_row_ndx, size_t new_target_row_ndx) = 0;
     virtual void do_swap_link(size_t row_ndx, size_t target_row_ndx_1, size_t target_row_ndx_2) = 0;
@@ -133,6 +135,15 @@ inline void LinkColumnBase::set_backlink_column(BacklinkColumn& column) noexcept
     m_backlink_column = &column;
 }
 
+// Overriding virtual method of Column. The backlinks to each moved row must
+// be updated, so the rows are moved one at a time.
+inline void LinkColumnBase::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                                bool broken_reciprocal_backlinks)
+{
+    ColumnBase::move_last_rows_over(row_ndx, num_rows_to_erase, prior_num_rows,
+                                    broken_reciprocal_backlinks); // Throws
+}
+
 inline void LinkColumnBase::adj_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept
 {
     IntegerColumn::adj_acc_insert_rows(row_ndx, num_rows);
@@ -0,0 +1,231 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_COLUMN_STATISTICS_HPP
+#define REALM_COLUMN_STATISTICS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <realm/null.hpp>
+#include <realm/query_conditions.hpp>
+#include <realm/timestamp.hpp>
+#include <realm/util/optional.hpp>
+
+namespace realm {
+
+/// Approximate statistics of the values of a column, computed from a sample
+/// of rows spread over the whole column. The query engine uses them to estimate how many rows
+/// a condition matches before running it, and hence which condition should
+/// drive the search.
+///
+/// The sorted sample doubles as an equi-depth histogram with one value per
+/// bucket. The supported value types are `int64_t` (for integer, boolean and
+/// OldDateTime columns, nullable or not), `float`, `double`, and `Timestamp`.
+template <class T>
+class ColumnStatistics {
+public:
+    /// The largest number of rows that sample() reads.
+    static const size_t max_sample_size = 256;
+
+    /// Sample the rows of \a column, replacing any previous sample. Columns
+    /// with at most `max_sample_size` rows are read in full, in which case the
+    /// statistics are exact.
+    template <class ColType>
+    void sample(const ColType& column);
+
+    /// The number of rows in the column when it was sampled.
+    size_t num_rows() const noexcept
+    {
+        return m_num_rows;
+    }
+
+    /// The number of rows that were read.
+    size_t sample_size() const noexcept
+    {
+        return m_values.size() + m_num_nulls;
+    }
+
+    /// The fraction of rows that are null.
+    double null_fraction() const noexcept;
+
+    /// The estimated number of distinct non-null values in the column.
+    double distinct_count() const noexcept
+    {
+        return m_distinct_count;
+    }
+
+    /// The estimated fraction of rows that match the condition `Cond` (such as
+    /// Equal or Greater) with the argument \a value, evaluated the way the
+    /// query nodes evaluate it. \a value has the type that the column returns
+    /// from `get()`, so null is `util::none` for nullable integer columns, the
+    /// null float for float and double columns, and a null Timestamp.
+    template <class Cond, class V>
+    double selectivity(V value) const;
+
+private:
+    std::vector<T> m_values; // The non-null values read, sorted
+    size_t m_num_nulls = 0;
+    size_t m_num_rows = 0;
+    double m_distinct_count = 0;
+
+    static bool unpack(int64_t v, int64_t& value) noexcept
+    {
+        value = v;
+        return true;
+    }
+    static bool unpack(util::Optional<int64_t> v, int64_t& value) noexcept
+    {
+        value = v ? *v : 0;
+        return bool(v);
+    }
+    template <class F>
+    static bool unpack(F v, F& value) noexcept
+    {
+        value = v;
+        return !null::is_null_float(v);
+    }
+    static bool unpack(Timestamp v, Timestamp& value) noexcept
+    {
+        value = v;
+        return !v.is_null();
+    }
+
+    // Orders the values, with any NaNs last
+    static bool less(int64_t a, int64_t b) noexcept
+    {
+        return a < b;
+    }
+    template <class F>
+    static bool less(F a, F b) noexcept
+    {
+        return a < b || (!std::isnan(a) && std::isnan(b));
+    }
+    static bool less(const Timestamp& a, const Timestamp& b) noexcept
+    {
+        return a < b;
+    }
+
+    void estimate_distinct_count();
+};
+
+
+// Implementation
+
+template <class T>
+const size_t ColumnStatistics<T>::max_sample_size;
+
+template <class T>
+template <class ColType>
+void ColumnStatistics<T>::sample(const ColType& column)
+{
+    m_values.clear();
+    m_num_nulls = 0;
+    m_num_rows = column.size();
+
+    size_t n = std::min(m_num_rows, size_t(max_sample_size));
+    m_values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        // One row from each of n equally sized ranges. The row within the
+        // range is scattered, as evenly spaced rows can line up with a
+        // pattern in the data.
+        uint64_t begin = uint64_t(i) * m_num_rows / n;
+        uint64_t end = uint64_t(i + 1) * m_num_rows / n;
+        uint64_t scatter = (uint64_t(i) + 1) * 0x9E3779B97F4A7C15ULL;
+        size_t row_ndx = size_t(begin + (scatter >> 32) % (end - begin));
+        T value;
+        if (unpack(column.get(row_ndx), value))
+            m_values.push_back(value);
+        else
+            ++m_num_nulls;
+    }
+    std::sort(m_values.begin(), m_values.end(), [](const T& a, const T& b) { return less(a, b); });
+    estimate_distinct_count();
+}
+
+template <class T>
+double ColumnStatistics<T>::null_fraction() const noexcept
+{
+    size_t n = sample_size();
+    return n == 0 ? 0 : double(m_num_nulls) / n;
+}
+
+template <class T>
+void ColumnStatistics<T>::estimate_distinct_count()
+{
+    // Values that occur once in the sample stand for many values that were
+    // not read, values that occur more than once are likely to be common
+    // (the GEE estimator of Charikar et al.)
+    size_t distinct = 0;
+    size_t singletons = 0;
+    for (size_t i = 0; i < m_values.size();) {
+        size_t j = i + 1;
+        while (j < m_values.size() && !less(m_values[i], m_values[j]))
+            ++j;
+        ++distinct;
+        if (j - i == 1)
+            ++singletons;
+        i = j;
+    }
+
+    double num_values = m_num_rows * (1 - null_fraction());
+    if (m_values.empty() || sample_size() == m_num_rows) {
+        m_distinct_count = double(distinct);
+        return;
+    }
+    double scale = std::sqrt(num_values / m_values.size());
+    m_distinct_count = std::min(num_values, std::max(double(distinct), scale * singletons + (distinct - singletons)));
+}
+
+template <class T>
+template <class Cond, class V>
+double ColumnStatistics<T>::selectivity(V column_value) const
+{
+    size_t n = sample_size();
+    if (n == 0)
+        return 0;
+
+    T value;
+    bool value_is_null = !unpack(column_value, value);
+    Cond cond;
+    size_t matches = 0;
+    for (const T& v : m_values) {
+        if (cond(v, value, false, value_is_null))
+            ++matches;
+    }
+    if (m_num_nulls != 0 && cond(T{}, value, true, value_is_null))
+        matches += m_num_nulls;
+
+    if (matches != 0 || n == m_num_rows)
+        return double(matches) / n;
+
+    // Nothing matched in the sample, so fewer than one in n rows match. When
+    // there are many distinct values, a value that was not read is likely to
+    // be as rare as the average value.
+    double estimate = 0.5 / n;
+    if (Cond::condition == cond_Equal && m_distinct_count > 0)
+        estimate = std::min(estimate, (1 - null_fraction()) / m_distinct_count);
+    return estimate;
+}
+
+} // namespace realm
+
+#endif // REALM_COLUMN_STATISTICS_HPP
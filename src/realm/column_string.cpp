@@ -65,6 +65,29 @@ void copy_leaf(const ArrayStringLong& from, ArrayBigBlobs& to)
     }
 }
 
+
+class UnshareLeaf : public BpTreeNode::UpdateHandler {
+public:
+    UnshareLeaf(Allocator& alloc) noexcept
+        : m_alloc(alloc)
+    {
+    }
+    void update(MemRef mem, ArrayParent* parent, size_t ndx_in_parent, size_t) override
+    {
+        bool is_big = Array::get_hasrefs_from_header(mem.get_addr()) &&
+                      Array::get_context_flag_from_header(mem.get_addr());
+        if (!is_big)
+            return;
+        ArrayBigBlobs leaf(m_alloc, false);
+        leaf.init_from_mem(mem);
+        leaf.set_parent(parent, ndx_in_parent);
+        leaf.unshare_all(); // Throws
+    }
+
+private:
+    Allocator& m_alloc;
+};
+
 } // anonymous namespace
 
 
@@ -138,6 +161,42 @@ bool StringColumn::is_nullable() const noexcept
     return m_nullable;
 }
 
+
+bool StringColumn::is_deduplicated() const noexcept
+{
+    return m_deduplicated;
+}
+
+
+void StringColumn::set_deduplicated(bool value) noexcept
+{
+    m_deduplicated = value;
+}
+
+
+void StringColumn::unshare_all()
+{
+    m_owner_index.clear();
+
+    bool array_root_is_leaf = !m_array->is_inner_bptree_node();
+    if (array_root_is_leaf) {
+        bool is_big = m_array->has_refs() && m_array->get_context_flag();
+        if (is_big)
+            static_cast<ArrayBigBlobs*>(m_array.get())->unshare_all(); // Throws
+        return;
+    }
+
+    // Non-leaf root
+    UnshareLeaf unshare_leaf(m_array->get_alloc());
+    static_cast<BpTreeNode*>(m_array.get())->update_bptree_leaves(unshare_leaf); // Throws
+}
+
+
+ArrayBigBlobs::OwnerIndex* StringColumn::get_owner_index() noexcept
+{
+    return m_deduplicated ? &m_owner_index : nullptr;
+}
+
 StringData StringColumn::get(size_t ndx) const noexcept
 {
     REALM_ASSERT_DEBUG(ndx < size());
@@ -299,11 +358,13 @@ public:
     Allocator& m_alloc;
     const StringData m_value;
     bool m_nullable;
+    ArrayBigBlobs::OwnerIndex* m_owners;
 
-    SetLeafElem(Allocator& alloc, StringData value, bool nullable) noexcept
+    SetLeafElem(Allocator& alloc, StringData value, bool nullable, ArrayBigBlobs::OwnerIndex* owners) noexcept
         : m_alloc(alloc)
         , m_value(value)
         , m_nullable(nullable)
+        , m_owners(owners)
     {
     }
 
@@ -316,7 +377,7 @@ public:
                 ArrayBigBlobs leaf(m_alloc, m_nullable);
                 leaf.init_from_mem(mem);
                 leaf.set_parent(parent, ndx_in_parent);
-                leaf.set_string(elem_ndx_in_leaf, m_value); // Throws
+                leaf.set_string(elem_ndx_in_leaf, m_value, m_owners); // Throws
                 return;
             }
             ArrayStringLong leaf(m_alloc, m_nullable);
@@ -333,7 +394,7 @@ public:
             new_leaf.update_parent();                   // Throws
             copy_leaf(leaf, new_leaf);                  // Throws
             leaf.destroy();
-            new_leaf.set_string(elem_ndx_in_leaf, m_value); // Throws
+            new_leaf.set_string(elem_ndx_in_leaf, m_value, m_owners); // Throws
             return;
         }
         ArrayString leaf(m_alloc, m_nullable);
@@ -361,7 +422,7 @@ public:
         new_leaf.update_parent();  // Throws
         copy_leaf(leaf, new_leaf); // Throws
         leaf.destroy();
-        new_leaf.set_string(elem_ndx_in_leaf, m_value); // Throws
+        new_leaf.set_string(elem_ndx_in_leaf, m_value, m_owners); // Throws
     }
 };
 
@@ -399,14 +460,14 @@ void StringColumn::set(size_t ndx, StringData value)
             }
             case leaf_type_Big: {
                 ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-                leaf->set_string(ndx, value); // Throws
+                leaf->set_string(ndx, value, get_owner_index()); // Throws
                 return;
             }
         }
         REALM_ASSERT(false);
     }
 
-    SetLeafElem set_leaf_elem(m_array->get_alloc(), value, m_nullable);
+    SetLeafElem set_leaf_elem(m_array->get_alloc(), value, m_nullable, get_owner_index());
     static_cast<BpTreeNode*>(m_array.get())->update_bptree_elem(ndx, set_leaf_elem); // Throws
 }
 
@@ -465,7 +526,7 @@ public:
         size_t ndx = elem_ndx_in_leaf;
         if (ndx == npos)
             ndx = last_ndx;
-        leaf.erase(ndx); // Throws
+        leaf.erase(ndx, m_column.m_deduplicated); // Throws
         return false;
     }
     void destroy_leaf(MemRef leaf_mem) noexcept override
@@ -524,6 +585,12 @@ void StringColumn::do_erase(size_t ndx, bool is_last)
         m_search_index->erase<StringData>(ndx, is_last);
     }
 
+    erase_without_updating_index(ndx, is_last); // Throws
+}
+
+
+void StringColumn::erase_without_updating_index(size_t ndx, bool is_last)
+{
     bool array_root_is_leaf = !m_array->is_inner_bptree_node();
     if (array_root_is_leaf) {
         bool long_strings = m_array->has_refs();
@@ -542,7 +609,7 @@ void StringColumn::do_erase(size_t ndx, bool is_last)
         }
         // Big strings root leaf
         ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-        leaf->erase(ndx); // Throws
+        leaf->erase(ndx, m_deduplicated); // Throws
         return;
     }
 
@@ -608,14 +675,14 @@ void StringColumn::do_move_last_over(size_t row_ndx, size_t last_row_ndx)
         }
         // Big strings root leaf
         ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-        leaf->set_string(row_ndx, copy_of_value); // Throws
-        leaf->erase(last_row_ndx);                // Throws
+        leaf->set_string(row_ndx, copy_of_value, get_owner_index()); // Throws
+        leaf->erase(last_row_ndx, m_deduplicated);                   // Throws
         return;
     }
 
     // Non-leaf root
     BpTreeNode* node = static_cast<BpTreeNode*>(m_array.get());
-    SetLeafElem set_leaf_elem(node->get_alloc(), copy_of_value, m_nullable);
+    SetLeafElem set_leaf_elem(node->get_alloc(), copy_of_value, m_nullable, get_owner_index());
     node->update_bptree_elem(row_ndx, set_leaf_elem); // Throws
     EraseLeafElem erase_leaf_elem(*this, m_nullable);
     BpTreeNode::erase_bptree_elem(node, realm::npos, erase_leaf_elem); // Throws
@@ -657,6 +724,7 @@ void StringColumn::do_swap_rows(size_t row_ndx_1, size_t row_ndx_2)
 
 void StringColumn::do_clear()
 {
+    m_owner_index.clear();
     if (root_is_leaf()) {
         bool long_strings = m_array->has_refs();
         if (!long_strings) {
@@ -1097,7 +1165,7 @@ void StringColumn::bptree_insert(size_t row_ndx, StringData value, size_t num_ro
 {
     REALM_ASSERT(row_ndx == realm::npos || row_ndx < size());
     ref_type new_sibling_ref = 0;
-    BpTreeNode::TreeInsert<StringColumn> state;
+    InsertState state;
     for (size_t i = 0; i != num_rows; ++i) {
         size_t row_ndx_2 = row_ndx == realm::npos ? realm::npos : row_ndx + i;
         if (root_is_leaf()) {
@@ -1119,7 +1187,8 @@ void StringColumn::bptree_insert(size_t row_ndx, StringData value, size_t num_ro
                 case leaf_type_Big: {
                     // Big strings root leaf
                     ArrayBigBlobs* leaf = static_cast<ArrayBigBlobs*>(m_array.get());
-                    new_sibling_ref = leaf->bptree_leaf_insert_string(row_ndx_2, value, state); // Throws
+                    new_sibling_ref =
+                        leaf->bptree_leaf_insert_string(row_ndx_2, value, state, get_owner_index()); // Throws
                     break;
                 }
             }
@@ -1129,6 +1198,7 @@ void StringColumn::bptree_insert(size_t row_ndx, StringData value, size_t num_ro
             BpTreeNode* node = static_cast<BpTreeNode*>(m_array.get());
             state.m_value = value;
             state.m_nullable = m_nullable;
+            state.m_owners = get_owner_index();
             if (row_ndx_2 == realm::npos) {
                 new_sibling_ref = node->bptree_append(state); // Throws
             }
@@ -1148,6 +1218,7 @@ void StringColumn::bptree_insert(size_t row_ndx, StringData value, size_t num_ro
 ref_type StringColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t ndx_in_parent, Allocator& alloc,
                                    size_t insert_ndx, BpTreeNode::TreeInsert<StringColumn>& state)
 {
+    InsertState& state_2 = static_cast<InsertState&>(state);
     bool long_strings = Array::get_hasrefs_from_header(leaf_mem.get_addr());
     if (long_strings) {
         bool is_big = Array::get_context_flag_from_header(leaf_mem.get_addr());
@@ -1155,7 +1226,7 @@ ref_type StringColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t
             ArrayBigBlobs leaf(alloc, state.m_nullable);
             leaf.init_from_mem(leaf_mem);
             leaf.set_parent(&parent, ndx_in_parent);
-            return leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state); // Throws
+            return leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state, state_2.m_owners); // Throws
         }
         ArrayStringLong leaf(alloc, state.m_nullable);
         leaf.init_from_mem(leaf_mem);
@@ -1169,7 +1240,7 @@ ref_type StringColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t
         new_leaf.update_parent();  // Throws
         copy_leaf(leaf, new_leaf); // Throws
         leaf.destroy();
-        return new_leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state); // Throws
+        return new_leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state, state_2.m_owners); // Throws
     }
     ArrayString leaf(alloc, state.m_nullable);
     leaf.init_from_mem(leaf_mem);
@@ -1193,7 +1264,119 @@ ref_type StringColumn::leaf_insert(MemRef leaf_mem, ArrayParent& parent, size_t
     new_leaf.update_parent();  // Throws
     copy_leaf(leaf, new_leaf); // Throws
     leaf.destroy();
-    return new_leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state); // Throws
+    return new_leaf.bptree_leaf_insert_string(insert_ndx, state.m_value, state, state_2.m_owners); // Throws
+}
+
+
+struct StringColumn::LeafAttacher {
+    // The ref of an already populated leaf, and the number of elements in it
+    using value_type = std::pair<ref_type, size_t>;
+
+    // TreeTraits concept:
+    static ref_type leaf_insert(MemRef leaf_mem, ArrayParent&, size_t, Allocator& alloc, size_t,
+                                BpTreeNode::TreeInsert<LeafAttacher>& state)
+    {
+        // The new leaf always goes after the current last leaf, which is
+        // full, so this is a split where the new sibling holds all of the new
+        // elements. See BpTree::LeafAttacher.
+        size_t leaf_size = get_size_from_ref(leaf_mem.get_ref(), alloc);
+        state.m_split_offset = leaf_size;
+        state.m_split_size = leaf_size + state.m_value.second;
+        return state.m_value.first;
+    }
+};
+
+
+void StringColumn::bulk_append(size_t num_rows, const StringData* values)
+{
+    if (num_rows == 0)
+        return;
+
+    size_t column_size = size();
+    size_t last_leaf_size = column_size;
+    if (!root_is_leaf()) {
+        BpTreeNode* node = static_cast<BpTreeNode*>(m_array.get());
+        last_leaf_size = node->get_bptree_leaf(column_size - 1).second + 1;
+    }
+
+    // The last leaf may have to change type, so it is filled the usual way
+    size_t ndx = 0;
+    while (ndx < num_rows && last_leaf_size < REALM_MAX_BPNODE_SIZE) {
+        bptree_insert(realm::npos, values[ndx++], 1); // Throws
+        ++last_leaf_size;
+    }
+
+    Allocator& alloc = get_alloc();
+    while (ndx < num_rows) {
+        size_t leaf_size = std::min(num_rows - ndx, size_t(REALM_MAX_BPNODE_SIZE));
+        ref_type leaf_ref = create_leaf(values + ndx, leaf_size); // Throws
+        _impl::DeepArrayRefDestroyGuard dg(leaf_ref, alloc);
+
+        BpTreeNode::TreeInsert<LeafAttacher> state;
+        state.m_value = std::make_pair(leaf_ref, leaf_size);
+        ref_type new_sibling_ref;
+        if (root_is_leaf()) {
+            new_sibling_ref = leaf_ref;
+            state.m_split_offset = last_leaf_size;
+            state.m_split_size = last_leaf_size + leaf_size;
+        }
+        else {
+            BpTreeNode* node = static_cast<BpTreeNode*>(m_array.get());
+            new_sibling_ref = node->bptree_append(state); // Throws
+        }
+        if (new_sibling_ref) {
+            bool is_append = true;
+            introduce_new_root(new_sibling_ref, state, is_append); // Throws
+        }
+        dg.release();
+        ndx += leaf_size;
+        last_leaf_size = leaf_size;
+    }
+
+    // bptree_append() counted one element per attached leaf
+    if (!root_is_leaf())
+        static_cast<BpTreeNode*>(m_array.get())->update_bptree_size_of_last_branch(last_leaf_size); // Throws
+
+    if (m_search_index) {
+        bool is_append = true;
+        for (size_t i = 0; i < num_rows; ++i)
+            m_search_index->insert(column_size + i, values[i], 1, is_append); // Throws
+    }
+}
+
+
+ref_type StringColumn::create_leaf(const StringData* values, size_t num_values)
+{
+    size_t max_size = 0;
+    for (size_t i = 0; i < num_values; ++i)
+        max_size = std::max(max_size, values[i].size());
+
+    Allocator& alloc = get_alloc();
+    if (max_size <= small_string_max_size) {
+        ArrayString leaf(alloc, m_nullable);
+        leaf.create(); // Throws
+        _impl::DestroyGuard<ArrayString> dg(&leaf);
+        for (size_t i = 0; i < num_values; ++i)
+            leaf.add(values[i]); // Throws
+        dg.release();
+        return leaf.get_ref();
+    }
+    if (max_size <= medium_string_max_size) {
+        ArrayStringLong leaf(alloc, m_nullable);
+        leaf.create(); // Throws
+        _impl::DeepArrayDestroyGuard dg(&leaf);
+        for (size_t i = 0; i < num_values; ++i)
+            leaf.add(values[i]); // Throws
+        dg.release();
+        return leaf.get_ref();
+    }
+    ArrayBigBlobs leaf(alloc, m_nullable);
+    leaf.create(); // Throws
+    _impl::DeepArrayDestroyGuard dg(&leaf);
+    for (size_t i = 0; i < num_values; ++i)
+        leaf.add_string(values[i], get_owner_index()); // Throws
+    dg.release();
+    return leaf.get_ref();
 }
 
 
@@ -1415,6 +1598,9 @@ ref_type StringColumn::write(size_t slice_offset, size_t slice_size, size_t tabl
 void StringColumn::refresh_accessor_tree(size_t col_ndx, const Spec& spec)
 {
     ColumnBaseSimple::refresh_accessor_tree(col_ndx, spec);
+    ColumnAttr attr = spec.get_column_attr(col_ndx);
+    m_deduplicated = (attr & col_attr_Deduplicated) != 0;
+    m_owner_index.clear();
     refresh_root_accessor(); // Throws
 
     // Refresh search index
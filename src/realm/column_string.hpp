@@ -70,6 +70,12 @@ public:
     void swap_rows(size_t row_ndx_1, size_t row_ndx_2) override;
     void clear();
 
+    /// Append \a num_rows values to the end of the column. This is equivalent
+    /// to calling add() once per value, but only the room left in the last
+    /// leaf is filled one value at a time. The remaining values go into whole
+    /// new leaves, each of the smallest type that holds its longest string.
+    void bulk_append(size_t num_rows, const StringData* values);
+
     size_t count(StringData value) const;
     size_t find_first(StringData value, size_t begin = 0, size_t end = npos) const;
     void find_all(IntegerColumn& result, StringData value, size_t begin = 0, size_t end = npos) const;
@@ -89,6 +95,16 @@ public:
 
     bool is_nullable() const noexcept final;
 
+    /// Whether long strings stored from now on share storage with identical
+    /// strings in the same leaf. See ArrayBigBlobs.
+    bool is_deduplicated() const noexcept;
+    void set_deduplicated(bool) noexcept;
+
+    /// Give every value that shares storage a copy of its own. Only
+    /// deduplicated columns keep track of shared values, so this must be done
+    /// before deduplication is turned off.
+    void unshare_all();
+
     // Search index
     StringData get_index_data(size_t ndx, StringIndex::StringConversionBuffer& buffer) const noexcept final;
     bool has_search_index() const noexcept override;
@@ -144,6 +160,12 @@ public:
 private:
     std::unique_ptr<StringIndex> m_search_index;
     bool m_nullable;
+    bool m_deduplicated = false;
+    ArrayBigBlobs::OwnerIndex m_owner_index;
+
+    /// The owner index to pass to big blobs leaves, null unless the column
+    /// is deduplicated.
+    ArrayBigBlobs::OwnerIndex* get_owner_index() noexcept;
 
     LeafType get_block(size_t ndx, ArrayParent**, size_t& off, bool use_retval = false) const;
 
@@ -169,11 +191,21 @@ private:
     static ref_type leaf_insert(MemRef leaf_mem, ArrayParent&, size_t ndx_in_parent, Allocator&, size_t insert_ndx,
                                 BpTreeNode::TreeInsert<StringColumn>& state);
 
+    struct InsertState : BpTreeNode::TreeInsert<StringColumn> {
+        ArrayBigBlobs::OwnerIndex* m_owners;
+    };
+
     class EraseLeafElem;
     class CreateHandler;
     class SliceHandler;
+    struct LeafAttacher;
+
+    /// Create a leaf holding the specified values, of the smallest type that
+    /// holds the longest of them.
+    ref_type create_leaf(const StringData* values, size_t num_values);
 
     void do_erase(size_t row_ndx, bool is_last);
+    void erase_without_updating_index(size_t row_ndx, bool is_last);
     void do_move_last_over(size_t row_ndx, size_t last_row_ndx);
     void do_swap_rows(size_t row_ndx_1, size_t row_ndx_2);
     void do_clear();
@@ -350,9 +382,13 @@ inline void StringColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, s
     REALM_ASSERT(row_ndx <= prior_num_rows - num_rows_to_erase);
 
     bool is_last = (row_ndx + num_rows_to_erase == prior_num_rows);
+    // Update the search index for the whole range first, so that the
+    // following rows are renumbered only once
+    if (m_search_index)
+        m_search_index->erase_rows<StringData>(row_ndx, num_rows_to_erase, is_last); // Throws
     for (size_t i = num_rows_to_erase; i > 0; --i) {
         size_t row_ndx_2 = row_ndx + i - 1;
-        do_erase(row_ndx_2, is_last); // Throws
+        erase_without_updating_index(row_ndx_2, is_last); // Throws
     }
 }
 
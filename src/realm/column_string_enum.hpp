@@ -127,6 +127,7 @@ public:
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
+    void move_last_rows_over(size_t, size_t, size_t, bool) override;
     void clear(size_t, bool) override;
     void update_from_parent(size_t) noexcept override;
     void refresh_accessor_tree(size_t, const Spec&) override;
@@ -253,9 +254,13 @@ inline void StringEnumColumn::erase_rows(size_t row_ndx, size_t num_rows_to_eras
     REALM_ASSERT(row_ndx <= prior_num_rows - num_rows_to_erase);
 
     bool is_last = (row_ndx + num_rows_to_erase == prior_num_rows);
+    // Update the search index for the whole range first, so that the
+    // following rows are renumbered only once
+    if (m_search_index)
+        m_search_index->erase_rows<StringData>(row_ndx, num_rows_to_erase, is_last); // Throws
     for (size_t i = num_rows_to_erase; i > 0; --i) {
         size_t row_ndx_2 = row_ndx + i - 1;
-        do_erase(row_ndx_2, is_last); // Throws
+        erase_without_updating_index(row_ndx_2, is_last); // Throws
     }
 }
 
@@ -269,6 +274,15 @@ inline void StringEnumColumn::move_last_row_over(size_t row_ndx, size_t prior_nu
     do_move_last_over(row_ndx, last_row_ndx); // Throws
 }
 
+// Overriding virtual method of Column. The search index is over the strings
+// rather than the keys, so the rows are moved one at a time.
+inline void StringEnumColumn::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                                  bool broken_reciprocal_backlinks)
+{
+    ColumnBase::move_last_rows_over(row_ndx, num_rows_to_erase, prior_num_rows,
+                                    broken_reciprocal_backlinks); // Throws
+}
+
 // Overriding virtual method of Column.
 inline void StringEnumColumn::clear(size_t, bool)
 {
@@ -45,6 +45,7 @@ public:
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
+    void move_last_rows_over(size_t, size_t, size_t, bool) override;
     void clear(size_t, bool) override;
     void swap_rows(size_t, size_t) override;
     void discard_subtable_accessor(size_t) noexcept override;
@@ -314,6 +315,15 @@ inline void SubtableColumnBase::move_last_row_over(size_t row_ndx, size_t prior_
         tf::unbind_ptr(*m_table);
 }
 
+// Overriding virtual method of Column. The subtable accessors of each moved
+// row must be adjusted, so the rows are moved one at a time.
+inline void SubtableColumnBase::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                                    bool broken_reciprocal_backlinks)
+{
+    ColumnBase::move_last_rows_over(row_ndx, num_rows_to_erase, prior_num_rows,
+                                    broken_reciprocal_backlinks); // Throws
+}
+
 inline void SubtableColumnBase::clear(size_t, bool)
 {
     discard_child_accessors();
@@ -169,14 +169,14 @@ void TimestampColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_
                                  bool /*broken_reciprocal_backlinks*/)
 {
     bool is_last = (row_ndx + num_rows_to_erase) == size();
+    // Update search index
+    // (it is important here that we do it before actually setting
+    //  the value, or the index would not be able to find the correct
+    //  position to update (as it looks for the old value))
+    if (has_search_index()) {
+        m_search_index->erase_rows<StringData>(row_ndx, num_rows_to_erase, is_last); // Throws
+    }
     for (size_t i = 0; i < num_rows_to_erase; ++i) {
-        // Update search index
-        // (it is important here that we do it before actually setting
-        //  the value, or the index would not be able to find the correct
-        //  position to update (as it looks for the old value))
-        if (has_search_index()) {
-            m_search_index->erase<StringData>(row_ndx + num_rows_to_erase - i - 1, is_last); // Throws
-        }
         m_seconds->erase(row_ndx + num_rows_to_erase - i - 1, is_last);     // Throws
         m_nanoseconds->erase(row_ndx + num_rows_to_erase - i - 1, is_last); // Throws
     }
@@ -202,6 +202,31 @@ void TimestampColumn::move_last_row_over(size_t row_ndx, size_t prior_num_rows,
     m_nanoseconds->move_last_over(row_ndx, last_row_ndx); // Throws
 }
 
+void TimestampColumn::move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                                          bool /*broken_reciprocal_backlinks*/)
+{
+    // Each row is moved once, directly to its final position
+    if (has_search_index()) {
+        bool is_last = true; // This tells StringIndex::erase_rows() to not adjust subsequent indexes
+        m_search_index->erase_rows<StringData>(row_ndx, num_rows_to_erase, is_last); // Throws
+        for_each_row_moved_over(row_ndx, num_rows_to_erase, prior_num_rows, [&](size_t from, size_t to) {
+            auto moved_value = get(from);
+            m_search_index->update_ref(moved_value, from, to); // Throws
+        });
+    }
+
+    for_each_row_moved_over(row_ndx, num_rows_to_erase, prior_num_rows, [&](size_t from, size_t to) {
+        m_seconds->set(to, m_seconds->get(from));         // Throws
+        m_nanoseconds->set(to, m_nanoseconds->get(from)); // Throws
+    });
+    bool is_last = true;
+    size_t new_size = prior_num_rows - num_rows_to_erase;
+    for (size_t i = prior_num_rows; i > new_size; --i) {
+        m_seconds->erase(i - 1, is_last);     // Throws
+        m_nanoseconds->erase(i - 1, is_last); // Throws
+    }
+}
+
 void TimestampColumn::clear(size_t num_rows, bool /*broken_reciprocal_backlinks*/)
 {
     REALM_ASSERT_EX(num_rows == m_seconds->size(), num_rows, m_seconds->size());
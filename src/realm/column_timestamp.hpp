@@ -19,6 +19,8 @@
 #ifndef REALM_COLUMN_TIMESTAMP_HPP
 #define REALM_COLUMN_TIMESTAMP_HPP
 
+#include <limits>
+
 #include <realm/column.hpp>
 #include <realm/timestamp.hpp>
 
@@ -48,6 +50,8 @@ public:
     void erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
                     bool broken_reciprocal_backlinks) override;
     void move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks) override;
+    void move_last_rows_over(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
+                             bool broken_reciprocal_backlinks) override;
     void clear(size_t num_rows, bool broken_reciprocal_backlinks) override;
     void swap_rows(size_t row_ndx_1, size_t row_ndx_2) override;
     void destroy() noexcept override;
@@ -85,6 +89,10 @@ public:
     void leaf_to_dot(MemRef, ArrayParent*, size_t ndx_in_parent, std::ostream&) const override;
 
     void add(const Timestamp& ts = Timestamp{});
+    /// Append \a num_rows timestamps, where the i'th new row gets the value
+    /// `value_at(i)`. See Column::bulk_append().
+    template <class F>
+    void bulk_append(size_t num_rows, F value_at);
     Timestamp get(size_t row_ndx) const noexcept;
     void set(size_t row_ndx, const Timestamp& ts);
     bool compare(const TimestampColumn& c) const noexcept;
@@ -95,20 +103,11 @@ public:
     size_t count(Timestamp) const;
     void erase(size_t row_ndx, bool is_last);
 
+    /// Find the first row in [begin, end) for which `Condition()(get(row), value, ...)`
+    /// holds. The seconds and nanoseconds leaves are scanned in lockstep, and
+    /// the nanoseconds are only looked at when the seconds leave it open.
     template <class Condition>
-    size_t find(Timestamp value, size_t begin, size_t end) const noexcept
-    {
-        // FIXME: Here we can do all sorts of clever optimizations. Use bithack-search on seconds, then for each match
-        // check nanoseconds, etc. Lots of possibilities. Below code is naive and slow but works.
-
-        Condition cond;
-        for (size_t t = begin; t < end; t++) {
-            Timestamp ts = get(t);
-            if (cond(ts, value, ts.is_null(), value.is_null()))
-                return t;
-        }
-        return npos;
-    }
+    size_t find(Timestamp value, size_t begin, size_t end) const noexcept;
 
     typedef Timestamp value_type;
 
@@ -122,6 +121,10 @@ private:
     template <class BT>
     class CreateHandler;
 
+    template <class Condition>
+    static size_t find_in_leaves(const ArrayIntNull& seconds, size_t seconds_begin, const ArrayInteger& nanoseconds,
+                                 size_t nanoseconds_begin, size_t size, Timestamp value) noexcept;
+
     template <class Condition>
     Timestamp minmax(size_t* result_index) const noexcept
     {
@@ -150,6 +153,139 @@ private:
     }
 };
 
+template <class Condition>
+size_t TimestampColumn::find(Timestamp value, size_t begin, size_t end) const noexcept
+{
+    using SecondsTree = BpTree<util::Optional<int64_t>>;
+    using NanosecondsTree = BpTree<int64_t>;
+    SecondsTree::LeafType seconds_fallback(m_seconds->get_alloc());
+    NanosecondsTree::LeafType nanoseconds_fallback(m_nanoseconds->get_alloc());
+    const SecondsTree::LeafType* seconds = nullptr;
+    const NanosecondsTree::LeafType* nanoseconds = nullptr;
+    SecondsTree::LeafInfo seconds_info{&seconds, &seconds_fallback};
+    NanosecondsTree::LeafInfo nanoseconds_info{&nanoseconds, &nanoseconds_fallback};
+
+    for (size_t row_ndx = begin; row_ndx < end;) {
+        size_t seconds_ndx, nanoseconds_ndx;
+        m_seconds->get_leaf(row_ndx, seconds_ndx, seconds_info);
+        m_nanoseconds->get_leaf(row_ndx, nanoseconds_ndx, nanoseconds_info);
+        // The two trees do not necessarily split their leaves at the same rows
+        size_t size = std::min(end - row_ndx, std::min(seconds->size() - seconds_ndx,
+                                                       nanoseconds->size() - nanoseconds_ndx));
+        size_t ndx = find_in_leaves<Condition>(*seconds, seconds_ndx, *nanoseconds, nanoseconds_ndx, size, value);
+        if (ndx != npos)
+            return row_ndx + ndx;
+        row_ndx += size;
+    }
+    return npos;
+}
+
+template <class Condition>
+size_t TimestampColumn::find_in_leaves(const ArrayIntNull& seconds, size_t seconds_begin,
+                                       const ArrayInteger& nanoseconds, size_t nanoseconds_begin, size_t size,
+                                       Timestamp value) noexcept
+{
+    // The seconds are searched in the underlying integer array, where the
+    // rows start at index 1, with the width specific (bithack or SSE)
+    // Array::find_first(). Nulls are stored as null_value() there.
+    const Array& raw_seconds = seconds;
+    const Array& raw_nanoseconds = nanoseconds;
+    const int64_t null_seconds = seconds.null_value();
+    const size_t raw_begin = seconds_begin + 1;
+    const size_t raw_end = raw_begin + size;
+    Condition cond;
+
+    auto to_ndx = [&](size_t raw_ndx) { return raw_ndx == not_found ? npos : raw_ndx - raw_begin; };
+    auto matches = [&](size_t ndx) {
+        int64_t s = raw_seconds.get(raw_begin + ndx);
+        if (s == null_seconds)
+            return cond(Timestamp{}, value, true, value.is_null());
+        Timestamp ts(s, int32_t(raw_nanoseconds.get(nanoseconds_begin + ndx)));
+        return cond(ts, value, false, value.is_null());
+    };
+
+    if (value.is_null()) {
+        // Whether a row matches only depends on whether it is null
+        bool null_matches = cond(Timestamp{}, value, true, true);
+        bool non_null_matches = cond(Timestamp(0, 0), value, false, true);
+        if (null_matches && non_null_matches)
+            return 0;
+        if (null_matches)
+            return to_ndx(raw_seconds.find_first<Equal>(null_seconds, raw_begin, raw_end));
+        if (non_null_matches)
+            return to_ndx(raw_seconds.find_first<NotEqual>(null_seconds, raw_begin, raw_end));
+        return npos;
+    }
+
+    const int64_t target = value.get_seconds();
+    const bool equal = std::is_same<Condition, Equal>::value;
+    const bool not_equal = std::is_same<Condition, NotEqual>::value;
+    const bool greater = std::is_same<Condition, Greater>::value || std::is_same<Condition, GreaterEqual>::value;
+    const bool less = std::is_same<Condition, Less>::value || std::is_same<Condition, LessEqual>::value;
+
+    if (target == null_seconds || !(equal || not_equal || greater || less)) {
+        // The raw seconds cannot tell nulls from `target`
+        for (size_t ndx = 0; ndx < size; ++ndx) {
+            if (matches(ndx))
+                return ndx;
+        }
+        return npos;
+    }
+
+    if (not_equal) {
+        // Rows before the first one with other seconds (or null) can only
+        // differ in their nanoseconds
+        size_t ndx = to_ndx(raw_seconds.find_first<NotEqual>(target, raw_begin, raw_end));
+        size_t nanoseconds_end = nanoseconds_begin + (ndx == npos ? size : ndx);
+        size_t nanoseconds_ndx = raw_nanoseconds.find_first<NotEqual>(value.get_nanoseconds(), nanoseconds_begin,
+                                                                      nanoseconds_end);
+        return nanoseconds_ndx == not_found ? ndx : nanoseconds_ndx - nanoseconds_begin;
+    }
+
+    // Find the rows whose seconds allow a match, and check those in full.
+    // Candidates are rejected when they are null, or when the seconds are equal
+    // to `target` and the nanoseconds decide against them.
+    size_t ndx = 0;
+    while (ndx < size) {
+        size_t raw_ndx;
+        if (equal)
+            raw_ndx = raw_seconds.find_first<Equal>(target, raw_begin + ndx, raw_end);
+        else if (greater && target != std::numeric_limits<int64_t>::min())
+            raw_ndx = raw_seconds.find_first<Greater>(target - 1, raw_begin + ndx, raw_end);
+        else if (less && target != std::numeric_limits<int64_t>::max())
+            raw_ndx = raw_seconds.find_first<Less>(target + 1, raw_begin + ndx, raw_end);
+        else
+            raw_ndx = raw_seconds.find_first<NotEqual>(null_seconds, raw_begin + ndx, raw_end);
+        ndx = to_ndx(raw_ndx);
+        if (ndx == npos || matches(ndx))
+            return ndx;
+        ++ndx;
+    }
+    return npos;
+}
+
+template <class F>
+void TimestampColumn::bulk_append(size_t num_rows, F value_at)
+{
+    size_t column_size = size(); // Slow
+    m_seconds->bulk_append(num_rows, [&](size_t i) -> util::Optional<int64_t> {
+        Timestamp ts = value_at(i);
+        if (ts.is_null())
+            return util::none;
+        return ts.get_seconds();
+    }); // Throws
+    m_nanoseconds->bulk_append(num_rows, [&](size_t i) {
+        Timestamp ts = value_at(i);
+        return int64_t(ts.is_null() ? 0 : ts.get_nanoseconds());
+    }); // Throws
+
+    if (has_search_index()) {
+        bool is_append = true;
+        for (size_t i = 0; i < num_rows; ++i)
+            m_search_index->insert(column_size + i, value_at(i), 1, is_append); // Throws
+    }
+}
+
 } // namespace realm
 
 #endif // REALM_COLUMN_TIMESTAMP_HPP
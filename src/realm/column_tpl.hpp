@@ -24,6 +24,7 @@
 #include <realm/util/features.h>
 #include <realm/array.hpp>
 #include <realm/array_basic.hpp>
+#include <realm/impl/float_kernels.hpp>
 
 namespace realm {
 
@@ -61,6 +62,44 @@ struct ColumnTypeTraits2<cond, double> {
 
 namespace _impl {
 
+// Aggregates that only skip nulls are computed by the vectorized kernels in
+// impl/float_kernels.hpp, with the same result as QueryState<R>::match() on
+// each element, except for the rounding of sums. Counting is done in the
+// integer state (see Column<T>::average()).
+template <Action action, class Condition, class R>
+struct FloatKernelAggregate {
+    static const bool value = (std::is_same<Condition, None>::value || std::is_same<Condition, NotNull>::value) &&
+                              (action == act_Sum || action == act_Min || action == act_Max ||
+                               (action == act_Count && std::is_same<R, int64_t>::value));
+};
+
+template <Action action, class Condition, class T, class R>
+void float_kernel_aggregate(const T* data, size_t size, size_t index_offset, QueryState<R>& state) noexcept
+{
+    if (action == act_Count) {
+        size_t n = std::is_same<Condition, None>::value ? size : size - float_count_null(data, size);
+        state.m_state += static_cast<R>(n);
+        state.m_match_count = size_t(state.m_state);
+        return;
+    }
+    if (action == act_Sum) {
+        FloatSum sum;
+        float_sum(data, size, false, sum);
+        state.m_state += static_cast<R>(sum.sum);
+        state.m_match_count += sum.count;
+        return;
+    }
+    size_t ndx = action == act_Max ? float_find_max(data, size) : float_find_min(data, size);
+    state.m_match_count += size - float_count_null(data, size);
+    if (ndx != npos) {
+        R value = static_cast<R>(data[ndx]);
+        if (action == act_Max ? value > state.m_state : value < state.m_state) {
+            state.m_state = value;
+            state.m_minmax_index = index_offset + ndx;
+        }
+    }
+}
+
 template <class ColType>
 struct FindInLeaf {
     using LeafType = typename ColType::LeafType;
@@ -69,6 +108,15 @@ struct FindInLeaf {
     static bool find(const LeafType& leaf, T target, size_t local_start, size_t local_end, size_t leaf_start,
                      QueryState<R>& state)
     {
+        // The kernels can only be used if the limit cannot be reached in the
+        // middle of the leaf
+        if (FloatKernelAggregate<action, Condition, R>::value &&
+            state.m_limit - state.m_match_count >= local_end - local_start) {
+            float_kernel_aggregate<action, Condition>(leaf.data() + local_start, local_end - local_start,
+                                                      leaf_start + local_start, state);
+            return state.m_limit > state.m_match_count;
+        }
+
         Condition cond;
         bool cont = true;
         // todo, make an additional loop with hard coded `false` instead of is_null(v) for non-nullable columns
@@ -61,7 +61,11 @@ enum ColumnAttr {
     col_attr_StrongLinks = 8,
 
     /// Specifies that elements in the column can be null.
-    col_attr_Nullable = 16
+    col_attr_Nullable = 16,
+
+    /// Specifies that identical big values share storage. Applies only to
+    /// binary and string columns (`type_Binary` and `type_String`).
+    col_attr_Deduplicated = 32
 };
 
 
@@ -301,6 +301,25 @@ public:
     /// \param link_type The type of links the column should store.
     void set_link_type(size_t col_ndx, LinkType link_type);
 
+    /// Set whether identical values stored in the specified column should
+    /// share storage. Only values that are too big to be stored inline are
+    /// shared, and only between rows that reside in the same leaf of the
+    /// column, so the saving is greatest when equal values are added close to
+    /// each other. Turning deduplication on does not affect the values that
+    /// are already stored. Turning it off gives every value that shares
+    /// storage a copy of its own, which takes time linear in the number of
+    /// rows.
+    ///
+    /// Deduplicated columns require file format version 10, which older
+    /// versions of the core library refuse to open. A file using version 9 is
+    /// raised to it by the first column to be deduplicated. For files using
+    /// an earlier version, this function throws
+    /// `LogicError::old_file_format`.
+    ///
+    /// \param col_ndx The index of a column of type `type_Binary` or
+    /// `type_String`. Only columns of the root table can be deduplicated.
+    void set_deduplicated(size_t col_ndx, bool deduplicated = true);
+
     //@{
     /// Get the descriptor for the specified subtable column.
     ///
@@ -662,6 +681,23 @@ inline void Descriptor::set_link_type(size_t col_ndx, LinkType link_type)
     tf::set_link_type(*get_root_table(), col_ndx, link_type); // Throws
 }
 
+inline void Descriptor::set_deduplicated(size_t col_ndx, bool deduplicated)
+{
+    typedef _impl::TableFriend tf;
+
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(!is_root()))
+        throw LogicError(LogicError::wrong_kind_of_descriptor);
+    if (REALM_UNLIKELY(col_ndx >= get_column_count()))
+        throw LogicError(LogicError::column_index_out_of_range);
+    DataType type = get_column_type(col_ndx);
+    if (REALM_UNLIKELY(type != type_Binary && type != type_String))
+        throw LogicError(LogicError::illegal_type);
+
+    tf::set_deduplicated(*get_root_table(), col_ndx, deduplicated); // Throws
+}
+
 inline ConstDescriptorRef Descriptor::get_subdescriptor(size_t column_ndx) const
 {
     return const_cast<Descriptor*>(this)->get_subdescriptor(column_ndx);
@@ -91,6 +91,10 @@ const char* LogicError::what() const noexcept
             return "Column does not exist";
         case subtable_of_subtable_index:
             return "Search index on a subtable of a subtable is not yet supported";
+        case binary_position_out_of_range:
+            return "Binary position out of range";
+        case old_file_format:
+            return "Not supported by the file format of the Realm file";
     }
     return "Unknown error";
 }
@@ -231,7 +231,15 @@ public:
         column_does_not_exist,
 
         /// You can not add index on a subtable of a subtable
-        subtable_of_subtable_index
+        subtable_of_subtable_index,
+
+        /// A position within a binary value was beyond its end.
+        binary_position_out_of_range,
+
+        /// The operation requires a newer file format than the one used by
+        /// the Realm file, and the file was not upgraded when it was opened
+        /// (see Group::get_file_format_version()).
+        old_file_format
     };
 
     LogicError(ErrorKind message);
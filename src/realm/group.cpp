@@ -31,6 +31,7 @@
 #include <realm/util/miscellaneous.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/impl/destroy_guard.hpp>
+#include <realm/impl/parallel_writer.hpp>
 #include <realm/utilities.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/column_linkbase.hpp>
@@ -106,6 +107,11 @@ int Group::get_target_file_format_version_for_session(int current_file_format_ve
     // Please see Group::get_file_format_version() for information about the
     // individual file format versions.
 
+    // Version 10 is only reached by deduplicating a column (see
+    // Table::do_set_deduplicated()), and is kept from then on.
+    if (current_file_format_version == 10)
+        return 10;
+
     if (requested_history_type == Replication::hist_None && current_file_format_version == 6)
         return 6;
 
@@ -182,7 +188,7 @@ void Group::open(ref_type top_ref, const std::string& file_path)
     bool file_format_ok = false;
     // In non-shared mode (Realm file opened via a Group instance) this version
     // of the core library is only able to open Realms using file format version
-    // 6, 7, 8 or 9. These versions can be read without an upgrade.
+    // 6, 7, 8, 9 or 10. These versions can be read without an upgrade.
     // Since a Realm file cannot be upgraded when opened in this mode
     // (we may be unable to write to the file), no earlier versions can be opened.
     // Please see Group::get_file_format_version() for information about the
@@ -195,6 +201,7 @@ void Group::open(ref_type top_ref, const std::string& file_path)
         case 7:
         case 8:
         case 9:
+        case 10:
             file_format_ok = true;
             break;
     }
@@ -704,15 +711,11 @@ public:
     }
     ref_type write_tables(_impl::OutputStream& out) override
     {
-        bool deep = true;                                           // Deep
-        bool only_if_modified = false;                              // Always
-        return m_group.m_tables.write(out, deep, only_if_modified); // Throws
+        return m_writer.write(m_group.m_tables.get_ref(), m_group.m_tables.get_alloc(), out); // Throws
     }
 
     HistoryInfo write_history(_impl::OutputStream& out) override
     {
-        bool deep = true;                                           // Deep
-        bool only_if_modified = false;                              // Always
         ref_type history_ref = _impl::GroupFriend::get_history_ref(m_group);
         HistoryInfo info;
         if (history_ref) {
@@ -729,17 +732,15 @@ public:
             }
             info.type = history_type;
             info.version = history_schema_version;
-            // FIXME: It's ugly that we have to instantiate a new array here,
-            // but it isn't obvious that Group should have history as a member.
-            Array history{const_cast<Allocator&>(_impl::GroupFriend::get_alloc(m_group))};
-            history.init_from_ref(history_ref);
-            info.ref = history.write(out, deep, only_if_modified); // Throws
+            Allocator& alloc = const_cast<Allocator&>(_impl::GroupFriend::get_alloc(m_group));
+            info.ref = m_writer.write(history_ref, alloc, out); // Throws
         }
         return info;
     }
 
 private:
     const Group& m_group;
+    _impl::ParallelArrayWriter m_writer; // Shares its threads between the tables and the history
 };
 
 void Group::write(std::ostream& out, bool pad) const
@@ -1261,12 +1262,14 @@ public:
         typedef _impl::TableFriend tf;
         if (m_table) {
             if (unordered) {
-                // Unordered insertion of multiple rows is not yet supported (and not
-                // yet needed).
-                REALM_ASSERT_EX((num_rows_to_insert == 1) || (num_rows_to_insert == 0), num_rows_to_insert);
-                size_t from_row_ndx = row_ndx;
-                size_t to_row_ndx = prior_num_rows;
-                tf::adj_acc_move_over(*m_table, from_row_ndx, to_row_ndx);
+                // This is the reverse of an unordered removal of multiple
+                // rows, which moves the last row over each of them, starting
+                // with the last one.
+                for (size_t i = 0; i < num_rows_to_insert; ++i) {
+                    size_t from_row_ndx = row_ndx + i;
+                    size_t to_row_ndx = prior_num_rows + i;
+                    tf::adj_acc_move_over(*m_table, from_row_ndx, to_row_ndx);
+                }
             }
             else {
                 tf::adj_acc_insert_rows(*m_table, row_ndx, num_rows_to_insert);
@@ -1283,13 +1286,14 @@ public:
     bool erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, bool unordered) noexcept
     {
         if (unordered) {
-            // Unordered removal of multiple rows is not yet supported (and not
-            // yet needed).
-            REALM_ASSERT_EX((num_rows_to_erase == 1) || (num_rows_to_erase == 0), num_rows_to_erase);
+            // The last row is moved over each of the removed rows, starting
+            // with the last one
             typedef _impl::TableFriend tf;
             if (m_table) {
-                size_t prior_last_row_ndx = prior_num_rows - 1;
-                tf::adj_acc_move_over(*m_table, prior_last_row_ndx, row_ndx);
+                for (size_t i = 0; i < num_rows_to_erase; ++i) {
+                    size_t prior_last_row_ndx = prior_num_rows - 1 - i;
+                    tf::adj_acc_move_over(*m_table, prior_last_row_ndx, row_ndx + num_rows_to_erase - 1 - i);
+                }
             }
         }
         else {
@@ -1450,6 +1454,11 @@ public:
         return true; // No-op
     }
 
+    bool set_binary_range(size_t, size_t, size_t, BinaryData) noexcept
+    {
+        return true; // No-op
+    }
+
     bool optimize_table() noexcept
     {
         return true; // No-op
@@ -1609,6 +1618,12 @@ public:
         return true; // No-op
     }
 
+    bool set_deduplicated(size_t, bool) noexcept
+    {
+        // Column accessors pick up the new attribute when they are refreshed
+        return true; // No-op
+    }
+
     bool select_link_list(size_t col_ndx, size_t, size_t) noexcept
     {
         // See comments on link handling in TransactAdvancer::set_link().
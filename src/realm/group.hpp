@@ -240,6 +240,14 @@ public:
     /// Returns the number of tables in this group.
     size_t size() const noexcept;
 
+    /// Tell the kernel how the underlying Realm file is going to be accessed,
+    /// for example util::File::advice_Sequential before a large scan, or
+    /// util::File::advice_Random when only doing point lookups. The hint is
+    /// shared by all groups that map the same file, and has no effect for
+    /// groups attached to a buffer or to an encrypted file. See
+    /// SlabAlloc::set_access_hint().
+    void set_access_hint(util::File::Advice) const noexcept;
+
     /// \defgroup group_table_access Table Accessors
     ///
     /// has_table() returns true if, and only if this group contains a table
@@ -753,6 +761,12 @@ private:
     ///
     ///   9 Replication instruction values shuffled, instr_MoveRow added.
     ///
+    ///  10 Deduplicated binary and string columns (col_attr_Deduplicated),
+    ///     whose big blobs leaves may hold tagged indexes of the elements
+    ///     owning the blobs. Files are never upgraded to this version when
+    ///     they are opened. Instead, a version 9 file is raised to it when
+    ///     one of its columns is first deduplicated.
+    ///
     /// IMPORTANT: When introducing a new file format version, be sure to review
     /// the file validity checks in Group::open() and SharedGroup::do_open, the file
     /// format selection logic in
@@ -856,6 +870,11 @@ inline bool Group::is_attached() const noexcept
     return m_attached;
 }
 
+inline void Group::set_access_hint(util::File::Advice advice) const noexcept
+{
+    m_alloc.set_access_hint(advice);
+}
+
 inline bool Group::is_empty() const noexcept
 {
     if (!is_attached())
@@ -29,6 +29,7 @@
 #include <realm/util/features.h>
 #include <realm/util/errno.hpp>
 #include <realm/util/safe_int_ops.hpp>
+#include <realm/util/file_mapper.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/group_writer.hpp>
 #include <realm/group_shared.hpp>
@@ -39,6 +40,7 @@
 #include <realm/disable_sync_to_disk.hpp>
 
 #ifndef _WIN32
+#include <sched.h>
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <unistd.h>
@@ -76,7 +78,9 @@ const uint16_t relaxed_sync_threshold = 50;
 //  9      Fair write transactions requires an additional condition variable,
 //         `write_fairness`
 // 10      Introducing SharedInfo::history_schema_version.
-const uint_fast16_t g_shared_info_version = 10;
+// 11      Futex based condition variables on Linux.
+// 12      Striped reader counts in the ringbuffer entries.
+const uint_fast16_t g_shared_info_version = 12;
 
 // The following functions are carefully designed for minimal overhead
 // in case of contention among read transactions. In case of contention,
@@ -95,6 +99,15 @@ const uint_fast16_t g_shared_info_version = 10;
 // no one refers to that version, so it's free lists can be merged into
 // older free space and recycled.
 //
+// To keep readers on different CPUs from contending for a single cache line,
+// the count field is split into a number of stripes, each in a cache line of
+// its own. A reader adds to the stripe of the CPU it runs on, and releases
+// through whatever stripe it is on when it ends, so a stripe on its own may
+// go "negative" - only the sum of the stripes is the (doubled) number of
+// readers. The free flag is set in every stripe, and a stripe with the flag
+// set refuses new readers. So a version can be freed once the flag has been
+// set in all stripes and the sum of the stripes, minus the flags, is zero.
+//
 // Only write transactions allocate and write new version entries. Also,
 // Only write transactions scan the ringbuffer for older versions which
 // are not used (count is zero) and free them. As write transactions are
@@ -179,20 +192,28 @@ inline void atomic_double_dec(std::atomic<T>& counter)
 }
 
 template <typename T>
-bool atomic_one_if_zero(std::atomic<T>& counter)
+void atomic_dec(std::atomic<T>& counter)
 {
-    T old_val = counter.fetch_add(1, std::memory_order_acquire);
-    if (old_val != 0) {
-        counter.fetch_sub(1, std::memory_order_relaxed);
-        return false;
-    }
-    return true;
+    counter.fetch_sub(1, std::memory_order_release);
 }
 
-template <typename T>
-void atomic_dec(std::atomic<T>& counter)
+const int num_count_stripes = 16;
+
+// Get the count stripe used by the calling thread. On Linux, this follows the
+// CPU that the thread is running on. Elsewhere, threads are assigned stripes
+// round-robin.
+uint_fast32_t current_count_stripe() noexcept
 {
-    counter.fetch_sub(1, std::memory_order_release);
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+        return uint_fast32_t(cpu) % num_count_stripes;
+#endif
+    static std::atomic<uint32_t> next_stripe(0);
+    static REALM_THREAD_LOCAL uint32_t stripe_plus_one = 0;
+    if (stripe_plus_one == 0)
+        stripe_plus_one = next_stripe.fetch_add(1, std::memory_order_relaxed) % num_count_stripes + 1;
+    return stripe_plus_one - 1;
 }
 
 // nonblocking ringbuffer
@@ -200,13 +221,14 @@ class Ringbuffer {
 public:
     // the ringbuffer is a circular list of ReadCount structures.
     // Entries from old_pos to put_pos are considered live and may
-    // have an even value in 'count'. The count indicates the
-    // number of referring transactions times 2.
+    // have an even value in each count stripe. The sum of the stripes
+    // indicates the number of referring transactions times 2.
     // Entries from after put_pos up till (not including) old_pos
-    // are free entries and must have a count of ONE.
+    // are free entries and must have the free flag (an odd value) in
+    // every stripe.
     // Cleanup is performed by starting at old_pos and incrementing
-    // (atomically) from 0 to 1 and moving the put_pos. It stops
-    // if count is non-zero. This approach requires that only a single thread
+    // (atomically) every stripe by one and moving the put_pos. It stops
+    // if the sum of the stripes is non-zero. This approach requires that only a single thread
     // at a time tries to perform cleanup. This is ensured by doing the cleanup
     // as part of write transactions, where mutual exclusion is assured by the
     // write mutex.
@@ -214,12 +236,69 @@ public:
         uint64_t version;
         uint64_t filesize;
         uint64_t current_top;
-        // The count field acts as synchronization point for accesses to the above
+        uint32_t next;
+        uint32_t reserved;
+        // The count stripes act as synchronization point for accesses to the above
         // fields. A succesfull inc implies acquire with regard to memory consistency.
-        // Release is triggered by explicitly storing into count whenever a
+        // Release is triggered by explicitly storing into every stripe whenever a
         // new entry has been initialized.
-        mutable std::atomic<uint32_t> count;
-        uint32_t next;
+        struct CountStripe {
+            mutable std::atomic<uint32_t> count;
+            char padding[60]; // Keep each stripe in a cache line of its own
+        };
+        CountStripe stripes[num_count_stripes];
+
+        // Register a reader of this entry. Fails if the entry is free, or is
+        // being probed by cleanup().
+        bool acquire() const noexcept
+        {
+            return atomic_double_inc_if_even(stripes[current_count_stripe()].count);
+        }
+
+        // Unregister a reader of this entry. This may happen on a different
+        // thread, or even in a different process, than the one that called
+        // acquire().
+        void release() const noexcept
+        {
+            atomic_double_dec(stripes[current_count_stripe()].count);
+        }
+
+        // Set the free flag, but only if there are no readers.
+        bool free_if_unused() const noexcept
+        {
+            for (int i = 0; i < num_count_stripes; ++i)
+                stripes[i].count.fetch_add(1, std::memory_order_acquire);
+            // No reader can register now, so the sum can only decrease
+            uint32_t sum = 0;
+            for (int i = 0; i < num_count_stripes; ++i)
+                sum += stripes[i].count.load(std::memory_order_acquire) - 1;
+            if (sum == 0)
+                return true;
+            for (int i = 0; i < num_count_stripes; ++i)
+                stripes[i].count.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Clear the free flag, publishing the fields above to readers.
+        void make_available() noexcept
+        {
+            for (int i = 0; i < num_count_stripes; ++i)
+                atomic_dec(stripes[i].count); // .store_release(0);
+        }
+
+        void set_count(uint32_t value) noexcept
+        {
+            for (int i = 0; i < num_count_stripes; ++i)
+                stripes[i].count.store(value, std::memory_order_relaxed);
+        }
+
+        uint32_t get_count() const noexcept
+        {
+            uint32_t sum = 0;
+            for (int i = 0; i < num_count_stripes; ++i)
+                sum += stripes[i].count.load(std::memory_order_relaxed);
+            return sum;
+        }
     };
 
     Ringbuffer() noexcept
@@ -227,13 +306,14 @@ public:
         entries = init_readers_size;
         for (int i = 0; i < init_readers_size; i++) {
             data[i].version = 1;
-            data[i].count.store(1, std::memory_order_relaxed);
+            data[i].set_count(1);
             data[i].current_top = 0;
             data[i].filesize = 0;
             data[i].next = i + 1;
+            data[i].reserved = 0;
         }
         old_pos = 0;
-        data[0].count.store(0, std::memory_order_relaxed);
+        data[0].set_count(0);
         data[init_readers_size - 1].next = 0;
         put_pos.store(0, std::memory_order_release);
     }
@@ -243,13 +323,13 @@ public:
         uint_fast32_t i = old_pos;
         std::cout << "--- " << std::endl;
         while (i != put_pos.load()) {
-            std::cout << "  used " << i << " : " << data[i].count.load() << " | " << data[i].version << std::endl;
+            std::cout << "  used " << i << " : " << data[i].get_count() << " | " << data[i].version << std::endl;
             i = data[i].next;
         }
-        std::cout << "  LAST " << i << " : " << data[i].count.load() << " | " << data[i].version << std::endl;
+        std::cout << "  LAST " << i << " : " << data[i].get_count() << " | " << data[i].version << std::endl;
         i = data[i].next;
         while (i != old_pos) {
-            std::cout << "  free " << i << " : " << data[i].count.load() << " | " << data[i].version << std::endl;
+            std::cout << "  free " << i << " : " << data[i].get_count() << " | " << data[i].version << std::endl;
             i = data[i].next;
         }
         std::cout << "--- Done" << std::endl;
@@ -261,10 +341,11 @@ public:
         // dump();
         for (uint_fast32_t i = entries; i < new_entries; i++) {
             data[i].version = 1;
-            data[i].count.store(1, std::memory_order_relaxed);
+            data[i].set_count(1);
             data[i].current_top = 0;
             data[i].filesize = 0;
             data[i].next = i + 1;
+            data[i].reserved = 0;
         }
         data[new_entries - 1].next = old_pos;
         data[put_pos.load(std::memory_order_relaxed)].next = entries;
@@ -310,12 +391,12 @@ public:
     ReadCount& reinit_last() noexcept
     {
         ReadCount& r = data[last()];
-        // r.count is an atomic<> due to other usage constraints. Right here, we're
+        // The count stripes are atomic<> due to other usage constraints. Right here, we're
         // operating under mutex protection, so the use of an atomic store is immaterial
-        // and just forced on us by the type of r.count.
-        // You'll find the full discussion of how r.count is operated and why it must be
-        // an atomic earlier in this file.
-        r.count.store(0, std::memory_order_relaxed);
+        // and just forced on us by the type of the stripes.
+        // You'll find the full discussion of how the counts are operated and why they must be
+        // atomics earlier in this file.
+        r.set_count(0);
         return r;
     }
 
@@ -345,7 +426,7 @@ public:
 
     void use_next() noexcept
     {
-        atomic_dec(get_next().count); // .store_release(0);
+        get_next().make_available();
         put_pos.store(next(), std::memory_order_release);
     }
 
@@ -356,7 +437,7 @@ public:
         // dump();
         while (old_pos.load(std::memory_order_relaxed) != put_pos.load(std::memory_order_relaxed)) {
             const ReadCount& r = get(old_pos.load(std::memory_order_relaxed));
-            if (!atomic_one_if_zero(r.count))
+            if (!r.free_if_unused())
                 break;
             auto next_ndx = get(old_pos.load(std::memory_order_relaxed)).next;
             old_pos.store(next_ndx, std::memory_order_relaxed);
@@ -772,12 +853,13 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
     m_lockfile_path = path + ".lock";
     try_make_dir(m_coordination_dir);
     m_key = options.encryption_key;
+    m_vectored_writes = options.vectored_writes;
     m_lockfile_prefix = m_coordination_dir + "/access_control";
     SlabAlloc& alloc = m_group.m_alloc;
 
 #if REALM_METRICS
     if (options.enable_metrics) {
-        m_metrics = std::make_shared<Metrics>();
+        m_metrics = std::make_shared<Metrics>(options.metrics_buffer_size, options.metrics_description_threshold);
         m_group.set_metrics(m_metrics);
     }
 #endif // REALM_METRICS
@@ -1050,7 +1132,7 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
             bool file_format_ok = false;
             // In shared mode (Realm file opened via a SharedGroup instance) this
             // version of the core library is able to open Realms using file format
-            // versions from 2 to 9. Please see Group::get_file_format_version() for
+            // versions from 2 to 10. Please see Group::get_file_format_version() for
             // information about the individual file format versions.
             switch (current_file_format_version) {
                 case 0:
@@ -1064,6 +1146,7 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 case 7:
                 case 8:
                 case 9:
+                case 10:
                     file_format_ok = true;
                     break;
             }
@@ -1200,7 +1283,12 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 // we shall instead simply check that there is agreement, and
                 // throw the same kind of exception, as would have been thrown
                 // with a bumped SharedInfo file format version, if there isn't.
-                if (info->file_format_version != target_file_format_version) {
+                // The exception is a file that was raised to file format
+                // version 10 during the session (see
+                // Table::do_set_deduplicated()), which needs no upgrade.
+                bool raised_during_session = (target_file_format_version == current_file_format_version &&
+                                              target_file_format_version > info->file_format_version);
+                if (info->file_format_version != target_file_format_version && !raised_during_session) {
                     std::stringstream ss;
                     ss << "File format version deosn't match: " << info->file_format_version << " "
                        << target_file_format_version << ".";
@@ -1390,6 +1478,7 @@ bool SharedGroup::compact()
     new_options.durability = dura;
     new_options.encryption_key = m_key;
     new_options.allow_file_format_upgrade = false;
+    new_options.vectored_writes = m_vectored_writes;
     do_open(m_db_path, true, false, new_options);
     return true;
 }
@@ -1690,9 +1779,10 @@ void SharedGroup::upgrade_file_format(bool allow_file_format_upgrade,
         int current_file_format_version_2 = gf::get_committed_file_format_version(m_group);
         // The file must either still be using its initial file_format or have
         // been upgraded already to the chosen target file format via a
-        // concurrent SharedGroup object.
+        // concurrent SharedGroup object. It may also have been raised further
+        // by a deduplicated column (see Table::do_set_deduplicated()).
         REALM_ASSERT(current_file_format_version_2 == current_file_format_version ||
-                     current_file_format_version_2 == target_file_format_version);
+                     current_file_format_version_2 >= target_file_format_version);
         bool need_file_format_upgrade = (current_file_format_version_2 < target_file_format_version);
         if (need_file_format_upgrade) {
             if (!allow_file_format_upgrade)
@@ -1709,17 +1799,25 @@ void SharedGroup::upgrade_file_format(bool allow_file_format_upgrade,
             // If somebody else has already performed the upgrade, we still need
             // to inform the rest of the core library about the new file format
             // of the attached file.
-            gf::set_file_format_version(m_group, target_file_format_version);
+            gf::set_file_format_version(m_group, current_file_format_version_2);
         }
 
         // History schema upgrade
-        int current_hist_schema_version_2 = gf::get_history_schema_version(m_group);
+        version_type version = 0; // Unused
+        int stored_hist_type = 0;
+        int current_hist_schema_version_2 = 0;
+        gf::get_version_and_history_info(m_group.m_alloc, m_group.m_top.get_ref(), version, stored_hist_type,
+                                         current_hist_schema_version_2);
         // The history must either still be using its initial schema or have
         // been upgraded already to the chosen target schema version via a
         // concurrent SharedGroup object.
         REALM_ASSERT(current_hist_schema_version_2 == current_hist_schema_version ||
                      current_hist_schema_version_2 == target_hist_schema_version);
-        bool need_hist_schema_upgrade = (current_hist_schema_version_2 < target_hist_schema_version);
+        // A Realm without a history has no history schema to upgrade. Its
+        // history gets the target schema version when it is created (see
+        // Group::prepare_history_parent()).
+        bool need_hist_schema_upgrade = (stored_hist_type != Replication::hist_None &&
+                                         current_hist_schema_version_2 < target_hist_schema_version);
         if (need_hist_schema_upgrade) {
             if (!allow_file_format_upgrade)
                 throw FileFormatUpgradeRequired();
@@ -1750,7 +1848,7 @@ void SharedGroup::release_read_lock(ReadLockInfo& read_lock) noexcept
     grow_reader_mapping(read_lock.m_reader_idx);
     SharedInfo* r_info = m_reader_map.get_addr();
     const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
-    atomic_double_dec(r.count); // <-- most of the exec time spent here
+    r.release();
 }
 
 
@@ -1768,7 +1866,7 @@ void SharedGroup::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
             const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
             // if the entry is stale and has been cleared by the cleanup process,
             // we need to start all over again. This is extremely unlikely, but possible.
-            if (!atomic_double_inc_if_even(r.count)) // <-- most of the exec time spent here!
+            if (!r.acquire())
                 continue;
             read_lock.m_version = r.version;
             read_lock.m_top_ref = to_size_t(r.current_top);
@@ -1789,7 +1887,7 @@ void SharedGroup::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
 
         // if the entry is stale and has been cleared by the cleanup process,
         // the requested version is no longer available
-        while (!atomic_double_inc_if_even(r.count)) { // <-- most of the exec time spent here!
+        while (!r.acquire()) {
             // we failed to lock the version. This could be because the version
             // is being cleaned up, but also because the cleanup is probing for access
             // to it. If it's being probed, the tail ptr of the ringbuffer will point
@@ -1801,7 +1899,7 @@ void SharedGroup::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
         // we managed to lock an entry in the ringbuffer, but it may be so old that
         // the version doesn't match the specific request. In that case we must release and fail
         if (r.version != version_id.version) {
-            atomic_double_dec(r.count); // <-- release
+            r.release();
             throw BadVersion();
         }
         read_lock.m_version = r.version;
@@ -1980,6 +2078,201 @@ void SharedGroup::unpin_version(VersionID token)
     release_read_lock(read_lock);
 }
 
+
+namespace {
+
+// Layout of the stream written by SharedGroup::write_backup(). The header is
+// followed by `num_arrays` entries, each consisting of the ref and the byte
+// size of an array (two uint64_t), followed by the array itself. Entries are
+// ordered by ref. All integers are stored in native byte order.
+struct BackupHeader {
+    char magic[8];
+    uint64_t base_top_ref; // Zero for a full backup
+    uint64_t top_ref;
+    uint64_t logical_file_size;
+    uint64_t version;
+    uint64_t num_arrays;
+    uint64_t file_format;
+};
+
+const char backup_magic[8] = {'R', 'L', 'M', 'B', 'A', 'C', 'K', '1'};
+
+} // anonymous namespace
+
+void SharedGroup::write_backup(std::ostream& out, VersionID base, VersionID version)
+{
+    ReadLockInfo base_lock;
+    grab_read_lock(base_lock, base); // Throws
+    ReadLockUnlockGuard g_1(*this, base_lock);
+    ReadLockInfo version_lock;
+    grab_read_lock(version_lock, version); // Throws
+    ReadLockUnlockGuard g_2(*this, version_lock);
+    if (base_lock.m_version >= version_lock.m_version)
+        throw LogicError(LogicError::bad_version);
+
+    do_write_backup(out, &base_lock, version_lock); // Throws
+}
+
+void SharedGroup::write_backup(std::ostream& out, VersionID version)
+{
+    ReadLockInfo version_lock;
+    grab_read_lock(version_lock, version); // Throws
+    ReadLockUnlockGuard g(*this, version_lock);
+
+    do_write_backup(out, nullptr, version_lock); // Throws
+}
+
+void SharedGroup::do_write_backup(std::ostream& out, const ReadLockInfo* base, const ReadLockInfo& version)
+{
+    File file(m_db_path, File::mode_Read); // Throws
+    if (m_key)
+        file.set_encryption_key(m_key);
+    File::Map<char> map(file, File::access_ReadOnly, version.m_file_size); // Throws
+    auto translate = [&](ref_type ref, size_t size) {
+        REALM_ASSERT_RELEASE(ref + size <= version.m_file_size);
+        realm::util::encryption_read_barrier(map, ref, size);
+        return map.get_addr() + ref;
+    };
+    auto translate_array = [&](ref_type ref) {
+        const char* header = translate(ref, Array::header_size);
+        return translate(ref, Array::get_byte_size_from_header(header));
+    };
+
+    // The arrays of `version` that were written after `base` are exactly
+    // those that lie in the free space of `base`, or beyond its end, because
+    // the space used by a pinned version is never reused
+    std::vector<std::pair<ref_type, size_t>> base_free_space; // Sorted by ref
+    size_t base_file_size = 0;
+    if (base) {
+        const char* top = translate_array(base->m_top_ref);
+        base_file_size = to_size_t(Array::get(top, 2) / 2);
+        if (Array::get_size_from_header(top) >= 5) {
+            const char* positions = translate_array(to_ref(Array::get(top, 3)));
+            const char* lengths = translate_array(to_ref(Array::get(top, 4)));
+            size_t n = Array::get_size_from_header(positions);
+            base_free_space.reserve(n); // Throws
+            for (size_t i = 0; i < n; ++i)
+                base_free_space.emplace_back(to_ref(Array::get(positions, i)), to_size_t(Array::get(lengths, i)));
+        }
+    }
+    auto is_new = [&](ref_type ref) {
+        if (!base || ref >= base_file_size)
+            return true;
+        auto i = std::upper_bound(base_free_space.begin(), base_free_space.end(), ref,
+                                  [](ref_type r, const std::pair<ref_type, size_t>& c) { return r < c.first; });
+        if (i == base_free_space.begin())
+            return false;
+        --i;
+        return ref < i->first + i->second;
+    };
+
+    // A subtree that already existed in `base` is not visited
+    std::vector<std::pair<ref_type, size_t>> arrays;
+    std::vector<ref_type> stack = {version.m_top_ref};
+    while (!stack.empty()) {
+        ref_type ref = stack.back();
+        stack.pop_back();
+        if (!is_new(ref))
+            continue;
+        const char* header = translate_array(ref);
+        arrays.emplace_back(ref, Array::get_byte_size_from_header(header)); // Throws
+        if (Array::get_hasrefs_from_header(header)) {
+            size_t n = Array::get_size_from_header(header);
+            for (size_t i = 0; i < n; ++i) {
+                int_fast64_t value = Array::get(header, i);
+                // Null-refs and tagged integers are skipped
+                if (value != 0 && (value & 1) == 0)
+                    stack.push_back(to_ref(value)); // Throws
+            }
+        }
+    }
+    std::sort(arrays.begin(), arrays.end());
+
+    BackupHeader header;
+    std::copy(std::begin(backup_magic), std::end(backup_magic), header.magic);
+    header.base_top_ref = base ? base->m_top_ref : 0;
+    header.top_ref = version.m_top_ref;
+    header.logical_file_size = to_size_t(Array::get(translate_array(version.m_top_ref), 2) / 2);
+    header.version = version.m_version;
+    header.num_arrays = arrays.size();
+    header.file_format = uint64_t(m_group.get_file_format_version());
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    for (const auto& array : arrays) {
+        uint64_t entry[2] = {array.first, array.second};
+        out.write(reinterpret_cast<const char*>(entry), sizeof entry);
+        out.write(translate(array.first, array.second), array.second);
+    }
+    out.flush();
+    if (!out)
+        throw std::runtime_error("Failed to write backup");
+}
+
+void SharedGroup::restore_backup(const std::string& path, std::istream& in, const char* encryption_key)
+{
+    auto read = [&](void* data, size_t size) {
+        in.read(static_cast<char*>(data), std::streamsize(size));
+        if (in.gcount() != std::streamsize(size))
+            throw InvalidDatabase("Truncated backup", path);
+    };
+
+    BackupHeader header;
+    read(&header, sizeof header); // Throws
+    if (!std::equal(std::begin(backup_magic), std::end(backup_magic), header.magic))
+        throw InvalidDatabase("Not a backup", path);
+    bool full = header.base_top_ref == 0;
+
+    File file(path, full ? File::mode_Write : File::mode_Update); // Throws
+    if (encryption_key)
+        file.set_encryption_key(encryption_key);
+
+    // The new top ref goes into the slot that is not currently selected
+    SlabAlloc::Header file_header = SlabAlloc::empty_file_header;
+    int slot = 0;
+    if (!full) {
+        file.seek(0);                                                                    // Throws
+        size_t n = file.read(reinterpret_cast<char*>(&file_header), sizeof file_header); // Throws
+        if (n != sizeof file_header ||
+            !std::equal(std::begin(file_header.m_mnemonic), std::end(file_header.m_mnemonic),
+                        SlabAlloc::empty_file_header.m_mnemonic))
+            throw InvalidDatabase("Not a Realm file", path);
+        int current_slot = (file_header.m_flags & SlabAlloc::flags_SelectBit) != 0 ? 1 : 0;
+        if (file_header.m_top_ref[current_slot] != header.base_top_ref)
+            throw InvalidDatabase("Backup does not apply to the current version of the Realm file", path);
+        slot = 1 - current_slot;
+    }
+
+    if (uint64_t(file.get_size()) < header.logical_file_size)
+        file.resize(File::SizeType(header.logical_file_size)); // Throws
+    std::vector<char> buffer;
+    for (uint64_t i = 0; i < header.num_arrays; ++i) {
+        uint64_t entry[2];
+        read(entry, sizeof entry); // Throws
+        if (entry[0] + entry[1] > header.logical_file_size)
+            throw InvalidDatabase("Corrupt backup", path);
+        buffer.resize(to_size_t(entry[1]));       // Throws
+        read(buffer.data(), buffer.size());       // Throws
+        file.seek(File::SizeType(entry[0]));      // Throws
+        file.write(buffer.data(), buffer.size()); // Throws
+    }
+
+    // As in GroupWriter::commit(), the data and the new top ref must reach
+    // stable storage before the slot selector is flipped
+    bool disable_sync = get_disable_sync_to_disk();
+    file_header.m_top_ref[slot] = header.top_ref;
+    file_header.m_file_format[slot] = uint8_t(header.file_format);
+    file.seek(0);                                                                // Throws
+    file.write(reinterpret_cast<const char*>(&file_header), sizeof file_header); // Throws
+    if (!disable_sync)
+        file.sync(); // Throws
+    if (!full) {
+        file_header.m_flags = uint8_t(file_header.m_flags ^ SlabAlloc::flags_SelectBit);
+        file.seek(0);                                                                // Throws
+        file.write(reinterpret_cast<const char*>(&file_header), sizeof file_header); // Throws
+        if (!disable_sync)
+            file.sync(); // Throws
+    }
+}
+
 #if REALM_METRICS
 std::shared_ptr<Metrics> SharedGroup::get_metrics()
 {
@@ -1999,11 +2292,25 @@ void SharedGroup::do_begin_read(VersionID version_id, bool writable)
 
     using gf = _impl::GroupFriend;
     gf::attach_shared(m_group, m_read_lock.m_top_ref, m_read_lock.m_file_size, writable); // Throws
+    refresh_file_format_version();
 
     g.release();
 }
 
 
+void SharedGroup::refresh_file_format_version() noexcept
+{
+    // Another session participant may have raised the file format version by
+    // deduplicating a column (see Table::do_set_deduplicated()), and a rolled
+    // back transaction may have raised it for this one alone. The file format
+    // of an empty Realm is not decided until its first commit.
+    using gf = _impl::GroupFriend;
+    int file_format_version = gf::get_committed_file_format_version(m_group);
+    if (file_format_version != 0)
+        gf::set_file_format_version(m_group, file_format_version);
+}
+
+
 void SharedGroup::do_end_read() noexcept
 {
     REALM_ASSERT(m_read_lock.m_version != std::numeric_limits<version_type>::max());
@@ -2097,6 +2404,8 @@ void SharedGroup::finish_begin_write()
         throw std::runtime_error("Crash of other process detected, session restart required");
     }
 
+    refresh_file_format_version();
+
 #ifdef REALM_ASYNC_DAEMON
     if (info->durability == static_cast<uint16_t>(Durability::Async)) {
 
@@ -2228,13 +2537,13 @@ SharedGroup::version_type SharedGroup::get_version_of_latest_snapshot()
         // now (double) increment the read count so that no-one cleans up the entry
         // while we read it.
         const Ringbuffer::ReadCount& r = r_info->readers.get(index);
-        if (!atomic_double_inc_if_even(r.count)) {
+        if (!r.acquire()) {
 
             continue;
         }
         version_type version = r.version;
         // release the entry again:
-        atomic_double_dec(r.count);
+        r.release();
         return version;
     }
 }
@@ -2274,7 +2583,7 @@ void SharedGroup::low_level_commit(uint_fast64_t new_version)
     m_group.update_num_objects();
 #endif // REALM_METRICS
     // info->readers.dump();
-    GroupWriter out(m_group); // Throws
+    GroupWriter out(m_group, m_vectored_writes); // Throws
     out.set_versions(new_version, oldest_version);
     // Recursively write all changed arrays to end of file
     ref_type new_top_ref = out.write_group(); // Throws
@@ -20,6 +20,7 @@
 #define REALM_GROUP_SHARED_HPP
 
 #include <functional>
+#include <iosfwd>
 #include <limits>
 #include <realm/util/features.h>
 #include <realm/util/thread.hpp>
@@ -528,6 +529,29 @@ public:
     // Release pinned version (not thread safe)
     void unpin_version(VersionID version);
 
+    /// Write an incremental backup to the specified stream. When applied by
+    /// restore_backup() to a copy of the Realm file at version \a base, the
+    /// backup brings that copy up to version \a version. It contains only the
+    /// arrays of \a version that were written after \a base. These are found
+    /// from the free space of \a base, which is only reliable while \a base
+    /// is pinned, so both versions must be pinned (pin_version()), and \a base
+    /// must be the older one.
+    ///
+    /// The overload without \a base writes a full backup of \a version.
+    ///
+    /// The backup is not encrypted, even when the Realm file is.
+    void write_backup(std::ostream&, VersionID base, VersionID version);
+    void write_backup(std::ostream&, VersionID version);
+
+    /// Apply a backup produced by write_backup() to the Realm file at the
+    /// specified path. A full backup replaces the contents of the file, or
+    /// creates it. An incremental backup requires the file to be at the base
+    /// version of the backup. The file must not be open in any SharedGroup.
+    ///
+    /// \throw InvalidDatabase if the stream is not a valid backup, or if an
+    /// incremental backup does not apply to the current version of the file.
+    static void restore_backup(const std::string& path, std::istream&, const char* encryption_key = nullptr);
+
 #if REALM_METRICS
     std::shared_ptr<metrics::Metrics> get_metrics();
 #endif // REALM_METRICS
@@ -575,6 +599,7 @@ private:
     std::string m_db_path;
     std::string m_coordination_dir;
     const char* m_key;
+    bool m_vectored_writes = false;
     TransactStage m_transact_stage;
     util::InterprocessMutex m_writemutex;
 #ifdef REALM_ASYNC_DAEMON
@@ -627,6 +652,8 @@ private:
     // call to grab_read_lock().
     void release_read_lock(ReadLockInfo&) noexcept;
 
+    void do_write_backup(std::ostream&, const ReadLockInfo* base, const ReadLockInfo& version);
+
     void do_begin_read(VersionID, bool writable);
     void do_end_read() noexcept;
     /// return true if write transaction can commence, false otherwise.
@@ -683,6 +710,7 @@ private:
 
     /// finish up the process of starting a write transaction. Internal use only.
     void finish_begin_write();
+    void refresh_file_format_version() noexcept;
 
     void close_internal(std::unique_lock<InterprocessMutex>) noexcept;
     friend class _impl::SharedGroupFriend;
@@ -22,6 +22,8 @@
 #include <functional>
 #include <string>
 
+#include <realm/metrics/metrics.hpp>
+
 namespace realm {
 
 struct SharedGroupOptions {
@@ -45,7 +47,9 @@ struct SharedGroupOptions {
         , upgrade_callback(file_upgrade_callback)
         , temp_dir(temp_directory)
         , enable_metrics(track_metrics)
-
+        , metrics_buffer_size(metrics::Metrics::default_max_history_size)
+        , metrics_description_threshold(0)
+        , vectored_writes(false)
     {
     }
 
@@ -56,6 +60,9 @@ struct SharedGroupOptions {
         , upgrade_callback(std::function<void(int, int)>())
         , temp_dir(sys_tmp_dir)
         , enable_metrics(false)
+        , metrics_buffer_size(metrics::Metrics::default_max_history_size)
+        , metrics_description_threshold(0)
+        , vectored_writes(false)
     {
     }
 
@@ -95,6 +102,24 @@ struct SharedGroupOptions {
     /// A prerequisite is compiling with REALM_METRICS=ON.
     bool enable_metrics;
 
+    /// The maximum number of query records, and of transaction records, that
+    /// the metrics retain until they are taken. Further records are dropped,
+    /// but still counted in the latency histograms. Only relevant when \a
+    /// enable_metrics is set.
+    size_t metrics_buffer_size;
+
+    /// Only capture the description of queries that run for at least this
+    /// many seconds. Generating a description is expensive compared to running
+    /// a simple query. If zero, the description of every query is captured.
+    double metrics_description_threshold;
+
+    /// If set to `true`, commits transfer the changed parts of the database to
+    /// the file using vectored writes (`pwritev()` on Linux) in file order,
+    /// and flush them using `fdatasync()`, instead of writing through memory
+    /// mappings and syncing each of them. This avoids page faults on freshly
+    /// mapped regions during commit. It has no effect on encrypted files.
+    bool vectored_writes;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating SharedGroupOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <limits>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -151,7 +152,7 @@ void GroupWriter::MapWindow::encryption_write_barrier(void* start_addr, size_t s
 }
 
 
-GroupWriter::GroupWriter(Group& group)
+GroupWriter::GroupWriter(Group& group, bool vectored_writes)
     : m_group(group)
     , m_alloc(group.m_alloc)
     , m_free_positions(m_alloc)
@@ -159,6 +160,7 @@ GroupWriter::GroupWriter(Group& group)
     , m_free_versions(m_alloc)
     , m_current_version(0)
     , m_alloc_position(0)
+    , m_vectored_writes(vectored_writes && !m_alloc.get_file().get_encryption_key())
 {
     m_map_windows.reserve(num_map_windows);
 
@@ -292,6 +294,13 @@ ref_type GroupWriter::write_group()
     // that has been release during the current transaction (or since the last
     // commit), as that would lead to clobbering of the previous database
     // version.
+    //
+    // All the arrays that are about to be written live in the slabs of the
+    // allocator, so their total size is known up front, and can be reserved as
+    // contiguous extents
+    m_extent_budget = m_alloc.get_allocated_slab_size();
+    m_max_extent_size = std::numeric_limits<size_t>::max();
+
     bool deep = true, only_if_modified = true;
     ref_type names_ref = m_group.m_table_names.write(*this, deep, only_if_modified); // Throws
     ref_type tables_ref = m_group.m_tables.write(*this, deep, only_if_modified);     // Throws
@@ -317,6 +326,9 @@ ref_type GroupWriter::write_group()
         }
     }
 
+    release_extent(); // Throws
+    m_extent_budget = 0;
+
     // We now have a bit of a chicken-and-egg problem. We need to write the
     // free-lists to the file, but the act of writing them will consume free
     // space, and thereby change the free-lists. To solve this problem, we
@@ -470,9 +482,13 @@ ref_type GroupWriter::write_group()
 
     // The free-list now have their final form, so we can write them to the file
     // char* start_addr = m_file_map.get_addr() + reserve_ref;
-    MapWindow* window = get_window(reserve_ref, end_ref - reserve_ref);
-    char* start_addr = window->translate(reserve_ref);
-    window->encryption_read_barrier(start_addr, used);
+    MapWindow* window = nullptr;
+    char* start_addr = nullptr;
+    if (!m_vectored_writes) {
+        window = get_window(reserve_ref, end_ref - reserve_ref);
+        start_addr = window->translate(reserve_ref);
+        window->encryption_read_barrier(start_addr, used);
+    }
     write_array_at(window, free_positions_ref, m_free_positions.get_header(), free_positions_size); // Throws
     write_array_at(window, free_sizes_ref, m_free_lengths.get_header(), free_sizes_size);           // Throws
     if (is_shared) {
@@ -481,7 +497,12 @@ ref_type GroupWriter::write_group()
 
     // Write top
     write_array_at(window, top_ref, top.get_header(), top_byte_size); // Throws
-    window->encryption_write_barrier(start_addr, used);
+    if (window) {
+        window->encryption_write_barrier(start_addr, used);
+    }
+    else {
+        flush_pending_writes(); // Throws
+    }
     // Return top_ref so that it can be saved in lock file used for coordination
     return top_ref;
 }
@@ -548,8 +569,82 @@ size_t GroupWriter::get_free_space(size_t size)
 {
     REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
 
-    std::pair<size_t, size_t> p = reserve_free_space(size);
+    std::pair<size_t, size_t> p = reserve_free_space(size); // Throws
+    return claim_free_space(p, size);                       // Throws
+}
+
+
+size_t GroupWriter::get_free_space_in_extent(size_t size)
+{
+    REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
+
+    if (size <= m_extent_end - m_extent_pos) {
+        size_t pos = m_extent_pos;
+        m_extent_pos += size;
+        return pos;
+    }
+
+    release_extent(); // Throws
+    if (size > m_extent_budget) {
+        // The estimate was exceeded
+        return get_free_space(size); // Throws
+    }
+
+    // An allocation cannot cross a section boundary, so an extent is never
+    // made larger than the last section of the file
+    size_t logical_file_size = to_size_t(m_group.m_top.get(2) / 2);
+    size_t last_pos = logical_file_size - 1;
+    size_t section_size = m_alloc.get_upper_section_boundary(last_pos) - m_alloc.get_lower_section_boundary(last_pos);
+    size_t extent_size = std::max(size, std::min(m_extent_budget, std::min(section_size, m_max_extent_size)));
+
+    // Prefer smaller extents over growing the file when the free space is
+    // fragmented. Only if the array itself fits nowhere must the file grow,
+    // and then it might as well grow by a whole extent.
+    std::pair<size_t, size_t> chunk;
+    size_t n = extent_size;
+    while (!search_free_space(n, chunk)) {
+        if (n == size) {
+            n = extent_size;
+            chunk = reserve_free_space(n); // Throws
+            break;
+        }
+        n = std::max(size, (n / 2) & ~size_t(7));
+        m_max_extent_size = n;
+    }
+    m_extent_pos = claim_free_space(chunk, n); // Throws
+    m_extent_end = m_extent_pos + n;
+    m_extent_budget -= n;
+    size_t pos = m_extent_pos;
+    m_extent_pos += size;
+    return pos;
+}
+
+
+void GroupWriter::release_extent()
+{
+    if (m_extent_pos == m_extent_end)
+        return;
+
+    // Merge the unused part with the following free chunk, which is usually
+    // what remains of the chunk the extent was taken from
+    size_t size = m_extent_end - m_extent_pos;
+    size_t ndx = m_free_positions.lower_bound_int(m_extent_end);
+    if (ndx < m_free_positions.size() && to_size_t(m_free_positions.get(ndx)) == m_extent_end) {
+        m_free_positions.set(ndx, m_extent_pos);                             // Throws
+        m_free_lengths.set(ndx, to_size_t(m_free_lengths.get(ndx)) + size); // Throws
+    }
+    else {
+        m_free_positions.insert(ndx, m_extent_pos); // Throws
+        m_free_lengths.insert(ndx, size);           // Throws
+        if (m_group.m_is_shared)
+            m_free_versions.insert(ndx, 0); // Throws
+    }
+    m_extent_pos = m_extent_end = 0;
+}
+
 
+size_t GroupWriter::claim_free_space(std::pair<size_t, size_t> p, size_t size)
+{
     bool is_shared = m_group.m_is_shared;
 
     // Claim space from identified chunk
@@ -643,10 +738,8 @@ std::pair<size_t, size_t> GroupWriter::search_free_space_in_part_of_freelist(siz
 }
 
 
-std::pair<size_t, size_t> GroupWriter::reserve_free_space(size_t size)
+bool GroupWriter::search_free_space(size_t size, std::pair<size_t, size_t>& chunk)
 {
-    typedef std::pair<size_t, size_t> Chunk;
-    Chunk chunk;
     bool found;
     size_t end = m_free_lengths.size();
     if (m_alloc_position >= end)
@@ -656,12 +749,23 @@ std::pair<size_t, size_t> GroupWriter::reserve_free_space(size_t size)
     if (!found) {
         chunk = search_free_space_in_part_of_freelist(size, 0, m_alloc_position, found);
     }
+    if (found)
+        m_alloc_position = chunk.first;
+    return found;
+}
+
+
+std::pair<size_t, size_t> GroupWriter::reserve_free_space(size_t size)
+{
+    typedef std::pair<size_t, size_t> Chunk;
+    Chunk chunk;
+    bool found = search_free_space(size, chunk);
     while (!found) {
         // No free space, so we have to extend the file.
         extend_free_space(size);
         // extending the file will add a new entry at the end of the freelist,
         // so search that particular entry
-        end = m_free_lengths.size();
+        size_t end = m_free_lengths.size();
         chunk = search_free_space_in_part_of_freelist(size, end - 1, end, found);
     }
     m_alloc_position = chunk.first;
@@ -727,10 +831,14 @@ std::pair<size_t, size_t> GroupWriter::extend_free_space(size_t requested_size)
 void GroupWriter::write(const char* data, size_t size)
 {
     // Get position of free space to write in (expanding file if needed)
-    size_t pos = get_free_space(size);
+    size_t pos = get_free_space_in_extent(size); // Throws
     REALM_ASSERT_3((pos & 0x7), ==, 0); // Write position should always be 64bit aligned
 
     // Write the block
+    if (m_vectored_writes) {
+        realm::safe_copy_n(data, size, stage_write(pos, size)); // Throws
+        return;
+    }
     MapWindow* window = get_window(pos, size);
     char* dest_addr = window->translate(pos);
     window->encryption_read_barrier(dest_addr, size);
@@ -742,10 +850,16 @@ void GroupWriter::write(const char* data, size_t size)
 ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checksum)
 {
     // Get position of free space to write in (expanding file if needed)
-    size_t pos = get_free_space(size);
+    size_t pos = get_free_space_in_extent(size); // Throws
     REALM_ASSERT_3((pos & 0x7), ==, 0); // Write position should always be 64bit aligned
 
     // Write the block
+    if (m_vectored_writes) {
+        char* dest_addr = stage_write(pos, size); // Throws
+        memcpy(dest_addr, &checksum, 4);
+        memcpy(dest_addr + 4, data + 4, size - 4);
+        return to_ref(pos);
+    }
     MapWindow* window = get_window(pos, size);
     char* dest_addr = window->translate(pos);
     window->encryption_read_barrier(dest_addr, size);
@@ -765,7 +879,7 @@ void GroupWriter::write_array_at(MapWindow* window, ref_type ref, const char* da
 
     REALM_ASSERT_3(pos + size, <=, to_size_t(m_group.m_top.get(2) / 2));
     // REALM_ASSERT_3(pos + size, <=, m_file_map.get_size());
-    char* dest_addr = window->translate(pos);
+    char* dest_addr = window ? window->translate(pos) : stage_write(ref, size); // Throws
 
     uint32_t dummy_checksum = 0x41414141UL; // "AAAA" in ASCII
     memcpy(dest_addr, &dummy_checksum, 4);
@@ -773,11 +887,67 @@ void GroupWriter::write_array_at(MapWindow* window, ref_type ref, const char* da
 }
 
 
+char* GroupWriter::stage_write(ref_type ref, size_t size)
+{
+    size_t offset = m_write_buffer.size();
+    if (offset != 0 && offset + size > max_pending_write_size) {
+        flush_pending_writes(); // Throws
+        offset = 0;
+    }
+    m_write_buffer.resize(offset + size);            // Throws
+    m_pending_writes.push_back({ref, offset, size}); // Throws
+    return m_write_buffer.data() + offset;
+}
+
+
+void GroupWriter::flush_pending_writes()
+{
+    if (m_pending_writes.empty())
+        return;
+
+    // Chunks are allocated from the free-lists in no particular order, so sort
+    // them to let the file layer coalesce adjacent ones
+    std::sort(m_pending_writes.begin(), m_pending_writes.end(),
+              [](const PendingWrite& a, const PendingWrite& b) { return a.ref < b.ref; });
+    std::vector<File::WriteSlice> slices;
+    slices.reserve(m_pending_writes.size()); // Throws
+    for (const PendingWrite& w : m_pending_writes)
+        slices.push_back({File::SizeType(w.ref), m_write_buffer.data() + w.offset, w.size});
+    m_alloc.get_file().write_at(slices.data(), slices.size()); // Throws
+
+    m_pending_writes.clear();
+    m_write_buffer.clear();
+}
+
+
 void GroupWriter::commit(ref_type new_top_ref)
 {
-    MapWindow* window = get_window(0, sizeof(SlabAlloc::Header));
-    SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(window->translate(0));
-    window->encryption_read_barrier(&file_header, sizeof file_header);
+    // With vectored writes, the header is read into memory, and written back
+    // in place, rather than being modified through a memory mapping
+    MapWindow* window = nullptr;
+    SlabAlloc::Header header_copy;
+    SlabAlloc::Header* header_addr = &header_copy;
+    File& file = m_alloc.get_file();
+    if (m_vectored_writes) {
+        flush_pending_writes(); // Throws
+        size_t n = file.read_at(0, reinterpret_cast<char*>(&header_copy), sizeof header_copy); // Throws
+        REALM_ASSERT_RELEASE(n == sizeof header_copy);
+    }
+    else {
+        window = get_window(0, sizeof(SlabAlloc::Header));
+        header_addr = reinterpret_cast<SlabAlloc::Header*>(window->translate(0));
+        window->encryption_read_barrier(header_addr, sizeof *header_addr);
+    }
+    SlabAlloc::Header& file_header = *header_addr;
+    auto write_header = [&] {
+        if (window) {
+            window->encryption_write_barrier(&file_header, sizeof file_header);
+        }
+        else {
+            File::WriteSlice slice{0, reinterpret_cast<const char*>(&file_header), sizeof file_header};
+            file.write_at(&slice, 1); // Throws
+        }
+    };
 
     // One bit of the flags field selects which of the two top ref slots are in
     // use (same for file format version slots). The current value of the bit
@@ -803,9 +973,15 @@ void GroupWriter::commit(ref_type new_top_ref)
 
     // Make sure that that all data relating to the new snapshot is written to
     // stable storage before flipping the slot selector
-    window->encryption_write_barrier(&file_header, sizeof file_header);
-    if (!disable_sync)
-        sync_all_mappings();
+    write_header(); // Throws
+    if (!disable_sync) {
+        if (window) {
+            sync_all_mappings();
+        }
+        else {
+            file.sync_data(); // Throws
+        }
+    }
 
     // Flip the slot selector bit.
     using type_2 = std::remove_reference<decltype(file_header.m_flags)>::type;
@@ -813,9 +989,15 @@ void GroupWriter::commit(ref_type new_top_ref)
 
     // Write new selector to disk
     // FIXME: we might optimize this to write of a single page?
-    window->encryption_write_barrier(&file_header, sizeof file_header);
-    if (!disable_sync)
-        window->sync();
+    write_header(); // Throws
+    if (!disable_sync) {
+        if (window) {
+            window->sync();
+        }
+        else {
+            file.sync_data(); // Throws
+        }
+    }
 }
 
 
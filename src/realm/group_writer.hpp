@@ -50,7 +50,14 @@ public:
     // (Group::m_is_shared), the constructor also adds version tracking
     // information to the group, if it is not already present (6th and 7th entry
     // in Group::m_top).
-    GroupWriter(Group&);
+    //
+    // If \a vectored_writes is true, and the file is not encrypted, changed
+    // arrays are not copied into memory mappings of the file. Instead they are
+    // staged in memory and transferred to the file in position order using
+    // vectored writes (see util::File::write_at()), and commit() flushes them
+    // to stable storage using util::File::sync_data() rather than by syncing
+    // each of the memory mappings.
+    GroupWriter(Group&, bool vectored_writes = false);
     ~GroupWriter();
 
     void set_versions(uint64_t current, uint64_t read_lock) noexcept;
@@ -109,6 +116,26 @@ private:
     // Merge adjacent chunks
     void merge_free_space();
 
+    // write_group() packs the arrays, in the depth-first order in which they
+    // are written, into extents of contiguous free space, so that arrays that
+    // are close in the tree also end up close in the file. The current extent
+    // is [m_extent_pos, m_extent_end). m_extent_budget is the estimated
+    // amount of data that is yet to be written beyond the current extent.
+    // m_max_extent_size is lowered when no free chunk can hold an extent.
+    size_t m_extent_pos = 0;
+    size_t m_extent_end = 0;
+    size_t m_extent_budget = 0;
+    size_t m_max_extent_size = 0;
+
+    // Allocate a chunk of free space of the specified size from the current
+    // extent, or from a new one. If no free chunk is large enough for a new
+    // extent, smaller extents are tried, down to the size of the array, before
+    // the file is extended.
+    size_t get_free_space_in_extent(size_t size);
+
+    // Return the unused part of the current extent to the free-lists
+    void release_extent();
+
     /// Allocate a chunk of free space of the specified size. The
     /// specified size must be 8-byte aligned. Extend the file if
     /// required. The returned chunk is removed from the amount of
@@ -131,6 +158,15 @@ private:
     /// size, and `chunk_size` is the size of that chunk.
     std::pair<size_t, size_t> reserve_free_space(size_t size);
 
+    /// Same as reserve_free_space(), but returns false instead of extending
+    /// the file if no chunk is large enough.
+    bool search_free_space(size_t size, std::pair<size_t, size_t>& chunk);
+
+    /// Remove the specified number of bytes from the beginning of the
+    /// specified chunk (as returned by reserve_free_space()), and return the
+    /// position of the removed part.
+    size_t claim_free_space(std::pair<size_t, size_t> chunk, size_t size);
+
     /// Search only a range of the free list for a block as big as the
     /// specified size. Return a pair with index and size of the found chunk.
     /// \param found indicates whether a suitable block was found.
@@ -147,6 +183,29 @@ private:
     /// size, and `chunk_size` is the size of that chunk.
     std::pair<size_t, size_t> extend_free_space(size_t requested_size);
 
+    // Arrays staged for vectored writes. `offset` is the position of the data
+    // within m_write_buffer.
+    struct PendingWrite {
+        ref_type ref;
+        size_t offset;
+        size_t size;
+    };
+    bool m_vectored_writes;
+    std::vector<char> m_write_buffer;
+    std::vector<PendingWrite> m_pending_writes;
+
+    // The amount of staged data that causes the pending writes to be flushed
+    // before the end of write_group().
+    const static size_t max_pending_write_size = 0x1000000; // 16MB
+
+    // Reserve room for a chunk of the specified size in the staging buffer,
+    // and return its address. The address stays valid until the next call.
+    char* stage_write(ref_type ref, size_t size);
+
+    // Write the staged chunks to the file in position order.
+    void flush_pending_writes();
+
+    // Write to the specified window, or stage the write if `window` is null
     void write_array_at(MapWindow* window, ref_type, const char* data, size_t size);
     size_t split_freelist_chunk(size_t index, size_t start_pos, size_t alloc_pos, size_t chunk_size, bool is_shared);
 };
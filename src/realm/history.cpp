@@ -28,7 +28,16 @@ using namespace realm;
 namespace {
 
 // As new schema versions come into existsnece, describe them here.
-constexpr int g_history_schema_version = 0;
+//
+//  0  Initial version.
+//
+//  1  New instructions AddRowsBulk, SetBinaryRange, and SetDeduplicated. An
+//     unordered EraseRows instruction may remove more than one row, in which
+//     case the last row is moved over each of the removed rows, starting with
+//     the last one. Version 0 histories contain none of these, and their
+//     single row unordered removals mean the same in both versions, so they
+//     are upgraded as they are.
+constexpr int g_history_schema_version = 1;
 
 
 /// This class is a basis for implementing the Replication API for the purpose
@@ -270,17 +279,14 @@ public:
 
     bool is_upgradable_history_schema(int stored_schema_version) const noexcept override
     {
-        // Never called because only one schema version exists so far.
-        static_cast<void>(stored_schema_version);
-        REALM_ASSERT(false);
-        return false;
+        return stored_schema_version == 0;
     }
 
     void upgrade_history_schema(int stored_schema_version) override
     {
-        // Never called because only one schema version exists so far.
+        // The changesets of a version 0 history are valid in version 1
+        REALM_ASSERT(stored_schema_version == 0);
         static_cast<void>(stored_schema_version);
-        REALM_ASSERT(false);
     }
 
     _impl::History* get_history() override
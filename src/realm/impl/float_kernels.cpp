@@ -0,0 +1,792 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <cmath>
+#include <limits>
+
+#include <realm/impl/float_kernels.hpp>
+#include <realm/array.hpp>
+#include <realm/null.hpp>
+#include <realm/utilities.hpp>
+
+#ifdef REALM_COMPILER_SSE
+#include <emmintrin.h> // SSE2 is part of x86-64
+#endif
+
+// The AVX kernels are compiled for AVX through a function attribute, so that
+// the rest of the library does not depend on it. They are only called if
+// cpuid_init() has detected AVX support.
+#if defined(REALM_COMPILER_AVX) && (defined(__GNUC__) || defined(_MSC_VER))
+#define REALM_FLOAT_KERNELS_AVX 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define REALM_TARGET_AVX
+#else
+#define REALM_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+using namespace realm;
+using namespace realm::_impl;
+
+namespace {
+
+template <class T>
+inline bool is_null(T v) noexcept
+{
+    return null::is_null_float(v);
+}
+
+inline size_t first_set_bit(unsigned int mask) noexcept
+{
+    REALM_ASSERT_DEBUG(mask != 0);
+#if defined(__GNUC__)
+    return size_t(__builtin_ctz(mask));
+#else
+    size_t i = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+// Kahan summation. The compensation is reset when the sum stops being finite,
+// as it would otherwise turn an infinite sum into NaN.
+inline void kahan_add(FloatSum& state, double value) noexcept
+{
+    double y = value - state.compensation;
+    double t = state.sum + y;
+    state.compensation = std::isfinite(t) ? (t - state.sum) - y : 0;
+    state.sum = t;
+}
+
+template <class T>
+void sum_scalar(const T* data, size_t size, bool compensated, FloatSum& state) noexcept
+{
+    for (size_t i = 0; i < size; ++i) {
+        T v = data[i];
+        if (is_null(v))
+            continue;
+        if (compensated)
+            kahan_add(state, v);
+        else
+            state.sum += v;
+        ++state.count;
+    }
+}
+
+// Fold the per-lane sums of a vector kernel into `state`.
+void merge_lanes(const double* sums, const double* compensations, size_t num_lanes, bool compensated, bool nan,
+                 FloatSum& state) noexcept
+{
+    for (size_t i = 0; i < num_lanes; ++i) {
+        if (compensated) {
+            kahan_add(state, sums[i]);
+            kahan_add(state, -compensations[i]);
+        }
+        else {
+            state.sum += sums[i];
+        }
+    }
+    if (nan)
+        state.sum += std::numeric_limits<double>::quiet_NaN();
+}
+
+// Inspect the NaN lanes of a vector, as given by the bits of `nan_mask`.
+template <class T>
+inline void scan_nan_lanes(const T* data, unsigned int nan_mask, size_t& num_nulls, bool& nan) noexcept
+{
+    while (nan_mask != 0) {
+        size_t i = first_set_bit(nan_mask);
+        if (is_null(data[i]))
+            ++num_nulls;
+        else
+            nan = true;
+        nan_mask &= nan_mask - 1;
+    }
+}
+
+template <class T>
+size_t count_null_scalar(const T* data, size_t size) noexcept
+{
+    size_t n = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (is_null(data[i]))
+            ++n;
+    }
+    return n;
+}
+
+template <bool find_max, class T>
+inline bool better(T a, T b) noexcept
+{
+    return find_max ? a > b : a < b;
+}
+
+// Returns the smallest (largest) value, ignoring NaNs, or infinity (-infinity)
+// if there is none.
+template <bool find_max, class T>
+T minmax_scalar(const T* data, size_t size, T m) noexcept
+{
+    for (size_t i = 0; i < size; ++i) {
+        if (better<find_max>(data[i], m))
+            m = data[i];
+    }
+    return m;
+}
+
+template <class T>
+size_t find_value(const T* data, size_t size, T m) noexcept
+{
+    // NaN never compares equal, so if `m` is infinity, and there are only
+    // nulls and NaNs, nothing is found.
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == m)
+            return i;
+    }
+    return npos;
+}
+
+template <FloatCompare c, class T>
+inline bool compare(T v, T value) noexcept
+{
+    switch (c) {
+        case FloatCompare::equal:
+            return v == value;
+        case FloatCompare::not_equal:
+            return v != value;
+        case FloatCompare::less:
+            return v < value;
+        case FloatCompare::less_equal:
+            return v <= value;
+        case FloatCompare::greater:
+            return v > value;
+        case FloatCompare::greater_equal:
+            return v >= value;
+    }
+    REALM_UNREACHABLE();
+}
+
+template <FloatCompare c, class T>
+size_t find_first_scalar(const T* data, size_t begin, size_t end, T value) noexcept
+{
+    for (size_t i = begin; i < end; ++i) {
+        if (compare<c>(data[i], value))
+            return i;
+    }
+    return npos;
+}
+
+
+#ifdef REALM_COMPILER_SSE
+
+namespace sse2 {
+
+template <class T>
+struct Vec;
+
+template <>
+struct Vec<double> {
+    using type = __m128d;
+    static const size_t width = 2;
+
+    static type load(const double* p)
+    {
+        return _mm_loadu_pd(p);
+    }
+    static type set1(double v)
+    {
+        return _mm_set1_pd(v);
+    }
+    // Replace the NaN lanes of `x` with `fill`, and return the mask of the
+    // NaN lanes.
+    static unsigned int clear_nan(type& x, type fill)
+    {
+        type ord = _mm_cmpord_pd(x, x);
+        x = _mm_or_pd(_mm_and_pd(ord, x), _mm_andnot_pd(ord, fill));
+        return ~unsigned(_mm_movemask_pd(ord)) & 0x3;
+    }
+    static unsigned int nan_mask(type x)
+    {
+        return unsigned(_mm_movemask_pd(_mm_cmpunord_pd(x, x)));
+    }
+    template <bool find_max>
+    static type minmax(type a, type b)
+    {
+        return find_max ? _mm_max_pd(a, b) : _mm_min_pd(a, b);
+    }
+    template <FloatCompare c>
+    static unsigned int compare(type a, type b)
+    {
+        switch (c) {
+            case FloatCompare::equal:
+                return unsigned(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+            case FloatCompare::not_equal:
+                return unsigned(_mm_movemask_pd(_mm_cmpneq_pd(a, b)));
+            case FloatCompare::less:
+                return unsigned(_mm_movemask_pd(_mm_cmplt_pd(a, b)));
+            case FloatCompare::less_equal:
+                return unsigned(_mm_movemask_pd(_mm_cmple_pd(a, b)));
+            case FloatCompare::greater:
+                return unsigned(_mm_movemask_pd(_mm_cmpgt_pd(a, b)));
+            case FloatCompare::greater_equal:
+                return unsigned(_mm_movemask_pd(_mm_cmpge_pd(a, b)));
+        }
+        REALM_UNREACHABLE();
+    }
+    static void store(double* out, type x)
+    {
+        _mm_storeu_pd(out, x);
+    }
+};
+
+template <>
+struct Vec<float> {
+    using type = __m128;
+    static const size_t width = 4;
+
+    static type load(const float* p)
+    {
+        return _mm_loadu_ps(p);
+    }
+    static type set1(float v)
+    {
+        return _mm_set1_ps(v);
+    }
+    static unsigned int clear_nan(type& x, type fill)
+    {
+        type ord = _mm_cmpord_ps(x, x);
+        x = _mm_or_ps(_mm_and_ps(ord, x), _mm_andnot_ps(ord, fill));
+        return ~unsigned(_mm_movemask_ps(ord)) & 0xF;
+    }
+    static unsigned int nan_mask(type x)
+    {
+        return unsigned(_mm_movemask_ps(_mm_cmpunord_ps(x, x)));
+    }
+    template <bool find_max>
+    static type minmax(type a, type b)
+    {
+        return find_max ? _mm_max_ps(a, b) : _mm_min_ps(a, b);
+    }
+    template <FloatCompare c>
+    static unsigned int compare(type a, type b)
+    {
+        switch (c) {
+            case FloatCompare::equal:
+                return unsigned(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+            case FloatCompare::not_equal:
+                return unsigned(_mm_movemask_ps(_mm_cmpneq_ps(a, b)));
+            case FloatCompare::less:
+                return unsigned(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+            case FloatCompare::less_equal:
+                return unsigned(_mm_movemask_ps(_mm_cmple_ps(a, b)));
+            case FloatCompare::greater:
+                return unsigned(_mm_movemask_ps(_mm_cmpgt_ps(a, b)));
+            case FloatCompare::greater_equal:
+                return unsigned(_mm_movemask_ps(_mm_cmpge_ps(a, b)));
+        }
+        REALM_UNREACHABLE();
+    }
+    static void store(float* out, type x)
+    {
+        _mm_storeu_ps(out, x);
+    }
+};
+
+// Sums are accumulated in double precision lanes
+template <bool compensated>
+inline void accumulate(__m128d x, __m128d& sum, __m128d& comp)
+{
+    if (!compensated) {
+        sum = _mm_add_pd(sum, x);
+        return;
+    }
+    __m128d y = _mm_sub_pd(x, comp);
+    __m128d t = _mm_add_pd(sum, y);
+    __m128d finite = _mm_cmpeq_pd(_mm_sub_pd(t, t), _mm_setzero_pd());
+    comp = _mm_and_pd(_mm_sub_pd(_mm_sub_pd(t, sum), y), finite);
+    sum = t;
+}
+
+template <bool compensated>
+inline void accumulate(__m128d x, __m128d* sum, __m128d* comp)
+{
+    accumulate<compensated>(x, sum[0], comp[0]);
+}
+
+template <bool compensated>
+inline void accumulate(__m128 x, __m128d* sum, __m128d* comp)
+{
+    accumulate<compensated>(_mm_cvtps_pd(x), sum[0], comp[0]);
+    accumulate<compensated>(_mm_cvtps_pd(_mm_movehl_ps(x, x)), sum[1], comp[1]);
+}
+
+// Returns the number of values consumed, which is a multiple of the vector
+// width.
+template <bool compensated, class T>
+size_t sum(const T* data, size_t size, FloatSum& state) noexcept
+{
+    using V = Vec<T>;
+    __m128d sum[2] = {_mm_setzero_pd(), _mm_setzero_pd()};
+    __m128d comp[2] = {_mm_setzero_pd(), _mm_setzero_pd()};
+    typename V::type zero = V::set1(0);
+    size_t num_nulls = 0;
+    bool nan = false;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        typename V::type x = V::load(data + i);
+        if (unsigned int nan_mask = V::clear_nan(x, zero))
+            scan_nan_lanes(data + i, nan_mask, num_nulls, nan);
+        accumulate<compensated>(x, sum, comp);
+    }
+    double sums[4], compensations[4];
+    _mm_storeu_pd(sums, sum[0]);
+    _mm_storeu_pd(sums + 2, sum[1]);
+    _mm_storeu_pd(compensations, comp[0]);
+    _mm_storeu_pd(compensations + 2, comp[1]);
+    merge_lanes(sums, compensations, 4, compensated, nan, state);
+    state.count += i - num_nulls;
+    return i;
+}
+
+template <class T>
+size_t count_null(const T* data, size_t size, size_t& num_nulls) noexcept
+{
+    using V = Vec<T>;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        if (unsigned int nan_mask = V::nan_mask(V::load(data + i))) {
+            bool nan = false;
+            scan_nan_lanes(data + i, nan_mask, num_nulls, nan);
+        }
+    }
+    return i;
+}
+
+template <bool find_max, class T>
+size_t minmax(const T* data, size_t size, T& m) noexcept
+{
+    using V = Vec<T>;
+    typename V::type fill = V::set1(m);
+    typename V::type acc = fill;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        typename V::type x = V::load(data + i);
+        V::clear_nan(x, fill);
+        acc = V::template minmax<find_max>(acc, x);
+    }
+    T lanes[V::width];
+    V::store(lanes, acc);
+    m = minmax_scalar<find_max>(lanes, V::width, m);
+    return i;
+}
+
+template <FloatCompare c, class T>
+size_t find_first(const T* data, size_t begin, size_t end, T value) noexcept
+{
+    using V = Vec<T>;
+    typename V::type v = V::set1(value);
+    size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        if (unsigned int mask = V::template compare<c>(V::load(data + i), v))
+            return i + first_set_bit(mask);
+    }
+    return find_first_scalar<c>(data, i, end, value);
+}
+
+} // namespace sse2
+
+#endif // REALM_COMPILER_SSE
+
+
+#ifdef REALM_FLOAT_KERNELS_AVX
+
+// The same kernels as above, on 256-bit vectors. Everything in here must be
+// compiled with REALM_TARGET_AVX.
+namespace avx {
+
+template <class T>
+struct Vec;
+
+template <>
+struct Vec<double> {
+    using type = __m256d;
+    static const size_t width = 4;
+
+    REALM_TARGET_AVX static type load(const double* p)
+    {
+        return _mm256_loadu_pd(p);
+    }
+    REALM_TARGET_AVX static type set1(double v)
+    {
+        return _mm256_set1_pd(v);
+    }
+    REALM_TARGET_AVX static unsigned int clear_nan(type& x, type fill)
+    {
+        type ord = _mm256_cmp_pd(x, x, _CMP_ORD_Q);
+        x = _mm256_blendv_pd(fill, x, ord);
+        return ~unsigned(_mm256_movemask_pd(ord)) & 0xF;
+    }
+    REALM_TARGET_AVX static unsigned int nan_mask(type x)
+    {
+        return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(x, x, _CMP_UNORD_Q)));
+    }
+    template <bool find_max>
+    REALM_TARGET_AVX static type minmax(type a, type b)
+    {
+        return find_max ? _mm256_max_pd(a, b) : _mm256_min_pd(a, b);
+    }
+    template <FloatCompare c>
+    REALM_TARGET_AVX static unsigned int compare(type a, type b)
+    {
+        switch (c) {
+            case FloatCompare::equal:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+            case FloatCompare::not_equal:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)));
+            case FloatCompare::less:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+            case FloatCompare::less_equal:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)));
+            case FloatCompare::greater:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)));
+            case FloatCompare::greater_equal:
+                return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)));
+        }
+        REALM_UNREACHABLE();
+    }
+    REALM_TARGET_AVX static void store(double* out, type x)
+    {
+        _mm256_storeu_pd(out, x);
+    }
+};
+
+template <>
+struct Vec<float> {
+    using type = __m256;
+    static const size_t width = 8;
+
+    REALM_TARGET_AVX static type load(const float* p)
+    {
+        return _mm256_loadu_ps(p);
+    }
+    REALM_TARGET_AVX static type set1(float v)
+    {
+        return _mm256_set1_ps(v);
+    }
+    REALM_TARGET_AVX static unsigned int clear_nan(type& x, type fill)
+    {
+        type ord = _mm256_cmp_ps(x, x, _CMP_ORD_Q);
+        x = _mm256_blendv_ps(fill, x, ord);
+        return ~unsigned(_mm256_movemask_ps(ord)) & 0xFF;
+    }
+    REALM_TARGET_AVX static unsigned int nan_mask(type x)
+    {
+        return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(x, x, _CMP_UNORD_Q)));
+    }
+    template <bool find_max>
+    REALM_TARGET_AVX static type minmax(type a, type b)
+    {
+        return find_max ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+    }
+    template <FloatCompare c>
+    REALM_TARGET_AVX static unsigned int compare(type a, type b)
+    {
+        switch (c) {
+            case FloatCompare::equal:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+            case FloatCompare::not_equal:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ)));
+            case FloatCompare::less:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)));
+            case FloatCompare::less_equal:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)));
+            case FloatCompare::greater:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)));
+            case FloatCompare::greater_equal:
+                return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)));
+        }
+        REALM_UNREACHABLE();
+    }
+    REALM_TARGET_AVX static void store(float* out, type x)
+    {
+        _mm256_storeu_ps(out, x);
+    }
+};
+
+template <bool compensated>
+REALM_TARGET_AVX inline void accumulate(__m256d x, __m256d& sum, __m256d& comp)
+{
+    if (!compensated) {
+        sum = _mm256_add_pd(sum, x);
+        return;
+    }
+    __m256d y = _mm256_sub_pd(x, comp);
+    __m256d t = _mm256_add_pd(sum, y);
+    __m256d finite = _mm256_cmp_pd(_mm256_sub_pd(t, t), _mm256_setzero_pd(), _CMP_EQ_OQ);
+    comp = _mm256_and_pd(_mm256_sub_pd(_mm256_sub_pd(t, sum), y), finite);
+    sum = t;
+}
+
+template <bool compensated>
+REALM_TARGET_AVX inline void accumulate(__m256d x, __m256d* sum, __m256d* comp)
+{
+    accumulate<compensated>(x, sum[0], comp[0]);
+}
+
+template <bool compensated>
+REALM_TARGET_AVX inline void accumulate(__m256 x, __m256d* sum, __m256d* comp)
+{
+    accumulate<compensated>(_mm256_cvtps_pd(_mm256_castps256_ps128(x)), sum[0], comp[0]);
+    accumulate<compensated>(_mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)), sum[1], comp[1]);
+}
+
+template <bool compensated, class T>
+REALM_TARGET_AVX size_t sum(const T* data, size_t size, FloatSum& state) noexcept
+{
+    using V = Vec<T>;
+    __m256d sum[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+    __m256d comp[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+    typename V::type zero = V::set1(0);
+    size_t num_nulls = 0;
+    bool nan = false;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        typename V::type x = V::load(data + i);
+        if (unsigned int nan_mask = V::clear_nan(x, zero))
+            scan_nan_lanes(data + i, nan_mask, num_nulls, nan);
+        accumulate<compensated>(x, sum, comp);
+    }
+    double sums[8], compensations[8];
+    _mm256_storeu_pd(sums, sum[0]);
+    _mm256_storeu_pd(sums + 4, sum[1]);
+    _mm256_storeu_pd(compensations, comp[0]);
+    _mm256_storeu_pd(compensations + 4, comp[1]);
+    merge_lanes(sums, compensations, 8, compensated, nan, state);
+    state.count += i - num_nulls;
+    return i;
+}
+
+template <class T>
+REALM_TARGET_AVX size_t count_null(const T* data, size_t size, size_t& num_nulls) noexcept
+{
+    using V = Vec<T>;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        if (unsigned int nan_mask = V::nan_mask(V::load(data + i))) {
+            bool nan = false;
+            scan_nan_lanes(data + i, nan_mask, num_nulls, nan);
+        }
+    }
+    return i;
+}
+
+template <bool find_max, class T>
+REALM_TARGET_AVX size_t minmax(const T* data, size_t size, T& m) noexcept
+{
+    using V = Vec<T>;
+    typename V::type fill = V::set1(m);
+    typename V::type acc = fill;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        typename V::type x = V::load(data + i);
+        V::clear_nan(x, fill);
+        acc = V::template minmax<find_max>(acc, x);
+    }
+    T lanes[V::width];
+    V::store(lanes, acc);
+    m = minmax_scalar<find_max>(lanes, V::width, m);
+    return i;
+}
+
+template <FloatCompare c, class T>
+REALM_TARGET_AVX size_t find_first(const T* data, size_t begin, size_t end, T value) noexcept
+{
+    using V = Vec<T>;
+    typename V::type v = V::set1(value);
+    size_t i = begin;
+    for (; i + V::width <= end; i += V::width) {
+        if (unsigned int mask = V::template compare<c>(V::load(data + i), v))
+            return i + first_set_bit(mask);
+    }
+    return find_first_scalar<c>(data, i, end, value);
+}
+
+} // namespace avx
+
+#endif // REALM_FLOAT_KERNELS_AVX
+
+
+template <bool compensated, class T>
+void sum_dispatch(const T* data, size_t size, FloatSum& state) noexcept
+{
+    size_t i = 0;
+#ifdef REALM_FLOAT_KERNELS_AVX
+    if (sseavx<1>()) {
+        i = avx::sum<compensated>(data, size, state);
+    }
+    else
+#endif
+    {
+#ifdef REALM_COMPILER_SSE
+        i = sse2::sum<compensated>(data, size, state);
+#endif
+    }
+    sum_scalar(data + i, size - i, compensated, state);
+}
+
+template <class T>
+size_t count_null_dispatch(const T* data, size_t size) noexcept
+{
+    size_t num_nulls = 0;
+    size_t i = 0;
+#ifdef REALM_FLOAT_KERNELS_AVX
+    if (sseavx<1>()) {
+        i = avx::count_null(data, size, num_nulls);
+    }
+    else
+#endif
+    {
+#ifdef REALM_COMPILER_SSE
+        i = sse2::count_null(data, size, num_nulls);
+#endif
+    }
+    return num_nulls + count_null_scalar(data + i, size - i);
+}
+
+template <bool find_max, class T>
+size_t find_minmax_dispatch(const T* data, size_t size) noexcept
+{
+    T m = find_max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+    size_t i = 0;
+#ifdef REALM_FLOAT_KERNELS_AVX
+    if (sseavx<1>()) {
+        i = avx::minmax<find_max>(data, size, m);
+    }
+    else
+#endif
+    {
+#ifdef REALM_COMPILER_SSE
+        i = sse2::minmax<find_max>(data, size, m);
+#endif
+    }
+    m = minmax_scalar<find_max>(data + i, size - i, m);
+    return find_value(data, size, m);
+}
+
+template <FloatCompare c, class T>
+size_t find_first_dispatch(const T* data, size_t begin, size_t end, T value) noexcept
+{
+#ifdef REALM_FLOAT_KERNELS_AVX
+    if (sseavx<1>())
+        return avx::find_first<c>(data, begin, end, value);
+#endif
+#ifdef REALM_COMPILER_SSE
+    return sse2::find_first<c>(data, begin, end, value);
+#else
+    return find_first_scalar<c>(data, begin, end, value);
+#endif
+}
+
+template <class T>
+size_t find_first_dispatch(FloatCompare c, const T* data, size_t begin, size_t end, T value) noexcept
+{
+    REALM_ASSERT_DEBUG(!is_null(value));
+    switch (c) {
+        case FloatCompare::equal:
+            return find_first_dispatch<FloatCompare::equal>(data, begin, end, value);
+        case FloatCompare::not_equal:
+            return find_first_dispatch<FloatCompare::not_equal>(data, begin, end, value);
+        case FloatCompare::less:
+            return find_first_dispatch<FloatCompare::less>(data, begin, end, value);
+        case FloatCompare::less_equal:
+            return find_first_dispatch<FloatCompare::less_equal>(data, begin, end, value);
+        case FloatCompare::greater:
+            return find_first_dispatch<FloatCompare::greater>(data, begin, end, value);
+        case FloatCompare::greater_equal:
+            return find_first_dispatch<FloatCompare::greater_equal>(data, begin, end, value);
+    }
+    REALM_UNREACHABLE();
+}
+
+} // anonymous namespace
+
+
+namespace realm {
+namespace _impl {
+
+void float_sum(const float* data, size_t size, bool compensated, FloatSum& state) noexcept
+{
+    if (compensated)
+        sum_dispatch<true>(data, size, state);
+    else
+        sum_dispatch<false>(data, size, state);
+}
+
+void float_sum(const double* data, size_t size, bool compensated, FloatSum& state) noexcept
+{
+    if (compensated)
+        sum_dispatch<true>(data, size, state);
+    else
+        sum_dispatch<false>(data, size, state);
+}
+
+size_t float_count_null(const float* data, size_t size) noexcept
+{
+    return count_null_dispatch(data, size);
+}
+
+size_t float_count_null(const double* data, size_t size) noexcept
+{
+    return count_null_dispatch(data, size);
+}
+
+size_t float_find_min(const float* data, size_t size) noexcept
+{
+    return find_minmax_dispatch<false>(data, size);
+}
+
+size_t float_find_min(const double* data, size_t size) noexcept
+{
+    return find_minmax_dispatch<false>(data, size);
+}
+
+size_t float_find_max(const float* data, size_t size) noexcept
+{
+    return find_minmax_dispatch<true>(data, size);
+}
+
+size_t float_find_max(const double* data, size_t size) noexcept
+{
+    return find_minmax_dispatch<true>(data, size);
+}
+
+size_t float_find_first(FloatCompare c, const float* data, size_t begin, size_t end, float value) noexcept
+{
+    return find_first_dispatch(c, data, begin, end, value);
+}
+
+size_t float_find_first(FloatCompare c, const double* data, size_t begin, size_t end, double value) noexcept
+{
+    return find_first_dispatch(c, data, begin, end, value);
+}
+
+} // namespace _impl
+} // namespace realm
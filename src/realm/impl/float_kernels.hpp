@@ -0,0 +1,73 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_FLOAT_KERNELS_HPP
+#define REALM_IMPL_FLOAT_KERNELS_HPP
+
+#include <cstddef>
+
+namespace realm {
+namespace _impl {
+
+// Kernels over the unpacked values of float and double leaves
+// (BasicArray<T>). On x86-64 they use AVX when the CPU supports it (see
+// sseavx()), and SSE2 otherwise. Elsewhere they are plain loops.
+//
+// Null is stored as a quiet NaN with a particular payload (see
+// null::is_null_float()). The kernels skip nulls, but treat any other NaN as
+// a value, just like QueryState<R>::match() does.
+
+/// The running state of a sum over one or more arrays.
+struct FloatSum {
+    double sum = 0;
+    double compensation = 0; // Negated rounding error, for compensated sums
+    size_t count = 0;        // Number of non-null values
+};
+
+/// Add the non-null values in [data, data + size) to \a state. The values are
+/// added in several independent lanes, so the rounding differs from that of a
+/// sequential sum. With \a compensated, each lane, and the combination of the
+/// lanes with \a state, uses Kahan summation, such that the error does not
+/// grow with the number of values.
+void float_sum(const float* data, size_t size, bool compensated, FloatSum& state) noexcept;
+void float_sum(const double* data, size_t size, bool compensated, FloatSum& state) noexcept;
+
+/// The number of nulls in [data, data + size).
+size_t float_count_null(const float* data, size_t size) noexcept;
+size_t float_count_null(const double* data, size_t size) noexcept;
+
+/// The index of the first occurrence of the smallest, or largest, value in
+/// [data, data + size), ignoring nulls and NaNs. Returns `npos` if there are
+/// only nulls and NaNs.
+size_t float_find_min(const float* data, size_t size) noexcept;
+size_t float_find_min(const double* data, size_t size) noexcept;
+size_t float_find_max(const float* data, size_t size) noexcept;
+size_t float_find_max(const double* data, size_t size) noexcept;
+
+enum class FloatCompare { equal, not_equal, less, less_equal, greater, greater_equal };
+
+/// The index of the first element `v` in [data + begin, data + end) for which
+/// `v <op> value` holds, or `npos`. The comparisons are those of IEEE 754, so
+/// a NaN (and so a null) only matches `not_equal`. \a value must not be null.
+size_t float_find_first(FloatCompare, const float* data, size_t begin, size_t end, float value) noexcept;
+size_t float_find_first(FloatCompare, const double* data, size_t begin, size_t end, double value) noexcept;
+
+} // namespace _impl
+} // namespace realm
+
+#endif // REALM_IMPL_FLOAT_KERNELS_HPP
@@ -0,0 +1,198 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <realm/array.hpp>
+#include <realm/util/safe_int_ops.hpp>
+#include <realm/impl/destroy_guard.hpp>
+#include <realm/impl/parallel_writer.hpp>
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::_impl;
+
+
+ParallelArrayWriter::ParallelArrayWriter(size_t num_threads)
+    : m_num_threads(num_threads)
+    , m_next_ref(0)
+{
+    if (m_num_threads == 0)
+        m_num_threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+ref_type ParallelArrayWriter::write(ref_type ref, Allocator& alloc, OutputStream& out)
+{
+    // With a single thread, there is nothing to overlap, and the buffering
+    // would only cost
+    if (m_num_threads == 1) {
+        bool only_if_modified = false;
+        return Array::write(ref, alloc, out, only_if_modified); // Throws
+    }
+
+    m_out = &out;
+    m_next_ref = out.get_ref_of_next_array();
+    m_planned.clear();
+    m_inner_arrays.clear();
+    m_planned_size = 0;
+    m_num_filled = 0;
+    ref_type new_ref = plan(ref, alloc); // Throws
+    flush();                             // Throws
+    write_filled();                      // Throws
+    REALM_ASSERT_3(out.get_ref_of_next_array(), ==, m_next_ref);
+    return new_ref;
+}
+
+
+// Mirrors Array::do_write_deep() such that the produced layout is the same as
+// that of a single threaded write.
+ref_type ParallelArrayWriter::plan(ref_type ref, Allocator& alloc)
+{
+    Array array(alloc);
+    array.init_from_ref(ref);
+    if (!array.has_refs()) {
+        bool copy = false;
+        return add_planned(array.get_mem().get_addr(), array.get_byte_size(), copy); // Throws
+    }
+
+    Array new_array(Allocator::get_default());
+    Array::Type type = array.is_inner_bptree_node() ? Array::type_InnerBptreeNode : Array::type_HasRefs;
+    new_array.create(type, array.get_context_flag()); // Throws
+    ShallowArrayDestroyGuard dg(&new_array);
+
+    size_t n = array.size();
+    for (size_t i = 0; i < n; ++i) {
+        int_fast64_t value = array.get(i);
+        bool is_ref = (value != 0 && (value & 1) == 0);
+        if (is_ref)
+            value = from_ref(plan(to_ref(value), alloc)); // Throws
+        new_array.add(value);                             // Throws
+    }
+
+    // The rebuilt array is released when we return, so it must be copied
+    bool copy = true;
+    return add_planned(new_array.get_mem().get_addr(), new_array.get_byte_size(), copy); // Throws
+}
+
+
+ref_type ParallelArrayWriter::add_planned(const char* data, size_t size, bool copy)
+{
+    REALM_ASSERT(size % 8 == 0);
+
+    PlannedArray planned{data, 0, size};
+    if (copy) {
+        planned.data = nullptr;
+        planned.offset = m_inner_arrays.size();
+        m_inner_arrays.insert(m_inner_arrays.end(), data, data + size); // Throws
+    }
+    m_planned.push_back(planned); // Throws
+
+    ref_type ref = m_next_ref;
+    if (int_add_with_overflow_detect(m_next_ref, size))
+        throw std::runtime_error("Stream size overflow");
+
+    // The refs of the planned arrays are final, so they can be written out
+    // before the rest of the tree is planned. This bounds the memory used
+    // by the writer.
+    m_planned_size += size;
+    if (m_planned_size >= m_num_threads * batch_size)
+        flush(); // Throws
+    return ref;
+}
+
+
+void ParallelArrayWriter::flush()
+{
+    size_t n = m_planned.size();
+    size_t i = 0;
+    while (i < n) {
+        // Cut at most one batch per thread. The buffers of the batches that
+        // were written out last time are reused.
+        size_t num_batches = 0;
+        while (i < n && num_batches < m_num_threads) {
+            if (num_batches == m_filling.size())
+                m_filling.emplace_back(); // Throws
+            Batch& batch = m_filling[num_batches];
+            batch.begin = i;
+            size_t size = 0;
+            while (i < n && size < batch_size)
+                size += m_planned[i++].size;
+            batch.end = i;
+            batch.buffer.resize(size); // Throws
+            ++num_batches;
+        }
+
+        // The workers fill all but the first buffer, while the calling thread
+        // writes the previous batches to the stream, and then fills the first
+        // buffer. Filling a buffer cannot fail.
+        bool use_pool = num_batches > 1;
+        if (use_pool) {
+            if (!m_pool)
+                m_pool.reset(new WorkerPool(m_num_threads - 1)); // Throws
+            auto fill_batch = [this](size_t j) {
+                Batch& batch = m_filling[j + 1];
+                fill(batch.buffer.data(), batch.begin, batch.end);
+            };
+            m_pool->run(fill_batch, num_batches - 1); // Throws
+        }
+        try {
+            write_filled(); // Throws
+        }
+        catch (...) {
+            if (use_pool)
+                m_pool->wait();
+            throw;
+        }
+        fill(m_filling[0].buffer.data(), m_filling[0].begin, m_filling[0].end);
+        if (use_pool)
+            m_pool->wait();
+
+        std::swap(m_filled, m_filling);
+        m_num_filled = num_batches;
+    }
+
+    m_planned.clear();
+    m_inner_arrays.clear();
+    m_planned_size = 0;
+}
+
+
+void ParallelArrayWriter::write_filled()
+{
+    for (size_t i = 0; i < m_num_filled; ++i)
+        m_out->write(m_filled[i].buffer.data(), m_filled[i].buffer.size()); // Throws
+    m_num_filled = 0;
+}
+
+
+void ParallelArrayWriter::fill(char* buffer, size_t begin, size_t end) const noexcept
+{
+    // Same as Array::do_write_shallow()
+    uint32_t dummy_checksum = 0x41414141UL; // "AAAA" in ASCII
+    for (size_t i = begin; i < end; ++i) {
+        const PlannedArray& planned = m_planned[i];
+        const char* data = planned.data ? planned.data : m_inner_arrays.data() + planned.offset;
+        std::memcpy(buffer, &dummy_checksum, 4);
+        std::memcpy(buffer + 4, data + 4, planned.size - 4);
+        buffer += planned.size;
+    }
+}
@@ -0,0 +1,95 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_PARALLEL_WRITER_HPP
+#define REALM_IMPL_PARALLEL_WRITER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <realm/alloc.hpp>
+#include <realm/impl/output_stream.hpp>
+#include <realm/impl/worker_pool.hpp>
+
+namespace realm {
+namespace _impl {
+
+/// Writes array trees to an OutputStream in the same layout as a deep
+/// Array::write(), but copies the array payloads on several threads.
+///
+/// The tree is walked on the calling thread, which assigns the final ref of
+/// every array. It reads only the headers of leaves, and rebuilds the inner
+/// arrays with the new refs of their children. Whenever the arrays planned so
+/// far add up to one batch per thread, they are cut into batches of
+/// contiguous output, whose buffers are filled concurrently. Each round of
+/// batches is written to the stream, in order, while the next round is being
+/// filled. The memory used is therefore bounded by the batch size, and not by
+/// the size of the tree.
+///
+/// The worker threads are started the first time they are needed, and are
+/// reused by later batches and writes. With a single thread, this is the same
+/// as Array::write().
+class ParallelArrayWriter {
+public:
+    /// If \a num_threads is zero, one thread per hardware thread is used.
+    ParallelArrayWriter(size_t num_threads = 0);
+
+    /// Write the tree rooted at the specified ref to the specified stream, and
+    /// return the ref of the written root. All arrays are written, whether
+    /// modified or not.
+    ref_type write(ref_type, Allocator&, OutputStream&);
+
+    /// Output is cut into batches of at least this many bytes.
+    static const size_t batch_size = 4 * 1024 * 1024L;
+
+private:
+    struct PlannedArray {
+        const char* data; // Null if the array is held in `m_inner_arrays`
+        size_t offset;    // Into `m_inner_arrays`
+        size_t size;
+    };
+
+    struct Batch {
+        size_t begin, end; // Into `m_planned`
+        std::vector<char> buffer;
+    };
+
+    OutputStream* m_out = nullptr;
+    size_t m_num_threads;
+    ref_type m_next_ref;
+    std::vector<PlannedArray> m_planned;
+    std::vector<char> m_inner_arrays;
+    size_t m_planned_size = 0; // Bytes in `m_planned`
+    std::vector<Batch> m_filling; // Batches of the current round
+    std::vector<Batch> m_filled;  // The first `m_num_filled` are yet to be written
+    size_t m_num_filled = 0;
+    std::unique_ptr<WorkerPool> m_pool;
+
+    ref_type plan(ref_type, Allocator&);
+    ref_type add_planned(const char* data, size_t size, bool copy);
+    void flush();
+    void write_filled();
+    void fill(char* buffer, size_t begin, size_t end) const noexcept;
+};
+
+
+} // namespace _impl
+} // namespace realm
+
+#endif // REALM_IMPL_PARALLEL_WRITER_HPP
@@ -81,6 +81,9 @@ enum Instruction {
     instr_LinkListClear = 38,   // Ramove all entries from a link list
     instr_LinkListSetAll = 39,  // Assign to link list entry
     instr_AddRowWithKey = 40,   // Insert a row with a given key
+    instr_AddRowsBulk = 41,     // Append rows with values for some of their columns
+    instr_SetBinaryRange = 42,  // Overwrite part of a binary value, growing it as needed
+    instr_SetDeduplicated = 43, // Share storage of identical values in a column, or stop doing so
 };
 
 class TransactLogStream {
@@ -242,6 +245,10 @@ public:
     {
         return true;
     }
+    bool set_binary_range(size_t, size_t, size_t, BinaryData)
+    {
+        return true;
+    }
     bool optimize_table()
     {
         return true;
@@ -280,6 +287,10 @@ public:
     {
         return true;
     }
+    bool set_deduplicated(size_t, bool)
+    {
+        return true;
+    }
 
     // Must have linklist selected:
     bool link_list_set(size_t, size_t, size_t)
@@ -336,6 +347,7 @@ public:
     /// Must have table selected.
     bool insert_empty_rows(size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows, bool unordered);
     bool add_row_with_key(size_t row_ndx, size_t prior_num_rows, size_t key_col_ndx, int64_t key);
+    bool add_rows_bulk(size_t row_ndx, size_t num_rows, size_t prior_num_rows, const std::vector<BulkColumn>&);
     bool erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, bool unordered);
     bool swap_rows(size_t row_ndx_1, size_t row_ndx_2);
     bool move_row(size_t from_ndx, size_t to_ndx);
@@ -358,6 +370,7 @@ public:
     bool nullify_link(size_t col_ndx, size_t row_ndx, size_t target_group_level_ndx);
     bool insert_substring(size_t col_ndx, size_t row_ndx, size_t pos, StringData);
     bool erase_substring(size_t col_ndx, size_t row_ndx, size_t pos, size_t size);
+    bool set_binary_range(size_t col_ndx, size_t row_ndx, size_t pos, BinaryData);
     bool optimize_table();
 
     // Must have descriptor selected:
@@ -370,6 +383,7 @@ public:
     bool add_search_index(size_t col_ndx);
     bool remove_search_index(size_t col_ndx);
     bool set_link_type(size_t col_ndx, LinkType);
+    bool set_deduplicated(size_t col_ndx, bool deduplicated);
 
     // Must have linklist selected:
     bool link_list_set(size_t link_ndx, size_t value, size_t prior_size);
@@ -495,12 +509,15 @@ public:
     virtual void set_link_list(const LinkView&, const IntegerColumn& values);
     virtual void insert_substring(const Table*, size_t col_ndx, size_t row_ndx, size_t pos, StringData);
     virtual void erase_substring(const Table*, size_t col_ndx, size_t row_ndx, size_t pos, size_t size);
+    virtual void set_binary_range(const Table*, size_t col_ndx, size_t row_ndx, size_t pos, BinaryData);
 
     /// \param prior_num_rows The number of rows in the table prior to the
     /// modification.
     virtual void insert_empty_rows(const Table*, size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows);
     virtual void add_row_with_key(const Table* t, size_t row_ndx, size_t prior_num_rows, size_t key_col_ndx,
                                   int64_t key);
+    virtual void add_rows_bulk(const Table*, size_t row_ndx, size_t num_rows, size_t prior_num_rows,
+                               const std::vector<BulkColumn>&);
 
     /// \param prior_num_rows The number of rows in the table prior to the
     /// modification.
@@ -513,6 +530,7 @@ public:
     virtual void add_search_index(const Descriptor&, size_t col_ndx);
     virtual void remove_search_index(const Descriptor&, size_t col_ndx);
     virtual void set_link_type(const Table*, size_t col_ndx, LinkType);
+    virtual void set_deduplicated(const Table*, size_t col_ndx, bool deduplicated);
     virtual void clear_table(const Table*, size_t prior_num_rows);
     virtual void optimize_table(const Table*);
 
@@ -1423,6 +1441,20 @@ inline void TransactLogConvenientEncoder::erase_substring(const Table* t, size_t
     }
 }
 
+inline bool TransactLogEncoder::set_binary_range(size_t col_ndx, size_t row_ndx, size_t pos, BinaryData value)
+{
+    StringData value_2(value.data(), value.size());
+    append_simple_instr(instr_SetBinaryRange, col_ndx, row_ndx, pos, value_2); // Throws
+    return true;
+}
+
+inline void TransactLogConvenientEncoder::set_binary_range(const Table* t, size_t col_ndx, size_t row_ndx, size_t pos,
+                                                           BinaryData value)
+{
+    select_table(t);                                          // Throws
+    m_encoder.set_binary_range(col_ndx, row_ndx, pos, value); // Throws
+}
+
 inline bool TransactLogEncoder::insert_empty_rows(size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows,
                                                   bool unordered)
 {
@@ -1445,6 +1477,62 @@ inline bool TransactLogEncoder::add_row_with_key(size_t row_ndx, size_t prior_nu
     return true;
 }
 
+inline bool TransactLogEncoder::add_rows_bulk(size_t row_ndx, size_t num_rows, size_t prior_num_rows,
+                                              const std::vector<BulkColumn>& columns)
+{
+    // The values are stored column by column. Each column starts with its
+    // index, its type, and whether it contains any nulls. Only in the latter
+    // case is each value prefixed by a null flag.
+    append_simple_instr(instr_AddRowsBulk, row_ndx, num_rows, prior_num_rows, columns.size()); // Throws
+    for (const BulkColumn& values : columns) {
+        DataType type = values.get_type();
+        bool has_nulls = false;
+        for (size_t i = 0; i < num_rows && !has_nulls; ++i)
+            has_nulls = values.is_null(i);
+        append_simple_instr(values.get_column_index(), type, has_nulls); // Throws
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (has_nulls) {
+                bool is_null = values.is_null(i);
+                append_simple_instr(is_null); // Throws
+                if (is_null)
+                    continue;
+            }
+            switch (type) {
+                case type_Int:
+                    append_simple_instr(values.get_int(i)); // Throws
+                    break;
+                case type_Bool:
+                    append_simple_instr(values.get_bool(i)); // Throws
+                    break;
+                case type_Float:
+                    append_simple_instr(values.get_float(i)); // Throws
+                    break;
+                case type_Double:
+                    append_simple_instr(values.get_double(i)); // Throws
+                    break;
+                case type_String:
+                    append_simple_instr(values.get_string(i)); // Throws
+                    break;
+                case type_Timestamp: {
+                    Timestamp ts = values.get_timestamp(i);
+                    append_simple_instr(ts.get_seconds(), ts.get_nanoseconds()); // Throws
+                    break;
+                }
+                default:
+                    REALM_UNREACHABLE();
+            }
+        }
+    }
+    return true;
+}
+
+inline void TransactLogConvenientEncoder::add_rows_bulk(const Table* t, size_t row_ndx, size_t num_rows,
+                                                        size_t prior_num_rows, const std::vector<BulkColumn>& columns)
+{
+    select_table(t);                                                       // Throws
+    m_encoder.add_rows_bulk(row_ndx, num_rows, prior_num_rows, columns); // Throws
+}
+
 inline void TransactLogConvenientEncoder::add_row_with_key(const Table* t, size_t row_ndx, size_t prior_num_rows,
                                                            size_t key_col_ndx, int64_t key)
 {
@@ -1543,6 +1631,18 @@ inline void TransactLogConvenientEncoder::set_link_type(const Table* t, size_t c
     m_encoder.set_link_type(col_ndx, link_type); // Throws
 }
 
+inline bool TransactLogEncoder::set_deduplicated(size_t col_ndx, bool deduplicated)
+{
+    append_simple_instr(instr_SetDeduplicated, col_ndx, int(deduplicated)); // Throws
+    return true;
+}
+
+inline void TransactLogConvenientEncoder::set_deduplicated(const Table* t, size_t col_ndx, bool deduplicated)
+{
+    select_table(t);                                   // Throws
+    m_encoder.set_deduplicated(col_ndx, deduplicated); // Throws
+}
+
 
 inline bool TransactLogEncoder::clear_table(size_t old_size)
 {
@@ -1864,6 +1964,15 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_SetBinaryRange: {
+            size_t col_ndx = read_int<size_t>();                         // Throws
+            size_t row_ndx = read_int<size_t>();                         // Throws
+            size_t pos = read_int<size_t>();                             // Throws
+            BinaryData value = read_binary(m_string_buffer);             // Throws
+            if (!handler.set_binary_range(col_ndx, row_ndx, pos, value)) // Throws
+                parser_error();
+            return;
+        }
         case instr_InsertEmptyRows: {
             size_t row_ndx = read_int<size_t>();                                                    // Throws
             size_t num_rows_to_insert = read_int<size_t>();                                         // Throws
@@ -1882,6 +1991,70 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_AddRowsBulk: {
+            // Handlers see this as an insertion of empty rows followed by a
+            // Set instruction for each specified cell.
+            size_t row_ndx = read_int<size_t>();        // Throws
+            size_t num_rows = read_int<size_t>();       // Throws
+            size_t prior_num_rows = read_int<size_t>(); // Throws
+            size_t num_columns = read_int<size_t>();    // Throws
+            bool unordered = false;
+            if (!handler.insert_empty_rows(row_ndx, num_rows, prior_num_rows, unordered)) // Throws
+                parser_error();
+            for (size_t j = 0; j < num_columns; ++j) {
+                size_t col_ndx = read_int<size_t>(); // Throws
+                int type = read_int<int>();          // Throws
+                bool has_nulls = read_bool();        // Throws
+                for (size_t i = 0; i < num_rows; ++i) {
+                    bool ok;
+                    if (has_nulls && read_bool()) { // Throws
+                        ok = handler.set_null(col_ndx, row_ndx + i, instr_Set, 0); // Throws
+                    }
+                    else {
+                        switch (DataType(type)) {
+                            case type_Int: {
+                                int_fast64_t value = read_int<int64_t>();                   // Throws
+                                ok = handler.set_int(col_ndx, row_ndx + i, value, instr_Set, 0); // Throws
+                                break;
+                            }
+                            case type_Bool: {
+                                bool value = read_bool();                                // Throws
+                                ok = handler.set_bool(col_ndx, row_ndx + i, value, instr_Set); // Throws
+                                break;
+                            }
+                            case type_Float: {
+                                float value = read_float();                                     // Throws
+                                ok = handler.set_float(col_ndx, row_ndx + i, value, instr_Set); // Throws
+                                break;
+                            }
+                            case type_Double: {
+                                double value = read_double();                                    // Throws
+                                ok = handler.set_double(col_ndx, row_ndx + i, value, instr_Set); // Throws
+                                break;
+                            }
+                            case type_String: {
+                                StringData value = read_string(m_string_buffer);                 // Throws
+                                ok = handler.set_string(col_ndx, row_ndx + i, value, instr_Set, 0); // Throws
+                                break;
+                            }
+                            case type_Timestamp: {
+                                int64_t seconds = read_int<int64_t>();     // Throws
+                                int32_t nanoseconds = read_int<int32_t>(); // Throws
+                                Timestamp value = Timestamp(seconds, nanoseconds);
+                                ok = handler.set_timestamp(col_ndx, row_ndx + i, value, instr_Set); // Throws
+                                break;
+                            }
+                            default:
+                                ok = false;
+                                break;
+                        }
+                    }
+                    if (!ok)
+                        parser_error();
+                }
+            }
+            return;
+        }
         case instr_EraseRows: {
             size_t row_ndx = read_int<size_t>();                                            // Throws
             size_t num_rows_to_erase = read_int<size_t>();                                  // Throws
@@ -2031,6 +2204,15 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_SetDeduplicated: {
+            size_t col_ndx = read_int<size_t>(); // Throws
+            int deduplicated = read_int<int>();  // Throws
+            if (deduplicated != 0 && deduplicated != 1)
+                parser_error();
+            if (!handler.set_deduplicated(col_ndx, deduplicated != 0)) // Throws
+                parser_error();
+            return;
+        }
         case instr_InsertColumn:
         case instr_InsertNullableColumn: {
             size_t col_ndx = read_int<size_t>(); // Throws
@@ -2575,6 +2757,11 @@ public:
         return true; // No-op
     }
 
+    bool set_binary_range(size_t, size_t, size_t, BinaryData)
+    {
+        return true; // No-op
+    }
+
     bool clear_table(size_t old_size)
     {
         bool unordered = false;
@@ -2598,6 +2785,11 @@ public:
         return true; // No-op
     }
 
+    bool set_deduplicated(size_t, bool)
+    {
+        return true; // No-op
+    }
+
     bool insert_link_column(size_t col_idx, DataType, StringData, size_t target_table_idx, size_t backlink_col_ndx)
     {
         m_encoder.erase_link_column(col_idx, target_table_idx, backlink_col_ndx);
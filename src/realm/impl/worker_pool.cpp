@@ -0,0 +1,99 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/assert.hpp>
+#include <realm/impl/worker_pool.hpp>
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::_impl;
+
+
+WorkerPool::WorkerPool(size_t num_threads)
+    : m_threads(new Thread[num_threads]) // Throws
+{
+    try {
+        for (; m_num_threads < num_threads; ++m_num_threads)
+            m_threads[m_num_threads].start([this] { worker(); }); // Throws
+    }
+    catch (...) {
+        stop();
+        throw;
+    }
+}
+
+
+WorkerPool::~WorkerPool() noexcept
+{
+    stop();
+}
+
+
+void WorkerPool::run(std::function<void(size_t)> task, size_t num_tasks)
+{
+    LockGuard lock(m_mutex);
+    REALM_ASSERT(m_num_unfinished == 0);
+    m_task = std::move(task);
+    m_num_tasks = num_tasks;
+    m_next_task = 0;
+    m_num_unfinished = num_tasks;
+    m_work_available.notify_all();
+}
+
+
+void WorkerPool::wait() noexcept
+{
+    LockGuard lock(m_mutex);
+    while (m_num_unfinished > 0)
+        m_work_done.wait(lock);
+}
+
+
+void WorkerPool::worker() noexcept
+{
+    for (;;) {
+        size_t i;
+        {
+            LockGuard lock(m_mutex);
+            while (!m_stop && m_next_task == m_num_tasks)
+                m_work_available.wait(lock);
+            if (m_next_task == m_num_tasks)
+                return;
+            i = m_next_task++;
+        }
+
+        // `m_task` is not replaced before the whole batch is done
+        m_task(i);
+
+        LockGuard lock(m_mutex);
+        if (--m_num_unfinished == 0)
+            m_work_done.notify_all();
+    }
+}
+
+
+void WorkerPool::stop() noexcept
+{
+    {
+        LockGuard lock(m_mutex);
+        m_stop = true;
+        m_work_available.notify_all();
+    }
+    for (size_t i = 0; i < m_num_threads; ++i)
+        m_threads[i].join();
+}
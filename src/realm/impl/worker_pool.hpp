@@ -0,0 +1,79 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_WORKER_POOL_HPP
+#define REALM_IMPL_WORKER_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <realm/util/thread.hpp>
+
+namespace realm {
+namespace _impl {
+
+/// A fixed set of threads that run batches of tasks, such that the threads
+/// are started once and reused for every batch.
+///
+/// Tasks must not throw. The destructor lets the workers finish the current
+/// batch before it stops and joins them.
+class WorkerPool {
+public:
+    /// Start \a num_threads worker threads. If a thread fails to start, those
+    /// already started are joined before the exception is propagated.
+    explicit WorkerPool(size_t num_threads);
+    ~WorkerPool() noexcept;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const noexcept
+    {
+        return m_num_threads;
+    }
+
+    /// Have the workers call `task(i)` for every `i` in `[0, num_tasks)`, and
+    /// return without waiting for them. The previous batch must have been
+    /// waited for.
+    void run(std::function<void(size_t)> task, size_t num_tasks);
+
+    /// Wait until every task of the current batch has returned.
+    void wait() noexcept;
+
+private:
+    util::Mutex m_mutex;
+    util::CondVar m_work_available;
+    util::CondVar m_work_done;
+    std::function<void(size_t)> m_task;
+    size_t m_num_tasks = 0;
+    size_t m_next_task = 0;
+    size_t m_num_unfinished = 0;
+    bool m_stop = false;
+    size_t m_num_threads = 0;
+    std::unique_ptr<util::Thread[]> m_threads;
+
+    void worker() noexcept;
+    void stop() noexcept;
+};
+
+
+} // namespace _impl
+} // namespace realm
+
+#endif // REALM_IMPL_WORKER_POOL_HPP
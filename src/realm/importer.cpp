@@ -18,6 +18,7 @@
 
 // Test tool in test/test_csv/test.pl
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -25,6 +26,8 @@
 #include <vector>
 
 #include <realm/util/assert.hpp>
+#include <realm/util/file.hpp>
+#include <realm/impl/worker_pool.hpp>
 #include <realm/importer.hpp>
 
 using namespace realm;
@@ -127,12 +130,65 @@ bool is_null(const char* v)
     return false;
 }
 
+// Memory maps an entire .csv file for reading
+class MappedFile {
+public:
+    MappedFile(const std::string& path)
+        : m_file(path)
+    {
+        size_t size = to_size_t(m_file.get_size());
+        if (size > 0)
+            m_map.map(m_file, util::File::access_ReadOnly, size);
+    }
+
+    const char* data() const noexcept
+    {
+        return m_map.is_attached() ? m_map.get_addr() : "";
+    }
+
+    size_t size() const noexcept
+    {
+        return m_map.get_size();
+    }
+
+private:
+    util::File m_file;
+    util::File::Map<char> m_map;
+};
+
 } // anonymous namespace
 
 
+// Values of one column of a chunk of rows, converted to its Realm type. Only the member that matches the type of the
+// column is used
+struct Importer::ParsedColumn {
+    std::vector<int64_t> ints;
+    std::unique_ptr<bool[]> bools;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    std::vector<std::string> strings;
+};
+
+// A chunk of rows converted into one array per column, ready for Table::add_rows_bulk()
+struct Importer::ParsedChunk {
+    size_t rows = 0;
+    std::vector<ParsedColumn> columns;
+
+    // Set if a field could not be converted to the type of its column. In that case 'rows' is the row of that field
+    bool failed = false;
+    size_t error_col = 0;
+    std::string error_field;
+
+    // Set if the chunk could not be tokenized (parser threads only)
+    std::exception_ptr exception;
+};
+
+
 Importer::Importer()
     : Quiet(false)
     , Separator(',')
+    , Threads(1)
+    , Parallel_chunk_size(parallel_chunk_size)
 {
 }
 
@@ -223,7 +279,7 @@ bool Importer::parse_bool(const char* col, bool* success)
         for (size_t t = 0; t < sizeof(a) / sizeof(a[0]); t++) {
             if (strcmp(col, a[t]) == 0) {
                 *success = true;
-                return !((t & 0x1) == 0);
+                return (t & 0x1) == 0;
             }
         }
         *success = false;
@@ -444,7 +500,7 @@ nextrecord:
     if (m_top - m_curpos < chunk_size / 2) {
         memmove(src, src + m_curpos, m_top - m_curpos);
         m_top -= m_curpos;
-        size_t r = fread(src + m_top, 1, chunk_size / 2, m_file);
+        size_t r = read_source(src + m_top, chunk_size / 2);
         m_top += r;
         m_curpos = 0;
         if (r != chunk_size / 2) {
@@ -549,7 +605,263 @@ end:
     return payload.size() - original_size;
 }
 
-size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* import_scheme,
+// Reads up to 'size' bytes from either the .csv file handle or the memory mapped .csv file, whichever is in use
+size_t Importer::read_source(char* dst, size_t size)
+{
+    if (m_file)
+        return fread(dst, 1, size, m_file);
+
+    size_t r = std::min(size, m_map_size - m_map_pos);
+    memcpy(dst, m_map + m_map_pos, r);
+    m_map_pos += r;
+    return r;
+}
+
+// Converts tokenized rows into one array per column. Strings are moved out of 'payload'. Stops at the first field
+// that cannot be converted to the type of its column
+void Importer::parse_payload(std::vector<std::vector<std::string>>& payload, const std::vector<DataType>& scheme,
+                             ParsedChunk& chunk)
+{
+    size_t num_rows = payload.size();
+
+    chunk.rows = 0;
+    chunk.failed = false;
+    chunk.columns.clear();
+    chunk.columns.resize(scheme.size());
+    for (size_t col = 0; col < scheme.size(); col++) {
+        ParsedColumn& c = chunk.columns[col];
+        if (scheme[col] == type_String)
+            c.strings.reserve(num_rows);
+        else if (scheme[col] == type_Int)
+            c.ints.reserve(num_rows);
+        else if (scheme[col] == type_Double)
+            c.doubles.reserve(num_rows);
+        else if (scheme[col] == type_Float)
+            c.floats.reserve(num_rows);
+        else if (scheme[col] == type_Bool)
+            c.bools.reset(new bool[num_rows]);
+        else
+            REALM_ASSERT(false);
+    }
+
+    for (size_t row = 0; row < num_rows; row++) {
+        std::vector<std::string>& fields = payload[row];
+        if (fields.size() != scheme.size()) {
+            std::string s = fields[0];
+            if (s.length() > 100)
+                s = s.substr(0, 100);
+            throw std::runtime_error("Wrong number of delimitors in csv file. First few characters of line: " + s);
+        }
+
+        for (size_t col = 0; col < scheme.size(); col++) {
+            ParsedColumn& c = chunk.columns[col];
+            const char* field = fields[col].c_str();
+            bool success = true;
+
+            if (scheme[col] == type_String)
+                c.strings.push_back(std::move(fields[col]));
+            else if (scheme[col] == type_Int)
+                c.ints.push_back(parse_integer<true>(field, &success));
+            else if (scheme[col] == type_Double)
+                c.doubles.push_back(parse_double<true>(field, &success));
+            else if (scheme[col] == type_Float)
+                c.floats.push_back(parse_float<true>(field, &success));
+            else if (scheme[col] == type_Bool)
+                c.bools[row] = parse_bool<true>(field, &success);
+
+            if (!success) {
+                chunk.failed = true;
+                chunk.error_col = col;
+                chunk.error_field = fields[col];
+                return;
+            }
+        }
+        chunk.rows++;
+    }
+}
+
+// Tokenizes and parses the records in [begin, end) using a private copy of this importer. Runs in a parser thread,
+// so it must only read the settings of this importer
+void Importer::parse_chunk(const char* begin, const char* end, size_t first_line, const std::vector<DataType>& scheme,
+                           ParsedChunk& chunk) const
+{
+    try {
+        std::unique_ptr<Importer> worker(new Importer(*this));
+        worker->m_file = nullptr;
+        worker->m_map = begin;
+        worker->m_map_size = end - begin;
+        worker->m_map_pos = 0;
+        worker->m_top = 0;
+        worker->m_curpos = 0;
+        worker->m_row = first_line;
+
+        std::vector<std::vector<std::string>> payload;
+        worker->tokenize(payload, static_cast<size_t>(-1));
+        worker->parse_payload(payload, scheme, chunk);
+        chunk.exception = nullptr;
+    }
+    catch (...) {
+        chunk.exception = std::current_exception();
+    }
+}
+
+// Appends the converted rows of 'chunk' to the table with one bulk append, and throws if the chunk ended at a field of
+// the wrong type. Never imports more than 'import_rows' rows in total. Returns the new number of imported rows
+size_t Importer::append_chunk(Table& table, const std::vector<DataType>& scheme, ParsedChunk& chunk,
+                              size_t imported_rows, size_t import_rows, size_t type_detection_rows)
+{
+    if (chunk.exception)
+        std::rethrow_exception(chunk.exception);
+
+    size_t num_rows = std::min(chunk.rows, import_rows - imported_rows);
+    std::vector<std::vector<StringData>> strings(scheme.size());
+    std::vector<BulkColumn> columns;
+    columns.reserve(scheme.size());
+
+    for (size_t col = 0; col < scheme.size(); col++) {
+        ParsedColumn& c = chunk.columns[col];
+
+        if (scheme[col] == type_String) {
+            strings[col].assign(c.strings.begin(), c.strings.begin() + num_rows);
+            columns.emplace_back(col, strings[col].data());
+        }
+        else if (scheme[col] == type_Int)
+            columns.emplace_back(col, c.ints.data());
+        else if (scheme[col] == type_Double)
+            columns.emplace_back(col, c.doubles.data());
+        else if (scheme[col] == type_Float)
+            columns.emplace_back(col, c.floats.data());
+        else if (scheme[col] == type_Bool)
+            columns.emplace_back(col, c.bools.get());
+    }
+
+    if (num_rows > 0)
+        table.add_rows_bulk(num_rows, columns);
+
+    if (!Quiet) {
+        for (size_t row = imported_rows; row < imported_rows + num_rows && row < 10; row++)
+            print_row(table, row);
+        if (imported_rows <= 11 && imported_rows + num_rows > 11)
+            std::cout << "\nOnly showing first few rows...\n";
+        std::cout << imported_rows + num_rows << " rows\r";
+    }
+
+    imported_rows += num_rows;
+
+    if (chunk.failed && num_rows == chunk.rows)
+        throw_parse_error(table, scheme, imported_rows, chunk.error_col, chunk.error_field, type_detection_rows);
+
+    return imported_rows;
+}
+
+// Returns the offset in the memory mapped file of the first record boundary (the byte after a line break that is not
+// inside a double-quoted field) that is at least Parallel_chunk_size bytes after 'begin', or the end of the file.
+// 'begin' must be a record boundary. Adds the number of line breaks passed to 'line'
+size_t Importer::find_chunk_end(size_t begin, size_t& line) const
+{
+    size_t target = begin + std::min(Parallel_chunk_size, m_map_size - begin);
+    bool quoted = false;
+    size_t pos = begin;
+
+    while (pos < m_map_size) {
+        char c = m_map[pos++];
+        if (c == '"')
+            quoted = !quoted;
+        else if (c == 0xa)
+            line++;
+
+        if (!quoted && pos >= target && (c == 0xd || c == 0xa)) {
+            if (c == 0xd && pos < m_map_size && m_map[pos] == 0xa) {
+                pos++;
+                line++;
+            }
+            break;
+        }
+    }
+    return pos;
+}
+
+// Tokenizes and parses the rest of the memory mapped file in chunks of about Parallel_chunk_size bytes on a pool of
+// Threads parser threads. The calling thread appends each batch of parsed chunks to the table, in file order, while
+// the parser threads work on the next batch
+size_t Importer::import_parallel(Table& table, const std::vector<DataType>& scheme, size_t imported_rows,
+                                 size_t import_rows, size_t type_detection_rows)
+{
+    size_t pos = m_map_pos - (m_top - m_curpos);
+    size_t line = m_row;
+    std::vector<ParsedChunk> parsed(Threads);
+    std::vector<ParsedChunk> parsing(Threads);
+    std::vector<std::pair<const char*, const char*>> ranges(Threads);
+    std::vector<size_t> first_lines(Threads);
+    size_t num_parsed = 0;
+
+    // Declared after the chunks, so that the parser threads are done with them before they are destroyed
+    _impl::WorkerPool pool(Threads);
+
+    while (pos < m_map_size || num_parsed > 0) {
+        size_t num_parsing = 0;
+        for (; num_parsing < Threads && pos < m_map_size; num_parsing++) {
+            first_lines[num_parsing] = line;
+            ranges[num_parsing].first = m_map + pos;
+            pos = find_chunk_end(pos, line);
+            ranges[num_parsing].second = m_map + pos;
+        }
+
+        auto parse = [&](size_t i) {
+            parse_chunk(ranges[i].first, ranges[i].second, first_lines[i], scheme, parsing[i]);
+        };
+        pool.run(parse, num_parsing);
+
+        // If this throws, the pool finishes the batch before it is destroyed
+        for (size_t i = 0; i < num_parsed && imported_rows < import_rows; i++)
+            imported_rows = append_chunk(table, scheme, parsed[i], imported_rows, import_rows, type_detection_rows);
+        pool.wait();
+
+        if (imported_rows == import_rows)
+            break;
+
+        std::swap(parsed, parsing);
+        num_parsed = num_parsing;
+    }
+
+    return imported_rows;
+}
+
+// Removes all columns so that user can call csv_import() on the table again, and throws an exception that describes
+// why the field in 'row' and 'col' could not be imported
+void Importer::throw_parse_error(Table& table, const std::vector<DataType>& scheme, size_t row, size_t col,
+                                 const std::string& field, size_t type_detection_rows)
+{
+    table.clear();
+
+    while (table.get_column_count() > 0)
+        table.remove_column(0);
+
+    std::stringstream sstm;
+
+    if (type_detection_rows > 0) {
+        if (scheme[col] != type_String && is_null(field.c_str()) && Empty_as_string)
+            sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                 << " using the first " << type_detection_rows << " rows of CSV file, but in row " << row
+                 << " of cvs file the field contained the NULL value '" << field.c_str()
+                 << "'. Please increase the 'type_detection_rows' argument or set "
+                 << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
+                    "false";
+        else
+            sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                 << " using the first " << type_detection_rows << " rows of CSV file, but in row " << row
+                 << " of cvs file the field contained '" << field.c_str()
+                 << "' which is of another type. Please increase the 'type_detection_rows' argument";
+    }
+    else
+        sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col]) << ", but in row "
+             << row << " of cvs file,"
+             << "the field contained '" << field.c_str() << "' which is of another type";
+
+    throw std::runtime_error(sstm.str());
+}
+
+size_t Importer::import_csv(FILE* file, const char* map, size_t map_size, Table& table, std::vector<DataType>* import_scheme,
                             std::vector<std::string>* column_names, size_t type_detection_rows,
                             size_t skip_first_rows, size_t import_rows)
 {
@@ -563,6 +875,9 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
     m_curpos = 0;
     m_fields = static_cast<size_t>(-1);
     m_file = file;
+    m_map = map;
+    m_map_size = map_size;
+    m_map_pos = 0;
     m_row = 1;
 
     if (import_scheme == nullptr) {
@@ -657,80 +972,17 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
         payload.clear();
     }
 
+    ParsedChunk chunk;
     do {
-        for (size_t row = 0; row < payload.size(); row++) {
-
-            if (imported_rows == import_rows)
-                return imported_rows;
-
-            if (!Quiet && imported_rows % 123 == 0)
-                std::cout << imported_rows << " rows\r";
-
-            // Add empty row to Realm
-            table.add_empty_row();
-
-            // Add all fields to new row
-            for (size_t col = 0; col < scheme.size(); col++) {
-                bool success = true;
-
-                if (scheme[col] == type_String)
-                    table.set_string(col, imported_rows, StringData(payload[row][col]));
-                else if (scheme[col] == type_Int)
-                    table.set_int(col, imported_rows, parse_integer<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Double)
-                    table.set_double(col, imported_rows, parse_double<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Float)
-                    table.set_float(col, imported_rows, parse_float<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Bool)
-                    table.set_bool(col, imported_rows, parse_bool<true>(payload[row][col].c_str(), &success));
-                else
-                    REALM_ASSERT(false);
-
-                if (!success) {
-                    // Remove all columns so that user can call csv_import() on it again
-                    table.clear();
-
-                    for (size_t t = 0; t < table.get_column_count(); t++)
-                        table.remove_column(0);
-
-                    std::stringstream sstm;
-
-                    if (type_detection_rows > 0) {
-                        if (scheme[col] != type_String && is_null(payload[row][col].c_str()) && Empty_as_string)
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained the NULL value '" << payload[row][col].c_str()
-                                 << "'. Please increase the 'type_detection_rows' argument or set "
-                                 << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
-                                    "false";
-                        else
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained '" << payload[row][col].c_str()
-                                 << "' which is of another type. Please increase the 'type_detection_rows' argument";
-                    }
-                    else
-                        sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col])
-                             << ", but in row " << imported_rows << " of cvs file,"
-                             << "the field contained '" << payload[row][col].c_str() << "' which is of another type";
-
-                    throw std::runtime_error(sstm.str());
-                }
-            }
-
+        parse_payload(payload, scheme, chunk);
+        imported_rows = append_chunk(table, scheme, chunk, imported_rows, import_rows, type_detection_rows);
+        if (imported_rows == import_rows)
+            return imported_rows;
 
-            if (!Quiet) {
-                if (imported_rows < 10)
-                    print_row(table, imported_rows);
-                else if (imported_rows == 11)
-                    std::cout << "\nOnly showing first few rows...\n";
-            }
-
-            imported_rows++;
-        }
         payload.clear();
+        if (m_map && Threads > 1)
+            return import_parallel(table, scheme, imported_rows, import_rows, type_detection_rows);
+
         tokenize(payload, record_chunks);
     } while (payload.size() > 0);
 
@@ -739,11 +991,27 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
 
 size_t Importer::import_csv_auto(FILE* file, Table& table, size_t type_detection_rows, size_t import_rows)
 {
-    return import_csv(file, table, nullptr, nullptr, type_detection_rows, 0, import_rows);
+    return import_csv(file, nullptr, 0, table, nullptr, nullptr, type_detection_rows, 0, import_rows);
 }
 
 size_t Importer::import_csv_manual(FILE* file, Table& table, std::vector<DataType> scheme,
                                    std::vector<std::string> column_names, size_t skip_first_rows, size_t import_rows)
 {
-    return import_csv(file, table, &scheme, &column_names, 0, skip_first_rows, import_rows);
+    return import_csv(file, nullptr, 0, table, &scheme, &column_names, 0, skip_first_rows, import_rows);
+}
+
+size_t Importer::import_csv_auto(const std::string& path, Table& table, size_t type_detection_rows,
+                                 size_t import_rows)
+{
+    MappedFile file(path);
+    return import_csv(nullptr, file.data(), file.size(), table, nullptr, nullptr, type_detection_rows, 0,
+                      import_rows);
+}
+
+size_t Importer::import_csv_manual(const std::string& path, Table& table, std::vector<DataType> scheme,
+                                   std::vector<std::string> column_names, size_t skip_first_rows, size_t import_rows)
+{
+    MappedFile file(path);
+    return import_csv(nullptr, file.data(), file.size(), table, &scheme, &column_names, 0, skip_first_rows,
+                      import_rows);
 }
@@ -64,7 +64,15 @@ import_csv(csv file handle, realm table)
         reads payload chunk and returns std::vector<std::vector<std::string>> with the right dimensions filled with
         rows and columns of the chunk payload
     Calls parse_float(), parse_bool(), etc, which tests for type and returns converted values
-    Calls table.add_empty_row(), table.set_float(), table.set_bool()
+    Calls parse_payload() which converts the rows into one array per column, and Table::add_rows_bulk() which
+    appends them to the table in one go
+
+import_csv(memory mapped .csv file, realm table)
+    Detects the scheme like above. The rest of the file is then split into chunks at record boundaries (line
+    breaks outside double-quotes). Up to 'Threads' chunks are tokenized and parsed concurrently, each by a copy of
+    the importer, while the calling thread appends the previous batch of chunks to the table in file order. Record
+    boundaries are found by tracking double-quotes only, so the non-conforming non-quoted line breaks mentioned
+    above are only supported within a chunk; use Threads = 1 for such files.
 */
 
 #include <cstddef>
@@ -79,9 +87,16 @@ static const size_t chunk_size = 32 * 1024;
 // Number of rows to csv-parse + insert into realm in each iteration.
 static const size_t record_chunks = 100;
 
+// Default number of bytes of .csv plaintext each thread tokenizes and parses at a time when importing from a memory
+// mapped file with multiple threads (see Importer::Parallel_chunk_size).
+static const size_t parallel_chunk_size = 4 * 1024 * 1024;
+
 // Width of each column when printing them on screen (non-Quiet mode)
 const size_t print_width = 25;
 
+#include <exception>
+#include <memory>
+#include <string>
 #include <vector>
 #include <realm.hpp>
 
@@ -97,12 +112,25 @@ public:
                              std::vector<std::string> column_names, size_t skip_first_rows = 0,
                              size_t import_rows = static_cast<size_t>(-1));
 
-    bool Quiet;           // Quiet mode, only print to screen upon errors
-    char Separator;       // csv delimitor/separator
-    bool Empty_as_string; // Import columns that have occurences of empty strings as String type column
+    // Same as above, but memory maps the file at 'path' and, if Threads > 1, parses it with that many threads
+    size_t import_csv_auto(const std::string& path, Table& table, size_t type_detection_rows = 1000,
+                           size_t import_rows = static_cast<size_t>(-1));
+
+    size_t import_csv_manual(const std::string& path, Table& table, std::vector<DataType> scheme,
+                             std::vector<std::string> column_names, size_t skip_first_rows = 0,
+                             size_t import_rows = static_cast<size_t>(-1));
+
+    bool Quiet;                 // Quiet mode, only print to screen upon errors
+    char Separator;             // csv delimitor/separator
+    bool Empty_as_string;       // Import columns that have occurences of empty strings as String type column
+    size_t Threads;             // Number of parser threads when importing from a path (memory mapped file)
+    size_t Parallel_chunk_size; // Bytes of .csv plaintext each parser thread tokenizes and parses at a time
 
 private:
-    size_t import_csv(FILE* file, Table& table, std::vector<DataType>* import_scheme,
+    struct ParsedColumn;
+    struct ParsedChunk;
+
+    size_t import_csv(FILE* file, const char* map, size_t map_size, Table& table, std::vector<DataType>* import_scheme,
                       std::vector<std::string>* column_names, size_t type_detection_rows, size_t skip_first_rows,
                       size_t import_rows);
     template <bool can_fail>
@@ -115,13 +143,28 @@ private:
     bool parse_bool(const char* col, bool* success = nullptr);
     std::vector<DataType> types(std::vector<std::string> v);
     size_t tokenize(std::vector<std::vector<std::string>>& payload, size_t records);
+    size_t read_source(char* dst, size_t size);
+    void parse_payload(std::vector<std::vector<std::string>>& payload, const std::vector<DataType>& scheme,
+                       ParsedChunk& chunk);
+    void parse_chunk(const char* begin, const char* end, size_t first_line, const std::vector<DataType>& scheme,
+                     ParsedChunk& chunk) const;
+    size_t append_chunk(Table& table, const std::vector<DataType>& scheme, ParsedChunk& chunk, size_t imported_rows,
+                        size_t import_rows, size_t type_detection_rows);
+    size_t import_parallel(Table& table, const std::vector<DataType>& scheme, size_t imported_rows,
+                           size_t import_rows, size_t type_detection_rows);
+    size_t find_chunk_end(size_t begin, size_t& line) const;
+    REALM_NORETURN void throw_parse_error(Table& table, const std::vector<DataType>& scheme, size_t row, size_t col,
+                                          const std::string& field, size_t type_detection_rows);
     std::vector<DataType> detect_scheme(std::vector<std::vector<std::string>> payload, size_t begin, size_t end);
     std::vector<DataType> lowest_common(std::vector<DataType> types1, std::vector<DataType> types2);
 
     char src[2 * chunk_size]; // .csv input buffer
     size_t m_top;             // points at top of buffer
     size_t m_curpos;          // points at next byte to parse
-    FILE* m_file;             // handle to .csv file
+    FILE* m_file;             // handle to .csv file, or null when reading from m_map
+    const char* m_map;        // memory mapped .csv file, or null when reading from m_file
+    size_t m_map_size;        // size of m_map in bytes
+    size_t m_map_pos;         // offset in m_map of next byte to read into src
     size_t m_fields;          // number of fields in each row
     size_t m_row;             // current row in .csv file, including field-embedded line breaks. Used for err msg only
 };
@@ -35,6 +35,7 @@ FILE* in_file;
 size_t auto_detection_flag = 0;
 size_t import_rows_flag = 0;
 size_t skip_rows_flag = 0;
+size_t threads_flag = 1;
 char separator_flag = ',';
 bool force_flag = false;
 bool quiet_flag = false;
@@ -45,15 +46,17 @@ const char* legend =
     "  csv <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Advanced auto-detection of scheme:\n"
-    "  csv [-a=N] [-n=N] [-e] [-f] [-q] [-l tablename] <.csv file | -stdin> <.realm file>\n"
+    "  csv [-a=N] [-n=N] [-j=N] [-e] [-f] [-q] [-l tablename] <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Manual specification of scheme:\n"
-    "  csv -t={s|i|b|f|d}{s|i|b|f|d}... name1 name2 ... [-s=N] [-n=N] <.csv file | -stdin> <.realm file>\n"
+    "  csv -t={s|i|b|f|d}{s|i|b|f|d}... name1 name2 ... [-s=N] [-n=N] [-j=N] <.csv file | -stdin> <.realm file>\n"
     "\n"
     " -a: Use the first N rows to auto-detect scheme (default =10000). Lower is faster but more error prone\n"
     " -e: Realm does not support null values. Set the -e flag to import a column as a String type column if\n"
     "     it has occurences of empty fields. Otherwise empty fields may be converted to 0, 0.0 or false\n"
     " -n: Only import first N rows of payload\n"
+    " -j: Parse the .csv file with N threads (default =1). The file is memory mapped, so -j cannot be used with\n"
+    "     -stdin. Line breaks outside double-quotes must always end a row when N > 1\n"
     " -t: List of column types where s=string, i=integer, b=bool, f=float, d=double\n"
     " -s: Skip first N rows (can be used to skip headers)\n"
     " -q: Quiet, only print upon errors\n"
@@ -63,6 +66,7 @@ const char* legend =
     "Examples:\n"
     "  csv file.csv file.realm\n"
     "  csv -a=200000 -e file.csv file.realm\n"
+    "  csv -j=8 file.csv file.realm\n"
     "  csv -t=ssdbi Name Email Height Gender Age file.csv -s=1 file.realm\n"
     "  csv -stdin file.realm < cat file.csv";
 
@@ -123,6 +127,10 @@ int main(int argc, char* argv[])
             skip_rows_flag = atoi(&argv[a][3]);
             abort2(skip_rows_flag == 0, "Invalid value for -s flag");
         }
+        else if (strncmp(argv[a], "-j", 2) == 0) {
+            threads_flag = atoi(&argv[a][3]);
+            abort2(threads_flag == 0, "Invalid value for -j flag");
+        }
         else if (strncmp(argv[a], "-e", 2) == 0)
             empty_as_string_flag = true;
         else if (strncmp(argv[a], "-f", 2) == 0)
@@ -169,6 +177,7 @@ int main(int argc, char* argv[])
            "-a flag cannot be used when scheme is specified manually with -t flag");
     abort2(empty_as_string_flag && scheme.size() > 0,
            "-e flag cannot be used when scheme is specified manually with -t flag");
+    abort2(threads_flag > 1 && strcmp(argv[argc - 2], "-stdin") == 0, "-j flag cannot be used with -stdin");
 
     abort2(!force_flag && util::File::exists(argv[argc - 1]), "Destination file '%s' already exists.",
            argv[argc - 1]);
@@ -176,7 +185,10 @@ int main(int argc, char* argv[])
     if (util::File::exists(argv[argc - 1]))
         util::File::try_remove(argv[argc - 1]);
 
-    in_file = open_files(argv[argc - 2]);
+    // Files are memory mapped so that they can be parsed by multiple threads
+    bool map_flag = strcmp(argv[argc - 2], "-stdin") != 0;
+    if (!map_flag)
+        in_file = open_files(argv[argc - 2]);
     std::string path = argv[argc - 1];
     Group group;
     TableRef table2 = group.add_table(tablename);
@@ -188,19 +200,28 @@ int main(int argc, char* argv[])
     importer.Quiet = quiet_flag;
     importer.Separator = ',';
     importer.Empty_as_string = empty_as_string_flag;
+    importer.Threads = threads_flag;
 
     try {
         if (scheme.size() > 0) {
             // Manual specification of scheme
-            imported_rows = importer.import_csv_manual(in_file, table, scheme, column_names, skip_rows_flag,
-                                                       import_rows_flag ? import_rows_flag : static_cast<size_t>(-1));
+            size_t import_rows = import_rows_flag ? import_rows_flag : static_cast<size_t>(-1);
+            if (map_flag)
+                imported_rows = importer.import_csv_manual(argv[argc - 2], table, scheme, column_names,
+                                                           skip_rows_flag, import_rows);
+            else
+                imported_rows =
+                    importer.import_csv_manual(in_file, table, scheme, column_names, skip_rows_flag, import_rows);
         }
         else if (argc >= 3) {
             // Auto detection
             abort2(skip_rows_flag > 0, "-s flag cannot be used in Simple auto-import mode");
-            imported_rows =
-                importer.import_csv_auto(in_file, table, auto_detection_flag ? auto_detection_flag : 10000,
-                                         import_rows_flag ? import_rows_flag : static_cast<size_t>(-1));
+            size_t type_detection_rows = auto_detection_flag ? auto_detection_flag : 10000;
+            size_t import_rows = import_rows_flag ? import_rows_flag : static_cast<size_t>(-1);
+            if (map_flag)
+                imported_rows = importer.import_csv_auto(argv[argc - 2], table, type_detection_rows, import_rows);
+            else
+                imported_rows = importer.import_csv_auto(in_file, table, type_detection_rows, import_rows);
         }
         else {
         }
@@ -1179,10 +1179,8 @@ StringData StringIndex::get(size_t ndx, StringConversionBuffer& buffer) const
     return m_target_column->get_index_data(ndx, buffer);
 }
 
-void StringIndex::adjust_row_indexes(size_t min_row_ndx, int diff)
+void StringIndex::adjust_row_indexes(size_t min_row_ndx, int_fast64_t diff)
 {
-    REALM_ASSERT(diff == 1 || diff == -1); // only used by insert and delete
-
     Allocator& alloc = m_array->get_alloc();
     const size_t array_size = m_array->size();
 
@@ -143,6 +143,11 @@ public:
     template <class T>
     void erase(size_t row_ndx, bool is_last);
 
+    /// Remove the entries of \a num_rows consecutive rows. The row indexes of
+    /// the following rows are adjusted in a single pass over the index.
+    template <class T>
+    void erase_rows(size_t row_ndx, size_t num_rows, bool is_last);
+
     template <class T>
     size_t find_first(T value) const;
     template <class T>
@@ -219,9 +224,9 @@ private:
                                           const IntegerColumnIterator& lower);
     key_type get_last_key() const;
 
-    /// Add small signed \a diff to all elements that are greater than, or equal
-    /// to \a min_row_ndx.
-    void adjust_row_indexes(size_t min_row_ndx, int diff);
+    /// Add signed \a diff to all elements that are greater than, or equal to
+    /// \a min_row_ndx.
+    void adjust_row_indexes(size_t min_row_ndx, int_fast64_t diff);
 
     struct NodeChange {
         size_t ref1;
@@ -499,27 +504,36 @@ void StringIndex::set(size_t row_ndx, util::Optional<T> new_value)
 template <class T>
 void StringIndex::erase(size_t row_ndx, bool is_last)
 {
-    StringConversionBuffer buffer;
-    StringData value = get(row_ndx, buffer);
-
-    do_delete(row_ndx, value, 0);
-
-    // Collapse top nodes with single item
-    while (m_array->is_inner_bptree_node()) {
-        REALM_ASSERT(m_array->size() > 1); // node cannot be empty
-        if (m_array->size() > 2)
-            break;
+    erase_rows<T>(row_ndx, 1, is_last);
+}
 
-        ref_type ref = m_array->get_as_ref(1);
-        m_array->set(1, 1); // avoid destruction of the extracted ref
-        m_array->destroy_deep();
-        m_array->init_from_ref(ref);
-        m_array->update_parent();
+template <class T>
+void StringIndex::erase_rows(size_t row_ndx, size_t num_rows, bool is_last)
+{
+    for (size_t i = num_rows; i > 0; --i) {
+        size_t row_ndx_2 = row_ndx + i - 1;
+        StringConversionBuffer buffer;
+        StringData value = get(row_ndx_2, buffer);
+
+        do_delete(row_ndx_2, value, 0);
+
+        // Collapse top nodes with single item
+        while (m_array->is_inner_bptree_node()) {
+            REALM_ASSERT(m_array->size() > 1); // node cannot be empty
+            if (m_array->size() > 2)
+                break;
+
+            ref_type ref = m_array->get_as_ref(1);
+            m_array->set(1, 1); // avoid destruction of the extracted ref
+            m_array->destroy_deep();
+            m_array->init_from_ref(ref);
+            m_array->update_parent();
+        }
     }
 
-    // If it is last item in column, we don't have to update refs
+    // If they are the last items in column, we don't have to update refs
     if (!is_last)
-        adjust_row_indexes(row_ndx, -1);
+        adjust_row_indexes(row_ndx + num_rows, -int_fast64_t(num_rows));
 }
 
 template <class T>
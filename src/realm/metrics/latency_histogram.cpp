@@ -0,0 +1,129 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/metrics/latency_histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if REALM_METRICS
+
+using namespace realm;
+using namespace realm::metrics;
+
+constexpr int LatencyHistogram::sub_bucket_bits;
+constexpr size_t LatencyHistogram::sub_bucket_count;
+constexpr size_t LatencyHistogram::sub_bucket_half_count;
+constexpr int LatencyHistogram::max_magnitude;
+constexpr size_t LatencyHistogram::num_buckets;
+
+LatencyHistogram::LatencyHistogram() noexcept
+{
+    reset();
+}
+
+void LatencyHistogram::record(double seconds) noexcept
+{
+    if (!(seconds > 0))
+        seconds = 0;
+    double nanos_float = seconds * 1e9;
+    // Clamp before converting, the conversion is undefined for out of range values
+    const double limit = double(uint_fast64_t(1) << 62);
+    uint_fast64_t nanos = nanos_float < limit ? uint_fast64_t(nanos_float) : uint_fast64_t(limit);
+
+    m_buckets[bucket_index(nanos)].fetch_add(1, std::memory_order_relaxed);
+    m_total_nanos.fetch_add(nanos, std::memory_order_relaxed);
+    uint_fast64_t max = m_max_nanos.load(std::memory_order_relaxed);
+    while (nanos > max && !m_max_nanos.compare_exchange_weak(max, nanos, std::memory_order_relaxed))
+        ;
+    // The count is updated last, so that a reader never sees more samples
+    // than have been put into buckets.
+    m_count.fetch_add(1, std::memory_order_release);
+}
+
+uint_fast64_t LatencyHistogram::get_count() const noexcept
+{
+    return m_count.load(std::memory_order_acquire);
+}
+
+double LatencyHistogram::get_mean() const noexcept
+{
+    uint_fast64_t count = get_count();
+    if (count == 0)
+        return 0;
+    return double(m_total_nanos.load(std::memory_order_relaxed)) / count / 1e9;
+}
+
+double LatencyHistogram::get_max() const noexcept
+{
+    return double(m_max_nanos.load(std::memory_order_relaxed)) / 1e9;
+}
+
+double LatencyHistogram::get_value_at_percentile(double percentile) const noexcept
+{
+    uint_fast64_t count = get_count();
+    if (count == 0)
+        return 0;
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint_fast64_t target = uint_fast64_t(std::ceil(percentile / 100 * count));
+    target = std::max(target, uint_fast64_t(1));
+
+    uint_fast64_t max = m_max_nanos.load(std::memory_order_relaxed);
+    uint_fast64_t seen = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return double(std::min(bucket_upper_bound(i), max)) / 1e9;
+    }
+    return double(max) / 1e9;
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (size_t i = 0; i < num_buckets; ++i)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    m_total_nanos.store(0, std::memory_order_relaxed);
+    m_max_nanos.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_release);
+}
+
+size_t LatencyHistogram::bucket_index(uint_fast64_t nanos) noexcept
+{
+    if (nanos < sub_bucket_count)
+        return size_t(nanos);
+    int magnitude = sub_bucket_bits;
+    while (magnitude < max_magnitude && (nanos >> (magnitude + 1)) != 0)
+        ++magnitude;
+    if (magnitude == max_magnitude)
+        return num_buckets - 1;
+    // The top sub_bucket_bits bits of the value, the highest of which is always set
+    size_t top = size_t(nanos >> (magnitude - sub_bucket_bits + 1));
+    return sub_bucket_count + (magnitude - sub_bucket_bits) * sub_bucket_half_count + (top - sub_bucket_half_count);
+}
+
+uint_fast64_t LatencyHistogram::bucket_upper_bound(size_t index) noexcept
+{
+    if (index < sub_bucket_count)
+        return index;
+    size_t offset = index - sub_bucket_count;
+    int magnitude = sub_bucket_bits + int(offset / sub_bucket_half_count);
+    uint_fast64_t top = sub_bucket_half_count + offset % sub_bucket_half_count;
+    return ((top + 1) << (magnitude - sub_bucket_bits + 1)) - 1;
+}
+
+#endif // REALM_METRICS
@@ -0,0 +1,92 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_LATENCY_HISTOGRAM_HPP
+#define REALM_LATENCY_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <realm/util/features.h>
+
+#if REALM_METRICS
+
+namespace realm {
+namespace metrics {
+
+/// A fixed size histogram of durations in the style of HdrHistogram. Samples
+/// are counted in buckets whose width grows with the magnitude of the value,
+/// so that every recorded value is represented with a relative error of at
+/// most 1/16 (6.25%), from nanoseconds up to about 73 minutes. Larger values
+/// are counted in the last bucket.
+///
+/// Recording a sample never allocates or blocks, and may happen concurrently
+/// with other recordings and with readers. Readers see a consistent count for
+/// each individual bucket, but not necessarily a consistent snapshot across
+/// buckets while samples are being recorded.
+class LatencyHistogram {
+public:
+    LatencyHistogram() noexcept;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(double seconds) noexcept;
+
+    /// Number of samples recorded since construction or the last reset().
+    uint_fast64_t get_count() const noexcept;
+
+    /// Mean, maximum and percentiles are reported in seconds. They are zero
+    /// if nothing has been recorded.
+    double get_mean() const noexcept;
+    double get_max() const noexcept;
+
+    /// The smallest value such that at least the specified percentage of all
+    /// samples are less than or equal to it, rounded up to the resolution of
+    /// the histogram. For example, `get_value_at_percentile(99)` is the p99
+    /// latency.
+    double get_value_at_percentile(double percentile) const noexcept;
+
+    void reset() noexcept;
+
+private:
+    // Values below 2^sub_bucket_bits nanoseconds have a bucket each. Above
+    // that, each power of two is split into 2^(sub_bucket_bits - 1) equally
+    // wide buckets.
+    static constexpr int sub_bucket_bits = 5;
+    static constexpr size_t sub_bucket_count = size_t(1) << sub_bucket_bits;
+    static constexpr size_t sub_bucket_half_count = sub_bucket_count / 2;
+    static constexpr int max_magnitude = 42;
+    static constexpr size_t num_buckets = sub_bucket_count + (max_magnitude - sub_bucket_bits) * sub_bucket_half_count;
+
+    std::atomic<uint_fast64_t> m_buckets[num_buckets];
+    std::atomic<uint_fast64_t> m_count;
+    std::atomic<uint_fast64_t> m_total_nanos;
+    std::atomic<uint_fast64_t> m_max_nanos;
+
+    static size_t bucket_index(uint_fast64_t nanos) noexcept;
+    static uint_fast64_t bucket_upper_bound(size_t index) noexcept;
+};
+
+} // namespace metrics
+} // namespace realm
+
+#endif // REALM_METRICS
+
+#endif // REALM_LATENCY_HISTOGRAM_HPP
@@ -49,7 +49,7 @@ void MetricTimerResult::report_seconds(double time)
 }
 
 
-MetricTimer::MetricTimer(std::shared_ptr<MetricTimerResult> destination)
+MetricTimer::MetricTimer(MetricTimerResult* destination)
     : m_dest(destination)
 {
     reset();
@@ -43,10 +43,13 @@ protected:
 };
 
 
+/// Measures the time from construction (or the last reset()) to destruction,
+/// and reports it to the destination, if any. The destination must outlive
+/// the timer.
 class MetricTimer {
 public:
-    MetricTimer(std::shared_ptr<MetricTimerResult> destination = nullptr);
-    ~MetricTimer();
+    MetricTimer(MetricTimerResult* destination = nullptr);
+    virtual ~MetricTimer();
 
     void reset();
 
@@ -66,7 +69,7 @@ private:
     using time_point = std::chrono::time_point<clock_type>;
     time_point m_start;
     time_point m_paused_at;
-    std::shared_ptr<MetricTimerResult> m_dest;
+    MetricTimerResult* m_dest;
 
     time_point get_timer_ticks() const;
     double calc_elapsed_seconds(time_point begin, time_point end) const;
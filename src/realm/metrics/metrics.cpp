@@ -24,10 +24,13 @@
 using namespace realm;
 using namespace realm::metrics;
 
-Metrics::Metrics()
+constexpr size_t Metrics::default_max_history_size;
+
+Metrics::Metrics(size_t max_history_size, double description_threshold)
+    : m_query_info(max_history_size)       // Throws
+    , m_transaction_info(max_history_size) // Throws
+    , m_description_threshold(description_threshold)
 {
-    m_query_info = std::make_unique<QueryInfoList>();
-    m_transaction_info = std::make_unique<TransactionInfoList>();
 }
 
 Metrics::~Metrics() noexcept
@@ -36,57 +39,98 @@ Metrics::~Metrics() noexcept
 
 size_t Metrics::num_query_metrics() const
 {
-    return m_query_info ? m_query_info->size() : 0;
+    return m_query_info.size();
 }
 
 size_t Metrics::num_transaction_metrics() const
 {
-    return m_transaction_info ? m_transaction_info->size() : 0;
+    return m_transaction_info.size();
+}
+
+uint_fast64_t Metrics::num_dropped_query_metrics() const
+{
+    return m_query_info.get_num_dropped();
+}
+
+uint_fast64_t Metrics::num_dropped_transaction_metrics() const
+{
+    return m_transaction_info.get_num_dropped();
+}
+
+double Metrics::get_description_threshold() const noexcept
+{
+    return m_description_threshold;
 }
 
 void Metrics::add_query(QueryInfo info)
 {
-    REALM_ASSERT_DEBUG(m_query_info);
-    m_query_info->push_back(info);
+    REALM_ASSERT_DEBUG(info.get_type() <= QueryInfo::type_Invalid);
+    m_query_latency[info.get_type()].record(info.get_query_time());
+    m_query_info.push(std::move(info));
+}
+
+size_t Metrics::start_query(QueryInfo::QueryType type)
+{
+    m_pending_queries.emplace_back(type, 0, std::string()); // Throws
+    ++m_num_running_queries;
+    return m_pending_queries.size() - 1;
+}
+
+void Metrics::end_query(size_t query_slot, double query_time, std::string description)
+{
+    REALM_ASSERT_DEBUG(query_slot < m_pending_queries.size());
+    REALM_ASSERT_DEBUG(m_num_running_queries > 0);
+    QueryInfo& info = m_pending_queries[query_slot];
+    info = QueryInfo(info.get_type(), query_time, std::move(description));
+    if (--m_num_running_queries == 0) {
+        for (QueryInfo& pending : m_pending_queries)
+            add_query(std::move(pending));
+        m_pending_queries.clear();
+    }
 }
 
 void Metrics::add_transaction(TransactionInfo info)
 {
-    REALM_ASSERT_DEBUG(m_transaction_info);
-    m_transaction_info->push_back(info);
+    if (info.get_transaction_type() == TransactionInfo::read_transaction) {
+        m_read_transaction_latency.record(info.get_transaction_time());
+    }
+    else {
+        m_write_transaction_latency.record(info.get_transaction_time());
+        m_write_latency.record(info.get_write_time());
+        m_fsync_latency.record(info.get_fsync_time());
+    }
+    m_transaction_info.push(std::move(info));
 }
 
 void Metrics::start_read_transaction()
 {
     REALM_ASSERT_DEBUG(!m_pending_read);
-    m_pending_read = std::make_unique<TransactionInfo>(TransactionInfo::read_transaction);
+    m_pending_read = TransactionInfo(TransactionInfo::read_transaction);
 }
 
 void Metrics::start_write_transaction()
 {
     REALM_ASSERT_DEBUG(!m_pending_write);
-    m_pending_write = std::make_unique<TransactionInfo>(TransactionInfo::write_transaction);
+    m_pending_write = TransactionInfo(TransactionInfo::write_transaction);
 }
 
 void Metrics::end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions)
 {
-    REALM_ASSERT_DEBUG(m_transaction_info);
     if (m_pending_read) {
         m_pending_read->update_stats(total_size, free_space, num_objects, num_versions);
         m_pending_read->finish_timer();
-        m_transaction_info->push_back(*m_pending_read);
-        m_pending_read.reset(nullptr);
+        add_transaction(std::move(*m_pending_read));
+        m_pending_read = util::none;
     }
 }
 
 void Metrics::end_write_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions)
 {
-    REALM_ASSERT_DEBUG(m_transaction_info);
     if (m_pending_write) {
         m_pending_write->update_stats(total_size, free_space, num_objects, num_versions);
         m_pending_write->finish_timer();
-        m_transaction_info->push_back(*m_pending_write);
-        m_pending_write.reset(nullptr);
+        add_transaction(std::move(*m_pending_write));
+        m_pending_write = util::none;
     }
 }
 
@@ -94,9 +138,8 @@ std::unique_ptr<MetricTimer> Metrics::report_fsync_time(const Group& g)
 {
     std::shared_ptr<Metrics> instance = g.get_metrics();
     if (instance) {
-        REALM_ASSERT_DEBUG(instance->m_transaction_info);
         if (instance->m_pending_write) {
-            return std::make_unique<MetricTimer>(instance->m_pending_write->m_fsync_time);
+            return std::make_unique<MetricTimer>(&instance->m_pending_write->m_fsync_time);
         }
 
     }
@@ -107,9 +150,8 @@ std::unique_ptr<MetricTimer> Metrics::report_write_time(const Group& g)
 {
     std::shared_ptr<Metrics> instance = g.get_metrics();
     if (instance) {
-        REALM_ASSERT_DEBUG(instance->m_transaction_info);
         if (instance->m_pending_write) {
-            return std::make_unique<MetricTimer>(instance->m_pending_write->m_write_time);
+            return std::make_unique<MetricTimer>(&instance->m_pending_write->m_write_time);
         }
 
     }
@@ -119,19 +161,44 @@ std::unique_ptr<MetricTimer> Metrics::report_write_time(const Group& g)
 
 std::unique_ptr<Metrics::QueryInfoList> Metrics::take_queries()
 {
-
     std::unique_ptr<QueryInfoList> values = std::make_unique<QueryInfoList>();
-    values.swap(m_query_info);
+    m_query_info.take_all(*values);
     return values;
 }
 
 std::unique_ptr<Metrics::TransactionInfoList> Metrics::take_transactions()
 {
     std::unique_ptr<TransactionInfoList> values = std::make_unique<TransactionInfoList>();
-    values.swap(m_transaction_info);
+    m_transaction_info.take_all(*values);
     return values;
 }
 
+const LatencyHistogram& Metrics::get_query_latency(QueryInfo::QueryType type) const noexcept
+{
+    REALM_ASSERT_DEBUG(type <= QueryInfo::type_Invalid);
+    return m_query_latency[type];
+}
+
+const LatencyHistogram& Metrics::get_read_transaction_latency() const noexcept
+{
+    return m_read_transaction_latency;
+}
+
+const LatencyHistogram& Metrics::get_write_transaction_latency() const noexcept
+{
+    return m_write_transaction_latency;
+}
+
+const LatencyHistogram& Metrics::get_write_latency() const noexcept
+{
+    return m_write_latency;
+}
+
+const LatencyHistogram& Metrics::get_fsync_latency() const noexcept
+{
+    return m_fsync_latency;
+}
+
 
 
 #endif // REALM_METRICS
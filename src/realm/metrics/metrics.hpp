@@ -22,9 +22,12 @@
 #include <memory>
 #include <vector>
 
+#include <realm/metrics/latency_histogram.hpp>
 #include <realm/metrics/query_info.hpp>
+#include <realm/metrics/ring_buffer.hpp>
 #include <realm/metrics/transaction_info.hpp>
 #include <realm/util/features.h>
+#include <realm/util/optional.hpp>
 
 namespace realm {
 
@@ -34,16 +37,44 @@ namespace metrics {
 
 #if REALM_METRICS
 
+/// Collects timings of queries and transactions of a SharedGroup.
+///
+/// Every query and transaction is counted in a latency histogram for its
+/// kind. In addition, the most recent ones are kept as QueryInfo and
+/// TransactionInfo records in bounded buffers, which a monitoring thread can
+/// drain with take_queries() and take_transactions() while the SharedGroup is
+/// being used. Records are dropped, rather than stored, when a buffer is full.
 class Metrics {
 public:
-    Metrics();
+    static constexpr size_t default_max_history_size = 10000;
+
+    /// \param max_history_size The maximum number of query records and of
+    /// transaction records that are retained until they are taken.
+    ///
+    /// \param description_threshold Only capture the description of queries
+    /// that take at least this many seconds. If zero, every description is
+    /// captured before the query runs.
+    explicit Metrics(size_t max_history_size = default_max_history_size, double description_threshold = 0);
     ~Metrics() noexcept;
     size_t num_query_metrics() const;
     size_t num_transaction_metrics() const;
 
+    /// The number of records that were not retained because the buffer was
+    /// full. They are still counted in the histograms.
+    uint_fast64_t num_dropped_query_metrics() const;
+    uint_fast64_t num_dropped_transaction_metrics() const;
+
+    double get_description_threshold() const noexcept;
+
     void add_query(QueryInfo info);
     void add_transaction(TransactionInfo info);
 
+    /// Used by QueryInfo::track(). A query that is started while another one
+    /// is running (such as a subquery across links) is reported after the
+    /// outer query, so that records appear in the order the queries started.
+    size_t start_query(QueryInfo::QueryType type);
+    void end_query(size_t query_slot, double query_time, std::string description);
+
     void start_read_transaction();
     void start_write_transaction();
     void end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions);
@@ -57,12 +88,33 @@ public:
     // Get the list of metric objects tracked since the last take
     std::unique_ptr<QueryInfoList> take_queries();
     std::unique_ptr<TransactionInfoList> take_transactions();
-private:
-    std::unique_ptr<QueryInfoList> m_query_info;
-    std::unique_ptr<TransactionInfoList> m_transaction_info;
 
-    std::unique_ptr<TransactionInfo> m_pending_read;
-    std::unique_ptr<TransactionInfo> m_pending_write;
+    /// Latency distributions since the SharedGroup was opened. The write and
+    /// fsync histograms count the time spent writing and syncing the Realm
+    /// file during commits.
+    const LatencyHistogram& get_query_latency(QueryInfo::QueryType) const noexcept;
+    const LatencyHistogram& get_read_transaction_latency() const noexcept;
+    const LatencyHistogram& get_write_transaction_latency() const noexcept;
+    const LatencyHistogram& get_write_latency() const noexcept;
+    const LatencyHistogram& get_fsync_latency() const noexcept;
+
+private:
+    RingBuffer<QueryInfo> m_query_info;
+    RingBuffer<TransactionInfo> m_transaction_info;
+    const double m_description_threshold;
+
+    // Queries that have started but not all been reported yet, see start_query()
+    std::vector<QueryInfo> m_pending_queries;
+    size_t m_num_running_queries = 0;
+
+    util::Optional<TransactionInfo> m_pending_read;
+    util::Optional<TransactionInfo> m_pending_write;
+
+    LatencyHistogram m_query_latency[QueryInfo::type_Invalid + 1];
+    LatencyHistogram m_read_transaction_latency;
+    LatencyHistogram m_write_transaction_latency;
+    LatencyHistogram m_write_latency;
+    LatencyHistogram m_fsync_latency;
 };
 
 
@@ -70,6 +122,8 @@ private:
 
 class Metrics
 {
+public:
+    static constexpr size_t default_max_history_size = 10000;
 };
 
 #endif // REALM_METRICS
@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/metrics/query_info.hpp>
+#include <realm/metrics/metrics.hpp>
 #include <realm/group.hpp>
 #include <realm/table.hpp>
 #include <realm/query.hpp>
@@ -27,15 +28,51 @@
 using namespace realm;
 using namespace realm::metrics;
 
-QueryInfo::QueryInfo(const Query* query, QueryType type)
-    : m_type(type)
-{
-    REALM_ASSERT(query);
+namespace {
+
+// Reports the query to the metrics when it has finished executing. The query
+// accessor is still alive at that point, so the description can be captured
+// only for the queries where it is wanted.
+class QueryTimer : public MetricTimer {
+public:
+    QueryTimer(std::shared_ptr<Metrics> metrics, const Query* query, QueryInfo::QueryType type,
+               std::string description)
+        : m_metrics(std::move(metrics))
+        , m_query(query)
+        , m_description(std::move(description))
+    {
+        m_slot = m_metrics->start_query(type); // Throws
+    }
 
-    const Group* group = query->m_table->get_parent_group();
-    REALM_ASSERT(group);
+    ~QueryTimer() override
+    {
+        double time = get_elapsed_time();
+        std::string description = std::move(m_description);
+        if (description.empty() && time >= m_metrics->get_description_threshold()) {
+            try {
+                description = m_query->get_description(); // Throws
+            }
+            catch (...) {
+                // Not all queries can be described, the timing is still useful
+            }
+        }
+        m_metrics->end_query(m_slot, time, std::move(description));
+    }
+
+private:
+    std::shared_ptr<Metrics> m_metrics;
+    const Query* m_query;
+    std::string m_description;
+    size_t m_slot;
+};
+
+} // anonymous namespace
 
-    m_description = query->get_description();
+QueryInfo::QueryInfo(QueryType type, double query_time, std::string description)
+    : m_description(std::move(description))
+    , m_type(type)
+    , m_query_time(query_time)
+{
 }
 
 QueryInfo::~QueryInfo() noexcept
@@ -54,10 +91,7 @@ QueryInfo::QueryType QueryInfo::get_type() const
 
 double QueryInfo::get_query_time() const
 {
-    if (m_query_time) {
-        return m_query_time->get_elapsed_seconds();
-    }
-    return 0;
+    return m_query_time;
 }
 
 std::unique_ptr<MetricTimer> QueryInfo::track(const Query* query, QueryType type)
@@ -78,11 +112,13 @@ std::unique_ptr<MetricTimer> QueryInfo::track(const Query* query, QueryType type
     if (!metrics)
         return nullptr;
 
-    QueryInfo info(query, type);
-    info.m_query_time = std::make_shared<MetricTimerResult>();
-    metrics->add_query(info);
+    // Without a threshold every description is wanted. It is captured up front
+    // so that queries which cannot be described fail before they run.
+    std::string description;
+    if (metrics->get_description_threshold() <= 0)
+        description = query->get_description(); // Throws
 
-    return std::make_unique<MetricTimer>(info.m_query_time);
+    return std::make_unique<QueryTimer>(std::move(metrics), query, type, std::move(description));
 }
 
 QueryInfo::QueryType QueryInfo::type_from_action(Action action)
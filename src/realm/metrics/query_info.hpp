@@ -49,20 +49,27 @@ public:
         type_Invalid
     };
 
-    QueryInfo(const Query* query, QueryType type);
+    QueryInfo(QueryType type, double query_time, std::string description);
     ~QueryInfo() noexcept;
 
+    /// The description is only captured for queries that took at least
+    /// `SharedGroupOptions::metrics_description_threshold` seconds. It is
+    /// empty for faster queries.
     std::string get_description() const;
     QueryType get_type() const;
     double get_query_time() const;
 
+    /// Start timing the execution of \a query. The query is reported to the
+    /// metrics of the group that it belongs to when the returned timer is
+    /// destroyed, which must happen before the query is destroyed. Returns
+    /// null if metrics are not enabled for the group.
     static std::unique_ptr<MetricTimer> track(const Query* query, QueryType type);
     static QueryType type_from_action(Action action);
 
 private:
     std::string m_description;
     QueryType m_type;
-    std::shared_ptr<MetricTimerResult> m_query_time;
+    double m_query_time;
 };
 
 } // namespace metrics
@@ -0,0 +1,145 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_METRICS_RING_BUFFER_HPP
+#define REALM_METRICS_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <realm/util/features.h>
+
+namespace realm {
+namespace metrics {
+
+/// A bounded single-producer, single-consumer queue. One thread may push()
+/// while another thread concurrently calls take_all(); neither blocks. When
+/// the buffer is full, new elements are dropped rather than evicting old
+/// ones, so that the consumer never races with the producer over a slot. The
+/// number of dropped elements is available through get_num_dropped().
+template <class T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity);
+    ~RingBuffer() noexcept;
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /// Returns false if the buffer was full and the element was dropped.
+    bool push(T&& value);
+
+    /// Move all elements currently in the buffer to the end of \a out, oldest
+    /// first.
+    void take_all(std::vector<T>& out);
+
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
+    uint_fast64_t get_num_dropped() const noexcept;
+
+private:
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    const size_t m_capacity;
+    std::unique_ptr<Storage[]> m_slots;
+    // Monotonic counters of elements pushed and taken. m_tail is only written
+    // by the producer, m_head only by the consumer.
+    std::atomic<uint_fast64_t> m_head{0};
+    std::atomic<uint_fast64_t> m_tail{0};
+    std::atomic<uint_fast64_t> m_dropped{0};
+
+    T* slot(uint_fast64_t pos) noexcept
+    {
+        return reinterpret_cast<T*>(&m_slots[size_t(pos % m_capacity)]);
+    }
+};
+
+
+// Implementation:
+
+template <class T>
+RingBuffer<T>::RingBuffer(size_t capacity)
+    : m_capacity(capacity == 0 ? 1 : capacity)
+    , m_slots(new Storage[m_capacity]) // Throws
+{
+}
+
+template <class T>
+RingBuffer<T>::~RingBuffer() noexcept
+{
+    uint_fast64_t tail = m_tail.load(std::memory_order_relaxed);
+    for (uint_fast64_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+        slot(i)->~T();
+}
+
+template <class T>
+bool RingBuffer<T>::push(T&& value)
+{
+    uint_fast64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint_fast64_t head = m_head.load(std::memory_order_acquire);
+    if (tail - head == m_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    new (slot(tail)) T(std::move(value)); // Throws
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <class T>
+void RingBuffer<T>::take_all(std::vector<T>& out)
+{
+    uint_fast64_t head = m_head.load(std::memory_order_relaxed);
+    uint_fast64_t tail = m_tail.load(std::memory_order_acquire);
+    out.reserve(out.size() + size_t(tail - head)); // Throws
+    for (; head != tail; ++head) {
+        T* elem = slot(head);
+        out.push_back(std::move(*elem));
+        elem->~T();
+    }
+    m_head.store(head, std::memory_order_release);
+}
+
+template <class T>
+inline size_t RingBuffer<T>::size() const noexcept
+{
+    uint_fast64_t head = m_head.load(std::memory_order_acquire);
+    return size_t(m_tail.load(std::memory_order_acquire) - head);
+}
+
+template <class T>
+inline size_t RingBuffer<T>::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+template <class T>
+inline uint_fast64_t RingBuffer<T>::get_num_dropped() const noexcept
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace metrics
+} // namespace realm
+
+#endif // REALM_METRICS_RING_BUFFER_HPP
@@ -28,11 +28,8 @@ TransactionInfo::TransactionInfo(TransactionInfo::TransactionType type)
     , m_realm_free_space(0)
     , m_total_objects(0)
     , m_type(type)
+    , m_num_versions(0)
 {
-    if (m_type == write_transaction) {
-        m_fsync_time = std::make_shared<MetricTimerResult>();
-        m_write_time = std::make_shared<MetricTimerResult>();
-    }
 }
 
 TransactionInfo::~TransactionInfo() noexcept
@@ -51,18 +48,12 @@ double TransactionInfo::get_transaction_time() const
 
 double TransactionInfo::get_fsync_time() const
 {
-    if (m_fsync_time) {
-        return m_fsync_time->get_elapsed_seconds();
-    }
-    return 0;
+    return m_fsync_time.get_elapsed_seconds();
 }
 
 double TransactionInfo::get_write_time() const
 {
-    if (m_write_time) {
-        return m_write_time->get_elapsed_seconds();
-    }
-    return 0;
+    return m_write_time.get_elapsed_seconds();
 }
 
 size_t TransactionInfo::get_disk_size() const
@@ -54,8 +54,8 @@ public:
 
 private:
     MetricTimerResult m_transaction_time;
-    std::shared_ptr<MetricTimerResult> m_fsync_time;
-    std::shared_ptr<MetricTimerResult> m_write_time;
+    MetricTimerResult m_fsync_time;
+    MetricTimerResult m_write_time;
     MetricTimer m_transact_timer;
 
     size_t m_realm_disk_size;
@@ -19,6 +19,9 @@
 #include "parser.hpp"
 
 #include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 #include <pegtl.hpp>
 #include <pegtl/analyze.hpp>
@@ -678,7 +681,64 @@ const std::string error_message_control< chars >::error_message = "Invalid chara
 template< typename Rule>
 const std::string error_message_control< Rule >::error_message = "Invalid predicate.";
 
-ParserResult parse(const std::string &query)
+namespace {
+
+// Parse results depend only on the query text, not on any schema, so the text
+// alone is the key. Key paths are resolved against a table later, by
+// query_builder::apply_predicate().
+class ParseCache {
+public:
+    std::shared_ptr<const ParserResult> get(const std::string& query)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto i = m_index.find(query);
+        if (i == m_index.end())
+            return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, i->second);
+        return i->second->second;
+    }
+
+    void put(const std::string& query, std::shared_ptr<const ParserResult> result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_capacity == 0 || m_index.count(query))
+            return;
+        m_entries.emplace_front(query, std::move(result));
+        m_index.emplace(query, m_entries.begin());
+        trim();
+    }
+
+    void set_capacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+        trim();
+    }
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const ParserResult>>;
+
+    std::mutex m_mutex;
+    size_t m_capacity = 256;
+    std::list<Entry> m_entries; // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+    void trim()
+    {
+        while (m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+};
+
+ParseCache& parse_cache()
+{
+    static ParseCache cache;
+    return cache;
+}
+
+ParserResult do_parse(const std::string &query)
 {
     DEBUG_PRINT_TOKEN(query);
 
@@ -696,6 +756,23 @@ ParserResult parse(const std::string &query)
     return ParserResult{ out_predicate, state.ordering_state};
 }
 
+} // anonymous namespace
+
+std::shared_ptr<const ParserResult> parse(const std::string &query)
+{
+    if (auto cached = parse_cache().get(query))
+        return cached;
+
+    auto result = std::make_shared<const ParserResult>(do_parse(query));
+    parse_cache().put(query, result);
+    return result;
+}
+
+void set_parse_cache_capacity(size_t capacity)
+{
+    parse_cache().set_capacity(capacity);
+}
+
 size_t analyze_grammar()
 {
     return analyze<pred>();
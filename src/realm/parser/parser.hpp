@@ -129,7 +129,13 @@ struct ParserResult
     DescriptorOrderingState ordering;
 };
 
-ParserResult parse(const std::string &query);
+// Parse results are kept in a process wide LRU cache keyed by the query text,
+// which may be used from several threads at once. A cache hit returns the
+// cached result itself, which is why results are shared and immutable.
+std::shared_ptr<const ParserResult> parse(const std::string &query);
+
+// Set the number of parse results kept in the cache. Zero disables caching.
+void set_parse_cache_capacity(size_t capacity);
 
 // run the analysis tool to check for cycles in the grammar
 // returns the number of problems found and prints some info to std::cout
@@ -26,8 +26,10 @@
 #include <realm/query_engine.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
+#include <realm/util/scope_exit.hpp>
 
 #include <algorithm>
+#include <chrono>
 
 
 using namespace realm;
@@ -968,7 +970,7 @@ R Query::aggregate(R (ColType::*aggregateMethod)(size_t start, size_t end, size_
 
 void Query::aggregate_internal(Action TAction, DataType TSourceColumn, bool nullable, ParentNode* pn,
                                QueryStateBase* st, size_t start, size_t end,
-                               SequentialGetterBase* source_column) const
+                               SequentialGetterBase* source_column, QueryProfile* profile) const
 {
     if (end == not_found)
         end = m_table->size();
@@ -976,6 +978,29 @@ void Query::aggregate_internal(Action TAction, DataType TSourceColumn, bool null
     for (size_t c = 0; c < pn->m_children.size(); c++)
         pn->m_children[c]->aggregate_local_prepare(TAction, TSourceColumn, nullable);
 
+    // Let child c aggregate the range local_start...local_end, recording what it did when profiling
+    auto run_local = [&](size_t c, size_t local_start, size_t local_end, size_t local_limit) -> size_t {
+        ParentNode* node = pn->m_children[c];
+        if (REALM_LIKELY(!profile))
+            return node->aggregate_local(st, local_start, local_end, local_limit, source_column);
+
+        QueryNodeProfile& node_profile = profile->nodes[c];
+        auto count_state = dynamic_cast<QueryState<int64_t>*>(st);
+        size_t matches_before = count_state ? count_state->m_match_count : 0;
+        auto time_start = std::chrono::steady_clock::now();
+        size_t next = node->aggregate_local(st, local_start, local_end, local_limit, source_column);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - time_start;
+
+        node_profile.time += elapsed.count();
+        node_profile.times_chosen++;
+        node_profile.rows_scanned += std::min(next, local_end) - local_start;
+        if (count_state)
+            node_profile.matches += count_state->m_match_count - matches_before;
+        if (profile->node_order.empty() || profile->node_order.back() != c)
+            profile->node_order.push_back(c);
+        return next;
+    };
+
     size_t td;
 
     while (start < end) {
@@ -990,7 +1015,7 @@ void Query::aggregate_internal(Action TAction, DataType TSourceColumn, bool null
         // on. Can be called on any node; yields same result, but different performance. Returns prematurely if
         // condition of called node has evaluated to true local_matches number of times.
         // Return value is the next row for resuming aggregating (next row that caller must call aggregate_local on)
-        start = pn->m_children[best]->aggregate_local(st, start, td, findlocals, source_column);
+        start = run_local(best, start, td, findlocals);
 
         // Make remaining conditions compute their m_dD (statistics)
         for (size_t c = 0; c < pn->m_children.size() && start < end; c++) {
@@ -1004,7 +1029,7 @@ void Query::aggregate_internal(Action TAction, DataType TSourceColumn, bool null
                 // Limit to bestdist in order not to skip too large parts of index nodes
                 size_t maxD = pn->m_children[c]->m_dT == 0.0 ? end - start : bestdist;
                 td = pn->m_children[c]->m_dT == 0.0 ? end : (start + maxD > end ? end : start + maxD);
-                start = pn->m_children[c]->aggregate_local(st, start, td, probe_matches, source_column);
+                start = run_local(c, start, td, probe_matches);
             }
         }
     }
@@ -1624,7 +1649,89 @@ void Query::init() const
         root->init();
         std::vector<ParentNode*> v;
         root->gather_children(v);
+
+        // With more than one condition, estimate up front which one should drive the search
+        if (v.size() > 1) {
+            for (ParentNode* node : v)
+                node->estimate_cost();
+            root->choose_first_child();
+        }
+    }
+}
+
+QueryProfile Query::explain() const
+{
+    QueryProfile profile;
+    ParentNode* root = root_node();
+    if (!root || m_table->is_degenerate())
+        return profile;
+
+    init();
+
+    util::serializer::SerialisationState state;
+    for (const ParentNode* node : root->m_children) {
+        QueryNodeProfile node_profile;
+        try {
+            node_profile.description = node->describe(state); // Throws
+        }
+        catch (const SerialisationError&) {
+            // Leave the description empty
+        }
+        node_profile.uses_index = node->uses_index();
+        node_profile.cost = node->cost();
+        profile.nodes.push_back(std::move(node_profile));
+    }
+
+    for (size_t i = 0; i < profile.nodes.size(); ++i)
+        profile.node_order.push_back(i);
+    std::stable_sort(profile.node_order.begin(), profile.node_order.end(),
+                     [&](size_t a, size_t b) { return profile.nodes[a].cost < profile.nodes[b].cost; });
+    return profile;
+}
+
+QueryProfile Query::profile(size_t start, size_t end) const
+{
+    QueryProfile profile = explain(); // Initializes the nodes
+    profile.executed = true;
+    profile.node_order.clear();
+    if (m_table->is_degenerate())
+        return profile;
+
+    if (end == size_t(-1))
+        end = m_table->size();
+    profile.rows = end - start;
+
+    auto time_start = std::chrono::steady_clock::now();
+    if (!has_conditions() || m_view) {
+        // Nothing to break down per condition
+        profile.matches = count(start, end);
+    }
+    else {
+        ParentNode* root = root_node();
+        std::vector<size_t> probes_before;
+        for (size_t i = 0; i < root->m_children.size(); ++i) {
+            root->m_children[i]->m_profile = &profile.nodes[i];
+            probes_before.push_back(root->m_children[i]->m_probes);
+        }
+        auto detach = util::make_scope_exit([&]() noexcept {
+            for (ParentNode* node : root->m_children)
+                node->m_profile = nullptr;
+        });
+
+        QueryState<int64_t> st;
+        st.init(act_Count, nullptr, size_t(-1));
+        aggregate_internal(act_Count, ColumnTypeTraits<int64_t>::id, false, root, &st, start, end, nullptr,
+                           &profile);
+        profile.matches = size_t(st.m_state);
+
+        for (size_t i = 0; i < root->m_children.size(); ++i) {
+            profile.nodes[i].probes = root->m_children[i]->m_probes - probes_before[i];
+            profile.nodes[i].cost = root->m_children[i]->cost();
+        }
     }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - time_start;
+    profile.time = elapsed.count();
+    return profile;
 }
 
 size_t Query::find_internal(size_t start, size_t end) const
@@ -42,6 +42,7 @@
 #include <realm/link_view_fwd.hpp>
 #include <realm/descriptor_fwd.hpp>
 #include <realm/row.hpp>
+#include <realm/query_profile.hpp>
 #include <realm/util/serializer.hpp>
 
 namespace realm {
@@ -346,6 +347,18 @@ public:
     std::string get_description() const;
     std::string get_description(util::serializer::SerialisationState& state) const;
 
+    /// Describe how the conditions of this query would be evaluated, without
+    /// running it: the condition nodes, their initial cost estimates, whether
+    /// they use a search index, and the order in which they are preferred.
+    /// See QueryProfile.
+    QueryProfile explain() const;
+
+    /// Run the query over the specified range of rows, in the same way as
+    /// count(), and report per condition how much work it did and how long it
+    /// took. Profiling adds a small overhead to every range that a condition
+    /// scans, so timings are somewhat inflated for very selective queries.
+    QueryProfile profile(size_t start = 0, size_t end = size_t(-1)) const;
+
 private:
     Query(Table& table, TableViewBase* tv = nullptr);
     void create();
@@ -419,7 +432,8 @@ private:
                 size_t start, size_t end, size_t limit, size_t* return_ndx = nullptr) const;
 
     void aggregate_internal(Action TAction, DataType TSourceColumn, bool nullable, ParentNode* pn, QueryStateBase* st,
-                            size_t start, size_t end, SequentialGetterBase* source_column) const;
+                            size_t start, size_t end, SequentialGetterBase* source_column,
+                            QueryProfile* profile = nullptr) const;
 
     void find_all(TableViewBase& tv, size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1)) const;
     void delete_nodes() noexcept;
@@ -16,6 +16,8 @@
  *
  **************************************************************************/
 
+#include <queue>
+
 #include <realm/query_engine.hpp>
 
 #include <realm/query_expression.hpp>
@@ -25,8 +27,8 @@ using namespace realm;
 size_t ParentNode::find_first(size_t start, size_t end)
 {
     size_t sz = m_children.size();
-    size_t current_cond = 0;
     size_t nb_cond_to_test = sz;
+    size_t current_cond = m_first_child;
 
     while (REALM_LIKELY(start < end)) {
         size_t m = m_children[current_cond]->find_first_local(start, end);
@@ -51,6 +53,33 @@ size_t ParentNode::find_first(size_t start, size_t end)
     return not_found;
 }
 
+void ParentNode::estimate_cost()
+{
+    uint_fast64_t version = m_table->get_version_counter();
+    if (version != m_estimate_version) {
+        double selectivity = estimate_selectivity();
+        if (selectivity < 0) {
+            m_estimated_dD = 0;
+        }
+        else {
+            // Same as the match distance measured by aggregate_local() over the whole table
+            double size = double(m_table->size());
+            m_estimated_dD = (size + 1) / (selectivity * size + 1);
+        }
+        m_estimate_version = version;
+    }
+    if (m_estimated_dD > 0)
+        m_dD = m_estimated_dD;
+}
+
+void ParentNode::choose_first_child()
+{
+    // Start with the condition that is expected to skip the most rows
+    auto score_compare = [](const ParentNode* a, const ParentNode* b) { return a->cost() < b->cost(); };
+    auto i = std::min_element(m_children.begin(), m_children.end(), score_compare);
+    m_first_child = size_t(std::distance(m_children.begin(), i));
+}
+
 void ParentNode::aggregate_local_prepare(Action TAction, DataType col_id, bool nullable)
 {
     if (TAction == act_ReturnFirst) {
@@ -160,6 +189,7 @@ size_t ParentNode::aggregate_local(QueryStateBase* st, size_t start, size_t end,
         size_t m = r;
 
         for (size_t c = 1; c < m_children.size(); c++) {
+            m_children[c]->m_probes++;
             m = m_children[c]->find_first_local(r, r + 1);
             if (m != r) {
                 break;
@@ -225,6 +255,15 @@ void StringNodeEqualBase::init()
     }
 }
 
+double StringNodeEqualBase::estimate_selectivity()
+{
+    // The search index has already counted the matches exactly
+    if (!m_condition_column->has_search_index() || m_table->size() == 0)
+        return -1;
+    size_t matches = m_index_matches ? m_results_end - m_results_start : 0;
+    return double(matches) / m_table->size();
+}
+
 size_t StringNodeEqualBase::find_first_local(size_t start, size_t end)
 {
     REALM_ASSERT(m_table);
@@ -325,6 +364,16 @@ void StringNode<Equal>::_search_index_init()
     }
 }
 
+bool StringNode<Equal>::get_index_matches(const IntegerColumn*& rows, size_t& begin, size_t& end) const
+{
+    if (!m_condition_column->has_search_index())
+        return false;
+    rows = m_index_matches.get();
+    begin = rows ? m_results_start : 0;
+    end = rows ? m_results_end : 0;
+    return true;
+}
+
 size_t StringNode<Equal>::_find_first_local(size_t start, size_t end)
 {
     // Normal string column, with long or short leaf
@@ -399,6 +448,64 @@ size_t StringNode<EqualIns>::_find_first_local(size_t start, size_t end)
 
 } // namespace realm
 
+void OrNode::init_index_rows()
+{
+    m_index_rows.clear();
+    m_index_driven = false;
+
+    // The rows found by one condition, read a leaf at a time
+    struct Stream {
+        SequentialGetter<IntegerColumn> getter;
+        size_t pos;
+        size_t end;
+
+        Stream(const IntegerColumn* rows, size_t begin, size_t end_pos)
+            : getter(rows)
+            , pos(begin)
+            , end(end_pos)
+        {
+        }
+
+        size_t get()
+        {
+            if (pos >= getter.m_leaf_end || pos < getter.m_leaf_start)
+                getter.cache_next(pos);
+            return to_size_t(getter.m_leaf_ptr->get(pos - getter.m_leaf_start));
+        }
+    };
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (auto& condition : m_conditions) {
+        const IntegerColumn* rows = nullptr;
+        size_t begin = 0;
+        size_t end = 0;
+        if (condition->m_child || !condition->get_index_matches(rows, begin, end))
+            return;
+        if (rows && begin < end)
+            streams.emplace_back(new Stream(rows, begin, end)); // Throws
+    }
+
+    // Merge the ascending streams, dropping rows that match more than one
+    // condition
+    using Head = std::pair<size_t, size_t>; // Row, stream
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t i = 0; i < streams.size(); ++i)
+        heads.emplace(streams[i]->get(), i);
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        if (m_index_rows.empty() || m_index_rows.back() != head.first)
+            m_index_rows.push_back(head.first);
+        Stream& stream = *streams[head.second];
+        if (++stream.pos < stream.end)
+            heads.emplace(stream.get(), head.second);
+    }
+
+    m_index_driven = true;
+    m_dT = 0.0;
+    m_dD = double(m_table->size() + 1) / (m_index_rows.size() + 1);
+}
+
 size_t NotNode::find_first_local(size_t start, size_t end)
 {
     if (start <= m_known_range_start && end >= m_known_range_end) {
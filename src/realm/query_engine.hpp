@@ -97,17 +97,20 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <realm/column_link.hpp>
 #include <realm/column_linklist.hpp>
 #include <realm/column_mixed.hpp>
+#include <realm/column_statistics.hpp>
 #include <realm/column_string.hpp>
 #include <realm/column_string_enum.hpp>
 #include <realm/column_table.hpp>
 #include <realm/column_timestamp.hpp>
 #include <realm/column_type_traits.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/impl/float_kernels.hpp>
 #include <realm/impl/sequential_getter.hpp>
 #include <realm/link_view.hpp>
 #include <realm/metrics/query_info.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/query_operators.hpp>
+#include <realm/query_profile.hpp>
 #include <realm/table.hpp>
 #include <realm/unicode.hpp>
 #include <realm/util/miscellaneous.hpp>
@@ -138,6 +141,10 @@ const size_t probe_matches = 4;
 
 const size_t bitwidth_time_unit = 64;
 
+// Minimum number of rows before the initial cost of a condition is estimated from a sample of its column. The
+// conditions of smaller tables are cheap to evaluate in any order, and the probing soon corrects a bad start.
+const size_t statistics_min_rows = 4 * ColumnStatistics<int64_t>::max_sample_size;
+
 typedef bool (*CallbackDummy)(int64_t);
 
 class ParentNode {
@@ -159,6 +166,7 @@ public:
         m_children = v;
         m_children.erase(m_children.begin() + i);
         m_children.insert(m_children.begin(), this);
+        m_first_child = 0;
     }
 
     double cost() const
@@ -169,6 +177,16 @@ public:
 
     size_t find_first(size_t start, size_t end);
 
+    /// Set the initial match distance from the estimated selectivity of the
+    /// condition, if there is one, so that the cheapest condition drives the
+    /// search from the start. The estimate is kept until the table changes.
+    void estimate_cost();
+
+    /// Make find_first() start with the child of the lowest cost(). This is
+    /// done once per query execution, after estimate_cost() has been called
+    /// on the children.
+    void choose_first_child();
+
     virtual void init()
     {
         // Verify that the cached column accessor is still valid
@@ -186,6 +204,7 @@ public:
             return;
 
         m_table.reset(&table);
+        m_estimate_version = uint_fast64_t(-1);
         if (m_child)
             m_child->set_table(table);
         table_changed();
@@ -247,6 +266,8 @@ public:
         , m_probes(from.m_probes)
         , m_matches(from.m_matches)
         , m_table(patches ? ConstTableRef{} : from.m_table)
+        , m_estimated_dD(from.m_estimated_dD)
+        , m_estimate_version(patches ? uint_fast64_t(-1) : from.m_estimate_version)
     {
     }
 
@@ -278,6 +299,30 @@ public:
         return "matches";
     }
 
+    /// True if the condition is evaluated by looking up a search index.
+    virtual bool uses_index() const
+    {
+        return false;
+    }
+
+    /// The estimated fraction of the rows of the table that match the
+    /// condition of this node, not counting its children, or a negative value
+    /// if the node has no estimate. Called after init().
+    virtual double estimate_selectivity()
+    {
+        return -1;
+    }
+
+    /// If init() has looked up the rows that match the condition of this node,
+    /// not counting its children, in a search index, set \a rows to the column
+    /// of row indexes that holds them, in ascending order, at positions
+    /// [\a begin, \a end), and return true. \a rows is set to null if no row
+    /// matches.
+    virtual bool get_index_matches(const IntegerColumn*&, size_t&, size_t&) const
+    {
+        return false;
+    }
+
     virtual std::string describe_expression(util::serializer::SerialisationState& state) const
     {
         std::string s;
@@ -299,12 +344,23 @@ public:
     size_t m_probes = 0;
     size_t m_matches = 0;
 
+    // Statistics of the current execution, only set by Query::profile()
+    QueryNodeProfile* m_profile = nullptr;
+
 protected:
     typedef bool (ParentNode::*Column_action_specialized)(QueryStateBase*, SequentialGetterBase*, size_t);
     Column_action_specialized m_column_action_specializer;
     ConstTableRef m_table;
     std::string error_code;
 
+    // The match distance found by estimate_cost(), valid while the version
+    // counter of the table is m_estimate_version
+    double m_estimated_dD = 0;
+    uint_fast64_t m_estimate_version = uint_fast64_t(-1);
+
+    // The index in m_children of the condition find_first() starts with
+    size_t m_first_child = 0;
+
     const ColumnBase& get_column_base(size_t ndx)
     {
         return m_table->get_column_base(ndx);
@@ -597,7 +653,7 @@ protected:
         // column only, with no references to other columns:
         bool fastmode = should_run_in_fastmode(source_column);
         for (size_t s = start; s < end;) {
-            cache_leaf(s);
+            cache_leaf(s, end);
 
             size_t end_in_leaf;
             if (end > m_leaf_end)
@@ -676,6 +732,7 @@ protected:
         m_leaf_end = 0;
         m_array_ptr.reset(); // Explicitly destroy the old one first, because we're reusing the memory.
         m_array_ptr.reset(new (&m_leaf_cache_storage) LeafType(m_table->get_alloc()));
+        m_prefetch = true;
     }
 
     void get_leaf(const ColType& col, size_t ndx)
@@ -685,17 +742,32 @@ protected:
         col.get_leaf(ndx, ndx_in_leaf, leaf_info);
         m_leaf_start = ndx - ndx_in_leaf;
         m_leaf_end = m_leaf_start + m_leaf_ptr->size();
+        if (REALM_UNLIKELY(m_profile))
+            ++m_profile->leaves_scanned;
     }
 
-    void cache_leaf(size_t s)
+    void cache_leaf(size_t s, size_t end)
     {
         if (s >= m_leaf_end || s < m_leaf_start) {
             get_leaf(*m_condition_column, s);
+            prefetch_next_leaf(end);
             size_t w = m_leaf_ptr->get_width();
             m_dT = (w == 0 ? 1.0 / REALM_MAX_BPNODE_SIZE : w / float(bitwidth_time_unit));
         }
     }
 
+    // If the scan continues past the cached leaf, ask for the next leaf to be
+    // paged in while the current one is being searched. On a cold file this
+    // overlaps the page faults of the next leaf with the work on this one. The
+    // allocator declines when the next leaf is resident already and the file
+    // is not being scanned sequentially, and then the rest of the scan skips
+    // the check, as the file is warm.
+    void prefetch_next_leaf(size_t end) noexcept
+    {
+        if (m_prefetch && end > m_leaf_end)
+            m_prefetch = m_condition_column->prefetch_leaf(m_leaf_end, m_leaf_ptr->get_byte_size());
+    }
+
     bool should_run_in_fastmode(SequentialGetterBase* source_column) const
     {
         return (m_children.size() == 1 &&
@@ -718,6 +790,7 @@ protected:
     size_t m_leaf_start = npos;
     size_t m_leaf_end = 0;
     size_t m_local_end;
+    bool m_prefetch = true;
 
     // Aggregate optimization
     using TFind_callback_specialized = bool (ThisType::*)(size_t, size_t);
@@ -767,6 +840,7 @@ public:
             // Cache internal leaves
             if (start >= this->m_leaf_end || start < this->m_leaf_start) {
                 this->get_leaf(*this->m_condition_column, start);
+                this->prefetch_next_leaf(end);
             }
 
             // FIXME: Create a fast bypass when you just need to check 1 row, which is used alot from within core.
@@ -805,6 +879,15 @@ public:
         return TConditionFunction::description();
     }
 
+    double estimate_selectivity() override
+    {
+        if (this->m_table->size() < statistics_min_rows)
+            return -1;
+        ColumnStatistics<int64_t> statistics;
+        statistics.sample(*this->m_condition_column);
+        return statistics.template selectivity<TConditionFunction>(this->m_value);
+    }
+
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
         return std::unique_ptr<ParentNode>(new IntegerNode<ColType, TConditionFunction>(*this, patches));
@@ -875,6 +958,44 @@ protected:
 };
 
 
+// The conditions of FloatDoubleNode that have a vectorized kernel
+template <class TConditionFunction>
+struct FloatKernelCompare {
+    static const bool supported = false;
+    static const _impl::FloatCompare value = _impl::FloatCompare::equal;
+};
+
+template <>
+struct FloatKernelCompare<Equal> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::equal;
+};
+template <>
+struct FloatKernelCompare<NotEqual> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::not_equal;
+};
+template <>
+struct FloatKernelCompare<Less> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::less;
+};
+template <>
+struct FloatKernelCompare<LessEqual> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::less_equal;
+};
+template <>
+struct FloatKernelCompare<Greater> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::greater;
+};
+template <>
+struct FloatKernelCompare<GreaterEqual> {
+    static const bool supported = true;
+    static const _impl::FloatCompare value = _impl::FloatCompare::greater_equal;
+};
+
 // This node is currently used for floats and doubles only
 template <class ColType, class TConditionFunction>
 class FloatDoubleNode : public ParentNode {
@@ -913,6 +1034,11 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        // A null argument has its own semantics for each condition, so only
+        // non-null arguments go through the kernels
+        if (FloatKernelCompare<TConditionFunction>::supported && !null::is_null_float(m_value))
+            return find_first_kernel(start, end);
+
         TConditionFunction cond;
 
         auto find = [&](bool nullability) {
@@ -933,6 +1059,22 @@ public:
             return find(false);
     }
 
+    size_t find_first_kernel(size_t start, size_t end)
+    {
+        for (size_t s = start; s < end;) {
+            m_condition_column.cache_next(s);
+            size_t local_start = s - m_condition_column.m_leaf_start;
+            size_t local_end = m_condition_column.local_end(end);
+            size_t res = _impl::float_find_first(FloatKernelCompare<TConditionFunction>::value,
+                                                 m_condition_column.m_leaf_ptr->data(), local_start, local_end,
+                                                 m_value);
+            if (res != npos)
+                return m_condition_column.m_leaf_start + res;
+            s = m_condition_column.m_leaf_start + local_end;
+        }
+        return not_found;
+    }
+
     virtual std::string describe(util::serializer::SerialisationState& state) const override
     {
         REALM_ASSERT(m_condition_column.m_column != nullptr);
@@ -944,6 +1086,15 @@ public:
         return TConditionFunction::description();
     }
 
+    double estimate_selectivity() override
+    {
+        if (m_table->size() < statistics_min_rows)
+            return -1;
+        ColumnStatistics<TConditionValue> statistics;
+        statistics.sample(*m_condition_column.m_column);
+        return statistics.template selectivity<TConditionFunction>(m_value);
+    }
+
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
         return std::unique_ptr<ParentNode>(new FloatDoubleNode(*this, patches));
@@ -1143,6 +1294,15 @@ public:
             + " " + TConditionFunction::description() + " " + util::serializer::print_value(TimestampNode::m_value);
     }
 
+    double estimate_selectivity() override
+    {
+        if (m_table->size() < statistics_min_rows)
+            return -1;
+        ColumnStatistics<Timestamp> statistics;
+        statistics.sample(*m_condition_column);
+        return statistics.template selectivity<TConditionFunction>(m_value);
+    }
+
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
         return std::unique_ptr<ParentNode>(new TimestampNode(*this, patches));
@@ -1513,6 +1673,13 @@ public:
         return Equal::description();
     }
 
+    bool uses_index() const override
+    {
+        return m_condition_column && m_condition_column->has_search_index();
+    }
+
+    double estimate_selectivity() override;
+
 protected:
     inline BinaryData str_to_bin(const StringData& s) noexcept
     {
@@ -1547,6 +1714,7 @@ public:
     using StringNodeEqualBase::StringNodeEqualBase;
 
     void _search_index_init() override;
+    bool get_index_matches(const IntegerColumn*& rows, size_t& begin, size_t& end) const override;
 
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
@@ -1667,6 +1835,7 @@ public:
         ParentNode::init();
 
         m_dD = 10.0;
+        m_dT = 50.0;
 
         m_start.clear();
         m_start.resize(m_conditions.size(), 0);
@@ -1683,6 +1852,8 @@ public:
             v.clear();
             condition->gather_children(v);
         }
+
+        init_index_rows();
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -1690,6 +1861,11 @@ public:
         if (start >= end)
             return not_found;
 
+        if (m_index_driven) {
+            auto it = std::lower_bound(m_index_rows.begin(), m_index_rows.end(), start);
+            return it != m_index_rows.end() && *it < end ? *it : not_found;
+        }
+
         size_t index = not_found;
 
         for (size_t c = 0; c < m_conditions.size(); ++c) {
@@ -1720,6 +1896,18 @@ public:
         return index;
     }
 
+    bool uses_index() const override
+    {
+        return m_index_driven;
+    }
+
+    double estimate_selectivity() override
+    {
+        if (!m_index_driven || m_table->size() == 0)
+            return -1;
+        return double(m_index_rows.size()) / m_table->size();
+    }
+
     std::string validate() override
     {
         if (error_code != "")
@@ -1757,12 +1945,21 @@ public:
     std::vector<std::unique_ptr<ParentNode>> m_conditions;
 
 private:
+    // If every condition is a single condition looked up in a search index,
+    // merge the rows they found into m_index_rows and search that instead.
+    void init_index_rows();
+
     // start index of the last find for each cond
     std::vector<size_t> m_start;
     // last looked at index of the lasft find for each cond
     // is a matching index if m_was_match is true
     std::vector<size_t> m_last;
     std::vector<bool> m_was_match;
+
+    // The rows that match any of the conditions, in ascending order, when
+    // m_index_driven is set
+    std::vector<size_t> m_index_rows;
+    bool m_index_driven = false;
 };
 
 
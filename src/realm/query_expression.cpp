@@ -22,13 +22,13 @@ namespace realm {
 
 void Columns<Link>::evaluate(size_t index, ValueBase& destination)
 {
-    std::vector<size_t> links = m_link_map.get_links(index);
-    Value<RowIndex> v = make_value_for_link<RowIndex>(m_link_map.only_unary_links(), links.size());
+    const std::vector<size_t>& links = m_link_map.get_links(index);
+    init_value_for_link(m_link_values, m_link_map.only_unary_links(), links.size());
 
     for (size_t t = 0; t < links.size(); t++) {
-        v.m_storage.set(t, RowIndex(links[t]));
+        m_link_values.m_storage.set(t, RowIndex(links[t]));
     }
-    destination.import(v);
+    destination.import(m_link_values);
 }
 
 void Columns<SubTable>::evaluate_internal(size_t index, ValueBase& destination, size_t nb_elements)
@@ -38,7 +38,7 @@ void Columns<SubTable>::evaluate_internal(size_t index, ValueBase& destination,
     REALM_ASSERT(d);
 
     if (m_link_map.m_link_columns.size() > 0) {
-        std::vector<size_t> links = m_link_map.get_links(index);
+        const std::vector<size_t>& links = m_link_map.get_links(index);
         auto sz = links.size();
 
         if (m_link_map.only_unary_links()) {
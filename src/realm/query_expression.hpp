@@ -931,19 +931,16 @@ struct NullableVector {
         }
     }
 
+    // The storage is only reallocated when it must grow, so that evaluating
+    // link lists of varying length does not hit the heap for every row.
     void init(size_t size)
     {
-        if (size == m_size)
-            return;
-
-        dealloc();
-        m_size = size;
-        if (m_size > 0) {
-            if (m_size > prealloc)
-                m_first = reinterpret_cast<t_storage*>(new t_storage[m_size]);
-            else
-                m_first = m_cache;
+        if (size > m_capacity) {
+            dealloc();
+            m_first = new t_storage[size];
+            m_capacity = size;
         }
+        m_size = size;
     }
 
     void init(size_t size, T values)
@@ -954,16 +951,17 @@ struct NullableVector {
 
     void dealloc()
     {
-        if (m_first) {
-            if (m_size > prealloc)
-                delete[] m_first;
-            m_first = nullptr;
+        if (m_first != m_cache) {
+            delete[] m_first;
+            m_first = m_cache;
+            m_capacity = prealloc;
         }
     }
 
     t_storage m_cache[prealloc];
     t_storage* m_first = &m_cache[0];
     size_t m_size = 0;
+    size_t m_capacity = prealloc;
 
     int64_t m_null = reinterpret_cast<int64_t>(&m_null); // choose magic value to represent nulls
 };
@@ -1874,11 +1872,13 @@ public:
         return s;
     }
 
-    std::vector<size_t> get_links(size_t index)
+    /// The returned vector is owned by the link map, and is overwritten by
+    /// the next call.
+    std::vector<size_t>& get_links(size_t index)
     {
-        std::vector<size_t> res;
-        get_links(index, res);
-        return res;
+        m_links.clear();
+        get_links(index, m_links);
+        return m_links;
     }
 
     size_t count_links(size_t row)
@@ -1984,6 +1984,9 @@ private:
     std::vector<const Table*> m_tables;
     bool m_only_unary_links = true;
 
+    // Reused by get_links() to avoid an allocation per evaluated row
+    std::vector<size_t> m_links;
+
     template <class>
     friend Query compare(const Subexpr2<Link>&, const ConstRow&);
 };
@@ -1993,10 +1996,10 @@ Query string_compare(const Subexpr2<StringData>& left, T right, bool case_insens
 template <class S, class I>
 Query string_compare(const Subexpr2<StringData>& left, const Subexpr2<StringData>& right, bool case_insensitive);
 
+// Reuses the storage of \a value if it is big enough
 template <class T>
-Value<T> make_value_for_link(bool only_unary_links, size_t size)
+void init_value_for_link(Value<T>& value, bool only_unary_links, size_t size)
 {
-    Value<T> value;
     if (only_unary_links) {
         REALM_ASSERT(size <= 1);
         value.init(false, 1);
@@ -2005,6 +2008,13 @@ Value<T> make_value_for_link(bool only_unary_links, size_t size)
     else {
         value.init(true, size);
     }
+}
+
+template <class T>
+Value<T> make_value_for_link(bool only_unary_links, size_t size)
+{
+    Value<T> value;
+    init_value_for_link(value, only_unary_links, size);
     return value;
 }
 
@@ -2061,14 +2071,15 @@ public:
         size_t col = column_ndx();
 
         if (links_exist()) {
-            std::vector<size_t> links = m_link_map.get_links(index);
-            Value<T> v = make_value_for_link<T>(m_link_map.only_unary_links(), links.size());
+            // Fill the destination directly, so that its storage is reused
+            // from row to row
+            const std::vector<size_t>& links = m_link_map.get_links(index);
+            init_value_for_link(d, m_link_map.only_unary_links(), links.size());
 
             for (size_t t = 0; t < links.size(); t++) {
                 size_t link_to = links[t];
-                v.m_storage.set(t, m_link_map.target_table()->template get<T>(col, link_to));
+                d.m_storage.set(t, m_link_map.target_table()->template get<T>(col, link_to));
             }
-            destination.import(v);
         }
         else {
             // Not a link column
@@ -2660,6 +2671,10 @@ public:
 
 private:
     LinkMap m_link_map;
+
+    // The linked rows. Reused from row to row.
+    Value<RowIndex> m_link_values;
+
     friend class Table;
 
     Columns(size_t column_ndx, const Table* table, const std::vector<size_t>& links = {})
@@ -3145,22 +3160,7 @@ public:
         REALM_ASSERT_DEBUG(sgc->m_column);
 
         if (links_exist()) {
-            // LinkList with more than 0 values. Create Value with payload for all fields
-
-            std::vector<size_t> links = m_link_map.get_links(index);
-            auto v = make_value_for_link<typename util::RemoveOptional<U>::type>(m_link_map.only_unary_links(),
-                                                                                 links.size());
-
-            for (size_t t = 0; t < links.size(); t++) {
-                size_t link_to = links[t];
-                sgc->cache_next(link_to);
-
-                if (sgc->m_column->is_null(link_to))
-                    v.m_storage.set_null(t);
-                else
-                    v.m_storage.set(t, sgc->get_next(link_to));
-            }
-            destination.import(v);
+            evaluate_links(index, destination, *sgc);
         }
         else {
             // Not a Link column
@@ -3205,7 +3205,7 @@ public:
     void evaluate(size_t index, ValueBase& destination) override
     {
         if (m_nullable && std::is_same<typename ColType::value_type, int64_t>::value) {
-            evaluate_internal<IntNullColumn>(index, destination);
+            evaluate_internal<NullableColType>(index, destination);
         }
         else {
             evaluate_internal<ColType>(index, destination);
@@ -3227,6 +3227,15 @@ public:
         return m_sg ? get_column_base().get_column_index() : m_column_ndx;
     }
 
+    // Used by Compare to read the leaves of the column directly. Null if the
+    // column is not bound to a table.
+    template <class ColType2>
+    SequentialGetter<ColType2>* get_sequential_getter() const noexcept
+    {
+        REALM_ASSERT_DEBUG(!m_sg || dynamic_cast<SequentialGetter<ColType2>*>(m_sg.get()));
+        return static_cast<SequentialGetter<ColType2>*>(m_sg.get());
+    }
+
 private:
     LinkMap m_link_map;
 
@@ -3240,6 +3249,35 @@ private:
     // or oclumn. Call init() to update it or use a constructor that takes table + column index as argument.
     bool m_nullable = false;
 
+    // The column type of nullable integer columns, and ColType for all others
+    using NullableColType = typename std::conditional<std::is_same<typename ColType::value_type, int64_t>::value,
+                                                      IntNullColumn, ColType>::type;
+
+    using LinkValueType = typename util::RemoveOptional<typename ColType::value_type>::type;
+
+    // The values of the linked rows. Reused from row to row, as the
+    // destination may be of another type.
+    Value<LinkValueType> m_link_values;
+
+    // LinkList with more than 0 values. Create Value with payload for all fields
+    template <class ColType2>
+    void evaluate_links(size_t index, ValueBase& destination, SequentialGetter<ColType2>& sgc)
+    {
+        const std::vector<size_t>& links = m_link_map.get_links(index);
+        init_value_for_link(m_link_values, m_link_map.only_unary_links(), links.size());
+
+        for (size_t t = 0; t < links.size(); t++) {
+            size_t link_to = links[t];
+            sgc.cache_next(link_to);
+
+            if (sgc.m_column->is_null(link_to))
+                m_link_values.m_storage.set_null(t);
+            else
+                m_link_values.m_storage.set(t, sgc.get_next(link_to));
+        }
+        destination.import(m_link_values);
+    }
+
     const ColumnBase& get_column_base() const noexcept
     {
         if (m_nullable && std::is_same<int64_t, T>::value)
@@ -3357,7 +3395,7 @@ public:
 
     void evaluate(size_t index, ValueBase& destination) override
     {
-        std::vector<size_t> links = m_link_map.get_links(index);
+        std::vector<size_t>& links = m_link_map.get_links(index);
         std::sort(links.begin(), links.end());
 
         Operation op;
@@ -3430,7 +3468,7 @@ public:
 
     void evaluate(size_t index, ValueBase& destination) override
     {
-        std::vector<size_t> links = m_link_map.get_links(index);
+        std::vector<size_t>& links = m_link_map.get_links(index);
         std::sort(links.begin(), links.end());
 
         size_t count = std::accumulate(links.begin(), links.end(), size_t(0), [this](size_t running_count, size_t link) {
@@ -3789,6 +3827,63 @@ private:
 };
 
 
+// Operands of the leaf level fast path of Compare. A column operand reads the
+// values straight from the cached leaf, and a constant operand repeats a single
+// value.
+template <class T, class ColType>
+struct CompareColumnOperand {
+    SequentialGetter<ColType>& getter;
+
+    size_t cache_leaf(size_t row)
+    {
+        getter.cache_next(row);
+        return getter.m_leaf_end;
+    }
+    void get(size_t row, T& value, bool& is_null) const
+    {
+        read(getter.m_leaf_ptr->get(row - getter.m_leaf_start), value, is_null);
+    }
+
+private:
+    static void read(util::Optional<int64_t> v, T& value, bool& is_null)
+    {
+        is_null = !v;
+        value = is_null ? T() : T(*v);
+    }
+    static void read(int64_t v, T& value, bool& is_null)
+    {
+        value = T(v);
+        is_null = false;
+    }
+    static void read(float v, T& value, bool& is_null)
+    {
+        value = T(v);
+        is_null = null::is_null_float(v);
+    }
+    static void read(double v, T& value, bool& is_null)
+    {
+        value = T(v);
+        is_null = null::is_null_float(v);
+    }
+};
+
+template <class T>
+struct CompareConstantOperand {
+    T value;
+    bool is_null;
+
+    size_t cache_leaf(size_t)
+    {
+        return npos;
+    }
+    void get(size_t, T& v, bool& n) const
+    {
+        v = value;
+        n = is_null;
+    }
+};
+
+
 template <class TCond, class T, class TLeft, class TRight>
 class Compare : public Expression {
 public:
@@ -3803,6 +3898,7 @@ public:
     {
         m_left->set_base_table(table);
         m_right->set_base_table(table);
+        m_has_fast_path = has_fast_path(FastPathTypes());
     }
 
     void verify_column() const override
@@ -3828,6 +3924,9 @@ public:
 
     size_t find_first(size_t start, size_t end) const override
     {
+        if (m_has_fast_path)
+            return find_first_fast(start, end, FastPathTypes());
+
         size_t match;
         Value<T> right;
         Value<T> left;
@@ -3885,8 +3984,85 @@ private:
     {
     }
 
+    // The fast path handles numeric columns without links compared to each
+    // other or to a constant. It evaluates the condition row by row over the
+    // leaves, without virtual calls and without materializing Values.
+    using FastPathTypes = std::integral_constant<bool, realm::is_any<T, int64_t, float, double>::value>;
+
+    static bool is_fast_path_operand(const Subexpr& subexpr)
+    {
+        if (auto column = dynamic_cast<const Columns<T>*>(&subexpr))
+            return column->get_base_table() && !column->links_exist();
+        if (auto value = dynamic_cast<const Value<T>*>(&subexpr))
+            return !value->m_from_link_list && value->m_values > 0;
+        return false;
+    }
+
+    bool has_fast_path(std::false_type) const
+    {
+        return false;
+    }
+
+    bool has_fast_path(std::true_type) const
+    {
+        return is_fast_path_operand(*m_left) && is_fast_path_operand(*m_right);
+    }
+
+    size_t find_first_fast(size_t, size_t, std::false_type) const
+    {
+        REALM_UNREACHABLE();
+    }
+
+    size_t find_first_fast(size_t start, size_t end, std::true_type) const
+    {
+        return with_operand(*m_left, [&](auto& left) {
+            return with_operand(*m_right, [&](auto& right) {
+                return find_first_fast(left, right, start, end);
+            });
+        });
+    }
+
+    template <class F>
+    static size_t with_operand(Subexpr& subexpr, F func)
+    {
+        if (auto column = dynamic_cast<Columns<T>*>(&subexpr)) {
+            using ColType = typename ColumnTypeTraits<T>::column_type;
+            using NullableColType = typename std::conditional<std::is_same<T, int64_t>::value, IntNullColumn,
+                                                              ColType>::type;
+            if (column->is_nullable() && std::is_same<T, int64_t>::value) {
+                auto& getter = *column->template get_sequential_getter<NullableColType>();
+                CompareColumnOperand<T, NullableColType> operand{getter};
+                return func(operand);
+            }
+            CompareColumnOperand<T, ColType> operand{*column->template get_sequential_getter<ColType>()};
+            return func(operand);
+        }
+        auto& value = static_cast<Value<T>&>(subexpr);
+        CompareConstantOperand<T> operand{value.m_storage[0], value.m_storage.is_null(0)};
+        return func(operand);
+    }
+
+    template <class L, class R>
+    static size_t find_first_fast(L& left, R& right, size_t start, size_t end)
+    {
+        TCond c;
+        while (start < end) {
+            size_t leaf_end = std::min(end, std::min(left.cache_leaf(start), right.cache_leaf(start)));
+            for (; start < leaf_end; ++start) {
+                T l, r;
+                bool l_null, r_null;
+                left.get(start, l, l_null);
+                right.get(start, r, r_null);
+                if (c(l, r, l_null, r_null))
+                    return start;
+            }
+        }
+        return not_found;
+    }
+
     std::unique_ptr<TLeft> m_left;
     std::unique_ptr<TRight> m_right;
+    bool m_has_fast_path = false;
 };
 }
 #endif // REALM_QUERY_EXPRESSION_HPP
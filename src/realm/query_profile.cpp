@@ -0,0 +1,59 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/query_profile.hpp>
+
+#include <sstream>
+
+using namespace realm;
+
+
+void QueryProfile::print(std::ostream& out) const
+{
+    out << (executed ? "Query profile: " : "Query plan: ") << nodes.size() << " condition(s)";
+    if (executed)
+        out << ", " << matches << " of " << rows << " rows matched in " << time * 1000 << " ms";
+    out << "\n";
+
+    out << "Order:";
+    for (size_t ndx : node_order)
+        out << " #" << ndx;
+    out << "\n";
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const QueryNodeProfile& node = nodes[i];
+        out << "  #" << i << " " << (node.description.empty() ? "<unknown>" : node.description);
+        if (node.uses_index)
+            out << " [index]";
+        out << "\n      cost " << node.cost;
+        if (executed) {
+            out << ", chosen " << node.times_chosen << " times, scanned " << node.rows_scanned << " rows, "
+                << node.matches << " matches, " << node.probes << " probes, " << node.leaves_scanned
+                << " leaves, " << node.time * 1000 << " ms";
+        }
+        out << "\n";
+    }
+}
+
+
+std::string QueryProfile::to_string() const
+{
+    std::ostringstream out;
+    print(out);
+    return out.str();
+}
@@ -0,0 +1,106 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_QUERY_PROFILE_HPP
+#define REALM_QUERY_PROFILE_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace realm {
+
+/// Plan and execution statistics of one condition node of a query. See
+/// Query::explain() and Query::profile().
+///
+/// The conditions of a query are evaluated by letting one node at a time
+/// scan a range of rows for local matches ("driving" the scan), and testing
+/// the remaining nodes only on the rows found. The node with the lowest
+/// estimated cost is picked to drive each range. Nodes combining other
+/// conditions (such as OR and NOT) are reported as a single node.
+struct QueryNodeProfile {
+    /// The condition in the query language, or empty if the node cannot be
+    /// described.
+    std::string description;
+
+    /// True if the condition is answered by a search index rather than by
+    /// scanning the column.
+    bool uses_index = false;
+
+    /// The cost estimate that the node was ordered by. For explain() this is
+    /// the initial estimate, for profile() the estimate when the query
+    /// finished. Lower is cheaper.
+    double cost = 0;
+
+    /// The remaining fields are only filled in by profile().
+
+    /// Number of ranges this node was picked to drive.
+    size_t times_chosen = 0;
+
+    /// Rows covered by the ranges driven by this node.
+    size_t rows_scanned = 0;
+
+    /// Rows of the result found while this node was driving.
+    size_t matches = 0;
+
+    /// Rows tested against this condition on behalf of another driving node.
+    size_t probes = 0;
+
+    /// B+-tree leaves loaded by the node. Only counted for integer conditions.
+    size_t leaves_scanned = 0;
+
+    /// Seconds spent driving ranges, including the time spent testing the
+    /// other conditions on the rows found.
+    double time = 0;
+};
+
+struct QueryProfile {
+    /// The condition nodes in the order they appear in the query.
+    std::vector<QueryNodeProfile> nodes;
+
+    /// Indexes into `nodes`. For explain(), the nodes sorted by estimated
+    /// cost, i.e. the order in which they are initially preferred. For
+    /// profile(), the nodes in the order they were picked to drive the scan,
+    /// with consecutive repetitions collapsed.
+    std::vector<size_t> node_order;
+
+    /// True if the query was run by profile().
+    bool executed = false;
+
+    /// Rows in the range that the query was run on, and matching rows.
+    size_t rows = 0;
+    size_t matches = 0;
+
+    /// Total execution time in seconds.
+    double time = 0;
+
+    /// Write a human readable table of the profile.
+    void print(std::ostream&) const;
+    std::string to_string() const;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const QueryProfile& profile)
+{
+    profile.print(out);
+    return out;
+}
+
+} // namespace realm
+
+#endif // REALM_QUERY_PROFILE_HPP
@@ -258,6 +258,20 @@ public:
         } // LCOV_EXCL_STOP
     }
 
+    bool set_binary_range(size_t col_ndx, size_t row_ndx, size_t pos, BinaryData value)
+    {
+        if (REALM_UNLIKELY(REALM_COVER_NEVER(!m_table)))
+            return false;
+        log("table->write_binary(%1, %2, %3, %4);", col_ndx, row_ndx, pos, value); // Throws
+        try {
+            m_table->write_binary(col_ndx, row_ndx, pos, value); // Throws
+            return true;
+        }
+        catch (LogicError&) { // LCOV_EXCL_START
+            return false;
+        } // LCOV_EXCL_STOP
+    }
+
     bool insert_empty_rows(size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows, bool unordered)
     {
         static_cast<void>(prior_num_rows);
@@ -286,24 +300,35 @@ public:
 
     bool erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, bool unordered)
     {
-        static_cast<void>(num_rows_to_erase);
-        static_cast<void>(prior_num_rows);
         if (REALM_UNLIKELY(REALM_COVER_NEVER(!m_table)))
             return false;
         if (REALM_UNLIKELY(REALM_COVER_NEVER(row_ndx >= prior_num_rows)))
             return false;
-        if (REALM_UNLIKELY(REALM_COVER_NEVER(num_rows_to_erase != 1)))
+        if (REALM_UNLIKELY(REALM_COVER_NEVER(num_rows_to_erase == 0)))
+            return false;
+        if (REALM_UNLIKELY(REALM_COVER_NEVER(num_rows_to_erase > prior_num_rows - row_ndx)))
             return false;
         if (REALM_UNLIKELY(REALM_COVER_NEVER(prior_num_rows != m_table->size())))
             return false;
         typedef _impl::TableFriend tf;
         if (unordered) {
-            log("table->move_last_over(%1);", row_ndx); // Throws
-            tf::do_move_last_over(*m_table, row_ndx);   // Throws
+            if (num_rows_to_erase == 1) {
+                log("table->move_last_over(%1);", row_ndx); // Throws
+            }
+            else {
+                log("for (size_t i = %2; i > 0; --i) table->move_last_over(%1 + i - 1);", row_ndx,
+                    num_rows_to_erase); // Throws
+            }
+            tf::do_move_last_over(*m_table, row_ndx, num_rows_to_erase); // Throws
         }
         else {
-            log("table->remove(%1);", row_ndx); // Throws
-            tf::do_remove(*m_table, row_ndx);   // Throws
+            if (num_rows_to_erase == 1) {
+                log("table->remove(%1);", row_ndx); // Throws
+            }
+            else {
+                log("for (size_t i = 0; i < %2; ++i) table->remove(%1);", row_ndx, num_rows_to_erase); // Throws
+            }
+            tf::do_remove(*m_table, row_ndx, num_rows_to_erase); // Throws
         }
         return true;
     }
@@ -431,6 +456,23 @@ public:
         return false;
     }
 
+    bool set_deduplicated(size_t col_ndx, bool deduplicated)
+    {
+        // Only root tables are deduplicated, so no descriptor is selected
+        if (REALM_LIKELY(REALM_COVER_ALWAYS(m_table))) {
+            if (REALM_LIKELY(REALM_COVER_ALWAYS(col_ndx < m_table->get_column_count()))) {
+                using tf = _impl::TableFriend;
+                DataType type = m_table->get_column_type(col_ndx);
+                if (REALM_UNLIKELY(REALM_COVER_NEVER(type != type_Binary && type != type_String)))
+                    return false;
+                log("table->set_deduplicated(%1, %2);", col_ndx, deduplicated); // Throws
+                tf::set_deduplicated(*m_table, col_ndx, deduplicated);          // Throws
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool insert_column(size_t col_ndx, DataType type, StringData name, bool nullable)
     {
         if (REALM_LIKELY(REALM_COVER_ALWAYS(m_desc))) {
@@ -0,0 +1,59 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+// Applies backups written by SharedGroup::write_backup() to a Realm file
+
+#include <fstream>
+#include <iostream>
+#include <realm/group_shared.hpp>
+
+using namespace realm;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: realm-restore <.realm file> <backup file>...\n"
+                     "\n"
+                     "Applies the backups to the Realm file, in the specified order. The first backup\n"
+                     "may be a full backup, which replaces the Realm file. Each incremental backup must\n"
+                     "continue from the version that the Realm file is at.\n";
+        return 1;
+    }
+
+    const char* realm_path = argv[1];
+    if (!SharedGroup::call_with_lock(realm_path, [&](const std::string& path) {
+            for (int i = 2; i < argc; ++i) {
+                std::ifstream in(argv[i], std::ios::in | std::ios::binary);
+                if (!in) {
+                    std::cerr << "realm-restore: Cannot open " << argv[i] << "\n";
+                    std::exit(1);
+                }
+                try {
+                    SharedGroup::restore_backup(path, in); // Throws
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "realm-restore: " << argv[i] << ": " << e.what() << "\n";
+                    std::exit(1);
+                }
+            }
+        })) {
+        std::cerr << "realm-restore: " << realm_path << " is in use\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,605 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#include <realm/exceptions.hpp>
+#include <realm/row_cache.hpp>
+#include <realm/table.hpp>
+
+using namespace realm;
+using namespace realm::_impl;
+
+
+RowCache::RowCache(const Table& table, size_t capacity)
+    : m_table(table.get_table_ref())
+    , m_capacity(std::max(capacity, size_t(1)))
+    , m_version(table.get_version_counter())
+{
+    refresh_columns(); // Throws
+}
+
+
+RowCache::~RowCache() noexcept
+{
+}
+
+
+const CachedRow& RowCache::get(size_t row_ndx)
+{
+    if (REALM_UNLIKELY(!m_table->is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    check_version(); // Throws
+    if (REALM_UNLIKELY(row_ndx >= m_table->size()))
+        throw LogicError(LogicError::row_index_out_of_range);
+
+    auto i = m_index.find(row_ndx);
+    if (i != m_index.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, i->second);
+        return *i->second;
+    }
+
+    // Reuse the least recently used entry if the cache is full
+    if (m_entries.size() < m_capacity) {
+        m_entries.emplace_front(); // Throws
+    }
+    else {
+        auto last = std::prev(m_entries.end());
+        m_index.erase(last->m_row_ndx);
+        m_entries.splice(m_entries.begin(), m_entries, last);
+    }
+    auto entry = m_entries.begin();
+    try {
+        load(*entry, row_ndx);    // Throws
+        m_index[row_ndx] = entry; // Throws
+    }
+    catch (...) {
+        m_entries.erase(entry);
+        throw;
+    }
+    return *entry;
+}
+
+
+void RowCache::invalidate(size_t row_ndx) noexcept
+{
+    auto i = m_index.find(row_ndx);
+    if (i != m_index.end()) {
+        m_entries.erase(i->second);
+        m_index.erase(i);
+    }
+}
+
+
+void RowCache::clear() noexcept
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+
+void RowCache::check_version()
+{
+    uint_fast64_t version = m_table->get_version_counter();
+    if (version == m_version && !m_columns_changed)
+        return;
+
+    // The table was modified behind our back
+    clear();
+    refresh_columns(); // Throws
+    m_version = version;
+}
+
+
+void RowCache::refresh_columns()
+{
+    const Table& table = *m_table;
+    size_t num_cols = table.get_column_count();
+    m_column_types.resize(num_cols); // Throws
+    m_nullable.resize(num_cols);     // Throws
+    m_has_link_columns = false;
+    for (size_t i = 0; i < num_cols; ++i) {
+        m_column_types[i] = table.get_column_type(i);
+        m_nullable[i] = table.is_nullable(i);
+        if (m_column_types[i] == type_Link)
+            m_has_link_columns = true;
+    }
+    m_columns_changed = false;
+}
+
+
+void RowCache::load(CachedRow& row, size_t row_ndx) const
+{
+    const Table& table = *m_table;
+    size_t num_cols = m_column_types.size();
+    row.m_row_ndx = row_ndx;
+    row.m_cells.resize(num_cols); // Throws
+    row.m_payload.clear();
+
+    auto add_payload = [&](CachedRow::Cell& cell, const char* data, size_t size) {
+        cell.m_offset = row.m_payload.size();
+        cell.m_size = size;
+        row.m_payload.insert(row.m_payload.end(), data, data + size); // Throws
+    };
+
+    for (size_t i = 0; i < num_cols; ++i) {
+        CachedRow::Cell& cell = row.m_cells[i];
+        cell.m_int = 0;
+        cell.m_size = 0;
+        cell.m_null = false;
+        switch (m_column_types[i]) {
+            case type_Int:
+            case type_Bool:
+            case type_Float:
+            case type_Double:
+            case type_OldDateTime:
+                if (m_nullable[i] && table.is_null(i, row_ndx)) {
+                    cell.m_null = true;
+                    break;
+                }
+                switch (m_column_types[i]) {
+                    case type_Int:
+                        cell.m_int = table.get_int(i, row_ndx);
+                        break;
+                    case type_Bool:
+                        cell.m_int = table.get_bool(i, row_ndx);
+                        break;
+                    case type_Float:
+                        cell.m_float = table.get_float(i, row_ndx);
+                        break;
+                    case type_Double:
+                        cell.m_double = table.get_double(i, row_ndx);
+                        break;
+                    default:
+                        cell.m_int = table.get_olddatetime(i, row_ndx).get_olddatetime();
+                        break;
+                }
+                break;
+            case type_String: {
+                StringData value = table.get_string(i, row_ndx);
+                cell.m_null = value.is_null();
+                add_payload(cell, value.data(), value.size()); // Throws
+                break;
+            }
+            case type_Binary: {
+                BinaryData value = table.get_binary(i, row_ndx);
+                cell.m_null = value.is_null();
+                add_payload(cell, value.data(), value.size()); // Throws
+                break;
+            }
+            case type_Timestamp: {
+                Timestamp value = table.get_timestamp(i, row_ndx);
+                cell.m_null = value.is_null();
+                if (!cell.m_null) {
+                    cell.m_int = value.get_seconds();
+                    cell.m_size = size_t(value.get_nanoseconds());
+                }
+                break;
+            }
+            case type_Link:
+                cell.m_null = table.is_null_link(i, row_ndx);
+                if (!cell.m_null)
+                    cell.m_int = table.get_link(i, row_ndx);
+                break;
+            case type_Table:
+            case type_Mixed:
+            case type_LinkList:
+                // Not cached
+                break;
+        }
+    }
+}
+
+
+template <class F>
+void RowCache::renumber(F map_function) noexcept
+{
+    try {
+        m_index.clear();
+        for (auto i = m_entries.begin(); i != m_entries.end();) {
+            size_t row_ndx = map_function(i->m_row_ndx);
+            if (row_ndx == npos) {
+                i = m_entries.erase(i);
+                continue;
+            }
+            i->m_row_ndx = row_ndx;
+            m_index[row_ndx] = i; // Throws
+            ++i;
+        }
+    }
+    catch (...) {
+        clear();
+    }
+}
+
+
+void RowCache::insert_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept
+{
+    if (row_ndx == prior_num_rows)
+        return;
+    if (unordered) {
+        // This is the reverse of an unordered removal, so the rows in the
+        // inserted range are moved to the end of the table
+        size_t end = row_ndx + num_rows;
+        renumber([&](size_t i) { return i >= row_ndx && i < end ? prior_num_rows + (i - row_ndx) : i; });
+        return;
+    }
+    renumber([&](size_t i) { return i < row_ndx ? i : i + num_rows; });
+}
+
+
+void RowCache::erase_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept
+{
+    size_t end = row_ndx + num_rows;
+    if (unordered) {
+        // The last rows are moved over the erased ones
+        size_t moved_begin = std::max(end, prior_num_rows - num_rows);
+        renumber([&](size_t i) {
+            if (i >= row_ndx && i < end)
+                return npos;
+            if (i >= moved_begin)
+                return num_rows == 1 ? row_ndx : npos;
+            return i;
+        });
+        return;
+    }
+    renumber([&](size_t i) {
+        if (i < row_ndx)
+            return i;
+        return i < end ? npos : i - num_rows;
+    });
+}
+
+
+void RowCache::swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept
+{
+    renumber([&](size_t i) {
+        if (i == row_ndx_1)
+            return row_ndx_2;
+        if (i == row_ndx_2)
+            return row_ndx_1;
+        return i;
+    });
+}
+
+
+void RowCache::invalidate_range(size_t begin, size_t end) noexcept
+{
+    if (end - begin >= m_entries.size()) {
+        renumber([&](size_t i) { return i >= begin && i < end ? npos : i; });
+        return;
+    }
+    for (size_t i = begin; i < end; ++i)
+        invalidate(i);
+}
+
+
+RowCache::Observer::Observer(RowCache& cache)
+    : m_cache(&cache)
+    , m_table_ndx(npos)
+{
+    const Table& table = *cache.m_table;
+    if (!table.is_attached()) {
+        cache.clear();
+        return;
+    }
+
+    // Changes that were not observed must be accounted for before the version
+    // counter is retagged
+    cache.check_version(); // Throws
+    if (table.is_group_level())
+        m_table_ndx = table.get_index_in_group();
+}
+
+
+RowCache::Observer::Observer(Observer&& other) noexcept
+    : m_cache(other.m_cache)
+    , m_table_ndx(other.m_table_ndx)
+    , m_selected(other.m_selected)
+    , m_selected_descriptor(other.m_selected_descriptor)
+{
+    other.m_cache = nullptr;
+}
+
+
+RowCache::Observer::~Observer() noexcept
+{
+    if (!m_cache)
+        return;
+    if (std::uncaught_exception()) {
+        // Advancing failed, possibly part way through the transaction logs
+        m_cache->clear();
+        return;
+    }
+
+    // The accessors have now been refreshed, so the changes to the table are
+    // those that were observed. If the table was not observed (such as when
+    // it is a subtable), the next access clears the cache.
+    const Table& table = *m_cache->m_table;
+    if (m_table_ndx != npos && table.is_attached())
+        m_cache->m_version = table.get_version_counter();
+}
+
+
+bool RowCache::Observer::select_table(size_t group_level_ndx, size_t levels, const size_t*) noexcept
+{
+    m_selected = (levels == 0 && group_level_ndx == m_table_ndx);
+    m_selected_descriptor = false;
+    return true;
+}
+
+
+bool RowCache::Observer::select_descriptor(size_t levels, const size_t*) noexcept
+{
+    // Columns of subtables are not cached
+    m_selected_descriptor = (m_selected && levels == 0);
+    return true;
+}
+
+
+bool RowCache::Observer::insert_group_level_table(size_t table_ndx, size_t, StringData) noexcept
+{
+    if (m_table_ndx != npos && table_ndx <= m_table_ndx)
+        ++m_table_ndx;
+    return true;
+}
+
+
+bool RowCache::Observer::erase_group_level_table(size_t table_ndx, size_t) noexcept
+{
+    if (m_table_ndx == npos)
+        return true;
+    if (table_ndx == m_table_ndx) {
+        m_cache->clear();
+        m_table_ndx = npos;
+        m_selected = false;
+    }
+    else if (table_ndx < m_table_ndx) {
+        --m_table_ndx;
+    }
+    return true;
+}
+
+
+bool RowCache::Observer::insert_empty_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows,
+                                           bool unordered) noexcept
+{
+    if (row_ndx != prior_num_rows)
+        row_moves();
+    if (m_selected)
+        m_cache->insert_rows(row_ndx, num_rows, prior_num_rows, unordered);
+    return true;
+}
+
+
+bool RowCache::Observer::add_row_with_key(size_t row_ndx, size_t prior_num_rows, size_t, int64_t) noexcept
+{
+    bool unordered = false;
+    return insert_empty_rows(row_ndx, 1, prior_num_rows, unordered);
+}
+
+
+bool RowCache::Observer::erase_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows,
+                                    bool unordered) noexcept
+{
+    row_moves();
+    if (m_selected)
+        m_cache->erase_rows(row_ndx, num_rows, prior_num_rows, unordered);
+    return true;
+}
+
+
+bool RowCache::Observer::swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept
+{
+    row_moves();
+    if (m_selected)
+        m_cache->swap_rows(row_ndx_1, row_ndx_2);
+    return true;
+}
+
+
+bool RowCache::Observer::move_row(size_t from_ndx, size_t to_ndx) noexcept
+{
+    row_moves();
+    if (m_selected)
+        m_cache->invalidate_range(std::min(from_ndx, to_ndx), std::max(from_ndx, to_ndx) + 1);
+    return true;
+}
+
+
+bool RowCache::Observer::merge_rows(size_t, size_t) noexcept
+{
+    // Only links to the merged row are changed
+    row_moves();
+    return true;
+}
+
+
+bool RowCache::Observer::clear_table(size_t) noexcept
+{
+    row_moves();
+    if (m_selected)
+        m_cache->clear();
+    return true;
+}
+
+
+bool RowCache::Observer::set_int(size_t, size_t row_ndx, int_fast64_t, Instruction variant, size_t) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::add_int(size_t, size_t row_ndx, int_fast64_t) noexcept
+{
+    set(row_ndx, instr_Set);
+    return true;
+}
+
+
+bool RowCache::Observer::set_bool(size_t, size_t row_ndx, bool, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_float(size_t, size_t row_ndx, float, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_double(size_t, size_t row_ndx, double, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_string(size_t, size_t row_ndx, StringData, Instruction variant, size_t) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_binary(size_t, size_t row_ndx, BinaryData, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_olddatetime(size_t, size_t row_ndx, OldDateTime, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_timestamp(size_t, size_t row_ndx, Timestamp, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_link(size_t, size_t row_ndx, size_t, size_t, Instruction variant) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::set_null(size_t, size_t row_ndx, Instruction variant, size_t) noexcept
+{
+    set(row_ndx, variant);
+    return true;
+}
+
+
+bool RowCache::Observer::nullify_link(size_t, size_t row_ndx, size_t) noexcept
+{
+    set(row_ndx, instr_Set);
+    return true;
+}
+
+
+bool RowCache::Observer::insert_substring(size_t, size_t row_ndx, size_t, StringData) noexcept
+{
+    set(row_ndx, instr_Set);
+    return true;
+}
+
+
+bool RowCache::Observer::erase_substring(size_t, size_t row_ndx, size_t, size_t) noexcept
+{
+    set(row_ndx, instr_Set);
+    return true;
+}
+
+
+bool RowCache::Observer::set_binary_range(size_t, size_t row_ndx, size_t, BinaryData) noexcept
+{
+    set(row_ndx, instr_Set);
+    return true;
+}
+
+
+bool RowCache::Observer::insert_link_column(size_t, DataType, StringData, size_t, size_t) noexcept
+{
+    columns_changed();
+    return true;
+}
+
+
+bool RowCache::Observer::insert_column(size_t, DataType, StringData, bool) noexcept
+{
+    columns_changed();
+    return true;
+}
+
+
+bool RowCache::Observer::erase_link_column(size_t, size_t, size_t) noexcept
+{
+    columns_changed();
+    return true;
+}
+
+
+bool RowCache::Observer::erase_column(size_t) noexcept
+{
+    columns_changed();
+    return true;
+}
+
+
+void RowCache::Observer::set(size_t row_ndx, Instruction variant) noexcept
+{
+    if (!m_selected)
+        return;
+    // Setting a unique value may merge the row with another one
+    if (variant == instr_SetUnique) {
+        m_cache->clear();
+        return;
+    }
+    m_cache->invalidate(row_ndx);
+}
+
+
+void RowCache::Observer::row_moves() noexcept
+{
+    // Moving rows of any table changes the values of links to them, so the
+    // rows of a table with link columns cannot be renumbered precisely.
+    if (m_cache->m_has_link_columns)
+        m_cache->clear();
+}
+
+
+void RowCache::Observer::columns_changed() noexcept
+{
+    if (m_selected_descriptor) {
+        m_cache->clear();
+        m_cache->m_columns_changed = true;
+    }
+}
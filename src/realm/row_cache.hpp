@@ -0,0 +1,328 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ROW_CACHE_HPP
+#define REALM_ROW_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <realm/binary_data.hpp>
+#include <realm/data_type.hpp>
+#include <realm/olddatetime.hpp>
+#include <realm/string_data.hpp>
+#include <realm/table_ref.hpp>
+#include <realm/timestamp.hpp>
+#include <realm/impl/transact_log.hpp>
+
+namespace realm {
+
+class RowCache;
+
+/// A copy of the values of one table row, as held by a RowCache.
+///
+/// All values are read from the table when the row is loaded into the cache,
+/// so the getters do not access the table. Strings and binary values are
+/// copied into a buffer owned by the row. Subtable, mixed, and link list
+/// columns are not cached, and must be read through the table.
+class CachedRow {
+public:
+    /// The index of the row in the table.
+    size_t get_index() const noexcept;
+
+    int_fast64_t get_int(size_t col_ndx) const noexcept;
+    bool get_bool(size_t col_ndx) const noexcept;
+    float get_float(size_t col_ndx) const noexcept;
+    double get_double(size_t col_ndx) const noexcept;
+    StringData get_string(size_t col_ndx) const noexcept;
+    BinaryData get_binary(size_t col_ndx) const noexcept;
+    OldDateTime get_olddatetime(size_t col_ndx) const noexcept;
+    Timestamp get_timestamp(size_t col_ndx) const noexcept;
+    size_t get_link(size_t col_ndx) const noexcept;
+    bool is_null_link(size_t col_ndx) const noexcept;
+    bool is_null(size_t col_ndx) const noexcept;
+
+private:
+    struct Cell {
+        union {
+            int_fast64_t m_int; // Also seconds of a timestamp
+            float m_float;
+            double m_double;
+            size_t m_offset; // Into `m_payload`
+        };
+        size_t m_size; // Of a string or binary value, or nanoseconds of a timestamp
+        bool m_null;
+    };
+
+    size_t m_row_ndx;
+    std::vector<Cell> m_cells;
+    std::vector<char> m_payload;
+
+    friend class RowCache;
+};
+
+
+/// A cache of recently read rows of one table.
+///
+/// Reading a row through the table costs one B+-tree lookup per column. The
+/// cache keeps the most recently used rows in the compact format of
+/// CachedRow, such that reading a hot row again costs a single hash lookup.
+/// When the cache is full, the least recently used row is evicted.
+///
+/// The cache is tagged with the version counter of the table
+/// (Table::get_version_counter()), and is cleared when it finds that the
+/// table has changed without the cache having been told. It can be kept warm
+/// across transactions by passing an observer() to
+/// LangBindHelper::advance_read(), LangBindHelper::promote_to_write(), or
+/// LangBindHelper::rollback_and_continue_as_read():
+///
+/// <pre>
+///
+///   RowCache cache(*table, 4096);
+///   const CachedRow& row = cache.get(table->find_first_int(0, key));
+///   ...
+///   LangBindHelper::advance_read(sg, cache.observer());
+///
+/// </pre>
+///
+/// The observer then drops or renumbers only the rows that were changed,
+/// inserted, or removed by the new transactions. Changes that cannot be
+/// tracked precisely, such as changes to the columns of the table, clear the
+/// cache. Local modifications of the table in a write transaction are not
+/// observed, and make the cache clear itself on the next access.
+///
+/// A RowCache, like the table accessor, must only be used by one thread at a
+/// time.
+class RowCache {
+public:
+    class Observer;
+
+    /// Cache at most \a capacity rows (at least one) of the specified table.
+    RowCache(const Table&, size_t capacity);
+    ~RowCache() noexcept;
+
+    /// Get the row at the specified index, loading it from the table if it is
+    /// not already cached. The returned reference stays valid until the next
+    /// call of a non-const function of the cache.
+    const CachedRow& get(size_t row_ndx);
+
+    /// Drop the specified row from the cache, if it is cached.
+    void invalidate(size_t row_ndx) noexcept;
+
+    /// Drop all rows from the cache.
+    void clear() noexcept;
+
+    /// The number of rows currently cached.
+    size_t size() const noexcept;
+
+    size_t capacity() const noexcept;
+
+    /// Get an observer of transaction logs that updates the cache. A new
+    /// observer must be used for every call to advance the transaction, and it
+    /// must be destroyed when that call returns, as happens when the observer
+    /// is passed as a temporary.
+    Observer observer();
+
+private:
+    using Entries = std::list<CachedRow>;
+
+    ConstTableRef m_table;
+    size_t m_capacity;
+    uint_fast64_t m_version;
+    std::vector<DataType> m_column_types;
+    std::vector<bool> m_nullable;
+    bool m_has_link_columns;
+    bool m_columns_changed;
+    Entries m_entries; // Most recently used first
+    std::unordered_map<size_t, Entries::iterator> m_index;
+
+    void check_version();
+    void refresh_columns();
+    void load(CachedRow&, size_t row_ndx) const;
+
+    /// Move the cached rows to new indexes. \a map_function is called with
+    /// each cached index, and returns the new index, or `npos` if the row
+    /// must be dropped.
+    template <class F>
+    void renumber(F map_function) noexcept;
+
+    void insert_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept;
+    void erase_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept;
+    void swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
+    void invalidate_range(size_t begin, size_t end) noexcept;
+};
+
+
+/// Updates a RowCache from the instructions of the transactions that the
+/// snapshot is advanced across. See RowCache::observer().
+class RowCache::Observer : public _impl::NullInstructionObserver {
+public:
+    Observer(Observer&&) noexcept;
+    ~Observer() noexcept;
+
+    bool select_table(size_t group_level_ndx, size_t levels, const size_t* path) noexcept;
+    bool select_descriptor(size_t levels, const size_t* path) noexcept;
+    bool insert_group_level_table(size_t table_ndx, size_t num_tables, StringData) noexcept;
+    bool erase_group_level_table(size_t table_ndx, size_t num_tables) noexcept;
+
+    bool insert_empty_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept;
+    bool add_row_with_key(size_t row_ndx, size_t prior_num_rows, size_t key_col_ndx, int64_t key) noexcept;
+    bool erase_rows(size_t row_ndx, size_t num_rows, size_t prior_num_rows, bool unordered) noexcept;
+    bool swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
+    bool move_row(size_t from_ndx, size_t to_ndx) noexcept;
+    bool merge_rows(size_t row_ndx, size_t new_row_ndx) noexcept;
+    bool clear_table(size_t num_rows) noexcept;
+    bool set_int(size_t col_ndx, size_t row_ndx, int_fast64_t, _impl::Instruction, size_t) noexcept;
+    bool add_int(size_t col_ndx, size_t row_ndx, int_fast64_t) noexcept;
+    bool set_bool(size_t col_ndx, size_t row_ndx, bool, _impl::Instruction) noexcept;
+    bool set_float(size_t col_ndx, size_t row_ndx, float, _impl::Instruction) noexcept;
+    bool set_double(size_t col_ndx, size_t row_ndx, double, _impl::Instruction) noexcept;
+    bool set_string(size_t col_ndx, size_t row_ndx, StringData, _impl::Instruction, size_t) noexcept;
+    bool set_binary(size_t col_ndx, size_t row_ndx, BinaryData, _impl::Instruction) noexcept;
+    bool set_olddatetime(size_t col_ndx, size_t row_ndx, OldDateTime, _impl::Instruction) noexcept;
+    bool set_timestamp(size_t col_ndx, size_t row_ndx, Timestamp, _impl::Instruction) noexcept;
+    bool set_link(size_t col_ndx, size_t row_ndx, size_t, size_t, _impl::Instruction) noexcept;
+    bool set_null(size_t col_ndx, size_t row_ndx, _impl::Instruction, size_t) noexcept;
+    bool nullify_link(size_t col_ndx, size_t row_ndx, size_t) noexcept;
+    bool insert_substring(size_t col_ndx, size_t row_ndx, size_t, StringData) noexcept;
+    bool erase_substring(size_t col_ndx, size_t row_ndx, size_t, size_t) noexcept;
+    bool set_binary_range(size_t col_ndx, size_t row_ndx, size_t, BinaryData) noexcept;
+
+    bool insert_link_column(size_t col_ndx, DataType, StringData, size_t, size_t) noexcept;
+    bool insert_column(size_t col_ndx, DataType, StringData, bool) noexcept;
+    bool erase_link_column(size_t col_ndx, size_t, size_t) noexcept;
+    bool erase_column(size_t col_ndx) noexcept;
+
+private:
+    RowCache* m_cache;
+    size_t m_table_ndx; // Of the cached table in the group, or `npos`
+    bool m_selected = false;
+    bool m_selected_descriptor = false;
+
+    Observer(RowCache&);
+
+    void set(size_t row_ndx, _impl::Instruction) noexcept;
+    void row_moves() noexcept;
+    void columns_changed() noexcept;
+
+    friend class RowCache;
+};
+
+
+// Implementation:
+
+inline size_t CachedRow::get_index() const noexcept
+{
+    return m_row_ndx;
+}
+
+inline int_fast64_t CachedRow::get_int(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return m_cells[col_ndx].m_int;
+}
+
+inline bool CachedRow::get_bool(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return m_cells[col_ndx].m_int != 0;
+}
+
+inline float CachedRow::get_float(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return m_cells[col_ndx].m_float;
+}
+
+inline double CachedRow::get_double(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return m_cells[col_ndx].m_double;
+}
+
+inline StringData CachedRow::get_string(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    const Cell& cell = m_cells[col_ndx];
+    if (cell.m_null)
+        return StringData();
+    return StringData(cell.m_size == 0 ? "" : m_payload.data() + cell.m_offset, cell.m_size);
+}
+
+inline BinaryData CachedRow::get_binary(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    const Cell& cell = m_cells[col_ndx];
+    if (cell.m_null)
+        return BinaryData();
+    return BinaryData(cell.m_size == 0 ? "" : m_payload.data() + cell.m_offset, cell.m_size);
+}
+
+inline OldDateTime CachedRow::get_olddatetime(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return OldDateTime(m_cells[col_ndx].m_int);
+}
+
+inline Timestamp CachedRow::get_timestamp(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    const Cell& cell = m_cells[col_ndx];
+    if (cell.m_null)
+        return Timestamp();
+    return Timestamp(cell.m_int, int32_t(cell.m_size));
+}
+
+inline size_t CachedRow::get_link(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return size_t(m_cells[col_ndx].m_int);
+}
+
+inline bool CachedRow::is_null_link(size_t col_ndx) const noexcept
+{
+    return is_null(col_ndx);
+}
+
+inline bool CachedRow::is_null(size_t col_ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(col_ndx < m_cells.size());
+    return m_cells[col_ndx].m_null;
+}
+
+inline size_t RowCache::size() const noexcept
+{
+    return m_entries.size();
+}
+
+inline size_t RowCache::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+inline RowCache::Observer RowCache::observer()
+{
+    return Observer(*this); // Throws
+}
+
+} // namespace realm
+
+#endif // REALM_ROW_CACHE_HPP
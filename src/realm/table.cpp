@@ -373,12 +373,13 @@ void Table::remove_backlink_broken_rows(const CascadeState& cascade_state)
         bool is_move_last_over = (i->is_ordered_removal == 0);
         Table& table = gf::get_table(group, i->table_ndx);
 
+        size_t num_rows = 1;
         bool broken_reciprocal_backlinks = true;
         if (is_move_last_over) {
-            table.do_move_last_over(i->row_ndx, broken_reciprocal_backlinks);
+            table.do_move_last_over(i->row_ndx, num_rows, broken_reciprocal_backlinks);
         }
         else {
-            table.do_remove(i->row_ndx, broken_reciprocal_backlinks);
+            table.do_remove(i->row_ndx, num_rows, broken_reciprocal_backlinks);
         }
     }
 }
@@ -996,6 +997,51 @@ void Table::do_set_link_type(size_t col_ndx, LinkType link_type)
 }
 
 
+void Table::do_set_deduplicated(size_t col_ndx, bool deduplicated)
+{
+    ColumnAttr attr = m_spec->get_column_attr(col_ndx);
+    ColumnAttr new_attr = ColumnAttr(attr & ~col_attr_Deduplicated);
+    if (deduplicated)
+        new_attr = ColumnAttr(new_attr | col_attr_Deduplicated);
+    if (new_attr == attr)
+        return;
+
+    // Older versions of the core library would take the tagged elements of
+    // the big blobs leaves for refs, so they must not be able to open the
+    // file. Only file format version 10 and later ensure that, and a file is
+    // raised to it here, by the first column to be deduplicated. Earlier
+    // versions than 9 require an upgrade that cannot happen mid-session.
+    Group* group = get_parent_group();
+    if (group && deduplicated && group->get_file_format_version() < 9)
+        throw LogicError(LogicError::old_file_format);
+    m_spec->set_column_attr(col_ndx, new_attr); // Throws
+    if (group && deduplicated && group->get_file_format_version() == 9)
+        group->set_file_format_version(10);
+
+    // Values already stored are left as they are, except that those sharing
+    // storage get copies of their own when deduplication is turned off, since
+    // only deduplicated columns keep track of sharing
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Binary:
+            if (!deduplicated)
+                get_column_binary(col_ndx).unshare_all(); // Throws
+            get_column_binary(col_ndx).set_deduplicated(deduplicated);
+            break;
+        case col_type_String:
+            if (!deduplicated)
+                get_column_string(col_ndx).unshare_all(); // Throws
+            get_column_string(col_ndx).set_deduplicated(deduplicated);
+            break;
+        default:
+            // The keys of an enumerated strings column are unique
+            break;
+    }
+
+    if (Replication* repl = get_repl())
+        repl->set_deduplicated(this, col_ndx, deduplicated); // Throws
+}
+
+
 void Table::insert_backlink_column(size_t origin_table_ndx, size_t origin_col_ndx, size_t backlink_col_ndx)
 {
     REALM_ASSERT_3(backlink_col_ndx, <=, m_cols.size());
@@ -1854,6 +1900,16 @@ LinkType Table::get_link_type(size_t col_ndx) const
     return (m_spec->get_column_attr(col_ndx) & col_attr_StrongLinks) ? LinkType::link_Strong : LinkType::link_Weak;
 }
 
+bool Table::is_deduplicated(size_t col_ndx) const
+{
+    if (!is_attached()) {
+        throw LogicError{LogicError::detached_accessor};
+    }
+
+    REALM_ASSERT_DEBUG(col_ndx < m_spec->get_column_count());
+    return (m_spec->get_column_attr(col_ndx) & col_attr_Deduplicated) != 0;
+}
+
 const ColumnBase& Table::get_column_base(size_t ndx) const noexcept
 {
     REALM_ASSERT_DEBUG(ndx < m_spec->get_column_count());
@@ -2248,6 +2304,118 @@ size_t Table::add_row_with_key(size_t key_col_ndx, int64_t key)
 }
 
 
+size_t Table::add_rows_bulk(size_t num_rows, const std::vector<BulkColumn>& columns)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+
+    size_t num_cols = m_spec->get_column_count();
+    if (REALM_UNLIKELY(num_cols == 0)) {
+        throw LogicError(LogicError::table_has_no_columns);
+    }
+
+    // Validate everything up front, such that a failure cannot leave the
+    // table with only some of its columns extended.
+    std::vector<const BulkColumn*> values_by_col_ndx(num_cols, nullptr);
+    for (const BulkColumn& values : columns) {
+        size_t col_ndx = values.get_column_index();
+        if (REALM_UNLIKELY(col_ndx >= get_column_count()))
+            throw LogicError(LogicError::column_index_out_of_range);
+        if (REALM_UNLIKELY(values_by_col_ndx[col_ndx]))
+            throw LogicError(LogicError::illegal_combination);
+        if (REALM_UNLIKELY(values.get_type() != get_column_type(col_ndx)))
+            throw LogicError(LogicError::type_mismatch);
+        bool nullable = is_nullable(col_ndx);
+        bool is_string = values.get_type() == type_String;
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (REALM_UNLIKELY(!nullable && values.is_null(i)))
+                throw LogicError(LogicError::column_not_nullable);
+            if (REALM_UNLIKELY(is_string && values.get_string(i).size() > max_string_size))
+                throw LogicError(LogicError::string_too_big);
+        }
+        values_by_col_ndx[col_ndx] = &values;
+    }
+
+    bump_version();
+
+    size_t row_ndx = m_size;
+    for (size_t col_ndx = 0; col_ndx != num_cols; ++col_ndx) {
+        if (const BulkColumn* values = values_by_col_ndx[col_ndx]) {
+            bulk_append_column(col_ndx, num_rows, *values); // Throws
+        }
+        else {
+            ColumnBase& col = get_column_base(col_ndx);
+            bool insert_nulls = is_nullable(col_ndx);
+            col.insert_rows(row_ndx, num_rows, m_size, insert_nulls); // Throws
+        }
+    }
+    m_size += num_rows;
+
+    if (Replication* repl = get_repl()) {
+        size_t prior_num_rows = m_size - num_rows;
+        repl->add_rows_bulk(this, row_ndx, num_rows, prior_num_rows, columns); // Throws
+    }
+
+    return row_ndx;
+}
+
+
+void Table::bulk_append_column(size_t col_ndx, size_t num_rows, const BulkColumn& values)
+{
+    switch (values.get_type()) {
+        case type_Int:
+        case type_Bool:
+            if (is_nullable(col_ndx)) {
+                IntNullColumn& col = get_column_int_null(col_ndx);
+                col.bulk_append(num_rows, [&](size_t i) -> util::Optional<int64_t> {
+                    if (values.is_null(i))
+                        return util::none;
+                    return values.get_int(i);
+                }); // Throws
+            }
+            else {
+                IntegerColumn& col = get_column(col_ndx);
+                col.bulk_append(num_rows, [&](size_t i) { return values.get_int(i); }); // Throws
+            }
+            return;
+        case type_Float: {
+            FloatColumn& col = get_column_float(col_ndx);
+            col.bulk_append(num_rows, [&](size_t i) {
+                return values.is_null(i) ? null::get_null_float<float>() : values.get_float(i);
+            }); // Throws
+            return;
+        }
+        case type_Double: {
+            DoubleColumn& col = get_column_double(col_ndx);
+            col.bulk_append(num_rows, [&](size_t i) {
+                return values.is_null(i) ? null::get_null_float<double>() : values.get_double(i);
+            }); // Throws
+            return;
+        }
+        case type_Timestamp: {
+            TimestampColumn& col = get_column_timestamp(col_ndx);
+            col.bulk_append(num_rows, [&](size_t i) { return values.get_timestamp(i); }); // Throws
+            return;
+        }
+        case type_String:
+            if (get_real_column_type(col_ndx) == col_type_StringEnum) {
+                // The values must be looked up among the keys one by one
+                StringEnumColumn& col = get_column_string_enum(col_ndx);
+                for (size_t i = 0; i < num_rows; ++i)
+                    col.add(values.get_string(i)); // Throws
+            }
+            else {
+                StringColumn& col = get_column_string(col_ndx);
+                col.bulk_append(num_rows, values.get_strings()); // Throws
+            }
+            return;
+        default:
+            break;
+    }
+    REALM_UNREACHABLE();
+}
+
+
 void Table::erase_row(size_t row_ndx, bool is_move_last_over)
 {
     REALM_ASSERT(is_attached());
@@ -2263,12 +2431,13 @@ void Table::erase_row(size_t row_ndx, bool is_move_last_over)
     }
 
     if (skip_cascade) {
+        size_t num_rows = 1;
         bool broken_reciprocal_backlinks = false;
         if (is_move_last_over) {
-            do_move_last_over(row_ndx, broken_reciprocal_backlinks); // Throws
+            do_move_last_over(row_ndx, num_rows, broken_reciprocal_backlinks); // Throws
         }
         else {
-            do_remove(row_ndx, broken_reciprocal_backlinks); // Throws
+            do_remove(row_ndx, num_rows, broken_reciprocal_backlinks); // Throws
         }
         return;
     }
@@ -2365,18 +2534,27 @@ void Table::batch_erase_rows(const IntegerColumn& row_indexes, bool is_move_last
         }
         sort(rows.begin(), rows.end());
         rows.erase(unique(rows.begin(), rows.end()), rows.end());
-        // Remove in reverse order to prevent invalidation of recorded row
-        // indexes.
-        auto rend = rows.rend();
-        for (auto i = rows.rbegin(); i != rend; ++i) {
-            size_t row_ndx = *i;
+        // Remove runs of consecutive rows at a time, in reverse order to
+        // prevent invalidation of recorded row indexes. Removing a run by
+        // moving the last row over each of its rows, starting from the back,
+        // is the same as doing it one row at a time.
+        size_t end = rows.size();
+        while (end > 0) {
+            size_t begin = end - 1;
+            while (begin > 0 && rows[begin - 1] + 1 == rows[begin])
+                --begin;
+            size_t row_ndx = rows[begin];
+            size_t run_size = end - begin;
             bool broken_reciprocal_backlinks = false;
-            if (is_move_last_over) {
-                do_move_last_over(row_ndx, broken_reciprocal_backlinks); // Throws
+            // A run at the end of the table is removed the same way in both
+            // modes, and removing it in order needs no rows to be moved.
+            if (is_move_last_over && row_ndx + run_size != m_size) {
+                do_move_last_over(row_ndx, run_size, broken_reciprocal_backlinks); // Throws
             }
             else {
-                do_remove(row_ndx, broken_reciprocal_backlinks); // Throws
+                do_remove(row_ndx, run_size, broken_reciprocal_backlinks); // Throws
             }
+            end = begin;
         }
         return;
     }
@@ -2421,7 +2599,7 @@ void Table::batch_erase_rows(const IntegerColumn& row_indexes, bool is_move_last
 
 // Replication instruction 'erase-row(unordered=false)' calls this function
 // directly with broken_reciprocal_backlinks=false.
-void Table::do_remove(size_t row_ndx, bool broken_reciprocal_backlinks)
+void Table::do_remove(size_t row_ndx, size_t num_rows, bool broken_reciprocal_backlinks)
 {
     size_t num_cols = m_spec->get_column_count();
     size_t num_public_cols = m_spec->get_public_column_count();
@@ -2441,29 +2619,34 @@ void Table::do_remove(size_t row_ndx, bool broken_reciprocal_backlinks)
     for (size_t col_ndx = num_cols; col_ndx > num_public_cols; --col_ndx) {
         ColumnBase& col = get_column_base(col_ndx - 1);
         size_t prior_num_rows = m_size;
-        col.erase_rows(row_ndx, 1, prior_num_rows, broken_reciprocal_backlinks); // Throws
+        col.erase_rows(row_ndx, num_rows, prior_num_rows, broken_reciprocal_backlinks); // Throws
     }
 
     if (Replication* repl = get_repl()) {
-        size_t num_rows_to_erase = 1;
         bool is_move_last_over = false;
-        repl->erase_rows(this, row_ndx, num_rows_to_erase, m_size, is_move_last_over); // Throws
+        repl->erase_rows(this, row_ndx, num_rows, m_size, is_move_last_over); // Throws
     }
 
     for (size_t col_ndx = num_public_cols; col_ndx > 0; --col_ndx) {
         ColumnBase& col = get_column_base(col_ndx - 1);
         size_t prior_num_rows = m_size;
-        col.erase_rows(row_ndx, 1, prior_num_rows, broken_reciprocal_backlinks); // Throws
+        col.erase_rows(row_ndx, num_rows, prior_num_rows, broken_reciprocal_backlinks); // Throws
     }
-    adj_row_acc_erase_row(row_ndx);
-    --m_size;
+    if (num_rows == 1) {
+        adj_row_acc_erase_row(row_ndx);
+    }
+    else {
+        adj_row_acc_erase_rows(row_ndx, num_rows);
+    }
+    m_size -= num_rows;
     bump_version();
 }
 
 
 // Replication instruction 'erase-row(unordered=true)' calls this function
-// directly with broken_reciprocal_backlinks=false.
-void Table::do_move_last_over(size_t row_ndx, bool broken_reciprocal_backlinks)
+// directly with broken_reciprocal_backlinks=false. Multiple rows are removed by
+// moving the last row over each of them, starting with the last one.
+void Table::do_move_last_over(size_t row_ndx, size_t num_rows, bool broken_reciprocal_backlinks)
 {
     size_t num_cols = m_spec->get_column_count();
     size_t num_public_cols = m_spec->get_public_column_count();
@@ -2482,25 +2665,24 @@ void Table::do_move_last_over(size_t row_ndx, bool broken_reciprocal_backlinks)
     // generate the instruction, and then delete the row in the remaining columns.
     for (size_t col_ndx = num_cols; col_ndx > num_public_cols; --col_ndx) {
         ColumnBase& col = get_column_base(col_ndx - 1);
-        size_t prior_num_rows = m_size;
-        col.move_last_row_over(row_ndx, prior_num_rows, broken_reciprocal_backlinks); // Throws
+        col.move_last_rows_over(row_ndx, num_rows, m_size, broken_reciprocal_backlinks); // Throws
     }
 
     if (Replication* repl = get_repl()) {
-        size_t num_rows_to_erase = 1;
         bool is_move_last_over = true;
-        repl->erase_rows(this, row_ndx, num_rows_to_erase, m_size, is_move_last_over); // Throws
+        repl->erase_rows(this, row_ndx, num_rows, m_size, is_move_last_over); // Throws
     }
 
     for (size_t col_ndx = num_public_cols; col_ndx > 0; --col_ndx) {
         ColumnBase& col = get_column_base(col_ndx - 1);
-        size_t prior_num_rows = m_size;
-        col.move_last_row_over(row_ndx, prior_num_rows, broken_reciprocal_backlinks); // Throws
+        col.move_last_rows_over(row_ndx, num_rows, m_size, broken_reciprocal_backlinks); // Throws
     }
 
-    size_t last_row_ndx = m_size - 1;
-    adj_row_acc_move_over(last_row_ndx, row_ndx);
-    --m_size;
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t last_row_ndx = m_size - 1 - i;
+        adj_row_acc_move_over(last_row_ndx, row_ndx + num_rows - 1 - i);
+    }
+    m_size -= num_rows;
     bump_version();
 }
 
@@ -3479,26 +3661,26 @@ void Table::set(size_t col_ndx, size_t row_ndx, util::Optional<double> value, bo
 template <class ColType, class T>
 size_t Table::do_find_unique(ColType& col, size_t ndx, T&& value, bool& conflict)
 {
-    size_t winner = size_t(-1);
-
-    while (true) {
-        winner = col.find_first(value, winner + 1);
-        if (winner == ndx)
-            continue;
-        if (winner == not_found)
-            return ndx;
-        else
-            break;
+    // set_unique() requires a search index, which answers the lookup
+    const StringIndex& index = *col.get_search_index();
+    size_t winner = index.find_first(value);
+    if (winner == ndx) {
+        // Avoid scanning the rest of the column when there is no other row
+        // to find
+        winner = (index.count(value) == 1) ? not_found : col.find_first(value, ndx + 1);
     }
+    if (winner == not_found)
+        return ndx;
 
     conflict = true;
 
     REALM_ASSERT(winner != not_found);
     REALM_ASSERT(winner != ndx);
 
-    // Delete additional duplicates.
+    // Delete additional duplicates. Usually there are none, which the index
+    // can tell without scanning the column.
     size_t duplicate = winner;
-    while (true) {
+    while (index.count(value) > 1) {
         duplicate = col.find_first(value, duplicate + 1);
         if (duplicate == ndx)
             continue;
@@ -3660,11 +3842,44 @@ void Table::set_binary_big(size_t col_ndx, size_t ndx, BinaryData value, bool is
                          is_default ? _impl::instr_SetDefault : _impl::instr_Set); // Throws
 }
 
+void Table::write_binary(size_t col_ndx, size_t ndx, size_t pos, BinaryData data)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(ndx >= m_size))
+        throw LogicError(LogicError::row_index_out_of_range);
+    // For a degenerate subtable, `m_cols.size()` is zero, even when it has
+    // columns, however, the previous row index check guarantees that `m_size >
+    // 0`, and since `m_size` is also zero for a degenerate subtable, the table
+    // cannot be degenerate if we got this far.
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        throw LogicError(LogicError::column_index_out_of_range);
+
+    // FIXME: Loophole: Assertion violation in Table::get_column_binary() on
+    // column type mismatch.
+    BinaryColumn& col = get_column_binary(col_ndx);
+    if (REALM_UNLIKELY(pos > col.get_blob_size(ndx)))
+        throw LogicError(LogicError::binary_position_out_of_range);
+    if (data.size() == 0 && !col.is_null(ndx))
+        return;
+    bump_version();
+
+    col.write(ndx, pos, data); // Throws
+
+    if (Replication* repl = get_repl())
+        repl->set_binary_range(this, col_ndx, ndx, pos, data); // Throws
+}
+
 BinaryData Table::get_binary_at(size_t col_ndx, size_t ndx, size_t& pos) const noexcept
 {
     return get_column<BinaryColumn, col_type_Binary>(col_ndx).get_at(ndx, pos);
 }
 
+size_t Table::get_binary_size(size_t col_ndx, size_t ndx) const noexcept
+{
+    return get_column<BinaryColumn, col_type_Binary>(col_ndx).get_blob_size(ndx);
+}
+
 
 DataType Table::get_mixed_type(size_t col_ndx, size_t ndx) const noexcept
 {
@@ -3861,21 +4076,21 @@ int64_t Table::sum_int(size_t col_ndx) const
         return col.sum();
     }
 }
-double Table::sum_float(size_t col_ndx) const
+double Table::sum_float(size_t col_ndx, bool compensated) const
 {
     if (!m_columns.is_attached())
         return 0.f;
 
     const FloatColumn& col = get_column<FloatColumn, col_type_Float>(col_ndx);
-    return col.sum();
+    return compensated ? col.sum_compensated() : col.sum();
 }
-double Table::sum_double(size_t col_ndx) const
+double Table::sum_double(size_t col_ndx, bool compensated) const
 {
     if (!m_columns.is_attached())
         return 0.;
 
     const DoubleColumn& col = get_column<DoubleColumn, col_type_Double>(col_ndx);
-    return col.sum();
+    return compensated ? col.sum_compensated() : col.sum();
 }
 
 // average ----------------------------------------------
@@ -4985,6 +5200,11 @@ void Table::write(std::ostream& out, size_t offset, size_t slice_size, StringDat
     bool pad_for_encryption = false;
     uint_fast64_t version_number = 0;
     int file_format_version = 0;
+    // See Table::do_set_deduplicated()
+    for (size_t i = 0; i < get_column_count(); ++i) {
+        if (is_deduplicated(i))
+            file_format_version = 10;
+    }
     Group::write(out, file_format_version, writer, no_top_array, pad_for_encryption, version_number); // Throws
 }
 
@@ -5950,6 +6170,35 @@ void Table::adj_row_acc_erase_row(size_t row_ndx) noexcept
     }
 }
 
+
+void Table::adj_row_acc_erase_rows(size_t row_ndx, size_t num_rows) noexcept
+{
+    // This function must assume no more than minimal consistency of the
+    // accessor hierarchy. This means in particular that it cannot access the
+    // underlying node structure. See AccessorConsistencyLevels.
+
+    // Adjust row accessors after removal of a range of rows
+    size_t end = row_ndx + num_rows;
+    LockGuard lock(m_accessor_mutex);
+    RowBase* row = m_row_accessors;
+    while (row) {
+        RowBase* next = row->m_next;
+        if (row->m_row_ndx >= end) {
+            row->m_row_ndx -= num_rows;
+        }
+        else if (row->m_row_ndx >= row_ndx) {
+            row->m_table.reset();
+            do_unregister_row_accessor(row);
+        }
+        row = next;
+    }
+
+    // Adjust rows in tableviews after removal of rows
+    for (auto& view : m_views) {
+        view->adj_row_acc_erase_rows(row_ndx, num_rows);
+    }
+}
+
 void Table::adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept
 {
     // This function must assume no more than minimal consistency of the
@@ -6277,6 +6526,14 @@ void Table::refresh_column_accessors(size_t col_ndx_begin)
                     origin_table.connect_opposite_link_columns(link_col_ndx, *this, col_ndx);
                 }
             }
+            else if (col_type == col_type_Binary) {
+                bool deduplicated = (attr & col_attr_Deduplicated) != 0;
+                static_cast<BinaryColumn*>(col)->set_deduplicated(deduplicated);
+            }
+            else if (col_type == col_type_String) {
+                bool deduplicated = (attr & col_attr_Deduplicated) != 0;
+                static_cast<StringColumn*>(col)->set_deduplicated(deduplicated);
+            }
         }
 
         if (column_has_search_index) {
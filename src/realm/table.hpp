@@ -78,6 +78,44 @@ class QueryInfo;
 class Replication;
 
 
+/// The values of one column for Table::add_rows_bulk(), given as an array
+/// with one entry per new row. The array is not copied, so it must stay
+/// alive until add_rows_bulk() returns.
+///
+/// For integer, boolean, float, and double columns, \a nulls may point to a
+/// second array with one entry per new row, where `true` means that the row
+/// is null, and that the corresponding entry in \a values must be ignored.
+/// String and timestamp values carry their own null state (see
+/// StringData::is_null() and Timestamp::is_null()).
+class BulkColumn {
+public:
+    BulkColumn(size_t col_ndx, const int64_t* values, const bool* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const bool* values, const bool* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const float* values, const bool* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const double* values, const bool* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const StringData* values) noexcept;
+    BulkColumn(size_t col_ndx, const Timestamp* values) noexcept;
+
+    size_t get_column_index() const noexcept;
+    DataType get_type() const noexcept;
+
+    bool is_null(size_t ndx) const noexcept;
+    int64_t get_int(size_t ndx) const noexcept;
+    bool get_bool(size_t ndx) const noexcept;
+    float get_float(size_t ndx) const noexcept;
+    double get_double(size_t ndx) const noexcept;
+    StringData get_string(size_t ndx) const noexcept;
+    const StringData* get_strings() const noexcept;
+    Timestamp get_timestamp(size_t ndx) const noexcept;
+
+private:
+    size_t m_col_ndx;
+    DataType m_type;
+    const void* m_values;
+    const bool* m_nulls;
+};
+
+
 /// FIXME: Table assignment (from any group to any group) could be made aliasing
 /// safe as follows: Start by cloning source table into target allocator. On
 /// success, assign, and then deallocate any previous structure at the target.
@@ -170,6 +208,10 @@ public:
     // Throws an LogicError if target column is not a link column.
     LinkType get_link_type(size_t col_ndx) const;
 
+    // Whether identical big values of the column share storage. See
+    // Descriptor::set_deduplicated().
+    bool is_deduplicated(size_t col_ndx) const;
+
     //@{
     /// Conventience functions for inspecting the dynamic table type.
     ///
@@ -386,6 +428,18 @@ public:
     /// remove_recursive() will delete linked rows if the removed link was the
     /// last one holding on to the row in question. This will be done recursively.
     ///
+    /// add_rows_bulk() appends \a num_rows rows and assigns their values column
+    /// by column from the specified arrays (see BulkColumn). Columns that are
+    /// not mentioned get their default value, or null if they are nullable.
+    /// The effect is the same as that of add_empty_row() followed by a set
+    /// operation per specified cell, but the columns are filled a whole B+-tree
+    /// leaf at a time (except enumerated string columns, see optimize()), and
+    /// the change is recorded as a single instruction in the transaction log.
+    /// Only integer, boolean, string and timestamp columns can be specified,
+    /// and at most once each.
+    /// All arguments are checked before the table is modified. Returns the
+    /// index of the first new row.
+    ///
     /// The removal of a row from an unordered table (move_last_over()) may
     /// cause other linked rows to be cascade-removed. The clearing of a table
     /// may also cause linked rows to be cascade-removed, but in this respect,
@@ -395,6 +449,7 @@ public:
     size_t add_empty_row(size_t num_rows = 1);
     void insert_empty_row(size_t row_ndx, size_t num_rows = 1);
     size_t add_row_with_key(size_t col_ndx, int64_t key);
+    size_t add_rows_bulk(size_t num_rows, const std::vector<BulkColumn>& columns);
     void remove(size_t row_ndx);
     void remove_recursive(size_t row_ndx);
     void remove_last();
@@ -452,6 +507,10 @@ public:
     /// if no more data.
     BinaryData get_binary_at(size_t col_ndx, size_t ndx, size_t& pos) const noexcept;
 
+    /// The size of a binary value, also if it is distributed across multiple
+    /// arrays. Zero if the value is null.
+    size_t get_binary_size(size_t col_ndx, size_t ndx) const noexcept;
+
     template <class T>
     T get(size_t c, size_t r) const noexcept;
 
@@ -562,6 +621,16 @@ public:
     // will just return null if the data is bigger than the limit.
     void set_binary_big(size_t column_ndx, size_t row_ndx, BinaryData value, bool is_default = false);
 
+    /// Overwrite the bytes of a binary value starting at \a pos, growing the
+    /// value if the specified data extends beyond its end. A null value is
+    /// treated as empty. Like set_binary_big(), the value may grow beyond
+    /// 16 MB, and only the parts of it that are modified are copied. The
+    /// change is replicated as just the written byte range. See
+    /// BinaryStream for a more convenient interface.
+    ///
+    /// \throw LogicError If \a pos is greater than the size of the value.
+    void write_binary(size_t column_ndx, size_t row_ndx, size_t pos, BinaryData data);
+
     void add_int(size_t column_ndx, size_t row_ndx, int_fast64_t value);
 
     void insert_substring(size_t col_ndx, size_t row_ndx, size_t pos, StringData);
@@ -635,8 +704,12 @@ public:
     size_t count_double(size_t column_ndx, double value) const;
 
     int64_t sum_int(size_t column_ndx) const;
-    double sum_float(size_t column_ndx) const;
-    double sum_double(size_t column_ndx) const;
+
+    /// With \a compensated, the sum is computed with Kahan summation, which
+    /// is slower, but keeps the rounding error independent of the number of
+    /// rows.
+    double sum_float(size_t column_ndx, bool compensated = false) const;
+    double sum_double(size_t column_ndx, bool compensated = false) const;
     int64_t maximum_int(size_t column_ndx, size_t* return_ndx = nullptr) const;
     float maximum_float(size_t column_ndx, size_t* return_ndx = nullptr) const;
     double maximum_double(size_t column_ndx, size_t* return_ndx = nullptr) const;
@@ -1095,9 +1168,10 @@ private:
     mutable uint_fast64_t m_version;
 
     void erase_row(size_t row_ndx, bool is_move_last_over);
+    void bulk_append_column(size_t col_ndx, size_t num_rows, const BulkColumn&);
     void batch_erase_rows(const IntegerColumn& row_indexes, bool is_move_last_over);
-    void do_remove(size_t row_ndx, bool broken_reciprocal_backlinks);
-    void do_move_last_over(size_t row_ndx, bool broken_reciprocal_backlinks);
+    void do_remove(size_t row_ndx, size_t num_rows, bool broken_reciprocal_backlinks);
+    void do_move_last_over(size_t row_ndx, size_t num_rows, bool broken_reciprocal_backlinks);
     void do_swap_rows(size_t row_ndx_1, size_t row_ndx_2);
     void do_move_row(size_t from_ndx, size_t to_ndx);
     void do_merge_rows(size_t row_ndx, size_t new_row_ndx);
@@ -1189,6 +1263,7 @@ private:
     void do_insert_root_column(size_t col_ndx, ColumnType, StringData name, bool nullable = false);
     void do_erase_root_column(size_t col_ndx);
     void do_set_link_type(size_t col_ndx, LinkType);
+    void do_set_deduplicated(size_t col_ndx, bool deduplicated);
     void insert_backlink_column(size_t origin_table_ndx, size_t origin_col_ndx, size_t backlink_col_ndx);
     void erase_backlink_column(size_t origin_table_ndx, size_t origin_col_ndx);
     void update_link_target_tables(size_t old_col_ndx_begin, size_t new_col_ndx_begin);
@@ -1517,6 +1592,7 @@ private:
     void adj_acc_clear_nonroot_table() noexcept;
     void adj_row_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_erase_row(size_t row_ndx) noexcept;
+    void adj_row_acc_erase_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
     void adj_row_acc_move_row(size_t from_ndx, size_t to_ndx) noexcept;
     void adj_row_acc_merge_rows(size_t old_row_ndx, size_t new_row_ndx) noexcept;
@@ -2075,6 +2151,120 @@ inline Table::ConstRowExpr Table::operator[](size_t row_ndx) const noexcept
     return get(row_ndx);
 }
 
+inline BulkColumn::BulkColumn(size_t col_ndx, const int64_t* values, const bool* nulls) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_Int)
+    , m_values(values)
+    , m_nulls(nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const bool* values, const bool* nulls) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_Bool)
+    , m_values(values)
+    , m_nulls(nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const float* values, const bool* nulls) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_Float)
+    , m_values(values)
+    , m_nulls(nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const double* values, const bool* nulls) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_Double)
+    , m_values(values)
+    , m_nulls(nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const StringData* values) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_String)
+    , m_values(values)
+    , m_nulls(nullptr)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const Timestamp* values) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type_Timestamp)
+    , m_values(values)
+    , m_nulls(nullptr)
+{
+}
+
+inline size_t BulkColumn::get_column_index() const noexcept
+{
+    return m_col_ndx;
+}
+
+inline DataType BulkColumn::get_type() const noexcept
+{
+    return m_type;
+}
+
+inline bool BulkColumn::is_null(size_t ndx) const noexcept
+{
+    switch (m_type) {
+        case type_String:
+            return get_string(ndx).is_null();
+        case type_Timestamp:
+            return get_timestamp(ndx).is_null();
+        default:
+            return m_nulls && m_nulls[ndx];
+    }
+}
+
+inline int64_t BulkColumn::get_int(size_t ndx) const noexcept
+{
+    if (m_type == type_Bool)
+        return get_bool(ndx) ? 1 : 0;
+    REALM_ASSERT_DEBUG(m_type == type_Int);
+    return static_cast<const int64_t*>(m_values)[ndx];
+}
+
+inline bool BulkColumn::get_bool(size_t ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_Bool);
+    return static_cast<const bool*>(m_values)[ndx];
+}
+
+inline float BulkColumn::get_float(size_t ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_Float);
+    return static_cast<const float*>(m_values)[ndx];
+}
+
+inline double BulkColumn::get_double(size_t ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_Double);
+    return static_cast<const double*>(m_values)[ndx];
+}
+
+inline StringData BulkColumn::get_string(size_t ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_String);
+    return static_cast<const StringData*>(m_values)[ndx];
+}
+
+inline const StringData* BulkColumn::get_strings() const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_String);
+    return static_cast<const StringData*>(m_values);
+}
+
+inline Timestamp BulkColumn::get_timestamp(size_t ndx) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_type == type_Timestamp);
+    return static_cast<const Timestamp*>(m_values)[ndx];
+}
+
 inline size_t Table::add_empty_row(size_t num_rows)
 {
     size_t row_ndx = m_size;
@@ -2520,16 +2710,16 @@ public:
         return *table.m_cols[col_ndx];
     }
 
-    static void do_remove(Table& table, size_t row_ndx)
+    static void do_remove(Table& table, size_t row_ndx, size_t num_rows = 1)
     {
         bool broken_reciprocal_backlinks = false;
-        table.do_remove(row_ndx, broken_reciprocal_backlinks); // Throws
+        table.do_remove(row_ndx, num_rows, broken_reciprocal_backlinks); // Throws
     }
 
-    static void do_move_last_over(Table& table, size_t row_ndx)
+    static void do_move_last_over(Table& table, size_t row_ndx, size_t num_rows = 1)
     {
         bool broken_reciprocal_backlinks = false;
-        table.do_move_last_over(row_ndx, broken_reciprocal_backlinks); // Throws
+        table.do_move_last_over(row_ndx, num_rows, broken_reciprocal_backlinks); // Throws
     }
 
     static void do_swap_rows(Table& table, size_t row_ndx_1, size_t row_ndx_2)
@@ -2615,6 +2805,11 @@ public:
         table.do_set_link_type(column_ndx, link_type); // Throws
     }
 
+    static void set_deduplicated(Table& table, size_t column_ndx, bool deduplicated)
+    {
+        table.do_set_deduplicated(column_ndx, deduplicated); // Throws
+    }
+
     static void erase_row(Table& table, size_t row_ndx, bool is_move_last_over)
     {
         table.erase_row(row_ndx, is_move_last_over); // Throws
@@ -573,6 +573,22 @@ void TableViewBase::adj_row_acc_erase_row(size_t row_ndx) noexcept
 }
 
 
+void TableViewBase::adj_row_acc_erase_rows(size_t row_ndx, size_t num_rows) noexcept
+{
+    int_fast64_t begin = int_fast64_t(row_ndx);
+    int_fast64_t end = begin + int_fast64_t(num_rows);
+    size_t n = m_row_indexes.size();
+    for (size_t i = 0; i < n; ++i) {
+        int_fast64_t v = m_row_indexes.get(i);
+        if (v >= begin && v < end) {
+            ++m_num_detached_refs;
+            m_row_indexes.set(i, -1);
+        }
+    }
+    m_row_indexes.adjust_ge(end, -int_fast64_t(num_rows));
+}
+
+
 void TableViewBase::adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept
 {
     size_t it = 0;
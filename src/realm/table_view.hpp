@@ -427,6 +427,7 @@ private:
     // Called by table to adjust any row references:
     void adj_row_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_erase_row(size_t row_ndx) noexcept;
+    void adj_row_acc_erase_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept;
     void adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
     void adj_row_acc_move_row(size_t from_row_ndx, size_t to_row_ndx) noexcept;
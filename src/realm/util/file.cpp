@@ -36,6 +36,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <sys/file.h> // BSD / Linux flock()
 #endif
 
@@ -570,6 +571,119 @@ void File::write(const char* data, size_t size)
     write_static(m_fd, data, size);
 }
 
+void File::write_at(const WriteSlice* slices, size_t num_slices)
+{
+    REALM_ASSERT_RELEASE(is_attached());
+    REALM_ASSERT_RELEASE(!m_encryption_key);
+
+#ifdef _WIN32
+    for (size_t i = 0; i < num_slices; ++i) {
+        seek_static(m_fd, slices[i].pos);
+        write_static(m_fd, slices[i].data, slices[i].size);
+    }
+#elif defined(__linux__)
+    std::vector<iovec> iov;
+    iov.reserve(std::min(num_slices, size_t(IOV_MAX)));
+    size_t i = 0;
+    while (i < num_slices) {
+        // Gather a run of adjacent slices
+        SizeType pos = slices[i].pos;
+        SizeType end = pos;
+        iov.clear();
+        while (i < num_slices && slices[i].pos == end && iov.size() < size_t(IOV_MAX)) {
+            REALM_ASSERT_DEBUG(i == 0 || slices[i - 1].pos < slices[i].pos);
+            iov.push_back({const_cast<char*>(slices[i].data), slices[i].size});
+            end += SizeType(slices[i].size);
+            ++i;
+        }
+        iovec* first = iov.data();
+        int count = int(iov.size());
+        while (count > 0) {
+            ssize_t r = ::pwritev(m_fd, first, count, off_t(pos));
+            if (r < 0) {
+                int err = errno; // Eliminate any risk of clobbering
+                if (err == EINTR)
+                    continue;
+                std::string msg = get_errno_msg("pwritev() failed: ", err);
+                if (err == ENOSPC || err == EDQUOT)
+                    throw OutOfDiskSpace(msg);
+                throw std::runtime_error(msg);
+            }
+            REALM_ASSERT_RELEASE(r != 0);
+            // Skip past what was written, which may end in the middle of a
+            // slice
+            pos += SizeType(r);
+            size_t n = size_t(r);
+            while (count > 0 && n >= first->iov_len) {
+                n -= first->iov_len;
+                ++first;
+                --count;
+            }
+            if (count > 0) {
+                first->iov_base = static_cast<char*>(first->iov_base) + n;
+                first->iov_len -= n;
+            }
+        }
+    }
+#else
+    for (size_t i = 0; i < num_slices; ++i) {
+        SizeType pos = slices[i].pos;
+        const char* data = slices[i].data;
+        size_t size = slices[i].size;
+        while (0 < size) {
+            size_t n = std::min(size, size_t(SSIZE_MAX));
+            ssize_t r = ::pwrite(m_fd, data, n, off_t(pos));
+            if (r < 0) {
+                int err = errno; // Eliminate any risk of clobbering
+                if (err == EINTR)
+                    continue;
+                std::string msg = get_errno_msg("pwrite() failed: ", err);
+                if (err == ENOSPC || err == EDQUOT)
+                    throw OutOfDiskSpace(msg);
+                throw std::runtime_error(msg);
+            }
+            REALM_ASSERT_RELEASE(r != 0);
+            REALM_ASSERT_RELEASE(size_t(r) <= n);
+            pos += SizeType(r);
+            data += size_t(r);
+            size -= size_t(r);
+        }
+    }
+#endif
+}
+
+size_t File::read_at(SizeType pos, char* data, size_t size)
+{
+    REALM_ASSERT_RELEASE(is_attached());
+    REALM_ASSERT_RELEASE(!m_encryption_key);
+
+#ifdef _WIN32
+    seek_static(m_fd, pos);
+    return read_static(m_fd, data, size);
+#else
+    char* const data_0 = data;
+    while (0 < size) {
+        // POSIX requires that 'n' is less than or equal to SSIZE_MAX
+        size_t n = std::min(size, size_t(SSIZE_MAX));
+        ssize_t r = ::pread(m_fd, data, n, off_t(pos));
+        if (r == 0)
+            break;
+        if (r < 0) {
+            int err = errno; // Eliminate any risk of clobbering
+            if (err == EINTR)
+                continue;
+            std::string msg = get_errno_msg("pread() failed: ", err);
+            throw std::runtime_error(msg);
+        }
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        pos += SizeType(r);
+        data += size_t(r);
+        size -= size_t(r);
+    }
+    return data - data_0;
+#endif
+}
+
 uint64_t File::get_file_pos(FileDesc fd)
 {
 #ifdef _WIN32
@@ -917,6 +1031,21 @@ void File::sync()
 }
 
 
+void File::sync_data()
+{
+#ifdef __linux__
+    REALM_ASSERT_RELEASE(is_attached());
+
+    if (::fdatasync(m_fd) == 0)
+        return;
+    int err = errno; // Eliminate any risk of clobbering
+    throw std::runtime_error(get_errno_msg("fdatasync() failed: ", err));
+#else
+    sync();
+#endif
+}
+
+
 bool File::lock(bool exclusive, bool non_blocking)
 {
     REALM_ASSERT_RELEASE(is_attached());
@@ -1049,6 +1178,81 @@ void File::sync_map(FileDesc fd, void* addr, size_t size)
 }
 
 
+void File::advise_map(void* addr, size_t size, Advice advice) noexcept
+{
+#ifdef _WIN32
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(advice);
+#else
+    if (size == 0)
+        return;
+    int flag;
+    switch (advice) {
+        case advice_Normal:
+            flag = MADV_NORMAL;
+            break;
+        case advice_Sequential:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case advice_Random:
+            flag = MADV_RANDOM;
+            break;
+        case advice_WillNeed:
+            flag = MADV_WILLNEED;
+            break;
+        case advice_HugePage:
+#ifdef MADV_HUGEPAGE
+            flag = MADV_HUGEPAGE;
+            break;
+#else
+            return;
+#endif
+        default:
+            return;
+    }
+    // madvise() requires a page aligned start address
+    size_t mask = page_size() - 1;
+    uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t aligned_begin = begin & ~uintptr_t(mask);
+    ::madvise(reinterpret_cast<void*>(aligned_begin), size + (begin - aligned_begin), flag); // Throws nothing
+#endif
+}
+
+
+bool File::is_map_resident(void* addr, size_t size) noexcept
+{
+#ifdef _WIN32
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    return true;
+#else
+    if (size == 0)
+        return true;
+    // mincore() requires a page aligned start address, and reports one byte
+    // per page. The first pages of a large range are enough to tell whether
+    // it has been read recently.
+    size_t page = page_size();
+    uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t aligned_begin = begin & ~uintptr_t(page - 1);
+    size_t num_pages = (size + (begin - aligned_begin) + page - 1) / page;
+#ifdef __APPLE__
+    char pages[16];
+#else
+    unsigned char pages[16];
+#endif
+    num_pages = std::min(num_pages, sizeof pages);
+    if (::mincore(reinterpret_cast<void*>(aligned_begin), num_pages * page, pages) != 0)
+        return true;
+    for (size_t i = 0; i < num_pages; ++i) {
+        if ((pages[i] & 1) == 0)
+            return false;
+    }
+    return true;
+#endif
+}
+
+
 bool File::exists(const std::string& path)
 {
 #ifdef _WIN32
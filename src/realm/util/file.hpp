@@ -310,12 +310,40 @@ public:
     void seek(SizeType);
     static void seek_static(FileDesc, SizeType);
 
+    /// A chunk of data to be written at a specific position by write_at().
+    struct WriteSlice {
+        SizeType pos;
+        const char* data;
+        size_t size;
+    };
+
+    /// Write each of the specified slices at its own position in this file.
+    /// The slices must be sorted by position and must not overlap. On Linux,
+    /// each run of adjacent slices is transferred by a single call to
+    /// `pwritev()`. The read/write offset is unspecified afterwards.
+    ///
+    /// This function must not be called on an encrypted file.
+    void write_at(const WriteSlice* slices, size_t num_slices);
+
+    /// Read up to the specified number of bytes from the specified position in
+    /// this file, without using or changing the read/write offset (`pread()`
+    /// on POSIX). Returns the number of bytes read, which is less than the
+    /// requested size only if the end of the file is reached.
+    ///
+    /// This function must not be called on an encrypted file.
+    size_t read_at(SizeType pos, char* data, size_t size);
+
     /// Flush in-kernel buffers to disk. This blocks the caller until the
     /// synchronization operation is complete. On POSIX systems this function
     /// calls `fsync()`. On Apple platforms if calls `fcntl()` with command
     /// `F_FULLFSYNC`.
     void sync();
 
+    /// Same as sync(), except that on Linux, it calls `fdatasync()`, which
+    /// skips the metadata that is not needed for reading back the data, such
+    /// as the modification time.
+    void sync_data();
+
     /// Place an exclusive lock on this file. This blocks the caller
     /// until all other locks have been released.
     ///
@@ -371,6 +399,18 @@ public:
         map_NoSync = 1
     };
 
+    /// Hints about how a memory mapped region is going to be accessed. They
+    /// are passed on to the kernel (madvise()) and have no effect on
+    /// correctness. On platforms where a hint is not supported, it is
+    /// silently ignored.
+    enum Advice {
+        advice_Normal,     ///< Default readahead behavior
+        advice_Sequential, ///< Aggressive readahead, pages may be dropped soon after access
+        advice_Random,     ///< No readahead
+        advice_WillNeed,   ///< Start reading the pages in now
+        advice_HugePage    ///< Back the region by transparent huge pages if possible
+    };
+
     /// Map this file into memory. The file is mapped as shared
     /// memory. This allows two processes to interact under exatly the
     /// same rules as applies to the interaction via regular memory of
@@ -421,6 +461,18 @@ public:
     /// map().
     static void sync_map(FileDesc fd, void* addr, size_t size);
 
+    /// Advise the kernel about the expected access pattern for the specified
+    /// address range, which must be (a subset of) one that was previously
+    /// returned by map(). The range is widened to page boundaries. Failures
+    /// are ignored, as the advice is only a hint.
+    static void advise_map(void* addr, size_t size, Advice) noexcept;
+
+    /// Check whether all pages of the specified address range, which must be
+    /// (a subset of) one that was previously returned by map(), are resident
+    /// in memory (mincore()). Returns true where this cannot be determined,
+    /// such that callers do not issue read-ahead advice for nothing.
+    static bool is_map_resident(void* addr, size_t size) noexcept;
+
     /// Check whether the specified file or directory exists. Note
     /// that a file or directory that resides in a directory that the
     /// calling process has no access to, will necessarily be reported
@@ -600,6 +652,8 @@ private:
         void remap(const File&, AccessMode, size_t size, int map_flags);
         void unmap() noexcept;
         void sync();
+        void advise(Advice, size_t offset, size_t size) const noexcept;
+        bool is_resident(size_t offset, size_t size) const noexcept;
 #if REALM_ENABLE_ENCRYPTION
         util::EncryptedFileMapping* m_encrypted_mapping = nullptr;
         inline util::EncryptedFileMapping* get_encrypted_mapping() const
@@ -733,6 +787,22 @@ public:
     /// attached to a memory mapped file, has undefined behavior.
     void sync();
 
+    /// See File::advise_map(). The range defaults to the entire mapping and
+    /// is clamped to it. Mappings of encrypted files are decrypted on access
+    /// through a separate buffer, so advice has no effect on those.
+    ///
+    /// Calling this function on an instance that is not currently
+    /// attached to a memory mapped file, has undefined behavior.
+    void advise(Advice, size_t offset = 0, size_t size = size_t(-1)) const noexcept;
+
+    /// See File::is_map_resident(). The range is clamped to the mapping.
+    /// Mappings of encrypted files are decrypted on access through a separate
+    /// buffer, so they count as resident.
+    ///
+    /// Calling this function on an instance that is not currently
+    /// attached to a memory mapped file, has undefined behavior.
+    bool is_resident(size_t offset, size_t size) const noexcept;
+
     /// Check whether this Map instance is currently attached to a
     /// memory mapped file.
     bool is_attached() const noexcept;
@@ -1107,6 +1177,28 @@ inline void File::MapBase::sync()
     File::sync_map(m_fd, m_addr, m_size);
 }
 
+inline void File::MapBase::advise(Advice advice, size_t offset, size_t size) const noexcept
+{
+    REALM_ASSERT(m_addr);
+
+    if (get_encrypted_mapping() || offset >= m_size)
+        return;
+    if (size > m_size - offset)
+        size = m_size - offset;
+    File::advise_map(static_cast<char*>(m_addr) + offset, size, advice);
+}
+
+inline bool File::MapBase::is_resident(size_t offset, size_t size) const noexcept
+{
+    REALM_ASSERT(m_addr);
+
+    if (get_encrypted_mapping() || offset >= m_size)
+        return true;
+    if (size > m_size - offset)
+        size = m_size - offset;
+    return File::is_map_resident(static_cast<char*>(m_addr) + offset, size);
+}
+
 template <class T>
 inline File::Map<T>::Map(const File& f, AccessMode a, size_t size, int map_flags)
 {
@@ -1155,6 +1247,18 @@ inline void File::Map<T>::sync()
     MapBase::sync();
 }
 
+template <class T>
+inline void File::Map<T>::advise(Advice advice, size_t offset, size_t size) const noexcept
+{
+    MapBase::advise(advice, offset, size);
+}
+
+template <class T>
+inline bool File::Map<T>::is_resident(size_t offset, size_t size) const noexcept
+{
+    return MapBase::is_resident(offset, size);
+}
+
 template <class T>
 inline bool File::Map<T>::is_attached() const noexcept
 {
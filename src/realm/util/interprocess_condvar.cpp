@@ -33,6 +33,13 @@
 #include <sys/time.h>
 #endif
 
+#ifdef REALM_CONDVAR_FUTEX
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -78,6 +85,29 @@ void notify_fd(int fd)
 } // anonymous namespace
 #endif // REALM_CONDVAR_EMULATION
 
+#ifdef REALM_CONDVAR_FUTEX
+
+namespace {
+
+// Wait until woken up, as long as '*addr' still equals 'expected'. The futex is
+// not process private, because the shared part is mapped by many processes.
+// FUTEX_WAIT_BITSET is used because it takes an absolute timeout (on the
+// realtime clock), which is what wait() is given.
+int futex_wait(uint32_t* addr, uint32_t expected, const timespec* abs_time)
+{
+    return int(syscall(SYS_futex, addr, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, expected, abs_time, nullptr,
+                       FUTEX_BITSET_MATCH_ANY));
+}
+
+void futex_wake(uint32_t* addr, int num_to_wake)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, num_to_wake, nullptr, nullptr, 0);
+}
+
+} // anonymous namespace
+
+#endif // REALM_CONDVAR_FUTEX
+
 
 InterprocessCondVar::InterprocessCondVar()
 {
@@ -265,6 +295,11 @@ void InterprocessCondVar::init_shared_part(SharedPart& shared_part)
     shared_part.wait_counter = 0;
     shared_part.signal_counter = 0;
 #endif
+#elif defined(REALM_CONDVAR_FUTEX)
+    shared_part.sequence = 0;
+    shared_part.waiters = 0;
+    shared_part.signals = 0;
+    shared_part.reserved = 0;
 #else
     new (&shared_part) CondVar(CondVar::process_shared_tag());
 #endif // REALM_CONDVAR_EMULATION
@@ -439,6 +474,41 @@ void InterprocessCondVar::wait(InterprocessMutex& m, const struct timespec* tp)
 
 #endif // _WIN32
 
+#elif defined(REALM_CONDVAR_FUTEX)
+    SharedPart& shared_part = *m_shared_part;
+    uint32_t my_sequence = shared_part.sequence;
+    ++shared_part.waiters;
+    for (;;) {
+        m.unlock(); // open for race from here
+
+        // Race: A notification may happen before the call to futex_wait(). In
+        // that case the sequence number has changed, so futex_wait() returns
+        // immediately. This is intended.
+        int r = futex_wait(&shared_part.sequence, my_sequence, tp);
+        int err = errno;
+
+        m.lock(); // no race after this point.
+
+        // Every notification made since we arrived is for us, or for a waiter
+        // that arrived before us. Whoever gets here first consumes it.
+        if (shared_part.sequence != my_sequence && shared_part.signals > 0) {
+            --shared_part.signals;
+            --shared_part.waiters;
+            return;
+        }
+        if (r == -1 && err == ETIMEDOUT) {
+            --shared_part.waiters;
+            // Unconsumed notifications that can no longer be consumed by
+            // anybody must be dropped, otherwise notify() would think that
+            // the remaining waiters have already been notified.
+            if (shared_part.signals > shared_part.waiters)
+                shared_part.signals = shared_part.waiters;
+            return;
+        }
+        // Interrupted, spuriously woken up, or somebody else consumed the
+        // notification. Wait for the next one.
+        my_sequence = shared_part.sequence;
+    }
 #else
     m_shared_part->wait(*m.m_shared_part, []() {}, tp);
 #endif
@@ -472,6 +542,12 @@ void InterprocessCondVar::notify() noexcept
         notify_fd(m_fd_write != -1 ? m_fd_write : m_fd_read);
     }
 #endif
+#elif defined(REALM_CONDVAR_FUTEX)
+    if (m_shared_part->waiters > m_shared_part->signals) {
+        ++m_shared_part->signals;
+        ++m_shared_part->sequence;
+        futex_wake(&m_shared_part->sequence, 1);
+    }
 #else
     m_shared_part->notify();
 #endif
@@ -525,6 +601,12 @@ void InterprocessCondVar::notify_all() noexcept
         notify_fd(m_fd_write != -1 ? m_fd_write : m_fd_read);
     }
 #endif
+#elif defined(REALM_CONDVAR_FUTEX)
+    if (m_shared_part->waiters > m_shared_part->signals) {
+        m_shared_part->signals = m_shared_part->waiters;
+        ++m_shared_part->sequence;
+        futex_wake(&m_shared_part->sequence, INT_MAX);
+    }
 #else
     m_shared_part->notify_all();
 #endif
@@ -28,8 +28,12 @@
 #include <sys/stat.h>
 #include <mutex>
 
-// Condvar Emulation is required if RobustMutex emulation is enabled
-#if defined(REALM_ROBUST_MUTEX_EMULATION) || defined(_WIN32)
+// On Linux (including Android) the condition variable is built directly on a
+// futex in the shared part. Elsewhere, condvar emulation is required if
+// RobustMutex emulation is enabled
+#if defined(__linux__)
+#define REALM_CONDVAR_FUTEX
+#elif defined(REALM_ROBUST_MUTEX_EMULATION) || defined(_WIN32)
 #define REALM_CONDVAR_EMULATION
 #endif
 
@@ -40,6 +44,9 @@ namespace util {
 /// Condition variable for use in synchronization monitors.
 /// This condition variable uses emulation based on named pipes
 /// for the inter-process case, if enabled by REALM_CONDVAR_EMULATION.
+/// On Linux (REALM_CONDVAR_FUTEX) it waits on a futex in the shared part
+/// instead, so no system call is made by notify() and notify_all() unless
+/// somebody is waiting.
 ///
 /// FIXME: This implementation will never release/delete pipes. This is unlikely
 /// to be a problem as long as only a modest number of different database names
@@ -74,6 +81,19 @@ public:
         uint64_t wait_counter;
 #endif
     };
+#elif defined(REALM_CONDVAR_FUTEX)
+    struct SharedPart {
+        // The futex word. Incremented by every notification that has someone
+        // to wake up. Each waiter remembers the value it saw when it arrived,
+        // so that it can tell whether it has been notified since then.
+        uint32_t sequence;
+        // Number of threads currently inside wait().
+        uint32_t waiters;
+        // Number of notifications not yet consumed by a waiter. Never more
+        // than the number of waiters.
+        uint32_t signals;
+        uint32_t reserved;
+    };
 #else
     typedef CondVar SharedPart;
 #endif
@@ -478,6 +478,36 @@ struct BenchmarkDistinctIntManyDupes : BenchmarkWithIntsTable {
     }
 };
 
+struct BenchmarkSetUniqueInt : BenchmarkWithIntsTable {
+    const char* name() const
+    {
+        return "SetUniqueInt";
+    }
+
+    void before_all(SharedGroup& group)
+    {
+        BenchmarkWithIntsTable::before_all(group);
+        WriteTransaction tr(group);
+        TableRef t = tr.get_table("IntOnly");
+        t->add_empty_row(BASE_SIZE * 4);
+        for (size_t i = 0; i < BASE_SIZE * 4; ++i) {
+            t->set_int(0, i, int64_t(i));
+        }
+        t->add_search_index(0);
+        tr.commit();
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        // One upsert per transaction, which conflicts with an existing row
+        WriteTransaction tr(group);
+        TableRef t = tr.get_table("IntOnly");
+        size_t row_ndx = t->add_empty_row();
+        t->set_int_unique(0, row_ndx, BASE_SIZE * 2);
+        tr.commit();
+    }
+};
+
 struct BenchmarkInsert : BenchmarkWithStringsTable {
     const char* name() const
     {
@@ -712,6 +742,62 @@ struct BenchmarkSetLongString : BenchmarkWithLongStrings {
     }
 };
 
+struct BenchmarkWithDeduplicatedLongStrings : BenchmarkWithLongStrings {
+    std::vector<std::string> values;
+
+    void before_all(SharedGroup& group)
+    {
+        BenchmarkWithLongStrings::before_all(group);
+        WriteTransaction tr(group);
+        TableRef t = tr.get_table("StringOnly");
+        t->get_descriptor()->set_deduplicated(0);
+        tr.commit();
+    }
+
+    void set_values(SharedGroup& group, size_t num_distinct)
+    {
+        if (values.size() != num_distinct) {
+            values.clear();
+            for (size_t i = 0; i < num_distinct; ++i) {
+                std::ostringstream out;
+                out << i << " A really long string, longer than 63 bytes at least, I guess......";
+                values.push_back(out.str());
+            }
+        }
+        WriteTransaction tr(group);
+        TableRef table = tr.get_table("StringOnly");
+        size_t len = table->size();
+        for (size_t i = 0; i < len; ++i) {
+            table->set_string(0, i, values[i % num_distinct]);
+        }
+        tr.commit();
+    }
+};
+
+struct BenchmarkSetDeduplicatedLongString : BenchmarkWithDeduplicatedLongStrings {
+    const char* name() const
+    {
+        return "SetDeduplicatedLongString";
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        set_values(group, 8);
+    }
+};
+
+struct BenchmarkSetDeduplicatedUniqueLongString : BenchmarkWithDeduplicatedLongStrings {
+    const char* name() const
+    {
+        return "SetDeduplicatedUniqueLongString";
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        set_values(group, BASE_SIZE * 4);
+    }
+};
+
 struct BenchmarkQueryNot : Benchmark {
     const char* name() const
     {
@@ -986,6 +1072,7 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkSortInt);
     BENCH(BenchmarkDistinctIntFewDupes);
     BENCH(BenchmarkDistinctIntManyDupes);
+    BENCH(BenchmarkSetUniqueInt);
     BENCH(BenchmarkDistinctStringFewDupes);
     BENCH(BenchmarkDistinctStringManyDupes);
     BENCH(BenchmarkFindAllStringFewDupes);
@@ -999,6 +1086,8 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkGetLongString);
     BENCH(BenchmarkQueryLongString);
     BENCH(BenchmarkSetLongString);
+    BENCH(BenchmarkSetDeduplicatedLongString);
+    BENCH(BenchmarkSetDeduplicatedUniqueLongString);
     BENCH(BenchmarkGetLinkList);
     BENCH(BenchmarkQueryInsensitiveString);
     BENCH(BenchmarkQueryInsensitiveStringIndexed);
@@ -31,6 +31,7 @@ function bench {
 }
 
 bench "realm"
+bench "realm-vectored"
 bench "sqlite"
 bench "mysql"
 bench "sqlite-wal"
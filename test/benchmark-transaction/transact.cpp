@@ -58,6 +58,7 @@ struct thread_info {
 
 
 static bool verbose;
+static SharedGroupOptions realm_options;
 
 // Shared variables and mutex to protect them
 static bool runnable = true;
@@ -81,7 +82,7 @@ void usage(const char* msg)
     std::cout << " -w   : number of writers" << std::endl;
     std::cout << " -r   : number of readers" << std::endl;
     std::cout << " -f   : database file" << std::endl;
-    std::cout << " -d   : database (realm, sqlite, sqlite-wal or mysql)" << std::endl;
+    std::cout << " -d   : database (realm, realm-vectored, sqlite, sqlite-wal or mysql)" << std::endl;
     std::cout << " -t   : duration (in secs)" << std::endl;
     std::cout << " -n   : number of rows" << std::endl;
     std::cout << " -v   : verbose" << std::endl;
@@ -275,7 +276,7 @@ static void* realm_reader(void* arg)
     size_t c = 0;
     srandom(tinfo->thread_num);
     clock_gettime(CLOCK_REALTIME, &ts_1);
-    SharedGroup sg(tinfo->datfile);
+    SharedGroup sg(tinfo->datfile, false, realm_options);
     while (true) {
         pthread_mutex_lock(&mtx_runnable);
         bool local_runnable = runnable;
@@ -401,7 +402,7 @@ static void* realm_writer(void* arg)
     struct timespec ts_1, ts_2;
     struct thread_info* tinfo = (struct thread_info*)arg;
     srandom(tinfo->thread_num);
-    SharedGroup sg(tinfo->datfile);
+    SharedGroup sg(tinfo->datfile, false, realm_options);
     while (true) {
         pthread_mutex_lock(&mtx_runnable);
         bool local_runnable = runnable;
@@ -497,7 +498,7 @@ void realm_create(const char* f, long n)
 {
     util::File::try_remove(f);
     util::File::try_remove(std::string(f) + ".lock");
-    SharedGroup sg(f);
+    SharedGroup sg(f, false, realm_options);
     {
         WriteTransaction wt(sg);
         BasicTableRef<TestTable> t = wt.get_or_add_table<TestTable>("test");
@@ -653,6 +654,11 @@ int main(int argc, char* argv[])
                 if (strcmp(optarg, "realm") == 0) {
                     database = DB_REALM;
                 }
+                if (strcmp(optarg, "realm-vectored") == 0) {
+                    // Commit using vectored writes instead of memory mappings
+                    database = DB_REALM;
+                    realm_options.vectored_writes = true;
+                }
                 if (strcmp(optarg, "sqlite") == 0) {
                     database = DB_SQLITE;
                 }
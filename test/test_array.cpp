@@ -484,6 +484,29 @@ TEST(Array_AddNeg1_1)
 }
 
 
+TEST(Array_GetRange)
+{
+    Array c(Allocator::get_default());
+    c.create(Array::type_Normal);
+
+    // Grow through every element width
+    const int64_t values[] = {0, 1, 3, 15, -128, 32767, -2147483647LL, 4294967296LL * 7};
+    int64_t out[100];
+    for (int64_t value : values) {
+        for (size_t i = 0; i < 10; ++i)
+            c.add(value - int64_t(i % 2));
+        size_t begin = c.size() / 3;
+        size_t end = c.size() - 1;
+        c.get_range(begin, end, out);
+        for (size_t i = begin; i < end; ++i)
+            CHECK_EQUAL(c.get(i), out[i - begin]);
+    }
+    c.get_range(5, 5, out);
+
+    c.destroy();
+}
+
+
 // Oops, see Array_LowerUpperBound
 TEST(Array_UpperLowerBound)
 {
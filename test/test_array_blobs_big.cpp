@@ -404,3 +404,93 @@ TEST(ArrayBigBlobs_get_at)
 
     c.destroy();
 }
+
+
+TEST(ArrayBigBlobs_Deduplicate)
+{
+    ArrayBigBlobs c(Allocator::get_default(), true);
+    c.create();
+
+    const char a[] = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+    const char b[] = "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb";
+    BinaryData bin_a(a, sizeof a - 1), bin_b(b, sizeof b - 1);
+    ArrayBigBlobs::OwnerIndex owners;
+
+    // Equal values share the blob of the first one
+    c.add(bin_a, false, &owners);
+    c.add(bin_b, false, &owners);
+    c.add(bin_a, false, &owners);
+    c.insert(0, bin_a, false, &owners);
+    c.add(BinaryData(), false, &owners);
+    CHECK_EQUAL(5, c.size());
+    CHECK(!c.get_as_ref_or_tagged(1).is_tagged());
+    CHECK(c.get_as_ref_or_tagged(0).is_tagged());
+    CHECK(c.get_as_ref_or_tagged(3).is_tagged());
+    CHECK(c.get(4).is_null());
+    CHECK_EQUAL(3, c.count(bin_a));
+    CHECK_EQUAL(0, c.find_first(bin_a));
+    CHECK_EQUAL(2, c.find_first(bin_b));
+
+    // Values added without deduplication get blobs of their own
+    c.add(bin_a);
+    CHECK(!c.get_as_ref_or_tagged(5).is_tagged());
+    CHECK_EQUAL(4, c.count(bin_a));
+
+    // Erasing the owner hands the blob over to one of the others
+    c.erase(1, true);
+    CHECK(c.get(0) == bin_a);
+    CHECK(c.get(1) == bin_b);
+    CHECK(c.get(2) == bin_a);
+    CHECK_EQUAL(3, c.count(bin_a));
+
+    // Changing a shared value leaves the others untouched
+    c.set(2, bin_b, false, &owners);
+    c.write(0, 0, BinaryData("x", 1), true);
+    CHECK(c.get(1) == bin_b);
+    CHECK(c.get(2) == bin_b);
+    CHECK_EQUAL('x', c.get(0).data()[0]);
+    CHECK_EQUAL(1, c.count(bin_a));
+    c.set(0, bin_b, false, &owners);
+    CHECK_EQUAL(3, c.count(bin_b));
+
+    // Truncation keeps the blobs still referenced
+    c.insert(0, bin_a, false, &owners);
+    c.add(bin_a, false, &owners);
+    c.truncate(2, true);
+    CHECK(c.get(0) == bin_a);
+    CHECK(c.get(1) == bin_b);
+
+    // The index follows the elements moved by an insertion, and is rebuilt
+    // after changes made without it
+    c.insert(1, bin_b, false, &owners);
+    c.insert(0, bin_b, false, &owners);
+    CHECK(c.get_as_ref_or_tagged(0).is_tagged());
+    CHECK(c.get_as_ref_or_tagged(2).is_tagged());
+    c.erase(0, true);
+    c.set(0, bin_b, false, &owners);
+    c.add(bin_b, false, &owners);
+    CHECK(c.get_as_ref_or_tagged(0).is_tagged());
+    CHECK(c.get_as_ref_or_tagged(3).is_tagged());
+    CHECK_EQUAL(0, c.count(bin_a));
+    CHECK_EQUAL(4, c.count(bin_b));
+#ifdef REALM_DEBUG
+    c.verify();
+#endif
+
+    // Afterwards, the leaf can be changed without keeping track of sharing
+    c.unshare_all();
+    for (size_t i = 0; i < c.size(); ++i)
+        CHECK(!c.get_as_ref_or_tagged(i).is_tagged());
+    CHECK_EQUAL(4, c.count(bin_b));
+    c.set(0, bin_a);
+    c.erase(1);
+    c.insert(0, bin_a);
+    CHECK(c.get(0) == bin_a);
+    CHECK(c.get(1) == bin_a);
+    CHECK_EQUAL(2, c.count(bin_b));
+#ifdef REALM_DEBUG
+    c.verify();
+#endif
+
+    c.destroy();
+}
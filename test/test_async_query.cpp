@@ -0,0 +1,251 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_ASYNC_QUERY
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <realm/async_query.hpp>
+#include <realm/history.hpp>
+#include <realm/lang_bind_helper.hpp>
+#include <realm.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+namespace {
+
+void add_rows(SharedGroup& sg, size_t begin, size_t end)
+{
+    WriteTransaction wt(sg);
+    TableRef table = wt.get_or_add_table("table");
+    if (table->get_column_count() == 0)
+        table->add_column(type_Int, "value");
+    for (size_t i = begin; i < end; ++i)
+        table->add_row_with_key(0, int64_t(i));
+    wt.commit();
+}
+
+} // anonymous namespace
+
+
+TEST(AsyncQuery_Future)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist);
+    add_rows(sg, 0, 100);
+
+    AsyncQueryService service(path, [&] { return make_in_realm_history(path); });
+
+    const Group& group = sg.begin_read();
+    ConstTableRef table = group.get_table("table");
+    Query query = table->where().greater(0, 49);
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor(*table, {{0}}, {false}));
+    std::future<AsyncQueryService::Result> future = service.run(sg, query, ordering);
+    AsyncQueryService::Result result = future.get();
+    CHECK(result);
+    CHECK(result.get_version() == sg.get_version_of_current_transaction());
+
+    std::unique_ptr<TableView> tv = result.import_into(sg);
+    CHECK(!result);
+    CHECK(tv->is_attached());
+    CHECK(tv->is_in_sync());
+    CHECK_EQUAL(50, tv->size());
+    CHECK_EQUAL(99, tv->get_int(0, 0));
+    CHECK_EQUAL(50, tv->get_int(0, 49));
+    CHECK_THROW(result.import_into(sg), LogicError);
+    sg.end_read();
+}
+
+
+TEST(AsyncQuery_Callback)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist);
+    add_rows(sg, 0, 10);
+
+    AsyncQueryService service(path, [&] { return make_in_realm_history(path); }, SharedGroupOptions(), 2);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<AsyncQueryService::Result> results;
+
+    const Group& group = sg.begin_read();
+    ConstTableRef table = group.get_table("table");
+    for (int64_t i = 0; i < 10; ++i) {
+        Query query = table->where().less(0, i);
+        service.run(sg, query, DescriptorOrdering(), [&](AsyncQueryService::Result result, std::exception_ptr error) {
+            CHECK(!error);
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::move(result));
+            cond.notify_one();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return results.size() == 10; });
+    }
+
+    std::vector<size_t> sizes;
+    for (AsyncQueryService::Result& result : results)
+        sizes.push_back(result.import_into(sg)->size());
+    std::sort(sizes.begin(), sizes.end());
+    for (size_t i = 0; i < 10; ++i)
+        CHECK_EQUAL(i, sizes[i]);
+    sg.end_read();
+}
+
+
+TEST(AsyncQuery_AdvanceToResult)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist);
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg_w(*hist_w);
+    add_rows(sg_w, 0, 10);
+
+    AsyncQueryService service(path, [&] { return make_in_realm_history(path); });
+
+    // The query is run at the latest version, which is newer than the one
+    // it was submitted at
+    const Group& group = sg.begin_read();
+    ConstTableRef table = group.get_table("table");
+    SharedGroup::VersionID old_version = sg.get_version_of_current_transaction();
+    Query query = table->where().greater_equal(0, 5);
+    add_rows(sg_w, 10, 20);
+    AsyncQueryService::Result result = service.run(sg, query).get();
+    SharedGroup::VersionID new_version = result.get_version();
+    CHECK(new_version > old_version);
+
+    std::unique_ptr<TableView> tv = result.import_into(sg);
+    CHECK(sg.get_version_of_current_transaction() == new_version);
+    CHECK_EQUAL(20, table->size());
+    CHECK_EQUAL(15, tv->size());
+    CHECK(tv->is_in_sync());
+
+    // A result older than the transaction of the importing thread is
+    // rejected, and the version it holds is released when it is destroyed
+    result = service.run(sg, query).get();
+    add_rows(sg_w, 20, 30);
+    LangBindHelper::advance_read(sg);
+    CHECK_THROW(result.import_into(sg), SharedGroup::BadVersion);
+    CHECK(result);
+    result = service.run(sg, query).get();
+    CHECK_EQUAL(25, result.import_into(sg)->size());
+    sg.end_read();
+}
+
+
+TEST(AsyncQuery_Errors)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist);
+    add_rows(sg, 0, 10);
+
+    AsyncQueryService service(path, [&] { return make_in_realm_history(path); });
+
+    // Not in a read transaction
+    {
+        Group& group = const_cast<Group&>(sg.begin_read());
+        Query query = group.get_table("table")->where();
+        sg.end_read();
+        CHECK_THROW(service.run(sg, query), LogicError);
+    }
+
+    // The table is removed before the query is run
+    {
+        std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+        SharedGroup sg_w(*hist_w);
+        const Group& group = sg.begin_read();
+        Query query = group.get_table("table")->where();
+        {
+            WriteTransaction wt(sg_w);
+            wt.get_group().remove_table("table");
+            wt.commit();
+        }
+        std::future<AsyncQueryService::Result> future = service.run(sg, query);
+        CHECK_THROW(future.get(), LogicError);
+        sg.end_read();
+    }
+}
+
+
+TEST(AsyncQuery_WithoutHistory)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroup sg(path);
+    add_rows(sg, 0, 10);
+
+    AsyncQueryService service(path);
+
+    // Without a history, the query is run at the version it was submitted at
+    const Group& group = sg.begin_read();
+    Query query = group.get_table("table")->where().not_equal(0, 3);
+    std::future<AsyncQueryService::Result> future = service.run(sg, query);
+    {
+        SharedGroup sg_w(path);
+        add_rows(sg_w, 10, 20);
+    }
+    AsyncQueryService::Result result = future.get();
+    CHECK(result.get_version() == sg.get_version_of_current_transaction());
+    CHECK_EQUAL(9, result.import_into(sg)->size());
+    sg.end_read();
+}
+
+#endif // TEST_ASYNC_QUERY
@@ -0,0 +1,274 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_COLUMN_CURSOR
+
+#include <string>
+
+#include <realm/column_cursor.hpp>
+#include <realm.hpp>
+
+#include "test.hpp"
+#include "util/check_logic_error.hpp"
+
+using namespace realm;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+namespace {
+
+const size_t num_rows = REALM_MAX_BPNODE_SIZE * 2 + 17;
+
+} // anonymous namespace
+
+
+TEST(ColumnCursor_Int)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_Bool, "bool");
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        // Mix of bit widths within and across leaves
+        int64_t value = (i % 7 == 0) ? -int64_t(i) * 1000003 : int64_t(i % 16);
+        table.set_int(0, i, value);
+        table.set_bool(1, i, i % 3 == 0);
+    }
+
+    ColumnCursor<int64_t> cursor(table, 0);
+    ColumnBlock<int64_t> block;
+    size_t row_ndx = 0;
+    size_t num_blocks = 0;
+    while (cursor.next(block)) {
+        CHECK_EQUAL(row_ndx, block.start_row);
+        CHECK_GREATER(block.size, 0);
+        CHECK_LESS_EQUAL(block.size, REALM_MAX_BPNODE_SIZE);
+        CHECK(!block.nulls);
+        for (size_t i = 0; i < block.size; ++i)
+            CHECK_EQUAL(table.get_int(0, row_ndx + i), block.values[i]);
+        row_ndx += block.size;
+        ++num_blocks;
+    }
+    CHECK_EQUAL(num_rows, row_ndx);
+    CHECK_EQUAL(num_rows, cursor.tell());
+    CHECK_GREATER_EQUAL(num_blocks, 3);
+
+    // A range that starts and ends in the middle of leaves
+    size_t begin = REALM_MAX_BPNODE_SIZE / 2;
+    size_t end = num_rows - 5;
+    ColumnCursor<int64_t> bool_cursor(table, 1, begin, end);
+    row_ndx = begin;
+    while (bool_cursor.next(block)) {
+        CHECK_EQUAL(row_ndx, block.start_row);
+        for (size_t i = 0; i < block.size; ++i)
+            CHECK_EQUAL(table.get_bool(1, row_ndx + i), block.values[i] != 0);
+        row_ndx += block.size;
+    }
+    CHECK_EQUAL(end, row_ndx);
+
+    bool_cursor.seek(end - 1);
+    CHECK(bool_cursor.next(block));
+    CHECK_EQUAL(end - 1, block.start_row);
+    CHECK_EQUAL(1, block.size);
+    CHECK(!bool_cursor.next(block));
+}
+
+
+TEST(ColumnCursor_Nulls)
+{
+    Table table;
+    table.add_column(type_Int, "int", true);
+    table.add_column(type_Float, "float", true);
+    table.add_column(type_Double, "double", true);
+    table.add_column(type_Double, "double not null");
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 3 != 0) {
+            table.set_int(0, i, int64_t(i) - 100);
+            table.set_float(1, i, float(i) / 2);
+            table.set_double(2, i, double(i) / 4);
+        }
+        table.set_double(3, i, -double(i));
+    }
+
+    {
+        ColumnCursor<int64_t> cursor(table, 0);
+        ColumnBlock<int64_t> block;
+        size_t row_ndx = 0;
+        while (cursor.next(block)) {
+            CHECK(block.nulls);
+            for (size_t i = 0; i < block.size; ++i) {
+                CHECK_EQUAL(table.is_null(0, row_ndx + i), block.is_null(i));
+                if (!block.is_null(i))
+                    CHECK_EQUAL(table.get_int(0, row_ndx + i), block.values[i]);
+            }
+            row_ndx += block.size;
+        }
+        CHECK_EQUAL(num_rows, row_ndx);
+    }
+    {
+        ColumnCursor<float> cursor(table, 1);
+        ColumnBlock<float> block;
+        size_t row_ndx = 0;
+        while (cursor.next(block)) {
+            for (size_t i = 0; i < block.size; ++i) {
+                CHECK_EQUAL(table.is_null(1, row_ndx + i), block.is_null(i));
+                if (!block.is_null(i))
+                    CHECK_EQUAL(table.get_float(1, row_ndx + i), block.values[i]);
+            }
+            row_ndx += block.size;
+        }
+        CHECK_EQUAL(num_rows, row_ndx);
+    }
+    {
+        ColumnCursor<double> cursor(table, 2, 1);
+        ColumnBlock<double> block;
+        size_t row_ndx = 1;
+        while (cursor.next(block)) {
+            for (size_t i = 0; i < block.size; ++i) {
+                CHECK_EQUAL(table.is_null(2, row_ndx + i), block.is_null(i));
+                if (!block.is_null(i))
+                    CHECK_EQUAL(table.get_double(2, row_ndx + i), block.values[i]);
+            }
+            row_ndx += block.size;
+        }
+        CHECK_EQUAL(num_rows, row_ndx);
+    }
+    {
+        ColumnCursor<double> cursor(table, 3);
+        ColumnBlock<double> block;
+        double sum = 0;
+        while (cursor.next(block)) {
+            CHECK(!block.nulls);
+            for (size_t i = 0; i < block.size; ++i)
+                sum += block.values[i];
+        }
+        CHECK_EQUAL(table.sum_double(3), sum);
+    }
+}
+
+
+TEST(ColumnCursor_String)
+{
+    Table table;
+    table.add_column(type_String, "short", true);
+    table.add_column(type_String, "mixed", true);
+    table.add_empty_row(num_rows);
+    std::string medium(40, 'm');
+    std::string big(100, 'b');
+    for (size_t i = 0; i < num_rows; ++i) {
+        std::string value = util::to_string(i % 10);
+        std::string medium_value = medium + value;
+        std::string big_value = big + value;
+        if (i % 4 != 0)
+            table.set_string(0, i, value);
+        // Small leaves at the start, then medium, then big
+        if (i < REALM_MAX_BPNODE_SIZE)
+            table.set_string(1, i, value);
+        else if (i < 2 * REALM_MAX_BPNODE_SIZE)
+            table.set_string(1, i, medium_value);
+        else if (i % 5 != 0)
+            table.set_string(1, i, big_value);
+    }
+
+    auto check_column = [&](size_t col_ndx) {
+        ColumnCursor<StringData> cursor(table, col_ndx);
+        ColumnBlock<StringData> block;
+        size_t row_ndx = 0;
+        while (cursor.next(block)) {
+            CHECK_EQUAL(row_ndx, block.start_row);
+            for (size_t i = 0; i < block.size; ++i) {
+                StringData value = table.get_string(col_ndx, row_ndx + i);
+                CHECK_EQUAL(value, block.values[i]);
+                CHECK_EQUAL(value.is_null(), block.values[i].is_null());
+                CHECK_EQUAL(value.is_null(), block.is_null(i));
+            }
+            row_ndx += block.size;
+        }
+        CHECK_EQUAL(num_rows, row_ndx);
+    };
+    check_column(0);
+    check_column(1);
+
+    // Enumerated strings are mapped through the keys
+    table.optimize(true);
+    CHECK(table.get_descriptor()->is_nullable(0));
+    check_column(0);
+    check_column(1);
+}
+
+
+TEST(ColumnCursor_Errors)
+{
+    TableRef table = Table::create();
+    table->add_column(type_Int, "int");
+    table->add_column(type_String, "string");
+    table->add_column(type_Timestamp, "timestamp");
+    table->add_empty_row(10);
+
+    CHECK_LOGIC_ERROR(ColumnCursor<int64_t>(*table, 3), LogicError::column_index_out_of_range);
+    CHECK_LOGIC_ERROR(ColumnCursor<int64_t>(*table, 1), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(ColumnCursor<StringData>(*table, 2), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(ColumnCursor<double>(*table, 0), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(ColumnCursor<int64_t>(*table, 0, 0, 11), LogicError::row_index_out_of_range);
+    CHECK_LOGIC_ERROR(ColumnCursor<int64_t>(*table, 0, 6, 5), LogicError::row_index_out_of_range);
+
+    ColumnCursor<int64_t> empty(*table, 0, 5, 5);
+    ColumnBlock<int64_t> block;
+    CHECK(!empty.next(block));
+
+    Group group;
+    TableRef group_table = group.add_table("table");
+    group_table->add_column(type_Int, "int");
+    group_table->add_empty_row();
+    ColumnCursor<int64_t> cursor(*group_table, 0);
+    group.remove_table("table");
+    CHECK_LOGIC_ERROR(cursor.next(block), LogicError::detached_accessor);
+}
+
+#endif // TEST_COLUMN_CURSOR
@@ -0,0 +1,175 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_COLUMN_STATISTICS
+
+#include <cmath>
+#include <limits>
+
+#include <realm/column_statistics.hpp>
+#include <realm.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+
+TEST(ColumnStatistics_Exact)
+{
+    // Small columns are read in full
+    ref_type ref = IntNullColumn::create(Allocator::get_default());
+    IntNullColumn col(Allocator::get_default(), ref);
+    for (size_t i = 0; i < 100; ++i) {
+        if (i % 5 == 0)
+            col.add(util::none);
+        else
+            col.add(int64_t(i % 10));
+    }
+
+    ColumnStatistics<int64_t> statistics;
+    statistics.sample(col);
+    CHECK_EQUAL(100, statistics.num_rows());
+    CHECK_EQUAL(100, statistics.sample_size());
+    CHECK_EQUAL(0.2, statistics.null_fraction());
+    CHECK_EQUAL(8, statistics.distinct_count());
+    CHECK_EQUAL(0.1, statistics.selectivity<Equal>(int64_t(3)));
+    CHECK_EQUAL(0, statistics.selectivity<Equal>(int64_t(5)));
+    CHECK_EQUAL(0.2, statistics.selectivity<Equal>(util::Optional<int64_t>()));
+    CHECK_EQUAL(0.9, statistics.selectivity<NotEqual>(int64_t(3)));
+    CHECK_EQUAL(0.3, statistics.selectivity<Less>(int64_t(4)));
+    CHECK_EQUAL(0.4, statistics.selectivity<GreaterEqual>(int64_t(6)));
+    CHECK_EQUAL(0, statistics.selectivity<Greater>(util::Optional<int64_t>()));
+
+    col.destroy();
+}
+
+
+TEST(ColumnStatistics_Sampled)
+{
+    const size_t num_rows = 100000;
+    ref_type ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn skewed(Allocator::get_default(), ref);
+    ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn unique(Allocator::get_default(), ref);
+    ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn few(Allocator::get_default(), ref);
+    for (size_t i = 0; i < num_rows; ++i) {
+        skewed.add(i % 50 == 7 ? 1 : 0);
+        unique.add(int64_t(i));
+        few.add(int64_t(i % 4));
+    }
+
+    ColumnStatistics<int64_t> statistics;
+    statistics.sample(skewed);
+    CHECK_EQUAL(num_rows, statistics.num_rows());
+    CHECK_EQUAL(ColumnStatistics<int64_t>::max_sample_size, statistics.sample_size());
+    CHECK_EQUAL(0, statistics.null_fraction());
+    CHECK_LESS_EQUAL(std::abs(statistics.selectivity<Equal>(int64_t(0)) - 0.98), 0.03);
+    CHECK_LESS_EQUAL(std::abs(statistics.selectivity<Greater>(int64_t(0)) - 0.02), 0.03);
+    // Values that are not in the sample are estimated to be rare, not absent
+    double missing = statistics.selectivity<Equal>(int64_t(2));
+    CHECK_GREATER(missing, 0);
+    CHECK_LESS_EQUAL(missing, 0.5 / statistics.sample_size());
+
+    // Every value read is distinct, so there are many more in the column
+    statistics.sample(unique);
+    CHECK_GREATER(statistics.distinct_count(), 10.0 * statistics.sample_size());
+    CHECK_LESS_EQUAL(statistics.distinct_count(), num_rows);
+    CHECK_LESS(statistics.selectivity<Equal>(int64_t(12345)), 1.0 / statistics.sample_size());
+    CHECK_LESS_EQUAL(std::abs(statistics.selectivity<Less>(int64_t(num_rows / 4)) - 0.25), 0.05);
+
+    statistics.sample(few);
+    CHECK_EQUAL(4, statistics.distinct_count());
+    CHECK_LESS_EQUAL(std::abs(statistics.selectivity<Equal>(int64_t(2)) - 0.25), 0.05);
+
+    skewed.destroy();
+    unique.destroy();
+    few.destroy();
+}
+
+
+TEST(ColumnStatistics_FloatAndTimestamp)
+{
+    ref_type ref = DoubleColumn::create(Allocator::get_default());
+    DoubleColumn doubles(Allocator::get_default(), ref);
+    ref = TimestampColumn::create(Allocator::get_default(), 0, true);
+    TimestampColumn timestamps(true, Allocator::get_default(), ref);
+    const size_t num_rows = 2000;
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 4 == 0)
+            doubles.add(null::get_null_float<double>());
+        else if (i % 4 == 1)
+            doubles.add(std::numeric_limits<double>::quiet_NaN());
+        else
+            doubles.add(double(i % 100) / 10);
+        timestamps.add(i % 2 == 0 ? Timestamp{} : Timestamp(int64_t(i), 0));
+    }
+
+    ColumnStatistics<double> double_statistics;
+    double_statistics.sample(doubles);
+    CHECK_LESS_EQUAL(std::abs(double_statistics.null_fraction() - 0.25), 0.05);
+    // A NaN is a value, but it is neither equal to, nor less than, anything,
+    // and nulls are not equal to any value
+    double null_value = null::get_null_float<double>();
+    CHECK_LESS_EQUAL(std::abs(double_statistics.selectivity<Equal>(null_value) - 0.25), 0.05);
+    CHECK_LESS_EQUAL(std::abs(double_statistics.selectivity<Less>(100.0) - 0.5), 0.05);
+    CHECK_EQUAL(1, double_statistics.selectivity<NotEqual>(1e10));
+
+    ColumnStatistics<Timestamp> timestamp_statistics;
+    timestamp_statistics.sample(timestamps);
+    CHECK_LESS_EQUAL(std::abs(timestamp_statistics.null_fraction() - 0.5), 0.05);
+    CHECK_LESS_EQUAL(std::abs(timestamp_statistics.selectivity<Equal>(Timestamp{}) - 0.5), 0.05);
+    CHECK_LESS_EQUAL(std::abs(timestamp_statistics.selectivity<Greater>(Timestamp(1000, 0)) - 0.25), 0.05);
+
+    doubles.destroy();
+    timestamps.destroy();
+}
+
+#endif // TEST_COLUMN_STATISTICS
@@ -1538,4 +1538,76 @@ TEST(ColumnString_NonLeafRoot)
     }
 }
 
+
+TEST_TYPES(ColumnString_BulkAppend, non_nullable, nullable)
+{
+    constexpr bool nullable = TEST_TYPE::value;
+    const size_t leaf_size = REALM_MAX_BPNODE_SIZE;
+    const size_t num_rows = 4 * leaf_size + 5;
+    const std::string medium = "This is a medium long string";
+    const std::string big = "This is a rather long string, that should not be very much shorter";
+
+    // The first leaf is topped up, and the one holding row `2 * leaf_size`
+    // needs medium strings, and the one holding row `3 * leaf_size` big ones
+    std::vector<std::string> strings(num_rows);
+    std::vector<StringData> values(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t row_ndx = 3 + i;
+        bool is_null = false;
+        if (row_ndx == 2 * leaf_size + leaf_size / 2) {
+            strings[i] = medium;
+        }
+        else if (row_ndx == 3 * leaf_size + leaf_size / 2) {
+            strings[i] = big;
+        }
+        else {
+            strings[i] = util::to_string(i);
+            is_null = nullable && i % 9 == 0;
+        }
+        values[i] = is_null ? StringData() : StringData(strings[i]);
+    }
+
+    ref_type ref = StringColumn::create(Allocator::get_default());
+    StringColumn c(Allocator::get_default(), ref, nullable);
+    c.create_search_index();
+    c.add("a");
+    c.add("b");
+    c.add("c");
+    c.bulk_append(num_rows, values.data());
+
+    CHECK_EQUAL(3 + num_rows, c.size());
+    for (size_t i = 0; i < num_rows; ++i)
+        CHECK_EQUAL(values[i], c.get(3 + i));
+    c.verify();
+
+    auto leaf_type = [&](size_t row_ndx) {
+        size_t ndx_in_leaf;
+        StringColumn::LeafType type;
+        c.get_leaf(row_ndx, ndx_in_leaf, type);
+        return type;
+    };
+    CHECK_EQUAL(StringColumn::leaf_type_Small, leaf_type(0));
+    CHECK_EQUAL(StringColumn::leaf_type_Small, leaf_type(leaf_size));
+    CHECK_EQUAL(StringColumn::leaf_type_Medium, leaf_type(2 * leaf_size));
+    CHECK_EQUAL(StringColumn::leaf_type_Big, leaf_type(3 * leaf_size));
+    CHECK_EQUAL(StringColumn::leaf_type_Small, leaf_type(4 * leaf_size));
+
+    // The search index must have been kept up to date
+    CHECK_EQUAL(1, c.count(medium));
+    CHECK_EQUAL(3 * leaf_size + leaf_size / 2, c.find_first(big));
+    CHECK_EQUAL(3 + 10, c.find_first(strings[10]));
+
+    // Regular appends must work on the resulting tree, also where the last
+    // leaf has to change type
+    c.add(big);
+    CHECK_EQUAL(big, c.get(3 + num_rows));
+    CHECK_EQUAL(StringColumn::leaf_type_Big, leaf_type(4 * leaf_size));
+    c.bulk_append(num_rows, values.data());
+    CHECK_EQUAL(4 + 2 * num_rows, c.size());
+    CHECK_EQUAL(values[num_rows - 1], c.get(c.size() - 1));
+    c.verify();
+
+    c.destroy();
+}
+
 #endif // TEST_COLUMN_STRING
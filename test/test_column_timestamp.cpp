@@ -595,6 +595,92 @@ TEST(TimestampColumn_FindFirst)
     CHECK_EQUAL(t.find_first_timestamp(1, Timestamp(-1, 0)), 5);
 }
 
+namespace {
+
+template <class Condition>
+void check_find(test_util::unit_test::TestContext& test_context, const Table& table, size_t col_ndx,
+                Timestamp value)
+{
+    const TimestampColumn& col =
+        static_cast<const TimestampColumn&>(_impl::TableFriend::get_column(table, col_ndx));
+    Condition cond;
+    size_t num_rows = table.size();
+    for (size_t begin = 0; begin < num_rows; begin += 97) {
+        size_t end = num_rows - begin / 3;
+        size_t expected = npos;
+        for (size_t i = begin; i < end; ++i) {
+            Timestamp ts = table.get_timestamp(col_ndx, i);
+            if (cond(ts, value, ts.is_null(), value.is_null())) {
+                expected = i;
+                break;
+            }
+        }
+        CHECK_EQUAL(expected, col.find<Condition>(value, begin, end));
+    }
+}
+
+} // anonymous namespace
+
+TEST(TimestampColumn_FindConditions)
+{
+    // Several leaves, with ties in the seconds, nulls and extreme seconds
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 2 + 17;
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    // Rows holding the extremes, in different leaves for any
+    // REALM_MAX_BPNODE_SIZE, and never null
+    const size_t min_row = num_rows * 3 / 5;
+    const size_t max_row = num_rows - 2;
+    Table table;
+    table.add_column(type_Timestamp, "nullable", true);
+    table.add_column(type_Timestamp, "not nullable", false);
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        int64_t seconds = int64_t(i % 11) - 5;
+        if (i == min_row)
+            seconds = min;
+        if (i == max_row)
+            seconds = max;
+        // The nanoseconds must not have the opposite sign of the seconds
+        int32_t nanoseconds = seconds < 0 ? -int32_t(i % 3) : int32_t(i % 3);
+        if (i % 13 != 7 || i == min_row || i == max_row)
+            table.set_timestamp(0, i, Timestamp(seconds, nanoseconds));
+        table.set_timestamp(1, i, Timestamp(seconds, nanoseconds));
+    }
+    // Large seconds give a wide leaf, and a null value that can be hit by a
+    // seconds only comparison
+    table.set_timestamp(0, 3, Timestamp(1000000, 0));
+    CHECK_EQUAL(min, table.get_timestamp(0, min_row).get_seconds());
+    CHECK_EQUAL(max, table.get_timestamp(0, max_row).get_seconds());
+
+    const Timestamp values[] = {Timestamp{},    Timestamp(0, 0),   Timestamp(0, 1),     Timestamp(-5, -2),
+                                Timestamp(5, 0), Timestamp(6, 0),  Timestamp(min, 0),   Timestamp(max, 0),
+                                Timestamp(-1, -1), Timestamp(1000000, 0), Timestamp(2000000, 0)};
+    for (size_t col_ndx = 0; col_ndx < 2; ++col_ndx) {
+        for (Timestamp value : values) {
+            check_find<Equal>(test_context, table, col_ndx, value);
+            check_find<NotEqual>(test_context, table, col_ndx, value);
+            check_find<Greater>(test_context, table, col_ndx, value);
+            check_find<GreaterEqual>(test_context, table, col_ndx, value);
+            check_find<Less>(test_context, table, col_ndx, value);
+            check_find<LessEqual>(test_context, table, col_ndx, value);
+        }
+    }
+
+    // The query engine finds all matches, not just the first
+    size_t expected = 0;
+    size_t num_nulls = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        Timestamp ts = table.get_timestamp(0, i);
+        if (ts.is_null())
+            ++num_nulls;
+        else if (ts > Timestamp(2, 1))
+            ++expected;
+    }
+    CHECK_EQUAL(expected, table.where().greater(0, Timestamp(2, 1)).count());
+    CHECK_EQUAL(num_nulls, table.where().equal(0, Timestamp{}).count());
+}
+
 TEST(TimestampColumn_AddColumnAfterRows)
 {
     constexpr bool nullable = true;
@@ -174,6 +174,72 @@ TEST(File_MapMultiplePages)
     }
 }
 
+TEST(File_MapAdvise)
+{
+    TEST_PATH(path);
+    const size_t size = page_size() * 4;
+    File f(path, File::mode_Write);
+    f.resize(size);
+    File::Map<char> map(f, File::access_ReadWrite, size);
+    for (size_t i = 0; i < size; ++i)
+        map.get_addr()[i] = char(i);
+
+    // Advice is only a hint and must not affect the contents of the mapping,
+    // also for ranges that are unaligned or extend beyond the end.
+    map.advise(File::advice_Sequential);
+    map.advise(File::advice_Random);
+    map.advise(File::advice_HugePage);
+    map.advise(File::advice_WillNeed, 13, page_size());
+    map.advise(File::advice_WillNeed, size - 1, size);
+    map.advise(File::advice_WillNeed, size + 8);
+    map.advise(File::advice_Normal);
+    File::advise_map(map.get_addr() + 1, 7, File::advice_WillNeed);
+    for (size_t i = 0; i < size; ++i) {
+        if (map.get_addr()[i] != char(i)) {
+            CHECK_EQUAL(int(map.get_addr()[i]), int(char(i)));
+            break;
+        }
+    }
+
+    // Every page has just been written, so it is resident. Ranges beyond the
+    // end of the mapping count as resident, as there is nothing to page in.
+    CHECK(map.is_resident(0, size));
+    CHECK(map.is_resident(13, page_size()));
+    CHECK(File::is_map_resident(map.get_addr() + 1, 7));
+    CHECK(map.is_resident(size, 8));
+}
+
+
+TEST(File_WriteAt)
+{
+    TEST_PATH(path);
+    File f(path, File::mode_Write);
+    f.resize(256);
+
+    // Two runs of adjacent slices, one of which is unaligned
+    char data[64];
+    for (size_t i = 0; i < sizeof data; ++i)
+        data[i] = char('a' + i % 26);
+    File::WriteSlice slices[] = {{8, data, 8}, {16, data + 8, 24}, {40, data + 32, 3}, {101, data, 64}};
+    f.write_at(slices, 4);
+    f.sync_data();
+
+    std::vector<char> expected(256, 0);
+    for (const File::WriteSlice& slice : slices)
+        std::copy(slice.data, slice.data + slice.size, expected.begin() + size_t(slice.pos));
+    File::Map<char> map(f, File::access_ReadOnly, 256);
+    CHECK(std::equal(expected.begin(), expected.end(), map.get_addr()));
+    CHECK_EQUAL(f.get_size(), 256);
+
+    // Reads stop at the end of the file
+    char buffer[64];
+    CHECK_EQUAL(f.read_at(101, buffer, 64), 64);
+    CHECK(std::equal(data, data + 64, buffer));
+    CHECK_EQUAL(f.read_at(240, buffer, 64), 16);
+    CHECK(std::equal(expected.begin() + 240, expected.end(), buffer));
+}
+
+
 TEST(File_ReaderAndWriter)
 {
     const size_t count = 4096 / sizeof(size_t) * 256 * 2;
@@ -0,0 +1,319 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_FLOAT_KERNELS
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <realm/impl/float_kernels.hpp>
+#include <realm.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::_impl;
+using namespace realm::test_util;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+namespace {
+
+// Small integers, such that sums are exact in any order, mixed with nulls,
+// NaNs and infinities as requested.
+template <class T>
+std::vector<T> make_values(Random& random, size_t size, bool with_nulls, bool with_nan, bool with_inf)
+{
+    std::vector<T> values(size);
+    for (size_t i = 0; i < size; ++i) {
+        int kind = random.draw_int_mod(20);
+        if (with_nulls && kind == 0)
+            values[i] = null::get_null_float<T>();
+        else if (with_nan && kind == 1)
+            values[i] = std::numeric_limits<T>::quiet_NaN();
+        else if (with_inf && kind == 2)
+            values[i] = std::numeric_limits<T>::infinity();
+        else
+            values[i] = T(random.draw_int<int>(-1000, 1000));
+    }
+    return values;
+}
+
+template <class T>
+void check_sum(unit_test::TestContext& test_context, Random& random)
+{
+    for (size_t size = 0; size < 40; ++size) {
+        for (int variant = 0; variant < 4; ++variant) {
+            std::vector<T> values = make_values<T>(random, size + 1, variant & 1, variant == 2, variant == 3);
+            // Start at an odd offset, which is never vector aligned
+            const T* data = values.data() + 1;
+            double expected = 0;
+            size_t expected_count = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (!null::is_null_float(data[i])) {
+                    expected += data[i];
+                    ++expected_count;
+                }
+            }
+            for (bool compensated : {false, true}) {
+                FloatSum state;
+                float_sum(data, size, compensated, state);
+                CHECK_EQUAL(expected_count, state.count);
+                if (std::isnan(expected))
+                    CHECK(std::isnan(state.sum));
+                else
+                    CHECK_EQUAL(expected, state.sum - state.compensation);
+            }
+            CHECK_EQUAL(size - expected_count, float_count_null(data, size));
+        }
+    }
+}
+
+template <class T>
+void check_minmax(unit_test::TestContext& test_context, Random& random)
+{
+    for (size_t size = 0; size < 40; ++size) {
+        for (int variant = 0; variant < 4; ++variant) {
+            std::vector<T> values = make_values<T>(random, size, true, variant >= 1, variant >= 2);
+            if (variant == 3) {
+                // Only nulls and NaNs
+                for (size_t i = 0; i < size; ++i)
+                    values[i] = i % 2 ? null::get_null_float<T>() : std::numeric_limits<T>::quiet_NaN();
+            }
+            const T inf = std::numeric_limits<T>::infinity();
+            size_t expected_min = npos;
+            size_t expected_max = npos;
+            T min = inf;
+            T max = -inf;
+            for (size_t i = 0; i < size; ++i) {
+                if (values[i] < min || (expected_min == npos && values[i] == inf)) {
+                    min = values[i];
+                    expected_min = i;
+                }
+                if (values[i] > max || (expected_max == npos && values[i] == -inf)) {
+                    max = values[i];
+                    expected_max = i;
+                }
+            }
+            CHECK_EQUAL(expected_min, float_find_min(values.data(), size));
+            CHECK_EQUAL(expected_max, float_find_max(values.data(), size));
+        }
+    }
+}
+
+template <class T>
+void check_find_first(unit_test::TestContext& test_context, Random& random)
+{
+    const FloatCompare compares[] = {FloatCompare::equal,   FloatCompare::not_equal,
+                                     FloatCompare::less,    FloatCompare::less_equal,
+                                     FloatCompare::greater, FloatCompare::greater_equal};
+    std::vector<T> values = make_values<T>(random, 100, true, true, true);
+    for (size_t i = 0; i < values.size(); ++i) {
+        // Few distinct values, such that all conditions have matches
+        if (!std::isnan(values[i]) && !std::isinf(values[i]))
+            values[i] = T(int(values[i]) % 4);
+    }
+    for (FloatCompare c : compares) {
+        for (T value : {T(-1), T(0), T(1.5), T(3), std::numeric_limits<T>::infinity()}) {
+            for (size_t begin = 0; begin < 12; ++begin) {
+                for (size_t end = begin; end < values.size(); end += 7) {
+                    size_t expected = npos;
+                    for (size_t i = begin; i < end && expected == npos; ++i) {
+                        T v = values[i];
+                        bool match = false;
+                        switch (c) {
+                            case FloatCompare::equal:
+                                match = v == value;
+                                break;
+                            case FloatCompare::not_equal:
+                                match = v != value;
+                                break;
+                            case FloatCompare::less:
+                                match = v < value;
+                                break;
+                            case FloatCompare::less_equal:
+                                match = v <= value;
+                                break;
+                            case FloatCompare::greater:
+                                match = v > value;
+                                break;
+                            case FloatCompare::greater_equal:
+                                match = v >= value;
+                                break;
+                        }
+                        if (match)
+                            expected = i;
+                    }
+                    CHECK_EQUAL(expected, float_find_first(c, values.data(), begin, end, value));
+                }
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+
+TEST(FloatKernels_Sum)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    check_sum<float>(test_context, random);
+    check_sum<double>(test_context, random);
+}
+
+
+TEST(FloatKernels_MinMax)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    check_minmax<float>(test_context, random);
+    check_minmax<double>(test_context, random);
+}
+
+
+TEST(FloatKernels_FindFirst)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    check_find_first<float>(test_context, random);
+    check_find_first<double>(test_context, random);
+}
+
+
+TEST(FloatKernels_Compensated)
+{
+    // Every small value is lost when added to the big one, unless the
+    // rounding error is carried along
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 3 + 5;
+    Table table;
+    table.add_column(type_Double, "double", true);
+    table.add_column(type_Float, "float");
+    table.add_empty_row(num_rows + 1);
+    table.set_double(0, 0, 1e16);
+    table.set_float(1, 0, 1e8f);
+    for (size_t i = 1; i <= num_rows; ++i) {
+        if (i % 10 != 0)
+            table.set_double(0, i, 1.0);
+        table.set_float(1, i, 1.0f);
+    }
+    size_t num_small = num_rows - num_rows / 10;
+    CHECK_EQUAL(1e16 + double(num_small), table.sum_double(0, true));
+    CHECK_EQUAL(1e8 + double(num_rows), table.sum_float(1, true));
+
+    // Floats are summed in double precision either way
+    CHECK_EQUAL(1e8 + double(num_rows), table.sum_float(1));
+    CHECK_APPROXIMATELY_EQUAL(table.sum_double(0), table.sum_double(0, true), 1e-12);
+
+    // An infinite sum stays infinite
+    table.set_double(0, 5, std::numeric_limits<double>::infinity());
+    CHECK_EQUAL(std::numeric_limits<double>::infinity(), table.sum_double(0, true));
+}
+
+
+TEST(FloatKernels_Query)
+{
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 2 + 11;
+    Table table;
+    table.add_column(type_Double, "nullable", true);
+    table.add_column(type_Float, "float");
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 7 != 3)
+            table.set_double(0, i, double(int(i % 23) - 11));
+        table.set_float(1, i, i == 100 ? std::numeric_limits<float>::quiet_NaN() : float(i % 13));
+    }
+
+    // Compare each condition with a row by row evaluation
+    auto count_rows = [&](size_t col_ndx, bool (*pred)(double)) {
+        size_t n = 0;
+        for (size_t i = 0; i < num_rows; ++i) {
+            bool is_null = table.is_null(col_ndx, i);
+            double v = col_ndx == 0 ? table.get_double(0, i) : table.get_float(1, i);
+            if (!is_null && pred(v))
+                ++n;
+        }
+        return n;
+    };
+    CHECK_EQUAL(count_rows(0, [](double v) { return v == 5; }), table.where().equal(0, 5.0).count());
+    CHECK_EQUAL(count_rows(0, [](double v) { return v > 5; }), table.where().greater(0, 5.0).count());
+    CHECK_EQUAL(count_rows(0, [](double v) { return v >= 5; }), table.where().greater_equal(0, 5.0).count());
+    CHECK_EQUAL(count_rows(0, [](double v) { return v < -3; }), table.where().less(0, -3.0).count());
+    CHECK_EQUAL(count_rows(0, [](double v) { return v <= -3; }), table.where().less_equal(0, -3.0).count());
+    // Nulls are not equal to any value
+    CHECK_EQUAL(num_rows - count_rows(0, [](double v) { return v == 5; }), table.where().not_equal(0, 5.0).count());
+    CHECK_EQUAL(num_rows - count_rows(1, [](double v) { return v == 2; }), table.where().not_equal(1, 2.0f).count());
+    CHECK_EQUAL(count_rows(1, [](double v) { return v >= 12; }), table.where().greater_equal(1, 12.0f).count());
+    CHECK_EQUAL(table.size() - table.count_double(0, 0) - count_rows(0, [](double v) { return v != 0; }),
+                table.where().equal(0, null()).count());
+
+    // Aggregates skip nulls, and the NaN is never a minimum or maximum
+    size_t ndx = npos;
+    CHECK_EQUAL(-11, table.minimum_double(0, &ndx));
+    CHECK_EQUAL(0, ndx);
+    CHECK_EQUAL(11, table.maximum_double(0, &ndx));
+    CHECK_EQUAL(22, ndx);
+    CHECK_EQUAL(0, table.minimum_float(1, &ndx));
+    CHECK_EQUAL(0, ndx);
+    CHECK_EQUAL(12, table.maximum_float(1, &ndx));
+    CHECK_EQUAL(12, ndx);
+    CHECK(std::isnan(table.sum_float(1)));
+
+    double sum = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (!table.is_null(0, i)) {
+            sum += table.get_double(0, i);
+            ++count;
+        }
+    }
+    CHECK_EQUAL(sum, table.sum_double(0));
+    size_t value_count = 0;
+    CHECK_EQUAL(sum / count, table.average_double(0, &value_count));
+    CHECK_EQUAL(count, value_count);
+}
+
+#endif // TEST_FLOAT_KERNELS
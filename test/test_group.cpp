@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 
 #include <sys/stat.h>
 #ifndef _WIN32
@@ -39,6 +40,8 @@ static const mode_t2 MS_MODE_MASK = 0x0000ffff;
 
 #include <realm.hpp>
 #include <realm/util/file.hpp>
+#include <realm/impl/output_stream.hpp>
+#include <realm/impl/parallel_writer.hpp>
 
 #include "test.hpp"
 #include "test_table_helper.hpp"
@@ -1214,6 +1217,50 @@ TEST(Group_Serialize_All)
     CHECK_EQUAL(false, t->get_mixed(5, 0).get_bool());
 }
 
+TEST(Group_Serialize_Parallel)
+{
+    // Enough data for several output batches
+    Group group;
+    for (int i = 0; i < 3; ++i) {
+        std::string name = "table_" + util::to_string(i);
+        TableRef table = group.add_table(name);
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "string");
+        size_t num_rows = 700000;
+        table->add_empty_row(num_rows);
+        for (size_t j = 0; j < num_rows; ++j)
+            table->set_int(0, j, int64_t(j) << 40);
+        table->set_string(1, num_rows - 1, "last");
+    }
+
+    // The refs must be the same as those of a single threaded write
+    Allocator& alloc = _impl::GroupFriend::get_alloc(group);
+    ref_type top_ref = _impl::GroupFriend::get_top_ref(group);
+    std::ostringstream serial;
+    ref_type serial_ref;
+    {
+        _impl::OutputStream out(serial);
+        bool only_if_modified = false;
+        serial_ref = Array::write(top_ref, alloc, out, only_if_modified);
+    }
+    for (size_t num_threads : {1, 2, 5}) {
+        // The second write reuses the threads of the first
+        _impl::ParallelArrayWriter writer(num_threads);
+        for (int i = 0; i < 2; ++i) {
+            std::ostringstream parallel;
+            _impl::OutputStream out(parallel);
+            CHECK_EQUAL(serial_ref, writer.write(top_ref, alloc, out));
+            CHECK_EQUAL(serial.str().size(), size_t(out.get_ref_of_next_array()));
+            CHECK(serial.str() == parallel.str());
+        }
+    }
+
+    BinaryData buffer = group.write_to_mem();
+    Group from_mem(buffer);
+    from_mem.verify();
+    CHECK(group == from_mem);
+}
+
 TEST(Group_Persist)
 {
     GROUP_TEST_PATH(path);
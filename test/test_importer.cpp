@@ -0,0 +1,322 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_IMPORTER
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <realm.hpp>
+#include <realm/importer.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+//
+// Another way to debug a particular test, is to copy that test into
+// `experiments/testcase.cpp` and then run `sh build.sh
+// check-testcase` (or one of its friends) from the command line.
+
+
+namespace {
+
+void write_file(const std::string& path, const std::string& contents)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+}
+
+// An importer that imports from a memory mapped file with 'threads' parser
+// threads, each of which handles chunks of about 'bytes_per_chunk' bytes
+Importer make_importer(size_t threads, size_t bytes_per_chunk = parallel_chunk_size)
+{
+    Importer importer;
+    importer.Quiet = true;
+    importer.Empty_as_string = false;
+    importer.Threads = threads;
+    importer.Parallel_chunk_size = bytes_per_chunk;
+    return importer;
+}
+
+// A header and 'num_rows' records of the form 'i,"name i",i.5,true|false'
+std::string simple_csv(size_t num_rows)
+{
+    std::ostringstream out;
+    out << "id,name,value,flag\n";
+    for (size_t i = 0; i < num_rows; ++i)
+        out << i << ",\"name " << i << "\"," << i << ".5," << (i % 3 == 0 ? "true" : "false") << "\n";
+    return out.str();
+}
+
+// Records with quoted fields holding separators, doubled quotes, and line
+// breaks, unquoted empty fields, negative numbers, and mixed line endings
+std::string mixed_csv(Random& random, size_t num_rows)
+{
+    std::ostringstream out;
+    out << "id,name,price,flag,note\r\n";
+    for (size_t i = 0; i < num_rows; ++i) {
+        out << random.draw_int<int>(-100000, 100000) << ",";
+        out << "\"name " << i << ", \"\"quoted\"\"\",";
+        out << random.draw_int<int>(0, 1000000) << "." << random.draw_int<int>(100000, 999999) << ",";
+        out << (random.draw_bool() ? "yes" : "no") << ",";
+        switch (random.draw_int_mod(4)) {
+            case 0:
+                break;
+            case 1:
+                out << "note " << i;
+                break;
+            default:
+                out << "\"line 1 of " << i << "\nline 2\r\nline 3\"";
+                break;
+        }
+        out << (random.draw_bool() ? "\r\n" : "\n");
+    }
+    return out.str();
+}
+
+} // anonymous namespace
+
+
+TEST(Importer_MultipleChunks)
+{
+    TEST_PATH(path);
+    const size_t num_rows = 1000;
+    write_file(path, simple_csv(num_rows));
+
+    // About 20 records per chunk, after the 10 used to detect the types
+    Importer importer = make_importer(4, 512);
+    Table table;
+    CHECK_EQUAL(num_rows, importer.import_csv_auto(path, table, 10));
+
+    CHECK_EQUAL(4, table.get_column_count());
+    CHECK_EQUAL("id", table.get_column_name(0));
+    CHECK_EQUAL(type_Int, table.get_column_type(0));
+    CHECK_EQUAL(type_String, table.get_column_type(1));
+    CHECK_EQUAL(type_Float, table.get_column_type(2));
+    CHECK_EQUAL(type_Bool, table.get_column_type(3));
+    CHECK_EQUAL(num_rows, table.size());
+    for (size_t i = 0; i < num_rows; ++i) {
+        CHECK_EQUAL(int64_t(i), table.get_int(0, i));
+        CHECK_EQUAL("name " + std::to_string(i), table.get_string(1, i));
+        CHECK_EQUAL(float(i) + 0.5f, table.get_float(2, i));
+        CHECK_EQUAL(i % 3 == 0, table.get_bool(3, i));
+    }
+}
+
+
+TEST(Importer_QuotedLineBreakAcrossChunks)
+{
+    TEST_PATH(path);
+
+    // The quoted field fills most of each record, so most chunks would end
+    // inside it if line breaks within quotes were taken for record ends
+    const size_t num_rows = 500;
+    std::ostringstream out;
+    for (size_t i = 0; i < num_rows; ++i)
+        out << i << ",\"first line of " << i << "\nsecond line\r\nthird line\"," << i * 2 << "\n";
+    write_file(path, out.str());
+
+    for (size_t bytes_per_chunk : {1, 7, 33, 64, 100}) {
+        Importer importer = make_importer(3, bytes_per_chunk);
+        Table table;
+        importer.import_csv_manual(path, table, {type_Int, type_String, type_Int}, {"a", "b", "c"});
+        CHECK_EQUAL(num_rows, table.size());
+        for (size_t i = 0; i < table.size(); ++i) {
+            CHECK_EQUAL(int64_t(i), table.get_int(0, i));
+            CHECK_EQUAL("first line of " + std::to_string(i) + "\nsecond line\r\nthird line",
+                        table.get_string(1, i));
+            CHECK_EQUAL(int64_t(i * 2), table.get_int(2, i));
+        }
+    }
+}
+
+
+TEST(Importer_MalformedRows)
+{
+    TEST_PATH(path);
+    const size_t num_rows = 1000;
+    std::string csv = simple_csv(num_rows);
+
+    // A field of the wrong type. The error names the row, counted from zero
+    // after the header, and the table is left without columns. Every import
+    // reports the same error, whichever thread parsed the row.
+    {
+        std::string bad = csv;
+        bad.replace(bad.find("\n700,") + 1, 3, "x00");
+        write_file(path, bad);
+
+        std::string expected = "Column 0 was auto detected to be of type Int using the first 10 rows of CSV file, "
+                               "but in row 700 of cvs file the field contained 'x00' which is of another type. "
+                               "Please increase the 'type_detection_rows' argument";
+        for (size_t threads : {1, 4}) {
+            Importer importer = make_importer(threads, 512);
+            Table table;
+            std::string message;
+            CHECK_THROW_ANY_GET_MESSAGE(importer.import_csv_auto(path, table, 10), message);
+            CHECK_EQUAL(expected, message);
+            CHECK_EQUAL(0, table.get_column_count());
+        }
+
+        std::FILE* file = std::fopen(std::string(path).c_str(), "rb");
+        Importer importer = make_importer(1);
+        Table table;
+        std::string message;
+        CHECK_THROW_ANY_GET_MESSAGE(importer.import_csv_auto(file, table, 10), message);
+        CHECK_EQUAL(expected, message);
+        std::fclose(file);
+    }
+
+    // The same with a scheme given by the caller
+    {
+        std::string bad = csv;
+        bad.replace(bad.find("\n801,") + 1, 3, "abc");
+        write_file(path, bad);
+
+        std::string expected = "Column 0 was specified to be of type Int, but in row 801 of cvs file,the field "
+                               "contained 'abc' which is of another type";
+        for (size_t threads : {1, 4}) {
+            Importer importer = make_importer(threads, 512);
+            Table table;
+            std::string message;
+            CHECK_THROW_ANY_GET_MESSAGE(importer.import_csv_manual(path, table,
+                                                                   {type_Int, type_String, type_Float, type_Bool},
+                                                                   {"id", "name", "value", "flag"}, 1),
+                                        message);
+            CHECK_EQUAL(expected, message);
+            CHECK_EQUAL(0, table.get_column_count());
+        }
+    }
+
+    // A record with an extra field. The error names the line of the record,
+    // give or take three lines.
+    {
+        std::string bad = csv;
+        bad.insert(bad.find("\n851,"), ",extra");
+        write_file(path, bad);
+
+        for (size_t threads : {1, 4}) {
+            Importer importer = make_importer(threads, 512);
+            Table table;
+            std::string message;
+            CHECK_THROW_ANY_GET_MESSAGE(importer.import_csv_auto(path, table, 10), message);
+            std::string prefix = "Wrong number of delimitors around line ";
+            CHECK_EQUAL(prefix, message.substr(0, prefix.size()));
+            int line = std::atoi(message.c_str() + prefix.size());
+            CHECK_GREATER_EQUAL(line, 852 - 3);
+            CHECK_LESS_EQUAL(line, 852 + 3);
+        }
+    }
+}
+
+
+TEST(Importer_ImportRowsLimit)
+{
+    TEST_PATH(path);
+    const size_t num_rows = 1000;
+    write_file(path, simple_csv(num_rows));
+
+    for (size_t limit : {0, 1, 10, 11, 333, 999, 1000, 5000}) {
+        size_t expected = std::min(limit, num_rows);
+        for (size_t threads : {1, 4}) {
+            Importer importer = make_importer(threads, 256);
+            Table table;
+            CHECK_EQUAL(expected, importer.import_csv_auto(path, table, 10, limit));
+            CHECK_EQUAL(expected, table.size());
+            if (expected > 0)
+                CHECK_EQUAL(int64_t(expected - 1), table.get_int(0, expected - 1));
+        }
+
+        std::FILE* file = std::fopen(std::string(path).c_str(), "rb");
+        Importer importer = make_importer(1);
+        Table table;
+        CHECK_EQUAL(expected, importer.import_csv_auto(file, table, 10, limit));
+        CHECK_EQUAL(expected, table.size());
+        std::fclose(file);
+    }
+
+    // The limit counts the rows after the skipped ones
+    Importer importer = make_importer(4, 256);
+    Table table;
+    CHECK_EQUAL(100, importer.import_csv_manual(path, table, {type_Int, type_String, type_Float, type_Bool},
+                                                {"id", "name", "value", "flag"}, 501, 100));
+    CHECK_EQUAL(100, table.size());
+    CHECK_EQUAL(500, table.get_int(0, 0));
+    CHECK_EQUAL(599, table.get_int(0, 99));
+}
+
+
+TEST(Importer_ParallelMatchesSingleThreaded)
+{
+    TEST_PATH(path);
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const size_t num_rows = 3000;
+    write_file(path, mixed_csv(random, num_rows));
+
+    std::FILE* file = std::fopen(std::string(path).c_str(), "rb");
+    Importer stream_importer = make_importer(1);
+    Table expected;
+    CHECK_EQUAL(num_rows, stream_importer.import_csv_auto(file, expected, 100));
+    std::fclose(file);
+    CHECK_EQUAL(5, expected.get_column_count());
+    CHECK_EQUAL(type_Int, expected.get_column_type(0));
+    CHECK_EQUAL(type_String, expected.get_column_type(1));
+    CHECK_EQUAL(type_Double, expected.get_column_type(2));
+    CHECK_EQUAL(type_Bool, expected.get_column_type(3));
+    CHECK_EQUAL(type_String, expected.get_column_type(4));
+
+    for (size_t threads : {1, 2, 5}) {
+        for (size_t bytes_per_chunk : {size_t(100), size_t(4096), parallel_chunk_size}) {
+            Importer importer = make_importer(threads, bytes_per_chunk);
+            Table table;
+            CHECK_EQUAL(num_rows, importer.import_csv_auto(path, table, 100));
+            CHECK(table == expected);
+        }
+    }
+}
+
+#endif // TEST_IMPORTER
@@ -31,6 +31,7 @@
 #include <realm/util/encrypted_file_mapping.hpp>
 #include <realm/util/to_string.hpp>
 #include <realm/replication.hpp>
+#include <realm/row_cache.hpp>
 #include <realm/history.hpp>
 
 // Need fork() and waitpid() for Shared_RobustAgainstDeathDuringWrite
@@ -7698,6 +7699,10 @@ public:
     {
         return false;
     }
+    bool set_deduplicated(size_t, bool)
+    {
+        return false;
+    }
     bool insert_empty_rows(size_t, size_t, size_t, bool)
     {
         return false;
@@ -7818,6 +7823,10 @@ public:
     {
         return false;
     }
+    bool set_binary_range(size_t, size_t, size_t, BinaryData)
+    {
+        return false;
+    }
     bool optimize_table()
     {
         return false;
@@ -13557,6 +13566,356 @@ TEST(LangBindHelper_UpdateDescriptor)
     CHECK_EQUAL(tv.size(), 1);
 }
 
+TEST(LangBindHelper_AdvanceReadTransact_EraseRowRuns)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+    SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+
+    {
+        WriteTransaction wt(sg_w);
+        TableRef target = wt.add_table("target");
+        target->add_column(type_Int, "i");
+        target->add_column(type_String, "s");
+        target->add_search_index(1);
+        target->add_empty_row(30);
+        for (size_t i = 0; i < 30; ++i) {
+            target->set_int(0, i, i);
+            std::string str = util::to_string(i);
+            target->set_string(1, i, str);
+        }
+        TableRef origin = wt.add_table("origin");
+        origin->add_column_link(type_Link, "link", *target);
+        origin->add_empty_row(30);
+        for (size_t i = 0; i < 30; ++i)
+            origin->set_link(0, i, i);
+        wt.commit();
+    }
+
+    Group& group = const_cast<Group&>(sg.begin_read());
+    ConstTableRef target = group.get_table("target");
+    ConstTableRef origin = group.get_table("origin");
+    ConstRow row_3 = target->get(3);
+    ConstRow row_5 = target->get(5);
+    ConstRow row_27 = target->get(27);
+
+    auto check = [&](const Table& table) {
+        for (size_t i = 0; i < table.size(); ++i) {
+            std::string str = util::to_string(table.get_int(0, i));
+            CHECK_EQUAL(str, table.get_string(1, i));
+            CHECK_EQUAL(i, table.find_first_string(1, str));
+        }
+        for (size_t i = 0; i < origin->size(); ++i) {
+            if (origin->is_null_link(0, i))
+                continue;
+            CHECK_EQUAL(int64_t(i), table.get_int(0, origin->get_link(0, i)));
+        }
+    };
+
+    // Remove runs in the middle and at the end of the table in one batch
+    for (int mode = 0; mode < 2; ++mode) {
+        RemoveMode remove_mode = (mode == 0 ? RemoveMode::unordered : RemoveMode::ordered);
+        {
+            WriteTransaction wt(sg_w);
+            TableRef t = wt.get_table("target");
+            size_t n = t->size();
+            size_t rows[] = {6, 7, 8, 9, 11, n - 2, n - 1};
+            Query q = t->where().equal(0, t->get_int(0, rows[0]));
+            for (size_t row_ndx : rows)
+                q.Or().equal(0, t->get_int(0, row_ndx));
+            TableView tv = q.find_all();
+            CHECK_EQUAL(7, tv.size());
+            tv.clear(remove_mode);
+            wt.commit();
+        }
+        LangBindHelper::advance_read(sg);
+        group.verify();
+        check(*target);
+        CHECK_EQUAL(30 - (mode + 1) * 7, target->size());
+        CHECK(row_3.is_attached());
+        CHECK_EQUAL(3, row_3.get_int(0));
+        CHECK(row_5.is_attached());
+        CHECK_EQUAL(5, row_5.get_int(0));
+    }
+    CHECK(!row_27.is_attached());
+
+    // Rollback of a batch removal restores the table accessors
+    LangBindHelper::promote_to_write(sg);
+    {
+        TableRef t = group.get_table("target");
+        TableView tv = t->where().less(0, 6).find_all();
+        tv.clear(RemoveMode::unordered);
+        CHECK(!row_3.is_attached());
+    }
+    LangBindHelper::rollback_and_continue_as_read(sg);
+    group.verify();
+    check(*target);
+    CHECK_EQUAL(16, target->size());
+}
+
+
+// Version 1 histories may hold instructions that older cores cannot replay, so
+// older histories are upgraded, and older cores reject the newer histories.
+TEST(LangBindHelper_HistorySchemaVersion)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+        {
+            WriteTransaction wt(sg);
+            TableRef table = wt.add_table("table");
+            table->add_column(type_Int, "i");
+            table->add_empty_row(10);
+            wt.commit();
+        }
+        WriteTransaction wt(sg);
+        CHECK_EQUAL(1, _impl::GroupFriend::get_history_schema_version(wt.get_group()));
+
+        // Pretend that the history was written by an older core
+        _impl::GroupFriend::set_history_schema_version(wt.get_group(), 0);
+        wt.commit();
+    }
+
+    // Opening it without permission to upgrade fails
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        bool allow_upgrade = false;
+        CHECK_THROW(SharedGroup(*hist, SharedGroupOptions(SharedGroupOptions::Durability::Full, crypt_key(),
+                                                          allow_upgrade)),
+                    FileFormatUpgradeRequired);
+    }
+
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+        ReadTransaction rt(sg);
+        CHECK_EQUAL(1, _impl::GroupFriend::get_history_schema_version(rt.get_group()));
+        CHECK_EQUAL(10, rt.get_table("table")->size());
+    }
+}
+
+
+TEST(LangBindHelper_RowCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+    SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+
+    {
+        WriteTransaction wt(sg_w);
+        TableRef people = wt.add_table("people");
+        people->add_column(type_Int, "id");
+        people->add_column(type_String, "name", true);
+        people->add_column(type_Double, "score");
+        people->add_column(type_Timestamp, "seen", true);
+        people->add_column(type_Binary, "blob");
+        people->add_empty_row(100);
+        for (size_t i = 0; i < 100; ++i) {
+            std::string name = "name " + util::to_string(i);
+            people->set_int(0, i, i);
+            if (i % 7 != 0)
+                people->set_string(1, i, name);
+            people->set_double(2, i, i * 0.5);
+            if (i % 5 != 0)
+                people->set_timestamp(3, i, Timestamp(i, int32_t(i)));
+            people->set_binary(4, i, BinaryData(name.data(), name.size()));
+        }
+        TableRef origin = wt.add_table("origin");
+        origin->add_column_link(type_Link, "person", *people);
+        origin->add_empty_row(10);
+        for (size_t i = 0; i < 10; ++i)
+            origin->set_link(0, i, 90 + i);
+        wt.commit();
+    }
+
+    ReadTransaction rt(sg);
+    ConstTableRef people = rt.get_table("people");
+    ConstTableRef origin = rt.get_table("origin");
+
+    auto check_rows = [&](RowCache& cache, const Table& table) {
+        for (size_t i = 0; i < table.size(); ++i) {
+            const CachedRow& row = cache.get(i);
+            CHECK_EQUAL(i, row.get_index());
+            for (size_t col = 0; col < table.get_column_count(); ++col) {
+                CHECK_EQUAL(table.is_null(col, i), row.is_null(col));
+                switch (table.get_column_type(col)) {
+                    case type_Int:
+                        CHECK_EQUAL(table.get_int(col, i), row.get_int(col));
+                        break;
+                    case type_String:
+                        CHECK_EQUAL(table.get_string(col, i), row.get_string(col));
+                        break;
+                    case type_Double:
+                        CHECK_EQUAL(table.get_double(col, i), row.get_double(col));
+                        break;
+                    case type_Timestamp:
+                        CHECK_EQUAL(table.get_timestamp(col, i), row.get_timestamp(col));
+                        break;
+                    case type_Binary:
+                        CHECK_EQUAL(table.get_binary(col, i), row.get_binary(col));
+                        break;
+                    case type_Link:
+                        if (!table.is_null_link(col, i))
+                            CHECK_EQUAL(table.get_link(col, i), row.get_link(col));
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    };
+
+    RowCache cache(*people, 10);
+    CHECK_EQUAL(10, cache.capacity());
+    for (size_t i = 0; i < 20; ++i)
+        CHECK_EQUAL(i, cache.get(i).get_int(0));
+    CHECK_EQUAL(10, cache.size());
+    CHECK_EQUAL("name 15", cache.get(15).get_string(1));
+    CHECK(cache.get(14).get_string(1).is_null());
+    CHECK_LOGIC_ERROR(cache.get(100), LogicError::row_index_out_of_range);
+
+    // Only the changed rows are dropped, and the others are renumbered
+    {
+        WriteTransaction wt(sg_w);
+        TableRef people_w = wt.get_table("people");
+        people_w->set_int(0, 15, 1015);
+        people_w->insert_empty_row(0);
+        people_w->move_last_over(12);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg, cache.observer());
+    CHECK_EQUAL(8, cache.size());
+    CHECK_EQUAL(1015, cache.get(16).get_int(0));
+    CHECK_EQUAL(13, cache.get(14).get_int(0));
+    CHECK_EQUAL(9, cache.size());
+    RowCache big_cache(*people, 1000);
+    check_rows(big_cache, *people);
+
+    // Changes to other tables leave the cache alone
+    {
+        WriteTransaction wt(sg_w);
+        wt.get_table("origin")->set_link(0, 0, 1);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg, big_cache.observer());
+    CHECK_EQUAL(people->size(), big_cache.size());
+
+    // Modifications that are not observed clear the cache
+    {
+        WriteTransaction wt(sg_w);
+        wt.get_table("people")->set_string(1, 3, "changed");
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg);
+    CHECK_EQUAL("changed", big_cache.get(3).get_string(1));
+    CHECK_EQUAL(1, big_cache.size());
+
+    LangBindHelper::promote_to_write(sg, big_cache.observer());
+    check_rows(big_cache, *people);
+    const_cast<Table&>(*people).set_double(2, 5, 42);
+    CHECK_EQUAL(42, big_cache.get(5).get_double(2));
+    CHECK_EQUAL(1, big_cache.size());
+    check_rows(big_cache, *people);
+    LangBindHelper::rollback_and_continue_as_read(sg, big_cache.observer());
+    CHECK_EQUAL(people->size() - 1, big_cache.size());
+    check_rows(big_cache, *people);
+
+    // Rolling back a move_last_over() moves the last row back into place
+    LangBindHelper::promote_to_write(sg, big_cache.observer());
+    const_cast<Table&>(*people).move_last_over(5);
+    check_rows(big_cache, *people);
+    LangBindHelper::rollback_and_continue_as_read(sg, big_cache.observer());
+    CHECK_EQUAL(people->size() - 1, big_cache.size());
+    check_rows(big_cache, *people);
+
+    // Links change when rows of the target table are moved
+    RowCache origin_cache(*origin, 100);
+    check_rows(origin_cache, *origin);
+    {
+        WriteTransaction wt(sg_w);
+        wt.get_table("people")->move_last_over(0);
+        wt.get_table("people")->swap_rows(1, 95);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg, origin_cache.observer());
+    check_rows(origin_cache, *origin);
+
+    // Column changes
+    {
+        WriteTransaction wt(sg_w);
+        TableRef people_w = wt.get_table("people");
+        people_w->remove_column(2);
+        people_w->add_column(type_Bool, "flag");
+        people_w->set_bool(4, 7, true);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg, cache.observer());
+    CHECK_EQUAL(0, cache.size());
+    CHECK(cache.get(7).get_bool(4));
+    check_rows(cache, *people);
+
+    // Removal of the table
+    {
+        WriteTransaction wt(sg_w);
+        wt.get_group().remove_table("origin");
+        wt.get_group().remove_table("people");
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg, cache.observer());
+    CHECK_EQUAL(0, cache.size());
+    CHECK_LOGIC_ERROR(cache.get(0), LogicError::detached_accessor);
+}
+
+TEST(LangBindHelper_SetUniqueAcrossTransactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+
+    const size_t num_rows = 1000;
+    {
+        WriteTransaction wt(sg);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "pk");
+        table->add_column(type_Int, "value");
+        table->add_search_index(0);
+        table->add_empty_row(num_rows);
+        for (size_t i = 0; i < num_rows; ++i)
+            table->set_int(0, i, int64_t(i));
+        wt.commit();
+    }
+
+    // One upsert per transaction, as a binding would do it. Every other
+    // transaction also looks up the key first.
+    for (size_t i = 0; i < 100; ++i) {
+        WriteTransaction wt(sg);
+        TableRef table = wt.get_table("table");
+        int64_t key = int64_t(i * 7 % num_rows);
+        if (i % 2 == 1)
+            CHECK_EQUAL(size_t(key), table->find_first_int(0, key));
+        size_t row_ndx = table->add_empty_row();
+        CHECK_EQUAL(size_t(key), table->set_int_unique(0, row_ndx, key));
+        table->set_int(1, size_t(key), int64_t(i));
+        CHECK_EQUAL(num_rows, table->size());
+        wt.commit();
+    }
+
+    ReadTransaction rt(sg);
+    ConstTableRef table = rt.get_table("table");
+    CHECK_EQUAL(num_rows, table->size());
+    for (size_t i = 0; i < 100; ++i) {
+        int64_t key = int64_t(i * 7 % num_rows);
+        CHECK_EQUAL(size_t(key), table->find_first_int(0, key));
+        CHECK_EQUAL(int64_t(i), table->get_int(1, size_t(key)));
+    }
+}
+
+
 TEST(LangBindHelper_callWithLock)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -907,6 +907,88 @@ TEST(LinkList_MultiLinkQuery)
 }
 
 
+TEST(LinkList_QueryVaryingLengths)
+{
+    Group group;
+    TableRef origin = group.add_table("origin");
+    TableRef target = group.add_table("target");
+    target->add_column(type_Int, "int");
+    size_t col_list = origin->add_column_link(type_LinkList, "list", *target);
+    target->add_empty_row(100);
+    for (size_t i = 0; i < 100; ++i)
+        target->set_int(0, i, i);
+
+    // Lengths on both sides of the inline capacity of the query value buffers,
+    // so the buffers are grown and then reused for shorter lists.
+    const size_t lengths[] = {0, 20, 3, 50, 1, 9, 8, 0, 100, 2};
+    size_t num_rows = sizeof lengths / sizeof lengths[0];
+    origin->add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        LinkViewRef list = origin->get_linklist(col_list, i);
+        for (size_t j = 0; j < lengths[i]; ++j)
+            list->add(j);
+    }
+
+    for (int64_t value : {0, 5, 19, 60}) {
+        size_t expected = 0;
+        size_t expected_sum = 0;
+        for (size_t length : lengths) {
+            if (int64_t(length) - 1 > value)
+                ++expected;
+            if (int64_t(length * (length - 1) / 2) > value * 10)
+                ++expected_sum;
+        }
+        CHECK_EQUAL(expected, (origin->link(col_list).column<Int>(0) > value).count());
+        CHECK_EQUAL(expected_sum, (origin->column<LinkList>(col_list).column<Int>(0).sum() > value * 10).count());
+    }
+}
+
+
+// Values of other types than in LinkList_QueryVaryingLengths, and the linked
+// rows themselves, from link lists on both sides of the inline capacity
+TEST(LinkList_QueryVaryingLengthsOtherTypes)
+{
+    Group group;
+    TableRef origin = group.add_table("origin");
+    TableRef target = group.add_table("target");
+    target->add_column(type_String, "string");
+    target->add_column(type_Double, "double", true);
+    size_t col_list = origin->add_column_link(type_LinkList, "list", *target);
+    target->add_empty_row(100);
+    for (size_t i = 0; i < 100; ++i) {
+        std::string str = util::to_string(i);
+        target->set_string(0, i, str);
+        if (i % 10 != 9)
+            target->set_double(1, i, double(i) / 2);
+    }
+
+    const size_t lengths[] = {0, 20, 3, 50, 1, 9, 8, 0, 100, 2};
+    size_t num_rows = sizeof lengths / sizeof lengths[0];
+    origin->add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        LinkViewRef list = origin->get_linklist(col_list, i);
+        for (size_t j = 0; j < lengths[i]; ++j)
+            list->add(j);
+    }
+
+    for (size_t value : {0, 5, 9, 19, 60}) {
+        size_t expected = 0;
+        size_t expected_nulls = 0;
+        for (size_t length : lengths) {
+            if (length > value)
+                ++expected;
+            if (length > 9)
+                ++expected_nulls;
+        }
+        std::string str = util::to_string(value);
+        CHECK_EQUAL(expected, (origin->link(col_list).column<String>(0) == StringData(str)).count());
+        size_t expected_doubles = (value % 10 == 9 ? 0 : expected);
+        CHECK_EQUAL(expected_doubles, (origin->link(col_list).column<Double>(1) == double(value) / 2).count());
+        CHECK_EQUAL(expected, (origin->column<Link>(col_list) == target->get(value)).count());
+        CHECK_EQUAL(expected_nulls, (origin->link(col_list).column<Double>(1) == null()).count());
+    }
+}
+
 TEST(LinkList_SortLinkView)
 {
     Group group;
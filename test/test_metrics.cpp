@@ -863,6 +863,134 @@ TEST(Metrics_TransactionVersions)
 }
 
 
+TEST(Metrics_LatencyHistogram)
+{
+    LatencyHistogram histogram;
+    CHECK_EQUAL(histogram.get_count(), 0);
+    CHECK_EQUAL(histogram.get_value_at_percentile(50), 0.0);
+    CHECK_EQUAL(histogram.get_max(), 0.0);
+
+    // 1..1000 microseconds
+    for (int i = 1; i <= 1000; ++i)
+        histogram.record(i * 1e-6);
+    CHECK_EQUAL(histogram.get_count(), 1000);
+    CHECK_APPROXIMATELY_EQUAL(histogram.get_mean(), 500.5e-6, 1e-6);
+    CHECK_APPROXIMATELY_EQUAL(histogram.get_max(), 1000e-6, 1e-6);
+    // Values are rounded up to the resolution of the histogram (1/16)
+    double p50 = histogram.get_value_at_percentile(50);
+    CHECK_GREATER_EQUAL(p50, 500e-6);
+    CHECK_LESS_EQUAL(p50, 500e-6 * (1 + 1.0 / 16));
+    double p99 = histogram.get_value_at_percentile(99);
+    CHECK_GREATER_EQUAL(p99, 990e-6);
+    CHECK_LESS_EQUAL(p99, 1000e-6);
+    CHECK_EQUAL(histogram.get_value_at_percentile(100), histogram.get_max());
+    CHECK_LESS_EQUAL(histogram.get_value_at_percentile(0), 1e-6 * (1 + 1.0 / 16));
+
+    // Out of range values are clamped, not lost
+    histogram.record(-1);
+    histogram.record(1e6);
+    CHECK_EQUAL(histogram.get_count(), 1002);
+    CHECK_GREATER(histogram.get_max(), 1e5);
+
+    histogram.reset();
+    CHECK_EQUAL(histogram.get_count(), 0);
+    CHECK_EQUAL(histogram.get_max(), 0.0);
+}
+
+
+TEST(Metrics_RingBufferDropsWhenFull)
+{
+    RingBuffer<std::string> buffer(3);
+    CHECK(buffer.push("a"));
+    CHECK(buffer.push("b"));
+    CHECK(buffer.push("c"));
+    CHECK(!buffer.push("d"));
+    CHECK_EQUAL(buffer.size(), 3);
+    CHECK_EQUAL(buffer.get_num_dropped(), 1);
+
+    std::vector<std::string> taken;
+    buffer.take_all(taken);
+    CHECK_EQUAL(buffer.size(), 0);
+    CHECK(taken == std::vector<std::string>({"a", "b", "c"}));
+
+    // Wrap around
+    CHECK(buffer.push("e"));
+    CHECK(buffer.push("f"));
+    taken.clear();
+    buffer.take_all(taken);
+    CHECK(taken == std::vector<std::string>({"e", "f"}));
+}
+
+
+TEST(Metrics_BoundedHistoryAndHistograms)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroupOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.metrics_buffer_size = 4;
+    options.metrics_description_threshold = 1000; // seconds, nothing is that slow
+    SharedGroup sg(*hist, options);
+    populate(sg);
+
+    {
+        ReadTransaction rt(sg);
+        ConstTableRef table = rt.get_table("person");
+        Query query = table->where().greater(0, 30);
+        for (int i = 0; i < 5; ++i)
+            CHECK_EQUAL(query.count(), 3);
+        query.find_all();
+    }
+
+    std::shared_ptr<Metrics> metrics = sg.get_metrics();
+    CHECK(metrics);
+    CHECK_EQUAL(metrics->num_query_metrics(), 4);
+    CHECK_EQUAL(metrics->num_dropped_query_metrics(), 2);
+    CHECK_EQUAL(metrics->get_query_latency(QueryInfo::type_Count).get_count(), 5);
+    CHECK_EQUAL(metrics->get_query_latency(QueryInfo::type_FindAll).get_count(), 1);
+    CHECK_EQUAL(metrics->get_query_latency(QueryInfo::type_Sum).get_count(), 0);
+
+    std::unique_ptr<Metrics::QueryInfoList> queries = metrics->take_queries();
+    CHECK_EQUAL(queries->size(), 4);
+    for (auto& info : *queries) {
+        CHECK_EQUAL(info.get_type(), QueryInfo::type_Count);
+        CHECK(info.get_description().empty());
+        CHECK_GREATER(info.get_query_time(), 0);
+    }
+    CHECK_EQUAL(metrics->num_query_metrics(), 0);
+
+    // The populating write and the read transaction
+    CHECK_EQUAL(metrics->get_write_transaction_latency().get_count(), 1);
+    CHECK_EQUAL(metrics->get_write_latency().get_count(), 1);
+    CHECK_EQUAL(metrics->get_fsync_latency().get_count(), 1);
+    CHECK_EQUAL(metrics->get_read_transaction_latency().get_count(), 1);
+    CHECK_GREATER(metrics->get_write_transaction_latency().get_max(), 0);
+    CHECK_EQUAL(metrics->take_transactions()->size(), 2);
+}
+
+
+TEST(Metrics_SlowQueryDescriptions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroupOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.metrics_description_threshold = 1e-9;
+    SharedGroup sg(*hist, options);
+    populate(sg);
+
+    {
+        ReadTransaction rt(sg);
+        ConstTableRef table = rt.get_table("person");
+        Query query = table->where().greater(0, 30);
+        query.count();
+    }
+
+    std::unique_ptr<Metrics::QueryInfoList> queries = sg.get_metrics()->take_queries();
+    CHECK_EQUAL(queries->size(), 1);
+    CHECK_EQUAL(find_count(queries->at(0).get_description(), "age"), 1);
+}
+
 
 #endif // REALM_METRICS
 #endif // TEST_METRICS
@@ -63,6 +63,7 @@
 #include <realm/util/encrypted_file_mapping.hpp>
 #include <realm/util/to_string.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <thread>
@@ -320,22 +321,69 @@ Query verify_query(test_util::unit_test::TestContext& test_context, TableRef t,
     Query q = t->where();
     realm::query_builder::NoArguments args;
 
-    parser::ParserResult res = realm::parser::parse(query_string);
-    realm::query_builder::apply_predicate(q, res.predicate, args);
+    auto res = realm::parser::parse(query_string);
+    realm::query_builder::apply_predicate(q, res->predicate, args);
 
     CHECK_EQUAL(q.count(), num_results);
     std::string description = q.get_description();
     //std::cerr << "original: " << query_string << "\tdescribed: " << description << "\n";
     Query q2 = t->where();
 
-    parser::ParserResult res2 = realm::parser::parse(description);
-    realm::query_builder::apply_predicate(q2, res2.predicate, args);
+    auto res2 = realm::parser::parse(description);
+    realm::query_builder::apply_predicate(q2, res2->predicate, args);
 
     CHECK_EQUAL(q2.count(), num_results);
     return q2;
 }
 
 
+TEST(Parser_ParseCache)
+{
+    Group g;
+    TableRef t = g.add_table("table");
+    t->add_column(type_Int, "age");
+    t->add_column(type_String, "name");
+    t->add_empty_row(3);
+    for (size_t i = 0; i < 3; ++i) {
+        t->set_int(0, i, i + 1);
+        t->set_string(1, i, i == 2 ? "c" : "a");
+    }
+
+    for (size_t capacity : {0, 1, 256}) {
+        parser::set_parse_cache_capacity(capacity);
+        verify_query(test_context, t, "age > 1 && name != 'c'", 1);
+        verify_query(test_context, t, "age > 1 && name != 'c'", 1);
+        verify_query(test_context, t, "age < 3", 2);
+        // Failures are not cached
+        CHECK_THROW_ANY(parser::parse("age >"));
+        CHECK_THROW_ANY(parser::parse("age >"));
+        // Hits share the cached result
+        bool is_shared = parser::parse("age < 3") == parser::parse("age < 3");
+        CHECK_EQUAL(capacity != 0, is_shared);
+    }
+
+    // Entries are evicted all the time with this capacity
+    parser::set_parse_cache_capacity(2);
+    std::atomic<size_t> mismatches(0);
+    const int num_threads = 4;
+    test_util::ThreadWrapper threads[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].start([&mismatches, i] {
+            for (int j = 0; j < 1000; ++j) {
+                std::string value = util::to_string((i + j) % 5);
+                auto res = parser::parse("age == " + value);
+                if (res->predicate.cmpr.expr[1].s != value)
+                    ++mismatches;
+            }
+        });
+    }
+    for (int i = 0; i < num_threads; ++i)
+        CHECK_NOT(threads[i].join());
+    CHECK_EQUAL(mismatches.load(), size_t(0));
+    parser::set_parse_cache_capacity(256);
+}
+
+
 TEST(Parser_empty_input)
 {
     Group g;
@@ -351,7 +399,7 @@ TEST(Parser_empty_input)
     std::string empty_description = q.get_description();
     CHECK(!empty_description.empty());
     CHECK_EQUAL(0, empty_description.compare("TRUEPREDICATE"));
-    realm::parser::Predicate p = realm::parser::parse(empty_description).predicate;
+    realm::parser::Predicate p = realm::parser::parse(empty_description)->predicate;
     query_builder::NoArguments args;
     realm::query_builder::apply_predicate(q, p, args);
     CHECK_EQUAL(q.count(), 5);
@@ -1037,7 +1085,7 @@ void verify_query_sub(test_util::unit_test::TestContext& test_context, TableRef
 
     Query q = t->where();
 
-    realm::parser::Predicate p = realm::parser::parse(query_string).predicate;
+    realm::parser::Predicate p = realm::parser::parse(query_string)->predicate;
     realm::query_builder::apply_predicate(q, p, args);
 
     CHECK_EQUAL(q.count(), num_results);
@@ -1045,7 +1093,7 @@ void verify_query_sub(test_util::unit_test::TestContext& test_context, TableRef
     //std::cerr << "original: " << query_string << "\tdescribed: " << description << "\n";
     Query q2 = t->where();
 
-    realm::parser::Predicate p2 = realm::parser::parse(description).predicate;
+    realm::parser::Predicate p2 = realm::parser::parse(description)->predicate;
     realm::query_builder::apply_predicate(q2, p2, args);
 
     CHECK_EQUAL(q2.count(), num_results);
@@ -1328,12 +1376,12 @@ TEST(Parser_string_binary_encoding)
 
         query_builder::NoArguments args;
         Query qstr2 = t->where();
-        realm::parser::Predicate pstr2 = realm::parser::parse(string_description).predicate;
+        realm::parser::Predicate pstr2 = realm::parser::parse(string_description)->predicate;
         realm::query_builder::apply_predicate(qstr2, pstr2, args);
         CHECK_EQUAL(qstr2.count(), num_results);
 
         Query qbin2 = t->where();
-        realm::parser::Predicate pbin2 = realm::parser::parse(binary_description).predicate;
+        realm::parser::Predicate pbin2 = realm::parser::parse(binary_description)->predicate;
         realm::query_builder::apply_predicate(qbin2, pbin2, args);
         CHECK_EQUAL(qbin2.count(), num_results);
     }
@@ -1529,10 +1577,10 @@ TableView get_sorted_view(TableRef t, std::string query_string)
     Query q = t->where();
     query_builder::NoArguments args;
 
-    parser::ParserResult result = realm::parser::parse(query_string);
-    realm::query_builder::apply_predicate(q, result.predicate, args);
+    auto result = realm::parser::parse(query_string);
+    realm::query_builder::apply_predicate(q, result->predicate, args);
     DescriptorOrdering ordering;
-    realm::query_builder::apply_ordering(ordering, t, result.ordering);
+    realm::query_builder::apply_ordering(ordering, t, result->ordering);
 
     std::string query_description = q.get_description();
     std::string ordering_description = ordering.get_description(t);
@@ -1541,10 +1589,10 @@ TableView get_sorted_view(TableRef t, std::string query_string)
     //std::cerr << "original: " << query_string << "\tdescribed: " << combined << "\n";
     Query q2 = t->where();
 
-    parser::ParserResult result2 = realm::parser::parse(combined);
-    realm::query_builder::apply_predicate(q2, result2.predicate, args);
+    auto result2 = realm::parser::parse(combined);
+    realm::query_builder::apply_predicate(q2, result2->predicate, args);
     DescriptorOrdering ordering2;
-    realm::query_builder::apply_ordering(ordering2, t, result2.ordering);
+    realm::query_builder::apply_ordering(ordering2, t, result2->ordering);
 
     TableView tv = q2.find_all();
     tv.apply_descriptor_ordering(ordering2);
@@ -1763,19 +1811,19 @@ TEST(Parser_Backlinks)
     query_builder::NoArguments args;
 
     q = items->where();
-    realm::parser::Predicate p = realm::parser::parse("purchasers.@count > 2").predicate;
+    realm::parser::Predicate p = realm::parser::parse("purchasers.@count > 2")->predicate;
     realm::query_builder::apply_predicate(q, p, args, mapping);
     CHECK_EQUAL(q.count(), 2);
 
     q = items->where();
-    p = realm::parser::parse("purchasers.@max.money >= 20").predicate;
+    p = realm::parser::parse("purchasers.@max.money >= 20")->predicate;
     realm::query_builder::apply_predicate(q, p, args, mapping);
     CHECK_EQUAL(q.count(), 3);
 
     // disable parsing backlink queries
     mapping.set_allow_backlinks(false);
     q = items->where();
-    p = realm::parser::parse("purchasers.@max.money >= 20").predicate;
+    p = realm::parser::parse("purchasers.@max.money >= 20")->predicate;
     CHECK_THROW_ANY_GET_MESSAGE(realm::query_builder::apply_predicate(q, p, args, mapping), message);
     CHECK_EQUAL(message, "Querying over backlinks is disabled but backlinks were found in the inverse relationship of property 'items' on type 'Person'");
 
@@ -1786,12 +1834,12 @@ TEST(Parser_Backlinks)
     mapping_with_prefix.add_mapping(t, "money", "account_balance");
 
     q = items->where();
-    p = realm::parser::parse("purchasers.@count > 2").predicate;
+    p = realm::parser::parse("purchasers.@count > 2")->predicate;
     realm::query_builder::apply_predicate(q, p, args, mapping_with_prefix);
     CHECK_EQUAL(q.count(), 2);
 
     q = items->where();
-    p = realm::parser::parse("purchasers.@max.money >= 20").predicate;
+    p = realm::parser::parse("purchasers.@max.money >= 20")->predicate;
     realm::query_builder::apply_predicate(q, p, args, mapping_with_prefix);
     CHECK_EQUAL(q.count(), 3);
 }
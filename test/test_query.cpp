@@ -20,6 +20,7 @@
 #ifdef TEST_QUERY
 
 #include <cstdlib> // itoa()
+#include <functional>
 #include <initializer_list>
 #include <limits>
 #include <vector>
@@ -8060,6 +8061,91 @@ TEST(Query_Null_Two_Columns)
     CHECK(equals(tv, {}));
 }
 
+TEST(Query_Expression_NumericColumnsOverLeaves)
+{
+    // Numeric columns without links are compared leaf by leaf. Check that
+    // this agrees with evaluating each row, across leaf boundaries and nulls.
+    Table table;
+    table.add_column(type_Int, "a", true);
+    table.add_column(type_Int, "b", true);
+    table.add_column(type_Int, "c");
+    table.add_column(type_Double, "d", true);
+    table.add_column(type_Float, "f", true);
+    table.add_column(type_Double, "e", true);
+    table.add_column(type_Float, "g");
+    size_t num_rows = 2500;
+    table.add_empty_row(num_rows);
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (random.draw_int_mod(5) != 0)
+            table.set_int(0, i, random.draw_int_mod(10));
+        if (random.draw_int_mod(5) != 0)
+            table.set_int(1, i, random.draw_int_mod(10));
+        table.set_int(2, i, random.draw_int_mod(10));
+        if (random.draw_int_mod(5) != 0)
+            table.set_double(3, i, random.draw_int_mod(10) / 2.0);
+        if (random.draw_int_mod(5) != 0)
+            table.set_float(4, i, random.draw_int_mod(10) / 2.0f);
+        if (random.draw_int_mod(5) != 0)
+            table.set_double(5, i, random.draw_int_mod(10) / 2.0);
+        table.set_float(6, i, random.draw_int_mod(10) / 2.0f);
+    }
+
+    auto count = [&](auto pred) {
+        size_t n = 0;
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (pred(i))
+                ++n;
+        }
+        return n;
+    };
+    auto get = [&](size_t col, size_t i) {
+        return table.is_null(col, i) ? util::Optional<int64_t>() : util::make_optional(table.get_int(col, i));
+    };
+    auto a = [&](size_t i) { return get(0, i); };
+    auto b = [&](size_t i) { return get(1, i); };
+
+    CHECK_EQUAL(count([&](size_t i) { return a(i) && b(i) && *a(i) < *b(i); }),
+                (table.column<Int>(0) < table.column<Int>(1)).count());
+    CHECK_EQUAL(count([&](size_t i) { return a(i) == b(i); }),
+                (table.column<Int>(0) == table.column<Int>(1)).count());
+    CHECK_EQUAL(count([&](size_t i) { return a(i) != b(i); }),
+                (table.column<Int>(0) != table.column<Int>(1)).count());
+    CHECK_EQUAL(count([&](size_t i) { return a(i) && *a(i) >= table.get_int(2, i); }),
+                (table.column<Int>(0) >= table.column<Int>(2)).count());
+    CHECK_EQUAL(count([&](size_t i) { return a(i) && *a(i) > 4; }),
+                (table.column<Int>(0) > Value<Int>(4)).count());
+    CHECK_EQUAL(count([&](size_t i) { return !table.is_null(3, i) && table.get_double(3, i) <= 2.5; }),
+                (table.column<Double>(3) <= Value<Double>(2.5)).count());
+    CHECK_EQUAL(count([&](size_t i) {
+                    return !table.is_null(3, i) && !table.is_null(5, i) &&
+                           table.get_double(3, i) < table.get_double(5, i);
+                }),
+                (table.column<Double>(3) < table.column<Double>(5)).count());
+    CHECK_EQUAL(count([&](size_t i) {
+                    return table.is_null(3, i) == table.is_null(5, i) &&
+                           (table.is_null(3, i) || table.get_double(3, i) == table.get_double(5, i));
+                }),
+                (table.column<Double>(3) == table.column<Double>(5)).count());
+    CHECK_EQUAL(count([&](size_t i) {
+                    return !table.is_null(4, i) && table.get_float(4, i) >= table.get_float(6, i);
+                }),
+                (table.column<Float>(4) >= table.column<Float>(6)).count());
+    CHECK_EQUAL(count([&](size_t i) {
+                    return table.is_null(4, i) || table.get_float(4, i) != table.get_float(6, i);
+                }),
+                (table.column<Float>(4) != table.column<Float>(6)).count());
+
+    // Columns of different types are not compared over leaves, but must
+    // give the same result
+    CHECK_EQUAL(count([&](size_t i) {
+                    return !table.is_null(3, i) && !table.is_null(4, i) &&
+                           table.get_float(4, i) > table.get_double(3, i);
+                }),
+                (table.column<Float>(4) > table.column<Double>(3)).count());
+}
+
+
 // Between, count, min and max
 TEST(Query_Null_BetweenMinMax_Nullable)
 {
@@ -11045,4 +11131,233 @@ TEST(Query_Group_bug)
     CHECK_EQUAL(5, q0.count());
 }
 
+
+// Scans over several leaves issue prefetch hints for the leaf ahead of the
+// one being searched. This must not change the results, with or without an
+// access hint set on the file.
+TEST(Query_ScanWithAccessHint)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 5 + 17;
+    {
+        WriteTransaction wt(sg);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_Int, "nullable_int", true);
+        table->add_empty_row(num_rows);
+        for (size_t i = 0; i < num_rows; ++i) {
+            table->set_int(0, i, i % 100);
+            if (i % 3 != 0)
+                table->set_int(1, i, i % 100);
+        }
+        wt.commit();
+    }
+
+    const File::Advice hints[] = {File::advice_Sequential, File::advice_Random, File::advice_WillNeed,
+                                  File::advice_HugePage, File::advice_Normal};
+    for (File::Advice hint : hints) {
+        ReadTransaction rt(sg);
+        rt.get_group().set_access_hint(hint);
+        ConstTableRef table = rt.get_table("table");
+        CHECK_EQUAL(table->where().equal(0, 99).count(), num_rows / 100);
+        CHECK_EQUAL(table->where().greater(0, 49).find(), 50);
+        size_t begin = num_rows - 100;
+        CHECK_EQUAL(table->where().equal(0, 42).find(begin), begin + (142 - begin % 100) % 100);
+        size_t expected_nonnull = 0;
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (i % 3 != 0 && i % 100 == 7)
+                ++expected_nonnull;
+        }
+        CHECK_EQUAL(table->where().equal(1, 7).count(), expected_nonnull);
+    }
+}
+
+
+TEST(Query_ExplainAndProfile)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_String, "str");
+    table.add_search_index(1);
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 3 + 11;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.set_int(0, i, i % 10);
+        table.set_string(1, i, i % 3 == 0 ? "fizz" : "buzz");
+    }
+
+    Query q = table.where().greater(0, 4).equal(1, "fizz");
+
+    QueryProfile plan = q.explain();
+    CHECK(!plan.executed);
+    CHECK_EQUAL(plan.nodes.size(), 2);
+    CHECK_EQUAL(plan.nodes[0].description, "int > 4");
+    CHECK(!plan.nodes[0].uses_index);
+    CHECK_EQUAL(plan.nodes[1].description, "str == \"fizz\"");
+    CHECK(plan.nodes[1].uses_index);
+    CHECK_EQUAL(plan.node_order.size(), 2);
+    CHECK_LESS_EQUAL(plan.nodes[plan.node_order[0]].cost, plan.nodes[plan.node_order[1]].cost);
+    CHECK_EQUAL(plan.nodes[0].rows_scanned, 0);
+
+    QueryProfile profile = q.profile();
+    CHECK(profile.executed);
+    CHECK_EQUAL(profile.rows, num_rows);
+    CHECK_EQUAL(profile.matches, q.count());
+    CHECK_GREATER_EQUAL(profile.time, 0);
+    CHECK(!profile.node_order.empty());
+
+    // The driving ranges cover every row exactly once, and every match is
+    // found while some node drives
+    size_t rows_scanned = 0;
+    size_t matches = 0;
+    for (auto& node : profile.nodes) {
+        rows_scanned += node.rows_scanned;
+        matches += node.matches;
+    }
+    CHECK_EQUAL(rows_scanned, num_rows);
+    CHECK_EQUAL(matches, profile.matches);
+    if (profile.nodes[0].times_chosen > 0)
+        CHECK_GREATER(profile.nodes[0].leaves_scanned, 0);
+    CHECK_EQUAL(profile.nodes[1].leaves_scanned, 0);
+    CHECK_GREATER(profile.nodes[0].probes + profile.nodes[1].probes, 0);
+
+    // Profiling must not leave anything behind that affects later runs
+    CHECK_EQUAL(q.count(), profile.matches);
+    CHECK_EQUAL(q.profile(0, 100).matches, q.count(0, 100));
+
+    std::string text = profile.to_string();
+    CHECK(text.find("int > 4") != std::string::npos);
+    CHECK(text.find("[index]") != std::string::npos);
+
+    // Queries without conditions are reported without nodes
+    QueryProfile all = table.where().profile();
+    CHECK(all.nodes.empty());
+    CHECK_EQUAL(all.matches, num_rows);
+}
+
+
+TEST(Query_CostFromStatistics)
+{
+    Table table;
+    table.add_column(type_Int, "status");
+    table.add_column(type_Int, "bucket");
+    table.add_column(type_String, "name");
+    table.add_search_index(2);
+    const size_t num_rows = 20000;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.set_int(0, i, i % 50 == 7 ? 1 : 0);
+        table.set_int(1, i, i % 100);
+        table.set_string(2, i, i % 1000 == 342 ? "rare" : "common");
+    }
+
+    auto check_query = [&](Query q, size_t driver, size_t expected_count) {
+        QueryProfile plan = q.explain();
+        CHECK_EQUAL(plan.node_order[0], driver);
+        CHECK_EQUAL(q.count(), expected_count);
+        CHECK_EQUAL(q.find_all().size(), expected_count);
+    };
+
+    // The rare value drives the search, whichever comes first in the query
+    check_query(table.where().equal(0, 0).equal(1, 42), 1, num_rows / 100);
+    check_query(table.where().equal(1, 42).equal(0, 0), 0, num_rows / 100);
+    check_query(table.where().equal(0, 1).greater(1, 10), 0, num_rows / 100);
+
+    // A search index is used when it finds few rows, and otherwise the scan
+    check_query(table.where().equal(1, 42).equal(2, "rare"), 1, num_rows / 1000);
+    check_query(table.where().equal(2, "common").equal(1, 42), 1, num_rows / 100 - num_rows / 1000);
+    check_query(table.where().equal(2, "none").equal(1, 42), 0, 0);
+    CHECK_EQUAL(table.where().equal(1, 42).equal(2, "rare").find(), 342);
+    CHECK_EQUAL(table.where().equal(0, 0).equal(1, 42).find(100), 142);
+
+    // The estimates follow changes to the table
+    Query q = table.where().equal(0, 0).equal(1, 42);
+    for (size_t i = 0; i < num_rows; ++i)
+        table.set_int(1, i, 42);
+    check_query(q, 0, num_rows - num_rows / 50);
+}
+
+
+TEST(Query_OrIndexed)
+{
+    Table table;
+    table.add_column(type_String, "id", true);
+    table.add_column(type_Int, "int");
+    table.add_search_index(0);
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * 5 + 17;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 11 != 0) {
+            std::string id = util::to_string(i % 700);
+            table.set_string(0, i, id);
+        }
+        table.set_int(1, i, i % 3);
+    }
+
+    // An IN list of 500 distinct values, some of which never occur in the
+    // table, followed by repeats of every 50th of them
+    std::vector<std::string> values;
+    for (size_t k = 0; k < 500; ++k)
+        values.push_back(util::to_string(k * 7 % 1000));
+    for (size_t k = 0; k < 500; k += 50)
+        values.push_back(values[k]);
+    auto is_match = [&](size_t i) {
+        if (table.is_null(0, i))
+            return false;
+        std::string id = table.get_string(0, i);
+        return std::find(values.begin(), values.end(), id) != values.end();
+    };
+    auto make_query = [&](bool with_null) {
+        Query q = table.where().group();
+        for (size_t k = 0; k < values.size(); ++k) {
+            if (k != 0)
+                q.Or();
+            q.equal(0, StringData(values[k]));
+        }
+        if (with_null)
+            q.Or().equal(0, StringData());
+        return q.end_group();
+    };
+    auto check_query = [&](Query q, bool uses_index, std::function<bool(size_t)> match) {
+        CHECK_EQUAL(q.explain().nodes[0].uses_index, uses_index);
+        TableView tv = q.find_all();
+        size_t n = 0;
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (match(i)) {
+                if (n < tv.size())
+                    CHECK_EQUAL(tv.get_source_ndx(n), i);
+                ++n;
+            }
+        }
+        CHECK_EQUAL(tv.size(), n);
+        CHECK_EQUAL(q.count(), n);
+        for (size_t start : {size_t(0), size_t(1), num_rows / 3, num_rows - num_rows / 20}) {
+            size_t expected = not_found;
+            for (size_t i = start; i < num_rows && expected == not_found; ++i) {
+                if (match(i))
+                    expected = i;
+            }
+            CHECK_EQUAL(q.find(start), expected);
+        }
+    };
+
+    check_query(make_query(false), true, is_match);
+    check_query(make_query(true), true, [&](size_t i) { return is_match(i) || table.is_null(0, i); });
+    check_query(make_query(false).equal(1, 2), true, [&](size_t i) { return is_match(i) && i % 3 == 2; });
+
+    // A condition that is not looked up in the index makes the OR scan
+    check_query(make_query(false).Or().equal(1, 2), false, [&](size_t i) { return is_match(i) || i % 3 == 2; });
+    Query combined = table.where().group().equal(0, "7").Or().equal(0, "14").equal(1, 0).end_group();
+    check_query(combined, false, [&](size_t i) {
+        return !table.is_null(0, i) && (table.get_string(0, i) == "7" ||
+                                        (table.get_string(0, i) == "14" && i % 3 == 0));
+    });
+
+    // Enumerated strings
+    table.optimize();
+    check_query(make_query(false), true, is_match);
+}
+
 #endif // TEST_QUERY
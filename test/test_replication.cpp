@@ -23,6 +23,7 @@
 #include <memory>
 
 #include <realm.hpp>
+#include <realm/binary_stream.hpp>
 #include <realm/util/features.h>
 #include <realm/util/file.hpp>
 #include <realm/replication.hpp>
@@ -3610,6 +3611,74 @@ TEST(Replication_AddRowWithKey)
 }
 
 
+TEST(Replication_AddRowsBulk)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    util::Logger& replay_logger = test_context.logger;
+
+    MyTrivialReplication repl(path_1);
+    SharedGroup sg_1(repl);
+    SharedGroup sg_2(path_2);
+
+    int64_t ints[] = {1, 2, 3};
+    bool nulls[] = {false, true, false};
+    bool bools[] = {true, false, true};
+    StringData strings[] = {"foo", StringData(), "bar"};
+    Timestamp timestamps[] = {Timestamp(1, 2), Timestamp(), Timestamp(3, 4)};
+    double doubles[] = {0.5, -1.25, 1e100};
+    float floats[] = {1.5f, 0.0f, -2.5f};
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table1 = wt.add_table("table");
+        table1->add_column(type_Int, "int");
+        table1->add_column(type_Int, "int_null", true);
+        table1->add_column(type_Bool, "bool");
+        table1->add_column(type_String, "str", true);
+        table1->add_column(type_Timestamp, "ts", true);
+        table1->add_column(type_Double, "double");
+        table1->add_column(type_Float, "float_null", true);
+        table1->add_column(type_Float, "float");
+        table1->add_search_index(3);
+        table1->add_empty_row();
+        std::vector<BulkColumn> columns;
+        columns.emplace_back(0, ints);
+        columns.emplace_back(1, ints, nulls);
+        columns.emplace_back(2, bools);
+        columns.emplace_back(3, strings);
+        columns.emplace_back(4, timestamps);
+        columns.emplace_back(5, doubles);
+        columns.emplace_back(6, floats, nulls);
+        table1->add_rows_bulk(3, columns);
+        wt.commit();
+    }
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt(sg_1);
+        ReadTransaction rt_2(sg_2);
+        ConstTableRef table1 = rt.get_table("table");
+        ConstTableRef table2 = rt_2.get_table("table");
+        CHECK(*table1 == *table2);
+
+        CHECK_EQUAL(4, table2->size());
+        for (size_t i = 0; i < 3; ++i) {
+            CHECK_EQUAL(ints[i], table2->get_int(0, i + 1));
+            CHECK_EQUAL(nulls[i], table2->is_null(1, i + 1));
+            CHECK_EQUAL(bools[i], table2->get_bool(2, i + 1));
+            CHECK_EQUAL(strings[i], table2->get_string(3, i + 1));
+            CHECK_EQUAL(timestamps[i], table2->get_timestamp(4, i + 1));
+            CHECK_EQUAL(doubles[i], table2->get_double(5, i + 1));
+            CHECK_EQUAL(nulls[i], table2->is_null(6, i + 1));
+            if (!nulls[i])
+                CHECK_EQUAL(floats[i], table2->get_float(6, i + 1));
+            CHECK_EQUAL(0.0f, table2->get_float(7, i + 1));
+        }
+        CHECK_EQUAL(3, table2->find_first_string(3, "bar"));
+    }
+}
+
+
 TEST(Replication_RenameGroupLevelTable_RenameColumn)
 {
     SHARED_GROUP_TEST_PATH(path_1);
@@ -3766,6 +3835,99 @@ TEST(Replication_Substrings)
 }
 
 
+TEST(Replication_BinaryRanges)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    util::Logger& replay_logger = test_context.logger;
+
+    MyTrivialReplication repl(path_1);
+    SharedGroup sg_1(repl);
+    SharedGroup sg_2(path_2);
+
+    std::string big(ArrayBlob::max_binary_size + 1000, 'x');
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Binary, "binary", true);
+        table->add_empty_row(2);
+        table->write_binary(0, 0, 0, BinaryData("Hello, World!", 13));
+        BinaryStream stream(table->get(1), 0);
+        stream.append(BinaryData(big.data(), big.size() / 2));
+        stream.append(BinaryData(big.data(), big.size() - big.size() / 2));
+        wt.commit();
+    }
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.get_table("table");
+        table->write_binary(0, 0, 7, BinaryData("Realm!", 6));
+        table->write_binary(0, 1, big.size() - 10, BinaryData("0123456789abcdef", 16));
+        wt.commit();
+    }
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt(sg_2);
+        auto table = rt.get_table("table");
+        CHECK_EQUAL(BinaryData("Hello, Realm!", 13), table->get_binary(0, 0));
+        big.replace(big.size() - 10, 10, "0123456789abcdef");
+        ConstBinaryStream stream(table->get(1), 0);
+        CHECK_EQUAL(big.size(), stream.size());
+        std::string read_back(big.size(), 0);
+        CHECK_EQUAL(big.size(), stream.read(&read_back[0], read_back.size()));
+        CHECK(read_back == big);
+    }
+}
+
+
+TEST(Replication_Deduplicated)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    util::Logger& replay_logger = test_context.logger;
+
+    MyTrivialReplication repl(path_1);
+    SharedGroup sg_1(repl);
+    SharedGroup sg_2(path_2);
+
+    std::string value(200, 'x');
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_String, "string");
+        table->get_descriptor()->set_deduplicated(0);
+        table->add_empty_row(3);
+        for (size_t i = 0; i < 3; ++i)
+            table->set_string(0, i, value);
+        wt.commit();
+    }
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt(sg_2);
+        ConstTableRef table = rt.get_table("table");
+        CHECK(table->is_deduplicated(0));
+        CHECK_EQUAL(3, table->count_string(0, value));
+    }
+
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.get_table("table");
+        table->get_descriptor()->set_deduplicated(0, false);
+        table->set_string(0, 1, "small");
+        wt.commit();
+    }
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt(sg_2);
+        ConstTableRef table = rt.get_table("table");
+        CHECK(!table->is_deduplicated(0));
+        CHECK_EQUAL(2, table->count_string(0, value));
+        CHECK_EQUAL("small", table->get_string(0, 1));
+    }
+}
+
+
 TEST(Replication_MoveSelectedLinkView)
 {
     // 1st: Create table with two rows
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <tuple>
 #include <iostream>
+#include <sstream>
 #include <fstream>
 #include <thread>
 
@@ -2718,6 +2719,49 @@ TEST(Shared_VersionCount)
     CHECK_EQUAL(2, sg_r.get_number_of_versions());
 }
 
+// Read locks are counted in per-CPU stripes, so a version that is pinned on
+// one thread and unpinned on another must still be reclaimed.
+TEST(Shared_VersionCountWithReadersOnManyThreads)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroup sg_w(path);
+    const int num_threads = 8;
+    SharedGroup::VersionID versions[num_threads];
+    {
+        Thread threads[num_threads];
+        for (int i = 0; i < num_threads; ++i) {
+            threads[i].start([&, i] {
+                SharedGroup sg(path);
+                sg.begin_read();
+                versions[i] = sg.pin_version();
+                sg.end_read();
+            });
+        }
+        for (int i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+    sg_w.begin_write();
+    sg_w.commit();
+    sg_w.begin_write();
+    sg_w.commit();
+    CHECK_EQUAL(3, sg_w.get_number_of_versions());
+    {
+        // Unpin in reverse order on other threads
+        Thread threads[num_threads];
+        for (int i = 0; i < num_threads; ++i) {
+            threads[i].start([&, i] {
+                SharedGroup sg(path);
+                sg.unpin_version(versions[num_threads - 1 - i]);
+            });
+        }
+        for (int i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+    sg_w.begin_write();
+    sg_w.commit();
+    CHECK_EQUAL(2, sg_w.get_number_of_versions());
+}
+
 TEST(Shared_MultipleRollbacks)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -3183,6 +3227,259 @@ TEST(Shared_CompactEmpty)
 }
 
 
+TEST(Shared_VectoredWrites)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroupOptions options;
+    options.vectored_writes = true;
+    std::string blob(0x100000, 'x');
+    {
+        SharedGroup sg(path, false, options);
+        {
+            // A reader using the default write path, to see the changes
+            // through its memory mappings
+            SharedGroup sg_2(path);
+            for (int i = 0; i < 20; ++i) {
+                WriteTransaction wt(sg);
+                TableRef t = wt.get_or_add_table("table");
+                if (t->get_column_count() == 0) {
+                    t->add_column(type_Int, "int");
+                    t->add_column(type_Binary, "bin");
+                }
+                // The last commit stages more than 16MB, forcing intermediate
+                // flushes
+                size_t n = i == 19 ? 20 : 1;
+                for (size_t j = 0; j < n; ++j) {
+                    size_t row = t->add_empty_row();
+                    t->set_int(0, row, i);
+                    blob[0] = char('a' + i);
+                    t->set_binary(1, row, BinaryData(blob));
+                }
+                wt.commit();
+
+                ReadTransaction rt(sg_2);
+                ConstTableRef t_2 = rt.get_table("table");
+                CHECK_EQUAL(t_2->size(), size_t(i + n));
+                CHECK_EQUAL(t_2->get_int(0, i), i);
+                CHECK_EQUAL(t_2->get_binary(1, i).data()[0], char('a' + i));
+            }
+        }
+        CHECK(sg.compact());
+    }
+    {
+        SharedGroup sg(path);
+        ReadTransaction rt(sg);
+        ConstTableRef t = rt.get_table("table");
+        CHECK_EQUAL(t->size(), 39);
+        for (size_t i = 0; i < 39; ++i) {
+            BinaryData bin = t->get_binary(1, i);
+            CHECK_EQUAL(bin.size(), blob.size());
+            CHECK_EQUAL(bin.data()[0], char('a' + std::min(i, size_t(19))));
+        }
+        rt.get_group().verify();
+    }
+}
+
+
+TEST(Shared_CommitPacksArraysContiguously)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroup sg(path);
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    {
+        WriteTransaction wt(sg);
+        // Make the file large enough for its sections to hold the leaves of
+        // "table" in one extent
+        TableRef filler = wt.add_table("filler");
+        filler->add_column(type_Int, "int");
+        filler->add_empty_row(200000);
+        for (size_t i = 0; i < 200000; ++i)
+            filler->set_int(0, i, int64_t(i) << 32);
+        TableRef t = wt.add_table("table");
+        t->add_column(type_Int, "int");
+        t->add_empty_row(5 * REALM_MAX_BPNODE_SIZE);
+        wt.commit();
+    }
+    // Leave a free chunk that can hold them, as an extent is never placed
+    // across smaller chunks
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("filler")->clear();
+        wt.commit();
+    }
+    // Fragment the free space by rewriting one leaf at a time
+    for (int i = 0; i < 50; ++i) {
+        WriteTransaction wt(sg);
+        TableRef t = wt.get_table("table");
+        t->set_int(0, random.draw_int_mod(t->size()), i % 100);
+        wt.commit();
+    }
+    {
+        WriteTransaction wt(sg);
+        TableRef t = wt.get_table("table");
+        for (size_t i = 0; i < t->size(); ++i)
+            t->set_int(0, i, int64_t(i % 100));
+        wt.commit();
+    }
+
+    // The leaves are written in order, back to back, followed by their parent
+    ReadTransaction rt(sg);
+    ConstTableRef t = rt.get_table("table");
+    const IntegerColumn& col = static_cast<const IntegerColumn&>(_impl::TableFriend::get_column(*t, 0));
+    const Array& root = *col.get_root_array();
+    CHECK(root.is_inner_bptree_node());
+    ref_type expected_ref = root.get_as_ref(1);
+    for (size_t i = 1; i < root.size() - 1; ++i) {
+        ref_type ref = root.get_as_ref(i);
+        CHECK_EQUAL(ref, expected_ref);
+        Array leaf(root.get_alloc());
+        leaf.init_from_ref(ref);
+        expected_ref = ref + leaf.get_byte_size();
+    }
+    CHECK_EQUAL(root.get_ref(), expected_ref);
+}
+
+
+TEST(Shared_Backup)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(backup_path);
+    SharedGroup sg(path);
+    {
+        WriteTransaction wt(sg);
+        TableRef t = wt.add_table("table");
+        t->add_column(type_Int, "int");
+        t->add_column(type_String, "str");
+        t->add_empty_row(10000);
+        for (size_t i = 0; i < 10000; ++i) {
+            std::string str = util::to_string(i);
+            t->set_int(0, i, i);
+            t->set_string(1, i, str);
+        }
+        wt.commit();
+    }
+    auto check_backup = [&](size_t num_rows, int64_t first) {
+        SharedGroup sg_2(backup_path);
+        ReadTransaction rt(sg_2);
+        rt.get_group().verify();
+        ConstTableRef t = rt.get_table("table");
+        CHECK_EQUAL(t->size(), num_rows);
+        CHECK_EQUAL(t->get_int(0, 0), first);
+        CHECK_EQUAL(t->get_int(0, num_rows - 1), int64_t(num_rows - 1));
+        CHECK_EQUAL(t->get_string(1, num_rows - 1), util::to_string(num_rows - 1));
+    };
+
+    // Full backup
+    sg.begin_read();
+    SharedGroup::VersionID v_1 = sg.pin_version();
+    sg.end_read();
+    std::ostringstream full;
+    sg.write_backup(full, v_1);
+    {
+        std::istringstream in(full.str());
+        SharedGroup::restore_backup(backup_path, in);
+    }
+    check_backup(10000, 0);
+
+    // Incremental backups only carry what changed
+    {
+        WriteTransaction wt(sg);
+        TableRef t = wt.get_table("table");
+        t->set_int(0, 0, 100);
+        t->add_empty_row();
+        t->set_int(0, 10000, 10000);
+        t->set_string(1, 10000, "10000");
+        wt.commit();
+    }
+    sg.begin_read();
+    SharedGroup::VersionID v_2 = sg.pin_version();
+    sg.end_read();
+    std::ostringstream delta_1;
+    sg.write_backup(delta_1, v_1, v_2);
+    CHECK_LESS(delta_1.str().size() * 10, full.str().size());
+    CHECK_THROW(sg.write_backup(delta_1, v_2, v_1), LogicError);
+    sg.unpin_version(v_1);
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("table")->set_int(0, 0, 200);
+        wt.commit();
+    }
+    sg.begin_read();
+    SharedGroup::VersionID v_3 = sg.pin_version();
+    sg.end_read();
+    std::ostringstream delta_2;
+    sg.write_backup(delta_2, v_2, v_3);
+    sg.unpin_version(v_2);
+    sg.unpin_version(v_3);
+
+    // Deltas must be applied in order
+    {
+        std::istringstream in(delta_2.str());
+        CHECK_THROW(SharedGroup::restore_backup(backup_path, in), InvalidDatabase);
+    }
+    {
+        std::istringstream in(delta_1.str());
+        SharedGroup::restore_backup(backup_path, in);
+    }
+    check_backup(10001, 100);
+    {
+        std::istringstream in(delta_2.str());
+        SharedGroup::restore_backup(backup_path, in);
+    }
+    check_backup(10001, 200);
+    {
+        std::istringstream in("garbage");
+        CHECK_THROW(SharedGroup::restore_backup(backup_path, in), InvalidDatabase);
+    }
+}
+
+
+TEST(Shared_CommitReusesFragmentedFreeSpace)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroup sg(path);
+    const size_t num_tables = 200;
+    {
+        WriteTransaction wt(sg);
+        for (size_t i = 0; i < num_tables; ++i) {
+            std::string name = "t" + util::to_string(i);
+            TableRef t = wt.add_table(name);
+            t->add_column(type_Int, "int");
+            t->add_empty_row(REALM_MAX_BPNODE_SIZE);
+            t->set_int(0, 0, int64_t(1) << 40);
+        }
+        wt.commit();
+    }
+    // Free the leaves of every other table, such that the free space is
+    // scattered in chunks of the size of one leaf
+    {
+        WriteTransaction wt(sg);
+        for (size_t i = 1; i < num_tables; i += 2) {
+            std::string name = "t" + util::to_string(i);
+            wt.get_table(name)->clear();
+        }
+        wt.commit();
+    }
+    for (int i = 0; i < 2; ++i) {
+        WriteTransaction wt(sg);
+        wt.commit();
+    }
+    size_t file_size = size_t(File(path).get_size());
+
+    // No free chunk can hold all the leaves rewritten by this commit, but
+    // together they can
+    {
+        WriteTransaction wt(sg);
+        for (size_t i = 0; i < num_tables / 2; i += 2) {
+            std::string name = "t" + util::to_string(i);
+            wt.get_table(name)->set_int(0, 1, 1);
+        }
+        wt.commit();
+    }
+    CHECK_EQUAL(file_size, size_t(File(path).get_size()));
+}
+
+
 TEST(Shared_VersionOfBoundSnapshot)
 {
     SHARED_GROUP_TEST_PATH(path);
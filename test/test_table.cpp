@@ -26,6 +26,7 @@
 #include <ostream>
 
 #include <realm.hpp>
+#include <realm/binary_stream.hpp>
 #include <realm/history.hpp>
 #include <realm/lang_bind_helper.hpp>
 #include <realm/util/buffer.hpp>
@@ -844,6 +845,90 @@ TEST(Table_StringOrBinaryTooBig)
 }
 
 
+TEST(Table_BinaryStream)
+{
+    Table table;
+    table.add_column(type_Binary, "b", true);
+    table.add_empty_row(3);
+
+    // Small values, which are rewritten in full
+    BinaryStream stream(table[1], 0);
+    CHECK_EQUAL(0, stream.size());
+    stream.write(BinaryData("abc", 3));
+    stream.seek(1);
+    stream.write(BinaryData("XY", 2));
+    stream.append(BinaryData("de", 2));
+    CHECK_EQUAL(BinaryData("aXYde", 5), table.get_binary(0, 1));
+    CHECK(table.is_null(0, 0));
+    CHECK(table.is_null(0, 2));
+    CHECK_LOGIC_ERROR(table.write_binary(0, 1, 6, BinaryData("x", 1)), LogicError::binary_position_out_of_range);
+    CHECK_LOGIC_ERROR(table.write_binary(0, 3, 0, BinaryData("x", 1)), LogicError::row_index_out_of_range);
+
+    // Growing beyond the limit of small blobs upgrades the leaf
+    std::string expected = "aXYde";
+    for (int i = 0; i < 10; ++i) {
+        std::string data(20, char('0' + i));
+        stream.append(BinaryData(data.data(), data.size()));
+        expected += data;
+    }
+    stream.seek(3);
+    stream.write(BinaryData("ZZ", 2));
+    expected.replace(3, 2, "ZZ");
+    CHECK_EQUAL(BinaryData(expected.data(), expected.size()), table.get_binary(0, 1));
+    CHECK(table.is_null(0, 0));
+
+    // Range reads
+    char buffer[16];
+    stream.seek(2);
+    CHECK_EQUAL(16, stream.read(buffer, sizeof buffer));
+    CHECK_EQUAL(expected.substr(2, 16), std::string(buffer, 16));
+    stream.seek(expected.size() - 4);
+    CHECK_EQUAL(4, stream.read(buffer, sizeof buffer));
+    CHECK_EQUAL(expected.substr(expected.size() - 4), std::string(buffer, 4));
+    CHECK_EQUAL(0, stream.read(buffer, sizeof buffer));
+
+    // Values bigger than 16 MB are distributed across multiple arrays, and
+    // writes may span their boundaries
+    size_t chunk_size = 0xA00000;
+    std::string big(3 * chunk_size, 0);
+    for (size_t i = 0; i < big.size(); ++i)
+        big[i] = char(i % 251);
+    BinaryStream big_stream(table[2], 0);
+    for (size_t i = 0; i < 3; ++i)
+        big_stream.append(BinaryData(big.data() + i * chunk_size, chunk_size));
+    CHECK_EQUAL(big.size(), big_stream.size());
+    CHECK(table.get_binary(0, 2).is_null());
+    std::string patch(1000, 'p');
+    size_t patch_pos = ArrayBlob::max_binary_size - 500;
+    big_stream.seek(patch_pos);
+    big_stream.write(BinaryData(patch.data(), patch.size()));
+    big.replace(patch_pos, patch.size(), patch);
+    std::string trailer(100, 't');
+    big_stream.seek(big.size() - 50);
+    big_stream.write(BinaryData(trailer.data(), trailer.size()));
+    big.replace(big.size() - 50, 50, trailer);
+    CHECK_EQUAL(big.size(), big_stream.size());
+
+    std::unique_ptr<char[]> read_buffer(new char[0x100000]);
+    std::string read_back;
+    big_stream.seek(0);
+    while (size_t n = big_stream.read(read_buffer.get(), 0x100000))
+        read_back.append(read_buffer.get(), n);
+    CHECK(read_back == big);
+    CHECK_EQUAL(BinaryData(expected.data(), expected.size()), table.get_binary(0, 1));
+#ifdef REALM_DEBUG
+    table.verify();
+#endif
+
+    // The stream follows its row, and is detached with it
+    table.remove(0);
+    CHECK_EQUAL(big.size(), big_stream.size());
+    table.remove(1);
+    CHECK(!big_stream.is_attached());
+    CHECK_LOGIC_ERROR(big_stream.append(BinaryData("x", 1)), LogicError::detached_accessor);
+}
+
+
 TEST(Table_SetBinaryLogicErrors)
 {
     Group group;
@@ -2099,6 +2184,55 @@ TEST_TYPES(Table_SetStringUnique, std::true_type, std::false_type)
 }
 
 
+TEST(Table_SetUniqueWithSearchIndex)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    table->add_column(type_Int, "int_key");
+    table->add_column(type_String, "string_key", true);
+    table->add_column(type_Int, "value");
+    table->add_search_index(0);
+    table->add_search_index(1);
+
+    // Upsert by key
+    const size_t num_rows = 2 * REALM_MAX_BPNODE_SIZE;
+    for (size_t i = 0; i < 2 * num_rows; ++i) {
+        int64_t key = int64_t(i % num_rows) * 3;
+        size_t row_ndx = table->find_first_int(0, key);
+        if (row_ndx == not_found) {
+            row_ndx = table->add_row_with_key(0, key);
+            std::string string_key = util::to_string(key);
+            table->set_string_unique(1, row_ndx, string_key);
+        }
+        table->set_int(2, row_ndx, int64_t(i));
+    }
+    CHECK_EQUAL(num_rows, table->size());
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t row_ndx = table->find_first_int(0, int64_t(i) * 3);
+        CHECK_EQUAL(i, row_ndx);
+        CHECK_EQUAL(int64_t(num_rows + i), table->get_int(2, row_ndx));
+        std::string string_key = util::to_string(i * 3);
+        CHECK_EQUAL(row_ndx, table->find_first_string(1, string_key));
+    }
+
+    // A conflicting set_unique() removes the new row
+    size_t row_ndx = table->add_empty_row();
+    table->set_int_unique(0, row_ndx, 30);
+    CHECK_EQUAL(num_rows, table->size());
+    CHECK_EQUAL(10, table->find_first_int(0, 30));
+    CHECK_EQUAL(10, table->find_first_string(1, "30"));
+    CHECK_EQUAL(int64_t(num_rows + 10), table->get_int(2, 10));
+
+    // Additional duplicates are merged into the winner as well
+    table->set_int(0, 11, 30);
+    table->set_int(0, 12, 30);
+    row_ndx = table->add_empty_row();
+    table->set_int_unique(0, row_ndx, 30);
+    CHECK_EQUAL(num_rows - 2, table->size());
+    CHECK_EQUAL(1, table->count_int(0, 30));
+}
+
+
 TEST(Table_AddInt)
 {
     Table t;
@@ -6968,6 +7102,137 @@ TEST(Table_AddColumnWithThreeLevelBptree)
 }
 
 
+TEST(Table_AddRowsBulk)
+{
+    Table table;
+    constexpr bool nullable = true;
+    size_t int_col = table.add_column(type_Int, "int");
+    size_t int_null_col = table.add_column(type_Int, "int_null", nullable);
+    size_t bool_col = table.add_column(type_Bool, "bool");
+    size_t str_col = table.add_column(type_String, "str", nullable);
+    size_t ts_col = table.add_column(type_Timestamp, "ts", nullable);
+    size_t double_col = table.add_column(type_Double, "double");
+    table.add_search_index(int_col);
+    table.add_search_index(str_col);
+
+    // Start out with a partially filled leaf
+    table.add_empty_row(3);
+
+    const size_t num_rows = 3 * REALM_MAX_BPNODE_SIZE + 7;
+    std::vector<int64_t> ints(num_rows);
+    std::unique_ptr<bool[]> nulls(new bool[num_rows]);
+    std::unique_ptr<bool[]> bools(new bool[num_rows]);
+    std::vector<std::string> strings(num_rows);
+    std::vector<StringData> string_values(num_rows);
+    std::vector<Timestamp> timestamps(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        ints[i] = int64_t(i) * 1000 - 77;
+        nulls[i] = i % 5 == 0;
+        bools[i] = i % 3 == 0;
+        strings[i] = "s" + util::to_string(i);
+        string_values[i] = i % 7 == 0 ? StringData() : StringData(strings[i]);
+        timestamps[i] = i % 11 == 0 ? Timestamp() : Timestamp(int64_t(i), int32_t(i % 1000));
+    }
+
+    std::vector<BulkColumn> columns;
+    columns.emplace_back(int_col, ints.data());
+    columns.emplace_back(int_null_col, ints.data(), nulls.get());
+    columns.emplace_back(bool_col, bools.get());
+    columns.emplace_back(str_col, string_values.data());
+    columns.emplace_back(ts_col, timestamps.data());
+
+    for (size_t batch = 0; batch < 2; ++batch) {
+        size_t first_row = table.add_rows_bulk(num_rows, columns);
+        CHECK_EQUAL(3 + batch * num_rows, first_row);
+        CHECK_EQUAL(3 + (batch + 1) * num_rows, table.size());
+        for (size_t i = 0; i < num_rows; ++i) {
+            size_t row_ndx = first_row + i;
+            CHECK_EQUAL(ints[i], table.get_int(int_col, row_ndx));
+            CHECK_EQUAL(nulls[i], table.is_null(int_null_col, row_ndx));
+            if (!nulls[i])
+                CHECK_EQUAL(ints[i], table.get_int(int_null_col, row_ndx));
+            CHECK_EQUAL(bools[i], table.get_bool(bool_col, row_ndx));
+            CHECK_EQUAL(string_values[i], table.get_string(str_col, row_ndx));
+            CHECK_EQUAL(timestamps[i], table.get_timestamp(ts_col, row_ndx));
+            CHECK_EQUAL(0.0, table.get_double(double_col, row_ndx));
+        }
+    }
+    table.verify();
+
+    // The search indexes must have been kept up to date
+    CHECK_EQUAL(3 + 42, table.find_first_int(int_col, ints[42]));
+    CHECK_EQUAL(3 + 43, table.find_first_string(str_col, strings[43]));
+    CHECK_EQUAL(3 + 2 * (num_rows / 7 + 1), table.where().equal(str_col, StringData()).count());
+
+    // Regular appends must work on the resulting trees
+    size_t row_ndx = table.add_empty_row();
+    table.set_int(int_col, row_ndx, 5);
+    table.set_timestamp(ts_col, row_ndx, Timestamp(5, 5));
+    CHECK_EQUAL(5, table.get_int(int_col, row_ndx));
+    CHECK_EQUAL(Timestamp(5, 5), table.get_timestamp(ts_col, row_ndx));
+    CHECK(table.is_null(ts_col, row_ndx - 1) == timestamps[num_rows - 1].is_null());
+    table.verify();
+}
+
+
+TEST(Table_AddRowsBulkThreeLevelBptree)
+{
+    Table table;
+    table.add_column(type_Int, "");
+
+    const size_t num_rows = REALM_MAX_BPNODE_SIZE * REALM_MAX_BPNODE_SIZE / 2 + 13;
+    std::vector<int64_t> values(num_rows);
+    for (size_t i = 0; i < num_rows; ++i)
+        values[i] = int64_t(i);
+    std::vector<BulkColumn> columns;
+    columns.emplace_back(0, values.data());
+    table.add_rows_bulk(num_rows, columns);
+    table.add_rows_bulk(num_rows, columns);
+    table.add_rows_bulk(num_rows, columns);
+
+    CHECK_EQUAL(3 * num_rows, table.size());
+    for (size_t i = 0; i < table.size(); i += 997)
+        CHECK_EQUAL(int64_t(i % num_rows), table.get_int(0, i));
+    CHECK_EQUAL(int64_t(num_rows - 1), table.get_int(0, table.size() - 1));
+    table.verify();
+
+    table.add_empty_row();
+    CHECK_EQUAL(0, table.get_int(0, 3 * num_rows));
+    table.remove_last();
+    table.remove_last();
+    CHECK_EQUAL(int64_t(num_rows - 2), table.get_int(0, table.size() - 1));
+    table.verify();
+}
+
+
+TEST(Table_AddRowsBulkChecks)
+{
+    Table table;
+    size_t int_col = table.add_column(type_Int, "int");
+    size_t str_col = table.add_column(type_String, "str");
+    table.add_empty_row();
+
+    int64_t ints[] = {1, 2};
+    bool nulls[] = {false, true};
+    StringData strings[] = {"a", StringData()};
+
+    auto add = [&](std::vector<BulkColumn> columns) { table.add_rows_bulk(2, columns); };
+    CHECK_LOGIC_ERROR(add({BulkColumn(2, ints)}), LogicError::column_index_out_of_range);
+    CHECK_LOGIC_ERROR(add({BulkColumn(str_col, ints)}), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(add({BulkColumn(int_col, ints), BulkColumn(int_col, ints)}), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(add({BulkColumn(int_col, ints, nulls)}), LogicError::column_not_nullable);
+    CHECK_LOGIC_ERROR(add({BulkColumn(int_col, ints), BulkColumn(str_col, strings)}),
+                      LogicError::column_not_nullable);
+    CHECK_EQUAL(1, table.size());
+
+    StringData non_null_strings[] = {"a", "b"};
+    add({BulkColumn(str_col, non_null_strings)});
+    CHECK_EQUAL(3, table.size());
+    CHECK_EQUAL(0, table.get_int(int_col, 2));
+    CHECK_EQUAL("b", table.get_string(str_col, 2));
+}
+
+
 TEST(Table_ClearWithTwoLevelBptree)
 {
     Table table;
@@ -8385,4 +8650,110 @@ TEST(Table_getLinkType)
     CHECK_THROW(table->get_link_type(1), LogicError);
 }
 
+TEST(Table_Deduplicated)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    table->add_column(type_Binary, "bin", true);
+    table->add_column(type_String, "str", true);
+    table->add_column(type_Int, "int");
+
+    DescriptorRef desc = table->get_descriptor();
+    CHECK_THROW(desc->set_deduplicated(2), LogicError);
+    CHECK_THROW(desc->set_deduplicated(3), LogicError);
+    CHECK(!table->is_deduplicated(0));
+    desc->set_deduplicated(0);
+    desc->set_deduplicated(1);
+    CHECK(table->is_deduplicated(0));
+    CHECK(table->is_deduplicated(1));
+    CHECK(!table->is_deduplicated(2));
+
+    // Groups using an older file format cannot get deduplicated columns
+    {
+        Group g_2;
+        _impl::GroupFriend::set_file_format_version(g_2, 8);
+        TableRef table_2 = g_2.add_table("table");
+        table_2->add_column(type_String, "str", true);
+        CHECK_LOGIC_ERROR(table_2->get_descriptor()->set_deduplicated(0), LogicError::old_file_format);
+        CHECK(!table_2->is_deduplicated(0));
+        table_2->get_descriptor()->set_deduplicated(0, false);
+    }
+
+    // Long enough to be stored as big blobs
+    std::string values[3];
+    for (int i = 0; i < 3; ++i)
+        values[i] = std::string(100, char('a' + i));
+
+    // Enough rows to split the leaves
+    const size_t num_rows = 2500;
+    table->add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        const std::string& value = values[i % 3];
+        table->set_binary(0, i, BinaryData(value.data(), value.size()));
+        table->set_string(1, i, StringData(value.data(), value.size()));
+        table->set_int(2, i, i % 3);
+    }
+    table->insert_empty_row(500, 10);
+    for (size_t i = 500; i < 510; ++i) {
+        table->set_binary(0, i, BinaryData(values[0].data(), values[0].size()));
+        table->set_string(1, i, StringData(values[0].data(), values[0].size()));
+        table->set_int(2, i, 0);
+    }
+    table->remove(0);
+    table->move_last_over(7);
+    table->swap_rows(3, 1700);
+    table->set_string(1, 4, StringData(values[2].data(), values[2].size()));
+    table->set_int(2, 4, 2);
+    table->set_binary(0, 4, BinaryData(values[2].data(), values[2].size()));
+
+    auto check_values = [&](const Table& t) {
+        size_t counts[3] = {0, 0, 0};
+        for (size_t i = 0; i < t.size(); ++i) {
+            const std::string& value = values[t.get_int(2, i)];
+            CHECK(t.get_binary(0, i) == BinaryData(value.data(), value.size()));
+            CHECK_EQUAL(t.get_string(1, i), StringData(value.data(), value.size()));
+            ++counts[t.get_int(2, i)];
+        }
+        for (size_t j = 0; j < 3; ++j) {
+            StringData value(values[j].data(), values[j].size());
+            CHECK_EQUAL(counts[j], t.count_string(1, value));
+            CHECK_EQUAL(t.find_first_int(2, j), t.find_first_string(1, value));
+            CHECK_EQUAL(t.find_first_int(2, j), t.find_first_binary(0, BinaryData(value.data(), value.size())));
+        }
+    };
+    check_values(*table);
+#ifdef REALM_DEBUG
+    table->verify();
+#endif
+
+    BinaryData buffer = g.write_to_mem();
+    Group from_mem(buffer);
+    CHECK_EQUAL(10, _impl::GroupFriend::get_file_format_version(from_mem));
+    ConstTableRef table_2 = from_mem.get_table("table");
+    CHECK(table_2->is_deduplicated(0));
+    CHECK(table_2->is_deduplicated(1));
+    check_values(*table_2);
+
+    // Turning deduplication off gives the values copies of their own
+    desc->set_deduplicated(0, false);
+    desc->set_deduplicated(1, false);
+    check_values(*table);
+    table->remove(10);
+    table->move_last_over(20);
+    table->swap_rows(30, 1500);
+    table->set_string(1, 40, StringData(values[1].data(), values[1].size()));
+    table->set_binary(0, 40, BinaryData(values[1].data(), values[1].size()));
+    table->set_int(2, 40, 1);
+    table->set_binary(0, 50, BinaryData(values[2].data(), values[2].size()));
+    table->set_string(1, 50, StringData(values[2].data(), values[2].size()));
+    table->set_int(2, 50, 2);
+    check_values(*table);
+#ifdef REALM_DEBUG
+    table->verify();
+#endif
+
+    table->clear();
+    CHECK_EQUAL(0, table->size());
+}
+
 #endif // TEST_TABLE
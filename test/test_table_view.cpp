@@ -1054,6 +1054,116 @@ TEST(TableView_ClearNone)
     v.clear();
 }
 
+// Verify that removing runs of consecutive rows at a time gives the same
+// result as removing the rows one by one
+TEST(TableView_ClearRuns)
+{
+    for (int mode = 0; mode < 2; ++mode) {
+        bool ordered = (mode == 0);
+        Table table_1, table_2;
+        for (Table* t : {&table_1, &table_2}) {
+            t->add_column(type_Int, "int");
+            t->add_column(type_String, "str");
+            t->add_search_index(0);
+            t->add_search_index(1);
+            t->add_empty_row(20);
+            for (size_t i = 0; i < 20; ++i) {
+                t->set_int(0, i, int64_t(i));
+                char str[] = {char('a' + i), 0};
+                t->set_string(1, i, str);
+            }
+        }
+
+        // Runs in the middle and at the end of the table
+        std::vector<size_t> rows = {2, 3, 4, 9, 12, 13, 17, 18, 19};
+        Query q = table_1.where().equal(0, int64_t(rows[0]));
+        for (size_t i = 1; i < rows.size(); ++i)
+            q.Or().equal(0, int64_t(rows[i]));
+        TableView v = q.find_all();
+        TableView kept = table_1.where().find_all();
+        Row first = table_1[0];
+        Row gone = table_1[13];
+        Row moved = table_1[16];
+        for (size_t i = rows.size(); i > 0; --i) {
+            if (ordered)
+                table_2.remove(rows[i - 1]);
+            else
+                table_2.move_last_over(rows[i - 1]);
+        }
+        CHECK_EQUAL(rows.size(), v.size());
+        v.clear(ordered ? RemoveMode::ordered : RemoveMode::unordered);
+
+        CHECK_EQUAL(0, v.size());
+        CHECK_EQUAL(table_2.size(), table_1.size());
+        for (size_t i = 0; i < table_1.size(); ++i) {
+            CHECK_EQUAL(table_2.get_int(0, i), table_1.get_int(0, i));
+            CHECK_EQUAL(table_2.get_string(1, i), table_1.get_string(1, i));
+            CHECK_EQUAL(i, table_1.find_first_int(0, table_1.get_int(0, i)));
+            CHECK_EQUAL(i, table_1.find_first_string(1, table_1.get_string(1, i)));
+        }
+        CHECK_EQUAL(not_found, table_1.find_first_int(0, 13));
+        CHECK_EQUAL(not_found, table_1.find_first_string(1, "n"));
+
+        CHECK(first.is_attached());
+        CHECK_EQUAL(0, first.get_int(0));
+        CHECK(!gone.is_attached());
+        CHECK(moved.is_attached());
+        CHECK_EQUAL(16, moved.get_int(0));
+        CHECK_EQUAL(table_1.size(), kept.num_attached_rows());
+    }
+}
+
+
+// Verify that unordered removal of runs of rows gives the same result as
+// moving the last row over each of them, also when a run reaches into the
+// rows that are moved
+TEST(TableView_ClearRunsUnordered)
+{
+    std::vector<std::vector<size_t>> row_sets = {{2, 3, 4, 9, 12, 13, 17}, {2, 12, 13, 14, 15, 16, 18}};
+    for (const std::vector<size_t>& rows : row_sets) {
+        Table table_1, table_2;
+        for (Table* t : {&table_1, &table_2}) {
+            t->add_column(type_Int, "int");
+            t->add_column(type_Timestamp, "time", true);
+            t->add_column(type_Double, "double");
+            t->add_search_index(0);
+            t->add_search_index(1);
+            t->add_empty_row(20);
+            for (size_t i = 0; i < 20; ++i) {
+                t->set_int(0, i, int64_t(i));
+                if (i % 5 != 0)
+                    t->set_timestamp(1, i, Timestamp(int64_t(i), int32_t(i)));
+                t->set_double(2, i, double(i) / 2);
+            }
+        }
+
+        Query q = table_1.where().equal(0, int64_t(rows[0]));
+        for (size_t i = 1; i < rows.size(); ++i)
+            q.Or().equal(0, int64_t(rows[i]));
+        TableView v = q.find_all();
+        Row moved = table_1[19];
+        for (size_t i = rows.size(); i > 0; --i)
+            table_2.move_last_over(rows[i - 1]);
+        v.clear(RemoveMode::unordered);
+        table_1.verify();
+
+        CHECK_EQUAL(table_2.size(), table_1.size());
+        for (size_t i = 0; i < table_1.size(); ++i) {
+            CHECK_EQUAL(table_2.get_int(0, i), table_1.get_int(0, i));
+            CHECK_EQUAL(table_2.get_timestamp(1, i), table_1.get_timestamp(1, i));
+            CHECK_EQUAL(table_2.get_double(2, i), table_1.get_double(2, i));
+            CHECK_EQUAL(i, table_1.find_first_int(0, table_1.get_int(0, i)));
+            if (!table_1.is_null(1, i))
+                CHECK_EQUAL(i, table_1.find_first_timestamp(1, table_1.get_timestamp(1, i)));
+        }
+        CHECK_EQUAL(not_found, table_1.find_first_int(0, 13));
+        CHECK_EQUAL(not_found, table_1.find_first_timestamp(1, Timestamp(13, 13)));
+        CHECK_EQUAL(table_1.where().equal(1, Timestamp{}).count(), table_2.where().equal(1, Timestamp{}).count());
+        CHECK(moved.is_attached());
+        CHECK_EQUAL(19, moved.get_int(0));
+    }
+}
+
 TEST(TableView_FindAllStacked)
 {
     TestTable table;
@@ -847,6 +847,56 @@ NONCONCURRENT_TEST(Thread_CondvarTimeout)
 }
 
 
+// Verify that a wait that times out does not swallow a later notification
+// meant for another waiter - this test hangs if it does.
+NONCONCURRENT_TEST(Thread_CondvarNotifyAfterTimeout)
+{
+    InterprocessMutex mutex;
+    InterprocessMutex::SharedPart mutex_part;
+    InterprocessCondVar changed;
+    InterprocessCondVar::SharedPart condvar_part;
+    InterprocessCondVar::init_shared_part(condvar_part);
+    TEST_PATH(path);
+    SharedGroupOptions default_options;
+    mutex.set_shared_part(mutex_part, path, "Thread_CondvarNotifyAfterTimeout_Mutex");
+    changed.set_shared_part(condvar_part, path, "Thread_CondvarNotifyAfterTimeout_CondVar",
+                            default_options.temp_dir);
+
+    bool waiting = false;
+    bool woken = false;
+    Thread waiter_thread;
+    waiter_thread.start([&] {
+        std::lock_guard<InterprocessMutex> l(mutex);
+        waiting = true;
+        while (!woken)
+            changed.wait(mutex, nullptr);
+    });
+
+    // Time out while the other thread is waiting
+    {
+        struct timespec time_limit;
+        timeval tv;
+        gettimeofday(&tv, nullptr);
+        time_limit.tv_sec = tv.tv_sec;
+        time_limit.tv_nsec = tv.tv_usec * 1000;
+        std::lock_guard<InterprocessMutex> l(mutex);
+        changed.wait(mutex, &time_limit);
+    }
+
+    for (;;) {
+        std::lock_guard<InterprocessMutex> l(mutex);
+        if (waiting) {
+            woken = true;
+            changed.notify();
+            break;
+        }
+    }
+    waiter_thread.join();
+    changed.release_shared_part();
+    mutex.release_shared_part();
+}
+
+
 // test that notify_all will wake up all waiting threads, if there
 // are many waiters:
 NONCONCURRENT_TEST(Thread_CondvarNotifyAllWakeup)
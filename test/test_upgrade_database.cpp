@@ -1419,4 +1419,95 @@ TEST_IF(Upgrade_Database_9_10, REALM_MAX_BPNODE_SIZE == 4 || REALM_MAX_BPNODE_SI
 }
 
 
+TEST(Upgrade_Database_9_10_Deduplicated)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(path_8);
+    {
+        Group g;
+        CHECK_EQUAL(9, _impl::GroupFriend::get_file_format_version(g));
+        TableRef t = g.add_table("table");
+        t->add_column(type_Binary, "bin");
+        g.write(path);
+        _impl::GroupFriend::set_file_format_version(g, 8);
+        g.write(path_8);
+    }
+
+    // Versions before 9 would need an upgrade
+    {
+        SharedGroup sg(path_8);
+        using sgf = _impl::SharedGroupFriend;
+        CHECK_EQUAL(8, sgf::get_file_format_version(sg));
+        WriteTransaction wt(sg);
+        DescriptorRef desc = wt.get_table("table")->get_descriptor();
+        CHECK_LOGIC_ERROR(desc->set_deduplicated(0), LogicError::old_file_format);
+        CHECK(!wt.get_table("table")->is_deduplicated(0));
+    }
+
+    // Opening the file does not upgrade it
+    std::unique_ptr<Replication> hist = make_in_realm_history(path);
+    std::unique_ptr<Replication> hist_2 = make_in_realm_history(path);
+    SharedGroup sg(*hist);
+    SharedGroup sg_2(*hist_2);
+    using sgf = _impl::SharedGroupFriend;
+    using gf = _impl::GroupFriend;
+    CHECK_EQUAL(9, sgf::get_file_format_version(sg));
+    CHECK_EQUAL(9, sgf::get_file_format_version(sg_2));
+
+    // Nor does a deduplicated column that is rolled back
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("table")->get_descriptor()->set_deduplicated(0);
+        CHECK_EQUAL(10, gf::get_file_format_version(wt.get_group()));
+    }
+    {
+        WriteTransaction wt(sg);
+        CHECK_EQUAL(9, gf::get_file_format_version(wt.get_group()));
+        wt.get_table("table")->add_empty_row();
+        wt.commit();
+    }
+    {
+        ReadTransaction rt(sg);
+        CHECK_EQUAL(9, gf::get_committed_file_format_version(rt.get_group()));
+    }
+
+    // The first deduplicated column raises the file format
+    {
+        WriteTransaction wt(sg);
+        wt.get_table("table")->get_descriptor()->set_deduplicated(0);
+        wt.commit();
+    }
+    {
+        // The other session participant keeps it
+        WriteTransaction wt(sg_2);
+        CHECK_EQUAL(10, gf::get_file_format_version(wt.get_group()));
+        CHECK(wt.get_table("table")->is_deduplicated(0));
+        wt.get_table("table")->add_empty_row();
+        wt.commit();
+    }
+    {
+        // A participant joining the session agrees
+        std::unique_ptr<Replication> hist_3 = make_in_realm_history(path);
+        SharedGroup sg_3(*hist_3);
+        CHECK_EQUAL(10, sgf::get_file_format_version(sg_3));
+        ReadTransaction rt(sg_3);
+        CHECK_EQUAL(10, gf::get_committed_file_format_version(rt.get_group()));
+        CHECK_EQUAL(2, rt.get_table("table")->size());
+    }
+    sg.close();
+    sg_2.close();
+    {
+        Group g(path);
+        CHECK_EQUAL(10, gf::get_file_format_version(g));
+        CHECK(g.get_table("table")->is_deduplicated(0));
+    }
+    {
+        // A new session keeps the version as well
+        std::unique_ptr<Replication> hist_3 = make_in_realm_history(path);
+        SharedGroup sg_3(*hist_3);
+        CHECK_EQUAL(10, sgf::get_file_format_version(sg_3));
+    }
+}
+
+
 #endif // TEST_GROUP
@@ -36,6 +36,7 @@
 
 #define TEST_BASIC_UTILS
 #define TEST_COLUMN_MIXED
+#define TEST_COLUMN_STATISTICS
 #define TEST_ALLOC
 #define TEST_ARRAY
 #define TEST_ARRAY_BINARY
@@ -43,17 +44,22 @@
 #define TEST_ARRAY_FLOAT
 #define TEST_ARRAY_STRING
 #define TEST_ARRAY_STRING_LONG
+#define TEST_ASYNC_QUERY
 #define TEST_COLUMN
 #define TEST_COLUMN_BASIC
 #define TEST_COLUMN_BINARY
+#define TEST_COLUMN_CURSOR
 #define TEST_COLUMN_TIMESTAMP
 #define TEST_COLUMN_FLOAT
 #define TEST_COLUMN_MIXED
+#define TEST_COLUMN_STATISTICS
 #define TEST_COLUMN_STRING
 #define TEST_FILE
 #define TEST_FILE_LOCKS
+#define TEST_FLOAT_KERNELS
 #define TEST_GROUP
 #define TEST_UPGRADE
+#define TEST_IMPORTER
 #define TEST_INDEX_STRING
 #define TEST_LANG_BIND_HELPER
 #define TEST_METRICS